@@ -132,6 +132,10 @@ typedef enum
 #define KEY1_BUTTON_PIN                   GPIO_PIN_0
 #define KEY1_BUTTON_GPIO_PORT             GPIOC
 #define KEY1_BUTTON_GPIO_CLK              RCM_AHB_PERIPH_GPIOC
+#define KEY1_BUTTON_EINT_LINE             EINT_LINE0
+#define KEY1_BUTTON_EINT_PORT_SOURCE      SYSCFG_PORT_GPIOC
+#define KEY1_BUTTON_EINT_PIN_SOURCE       SYSCFG_PIN_0
+#define KEY1_BUTTON_EINT_IRQn             EINT0_1_IRQn
 
 /**
  * @brief Key2 push-button
@@ -139,6 +143,10 @@ typedef enum
 #define KEY2_BUTTON_PIN                   GPIO_PIN_1
 #define KEY2_BUTTON_GPIO_PORT             GPIOC
 #define KEY2_BUTTON_GPIO_CLK              RCM_AHB_PERIPH_GPIOC
+#define KEY2_BUTTON_EINT_LINE             EINT_LINE1
+#define KEY2_BUTTON_EINT_PORT_SOURCE      SYSCFG_PORT_GPIOC
+#define KEY2_BUTTON_EINT_PIN_SOURCE       SYSCFG_PIN_1
+#define KEY2_BUTTON_EINT_IRQn             EINT0_1_IRQn
 
 /**
  * @brief Key3 push-button
@@ -146,6 +154,10 @@ typedef enum
 #define KEY3_BUTTON_PIN                   GPIO_PIN_2
 #define KEY3_BUTTON_GPIO_PORT             GPIOC
 #define KEY3_BUTTON_GPIO_CLK              RCM_AHB_PERIPH_GPIOC
+#define KEY3_BUTTON_EINT_LINE             EINT_LINE2
+#define KEY3_BUTTON_EINT_PORT_SOURCE      SYSCFG_PORT_GPIOC
+#define KEY3_BUTTON_EINT_PIN_SOURCE       SYSCFG_PIN_2
+#define KEY3_BUTTON_EINT_IRQn             EINT2_3_IRQn
 
 /**
  * @brief Key4 push-button
@@ -153,6 +165,10 @@ typedef enum
 #define KEY4_BUTTON_PIN                   GPIO_PIN_3
 #define KEY4_BUTTON_GPIO_PORT             GPIOC
 #define KEY4_BUTTON_GPIO_CLK              RCM_AHB_PERIPH_GPIOC
+#define KEY4_BUTTON_EINT_LINE             EINT_LINE3
+#define KEY4_BUTTON_EINT_PORT_SOURCE      SYSCFG_PORT_GPIOC
+#define KEY4_BUTTON_EINT_PIN_SOURCE       SYSCFG_PIN_3
+#define KEY4_BUTTON_EINT_IRQn             EINT2_3_IRQn
 
 #define COMn                             2
 
@@ -210,6 +226,8 @@ void APM_EVAL_LEDToggle(Led_TypeDef Led);
 /* Key button */
 void APM_EVAL_PBInit(Button_TypeDef Button, ButtonMode_TypeDef Button_Mode);
 uint32_t APM_EVAL_PBGetState(Button_TypeDef Button);
+uint8_t APM_EVAL_PBReadEintFlag(Button_TypeDef Button);
+void APM_EVAL_PBClearEintFlag(Button_TypeDef Button);
 void APM_EVAL_PB_Led_Isr(void);
 
 /* COM */
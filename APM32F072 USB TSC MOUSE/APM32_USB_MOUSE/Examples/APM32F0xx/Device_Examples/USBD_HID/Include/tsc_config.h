@@ -59,7 +59,9 @@ extern "C" {
 #define TOUCH_TOTAL_TOUCHKEYS_B (0)
 
 /** The number of "Extended" Linear and Rotary sensors (0..24) */
+#ifndef TOUCH_TOTAL_LINROTS
 #define TOUCH_TOTAL_LINROTS (0)
+#endif
 
 /** The number of "Basic" Linear and Rotary sensors (0..24) */
 #define TOUCH_TOTAL_LINROTS_B (0)
@@ -287,6 +289,27 @@ extern "C" {
  */
 #define TOUCH_LINROT_DIR_CHG_DEB (1)
 
+/** High resolution position calculation (0..1)
+ *  - 0: Not used
+ *  - 1: Used. The TSC_Linrot_CalcPosHiRes() method can be used as CalcPosition
+ *       method. It computes a weighted centroid over all the channels of the sensor.
+ */
+#ifndef TOUCH_LINROT_USE_HIRES
+#define TOUCH_LINROT_USE_HIRES (0)
+#endif
+
+/** High resolution position in number of bits (1..16)
+ *  - Resolution of the position returned by TSC_Linrot_ReadHiResPosition().
+ */
+#define TOUCH_LINROT_HIRES_RESOLUTION (12)
+
+/** High resolution position jitter filter (0..8)
+ *  - Exponential filter coefficient, the new position is weighted by 1/(2^N).
+ *  - 0: No filter
+ *  - A High value will result in a stable but slower position.
+ */
+#define TOUCH_LINROT_HIRES_FILTER (2)
+
 /**@} Common_Parameters_Position_Linear_Rotary */
 
 /** @addtogroup Common_Parameters_Debounce_Counters
@@ -346,6 +369,36 @@ extern "C" {
 
 /**@} Common_Parameters_Environment_Change_System */
 
+/** @addtogroup Common_Parameters_Water_Rejection
+  @{
+*/
+
+/** Water rejection with a driven shield (0=No, 1=Yes)
+ *  - The shield electrode is acquired in each block together with the keys.
+ *  - The ECS is paused while water is present on the shield.
+ */
+#ifndef TOUCH_USE_WATER
+#define TOUCH_USE_WATER (0)
+#endif
+
+/** Shield delta threshold for the water presence (0..255)
+ *  - Water is present if the shield delta is above.
+ */
+#define TOUCH_WATER_SHIELD_TH (40)
+
+/** Minimum key/shield delta ratio of a finger in 1/16 unit (1..255)
+ *  - While water is present, a detection is rejected if the key delta is
+ *    lower than the shield delta x TOUCH_WATER_RATIO / 16.
+ */
+#define TOUCH_WATER_RATIO (48)
+
+/** Water debounce counter (0..63)
+ *  - Number of frames with the shield delta below threshold to leave the water state.
+ */
+#define TOUCH_WATER_DEB_DRY (10)
+
+/**@} Common_Parameters_Water_Rejection */
+
 /** @addtogroup Common_Parameters_Detection_Time_Out (DTO)
   @{
 */
@@ -372,6 +425,24 @@ extern "C" {
 /** Detection Exclusion System (0=No, 1=Yes) */
 #define TOUCH_USE_DXS (0)
 
+/** Detection arbitration between the objects of a group (0=No, 1=Yes)
+ *  - TSC_Dxs_Arbitrate() reports the objects in detect state selected by the mode.
+ */
+#define TOUCH_USE_DXS_ARB (1)
+
+/** Default arbitration mode (0..3)
+ *  - 0: Exclusive, one object is reported only if it is alone in detect state
+ *  - 1: First wins, the first object detected is kept until it is released
+ *  - 2: Strongest wins, the object with the biggest delta is reported
+ *  - 3: Chord, all the objects in detect state are reported together
+ */
+#define TOUCH_DXS_ARB_MODE (3)
+
+/** Maximum number of objects reported together in chord mode (1..24)
+ *  - Nothing is reported if more objects are in detect state (palm rejection).
+ */
+#define TOUCH_DXS_CHORD_MAX (2)
+
 /**@} Common_Parameters_Detection_Exclusion_System */
 
 /** @addtogroup Common_Parameters_Miscellaneous_Parameters
@@ -424,8 +495,13 @@ extern "C" {
 #define TOUCH_TSC_GROUP2_IO3  CHANNEL  //!< PA6
 #define TOUCH_TSC_GROUP2_IO4  CHANNEL       //!< PA7
 
+#if TOUCH_USE_WATER > 0
+#define TOUCH_TSC_GROUP3_IO1  SAMPCAP  //!< PC5
+#define TOUCH_TSC_GROUP3_IO2  CHANNEL  //!< PB0, shield electrode (acquired)
+#else
 #define TOUCH_TSC_GROUP3_IO1  NU  //!< PC5
 #define TOUCH_TSC_GROUP3_IO2  NU  //!< PB0
+#endif
 #define TOUCH_TSC_GROUP3_IO3  NU  //!< PB1
 #define TOUCH_TSC_GROUP3_IO4  NU       //!< PB2
 
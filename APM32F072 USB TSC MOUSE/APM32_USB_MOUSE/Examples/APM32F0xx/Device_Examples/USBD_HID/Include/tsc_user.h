@@ -70,19 +70,39 @@ extern "C" {
 #define CHANNEL_4_SRC       (1) /*!< Index in source register (TSC->IOGXCR[]) */
 #define CHANNEL_4_DEST      (4) /*!< Index in destination result array */
 
-#define SHIELD_IO_MSK       (0)
+#if TOUCH_USE_WATER > 0
+#define CHANNEL_SHIELD_IO_MSK    (TSC_GROUP3_IO2)
+#define CHANNEL_SHIELD_GRP_MSK   (TSC_GROUP3)
+#define CHANNEL_SHIELD_SRC       (2) /*!< Index in source register (TSC->IOGXCR[]) */
+#define CHANNEL_SHIELD_DEST      (TOUCH_TOTAL_CHANNELS) /*!< Index in destination result array */
 
-#define BLOCK_0_NUMCHANNELS      (2)
-#define BLOCK_0_MSK_CHANNELS     (CHANNEL_1_IO_MSK | CHANNEL_2_IO_MSK)
-#define BLOCK_0_MSK_GROUPS       (CHANNEL_1_GRP_MSK | CHANNEL_2_GRP_MSK)
+/* The driven shield is acquired in each block together with the keys */
+#define SHIELD_IO_MSK            (CHANNEL_SHIELD_IO_MSK)
+#define SHIELD_GRP_MSK           (CHANNEL_SHIELD_GRP_MSK)
+#define SHIELD_NUMCHANNELS       (1)
+#else
+#define SHIELD_IO_MSK            (0)
+#define SHIELD_GRP_MSK           (0)
+#define SHIELD_NUMCHANNELS       (0)
+#endif
+
+#define BLOCK_0_NUMCHANNELS      (2 + SHIELD_NUMCHANNELS)
+#define BLOCK_0_MSK_CHANNELS     (CHANNEL_1_IO_MSK | CHANNEL_2_IO_MSK | SHIELD_IO_MSK)
+#define BLOCK_0_MSK_GROUPS       (CHANNEL_1_GRP_MSK | CHANNEL_2_GRP_MSK | SHIELD_GRP_MSK)
                                  
-#define BLOCK_1_NUMCHANNELS      (2)
-#define BLOCK_1_MSK_CHANNELS     (CHANNEL_0_IO_MSK | CHANNEL_4_IO_MSK)
-#define BLOCK_1_MSK_GROUPS       (CHANNEL_0_GRP_MSK |CHANNEL_4_GRP_MSK)
+#define BLOCK_1_NUMCHANNELS      (2 + SHIELD_NUMCHANNELS)
+#define BLOCK_1_MSK_CHANNELS     (CHANNEL_0_IO_MSK | CHANNEL_4_IO_MSK | SHIELD_IO_MSK)
+#define BLOCK_1_MSK_GROUPS       (CHANNEL_0_GRP_MSK |CHANNEL_4_GRP_MSK | SHIELD_GRP_MSK)
+
+#define BLOCK_2_NUMCHANNELS      (1 + SHIELD_NUMCHANNELS)
+#define BLOCK_2_MSK_CHANNELS     (CHANNEL_3_IO_MSK | SHIELD_IO_MSK)
+#define BLOCK_2_MSK_GROUPS       (CHANNEL_3_GRP_MSK | SHIELD_GRP_MSK)
 
-#define BLOCK_2_NUMCHANNELS      (1)
-#define BLOCK_2_MSK_CHANNELS     (CHANNEL_3_IO_MSK)
-#define BLOCK_2_MSK_GROUPS       (CHANNEL_3_GRP_MSK)
+/* Index of the first channel of each block in the source/destination tables */
+#define BLOCK_0_FIRST_CHANNEL    (0)
+#define BLOCK_1_FIRST_CHANNEL    (BLOCK_0_FIRST_CHANNEL + BLOCK_0_NUMCHANNELS)
+#define BLOCK_2_FIRST_CHANNEL    (BLOCK_1_FIRST_CHANNEL + BLOCK_1_NUMCHANNELS)
+#define BLOCK_TOTAL_CHANNELS     (BLOCK_2_FIRST_CHANNEL + BLOCK_2_NUMCHANNELS)
 /**@} end of group TSC_KeyLinearRotate_Macros*/
 
 #define TOUCHKEY_PRESS(Num) ((MyTouchKeys[(Num)].p_Data->StateId == TSC_STATEID_DETECT))
@@ -96,21 +116,93 @@ typedef enum
     TSC_TOUCH_K4 = 0x08,
     TSC_TOUCH_K5 = 0x10,
 } TSC_TOUCH_T;
+
+/* Keys reported by the detection arbitration */
+#define TSC_TOUCH_ARB_MASK  (TSC_TOUCH_K1 | TSC_TOUCH_K2 | TSC_TOUCH_K3 | TSC_TOUCH_K4 | TSC_TOUCH_K5)
+
+/**
+ * @brief    Touch key action type
+ */
+typedef enum
+{
+    TSC_ACTION_NONE,
+    TSC_ACTION_MOVE,        /*!< Cursor motion while the key is held */
+    TSC_ACTION_BUTTON,      /*!< Mouse button bitmap */
+    TSC_ACTION_KEY,         /*!< Keyboard usage and modifier */
+    TSC_ACTION_CONSUMER,    /*!< Consumer control usage */
+} TSC_ACTION_TYPE_T;
+
+/**
+ * @brief    Touch key action
+ */
+typedef struct
+{
+    uint8_t  type;          /*!< TSC_ACTION_TYPE_T */
+    uint8_t  modifier;      /*!< Keyboard modifier bitmap */
+    int8_t   x;             /*!< Cursor X step */
+    int8_t   y;             /*!< Cursor Y step */
+    uint16_t code;          /*!< Button bitmap, keyboard or consumer usage */
+} TSC_ACTION_T;
+
+#define HID_CONSUMER_PLAY_PAUSE    (0x00CD)
+#define HID_CONSUMER_VOLUME_UP     (0x00E9)
+#define HID_CONSUMER_VOLUME_DOWN   (0x00EA)
+/* GPIO key bitmap, bit n is BUTTON_KEYn+1 */
 enum
 {
-    HID_MOUSE_KEY_NULL,
-    HID_MOUSE_KEY_LEFT,
-    HID_MOUSE_KEY_RIGHT,
-    HID_MOUSE_KEY_UP,
-    HID_MOUSE_KEY_DOWN,
+    HID_MOUSE_KEY_NULL  = 0x00,
+    HID_MOUSE_KEY_UP    = 0x01,   /*!< KEY1, PC0 */
+    HID_MOUSE_KEY_DOWN  = 0x02,   /*!< KEY2, PC1 */
+    HID_MOUSE_KEY_LEFT  = 0x04,   /*!< KEY3, PC2 */
+    HID_MOUSE_KEY_RIGHT = 0x08,   /*!< KEY4, PC3 */
 };
+/* Telemetry report: header, then one record per channel */
+#define TSC_TLM_HEADER_SIZE        (4)    /*!< Sequence (2), channel count, flags */
+#define TSC_TLM_CHANNEL_SIZE       (7)    /*!< Meas (2), Delta (2), Refer (2), StateId */
+#define TSC_TLM_CHANNELS           (TOUCH_TOTAL_KEYS + SHIELD_NUMCHANNELS)
+#define TSC_TLM_FLAG_PROCESS       (0x01) /*!< ECS held off by a sensor in process */
+#define TSC_TLM_FLAG_WET           (0x02) /*!< Water on the shield */
+
+/* Telemetry commands, first byte of an OUT report */
+#define TSC_TLM_CMD_STREAM         (0x01) /*!< [1] 0 to stop, 1 to start */
+#define TSC_TLM_CMD_THRESHOLD      (0x02) /*!< [1] key, [2] detect in, [3] detect out, [4] calibration */
+#define TSC_TLM_CMD_DEBOUNCE       (0x03) /*!< [1] key, [2] detect, [3] release, [4] calibration, [5] error */
+#define TSC_TLM_CMD_FILTER         (0x04) /*!< [1] TSC_TLM_FILTER_x bitmap */
+#define TSC_TLM_KEY_ALL            (0xFF)
+#define TSC_TLM_FILTER_MEAS        (0x01)
+#define TSC_TLM_FILTER_DELTA       (0x02)
+
+/* Parameter block of the telemetry feature report, version 1 */
+#define TSC_PARAM_VERSION          (0x01)
+#define TSC_PARAM_HEADER_SIZE      (12)   /*!< Version, key count, flags, interval, AcqMin (2), AcqMax (2),
+                                               ECS K differ, ECS K same, filter, reserved */
+#define TSC_PARAM_KEY_SIZE         (7)    /*!< Detect in, detect out, calibration thresholds,
+                                               calibration, detect, release, error debounce */
+#define TSC_PARAM_SIZE             (TSC_PARAM_HEADER_SIZE + TOUCH_TOTAL_KEYS * TSC_PARAM_KEY_SIZE)
+#define TSC_PARAM_FLAG_SAVE        (0x01) /*!< Write the block to flash once applied */
+#define TSC_PARAM_DEB_MAX          (63)   /*!< Largest debounce counter */
+/* Last 2 KB page of the 128 KB flash, left out of the IROM of the project */
+#ifndef TSC_PARAM_FLASH_ADDR
+#define TSC_PARAM_FLASH_ADDR       (0x0801F800)
+#endif
+#define TSC_PARAM_FLASH_MAGIC      (0x5054)
+
+/* GPIO key level sampled once its edges have settled for this time in ms */
+#define HID_MOUSE_KEY_DEBOUNCE     (20)
+/* Touch cursor speed: vector counts per period in ms */
+#define HID_MOUSE_MOTION_PERIOD    (20)
+/* Acquisition period in ms while the USB bus is suspended */
+#define TSC_SUSPEND_SCAN_PERIOD    (50)
 /* Timer tick */
 extern uint8_t cnt50ms ;
 extern uint8_t taskFlag ;
 extern uint8_t tscPressStatus ;
 extern uint16_t cntTick;
+extern __IO uint16_t cntMotion;
+extern __IO uint16_t cntFrame;
+extern __IO uint16_t cntWake;
+extern __IO uint32_t cntMs;
 extern __IO uint32_t Global_EOA;
-extern uint8_t keyRecord;
 /** @defgroup TSC_KeyLinearRotate_Variables Variables
   @{
   */
@@ -119,6 +211,14 @@ extern CONST TSC_Block_T MyBlocks[];
 extern CONST TSC_TouchKey_T MyTouchKeys[];
 extern CONST TSC_Object_T MyObjects[];
 extern TSC_ObjectGroup_T MyObjGroup;
+extern CONST TSC_ACTION_T MyKeyActions[];
+#if TOUCH_USE_DXS_ARB > 0
+extern TSC_DxsArb_T MyArb;
+#endif
+#if TOUCH_USE_WATER > 0
+extern TSC_ObjectGroup_T MyShieldGroup;
+extern TSC_Water_T MyWater;
+#endif
 extern uint32_t Global_ProcessSensor;
 
 /**@} end of group TSC_KeyLinearRotate_Variables*/
@@ -127,9 +227,13 @@ extern uint32_t Global_ProcessSensor;
   @{
   */
 void Menu_TSCHandler(void);
+void Digitizer_TSCHandler(void);
+void Action_TSCHandler(void);
 void HidMouse_Proc(void);
 uint8_t HidMouse_ReadKey(void);
-void HidMouse_Write(uint8_t key);
+void HidMouse_Write(uint8_t keys);
+void HidMouse_KeyIsr(void);
+void HidMouse_KeyTick(void);
 void APM_EVAL_TMR14_Init(uint16_t period, uint16_t div);
 void TMR14_Isr(void);
 void MyKeys_ProcessOffState(void);
@@ -139,6 +243,13 @@ void TSC_DetectHandler(void);
 void TSC_User_Config(void);
 void TSC_User_Thresholds(void);
 TSC_STATUS_T TSC_User_Action(void);
+uint8_t TSC_User_Touched(void);
+uint32_t TSC_User_ReadTimeUs(void);
+void TSC_User_Telemetry(void);
+TSC_STATUS_T TSC_User_TlmReceive(uint8_t* buffer, uint8_t length);
+TSC_STATUS_T TSC_User_ParamRead(uint8_t* buffer, uint8_t length);
+TSC_STATUS_T TSC_User_ParamWrite(uint8_t* buffer, uint8_t length);
+void TSC_User_ParamLoad(void);
 
 
 #ifdef __cplusplus
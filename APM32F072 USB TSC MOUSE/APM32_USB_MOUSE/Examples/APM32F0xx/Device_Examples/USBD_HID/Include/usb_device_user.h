@@ -54,14 +54,142 @@ typedef enum
     USBD_APP_READY,
 } USBD_APP_STA_T;
 
+/**
+ * @brief    USB device remote wakeup status
+ */
+typedef enum
+{
+    USBD_WAKE_IDLE,
+    USBD_WAKE_RESUME,
+} USBD_WAKE_STA_T;
+
+/**
+ * @brief    Touch to report latency stages
+ */
+typedef enum
+{
+    USBD_LAT_EOA,           /*!< End of the acquisition frame */
+    USBD_LAT_STATE,         /*!< Key state change processed */
+    USBD_LAT_QUEUE,         /*!< Report queued to the HID class */
+    USBD_LAT_ACK,           /*!< IN transaction acknowledged by the host */
+    USBD_LAT_STAGE_NUM,
+} USBD_LAT_STAGE_T;
+
+/**
+ * @brief    Touch to report latency trace status
+ */
+typedef enum
+{
+    USBD_LAT_STA_IDLE,
+    USBD_LAT_STA_STATE,
+    USBD_LAT_STA_QUEUE,
+    USBD_LAT_STA_DONE,
+} USBD_LAT_STA_T;
+
 /**@} end of group USBD_HID_Enumerates*/
 
+/** @defgroup USBD_HID_Macros Macros
+  @{
+  */
+
+/* Give up the wake latency measure after this time in ms */
+#define USBD_WAKE_TIMEOUT       1000
+
+/* Latency histogram bins, bin n counts latencies below 125 us << n
+   and the last bin counts the rest */
+#define USBD_LAT_BIN_NUM        8
+#define USBD_LAT_BIN_BASE       125
+/* Drop a queued trace not acknowledged after this time in ms */
+#define USBD_LAT_TIMEOUT        100
+
+/* Vendor requests on the telemetry interface */
+#define USBD_LAT_REQ_READ       0x01    /*!< IN, wValue selects USBD_LAT_PAGE_x */
+#define USBD_LAT_REQ_CLEAR      0x02    /*!< OUT, no data */
+#define USBD_LAT_PAGE_HIST      0x00    /*!< Histograms, 16-bit bins */
+#define USBD_LAT_PAGE_TRACE     0x01    /*!< Counters and the last trace */
+#define USBD_LAT_PAGE_ISR       0x02    /*!< USB interrupt time and event queue */
+#define USBD_LAT_PAGE_LINK      0x03    /*!< Link counters and endpoint transactions */
+#define USBD_LAT_PAGE_BYTE      0x04    /*!< Endpoint bytes, 32-bit */
+#define USBD_LAT_PAGE_CRS       0x05    /*!< HSI48 trim and CRS errors */
+
+/**@} end of group USBD_HID_Macros*/
+
+/** @defgroup USBD_HID_Structures Structures
+  @{
+  */
+
+/**
+ * @brief    USB device remote wakeup statistics, latencies in ms
+ *           from the wakeup request to the first report polled
+ */
+typedef struct
+{
+    uint16_t    count;
+    uint16_t    timeout;
+    uint16_t    lastLatency;
+    uint16_t    maxLatency;
+} USBD_WAKE_STAT_T;
+
+/**
+ * @brief    Touch to report latency trace, times in us and the USB
+ *           frame number at each stage
+ */
+typedef struct
+{
+    uint32_t    time[USBD_LAT_STAGE_NUM];
+    uint16_t    frame[USBD_LAT_STAGE_NUM];
+} USBD_LAT_TRACE_T;
+
+/**
+ * @brief    Touch to report latency statistics. hist[n] counts the
+ *           time from stage n-1 to stage n, hist[USBD_LAT_EOA] the
+ *           time from the end of acquisition to the host ACK.
+ */
+typedef struct
+{
+    uint16_t            count;
+    uint16_t            drop;
+    uint16_t            hist[USBD_LAT_STAGE_NUM][USBD_LAT_BIN_NUM];
+    USBD_LAT_TRACE_T    last;
+    uint16_t            isrMax;         /*!< Longest USB interrupt in us */
+} USBD_LAT_STAT_T;
+
+/**
+ * @brief    Clock recovery statistics of the HSI48 trimmed on the
+ *           host SOF
+ */
+typedef struct
+{
+    uint16_t    syncOk;         /*!< SYNC within the warning limit */
+    uint16_t    syncWarn;       /*!< SYNC beyond the warning limit */
+    uint16_t    syncErr;        /*!< SYNC beyond the error limit */
+    uint16_t    syncMiss;       /*!< SYNC missed */
+    uint16_t    trimOvf;        /*!< Trim overflow or underflow */
+    uint16_t    fallback;       /*!< Trim restored to USBD_CRS_TRIM_DEFAULT */
+    uint8_t     trim;           /*!< Trim at the last SYNC */
+    uint8_t     trimMin;
+    uint8_t     trimMax;
+    int16_t     freqErr;        /*!< Frequency error at the last SYNC, positive when fast */
+    uint32_t    lockTime;       /*!< us from the last reset or resume to the first SYNC OK */
+} USBD_CRS_STAT_T;
+
+/**@} end of group USBD_HID_Structures*/
+
 /** @defgroup USBD_HID_Variables Variables
   @{
   */
 
 extern USBD_APP_STA_T gUsbDevAppStatus;
 extern USBD_INFO_T gUsbDeviceFS;
+#if USBD_SUP_REMOTE_WAKEUP
+extern USBD_WAKE_STAT_T gUsbWakeStat;
+#endif
+#if USBD_SUP_LATENCY
+extern USBD_LAT_STAT_T gUsbLatStat;
+#endif
+#if USBD_SUP_CRS_STAT
+extern USBD_CRS_STAT_T gUsbCrsStat;
+#endif
 
 /**@} end of group USBD_HID_Variables*/
 
@@ -72,6 +200,25 @@ extern USBD_INFO_T gUsbDeviceFS;
 void USB_DeviceInit(void);
 void USB_DeviceReset(void);
 void USB_DevUserApplication(void);
+void USB_DevClassRegister(USBD_INFO_T* usbInfo);
+#if USBD_SUP_REMOTE_WAKEUP
+USBD_STA_T USB_DevRemoteWakeup(void);
+void USB_DevWakeProc(void);
+#endif
+#if USBD_SUP_LATENCY
+void USB_DevLatStamp(USBD_LAT_STAGE_T stage);
+void USB_DevLatAck(uint32_t time, uint16_t frame);
+void USB_DevLatProc(void);
+void USB_DevIsrTime(uint32_t time);
+#endif
+#if USBD_SUP_DEFER_ISR
+void USB_DevEventProc(void);
+#endif
+uint8_t USB_DevCtrlIdle(void);
+void USB_DevFormatProc(void);
+#if USBD_SUP_CRS_STAT
+void USB_DevCrsIsr(void);
+#endif
 
 /**@} end of group USBD_HID_Functions */
 /**@} end of group USBD_HID */
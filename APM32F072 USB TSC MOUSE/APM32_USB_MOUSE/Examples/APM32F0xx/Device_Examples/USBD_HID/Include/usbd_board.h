@@ -45,17 +45,67 @@
   @{
 */
 
-#define USBD_SUP_CLASS_MAX_NUM              1
-#define USBD_SUP_INTERFACE_MAX_NUM          1
+/* Classes registered by USB_DevClassRegister beside the mouse, up to
+   CDC, MSC and WINUSB with 4 interfaces between them */
+#ifndef USBD_SUP_COMPOSITE
+#define USBD_SUP_COMPOSITE                  0
+#endif
+
+/* Vendor defined HID interface streaming TSC telemetry, left out of a
+   composite device to fit the bulk buffers of the others in the PMA */
+#define USBD_SUP_HID_TLM                    (!USBD_SUP_COMPOSITE)
+
+#define USBD_SUP_CLASS_MAX_NUM              4
+/* MSC data buffer, a block of the memory */
+#define USBD_SUP_MSC_MEDIA_PACKET           512
+#define USBD_SUP_INTERFACE_MAX_NUM          (1 + USBD_SUP_HID_TLM + 4 * USBD_SUP_COMPOSITE)
 #define USBD_SUP_CONFIGURATION_MAX_NUM      1
-#define USBD_SUP_STR_DESC_MAX_NUM           512
 
 #define USBD_HID_EP_IN_ADDR                 0x81
-#define USBD_HID_EP_IN_SIZE                 0x100
+#define USBD_HID_TLM_EP_IN_ADDR             0x82
+#define USBD_HID_TLM_EP_OUT_ADDR            0x02
+/* HID report interval in ms, can be 1, 2, 4, 8 or 10 */
+#define USBD_HID_REPORT_INTERVAL            1
+/* HID report format, USBD_HID_FORMAT_BOOT, _HIRES, _DIGITIZER or _COMPOSITE */
+#define USBD_HID_REPORT_FORMAT              USBD_HID_FORMAT_COMPOSITE
+/* D+ pull up released in ms to re-enumerate in a new report format */
+#define USBD_DETACH_TIME                    10
 
-/* Only support LPM USB device */
-#define USBD_SUP_LPM                        0
+/* LPM L1 sleep, advertised by a BOS descriptor with bcdUSB 2.01 */
+#define USBD_SUP_LPM                        1
+/* BESL recommended to the host for L1, 2 = 200 us */
+#define USBD_LPM_BESL_BASELINE              2
+/* BESL from which the clocks are stopped during L1, 8 = 3 ms to restart
+   the HSE and the PLL */
+#define USBD_LPM_BESL_DEEP                  8
+/* Stop the clocks in a suspend or a deep L1 sleep, unless the host
+   allowed a remote wakeup that needs the touch scans of the main loop.
+   The bus wakes the device through EINT line 18 */
+#define USBD_SUP_LOW_POWER                  1
 #define USBD_SUP_SELF_PWR                   1
+/* Wake the host on a touch while the bus is suspended */
+#define USBD_SUP_REMOTE_WAKEUP              1
+/* Touch to report latency histograms, read over the telemetry interface */
+#define USBD_SUP_LATENCY                    USBD_SUP_HID_TLM
+/* Service the USB events from the main loop, the interrupt only
+   acknowledges them */
+#define USBD_SUP_DEFER_ISR                  1
+/* System clock from the HSE through the PLL, 0 runs it from the HSI48
+   trimmed by the CRS on the host SOF and needs no crystal */
+#define USBD_SUP_HSE_CLOCK                  1
+/* HSI48 trim and CRS error statistics, read over the telemetry interface */
+#define USBD_SUP_CRS_STAT                   USBD_SUP_LATENCY
+/* CRS errors in a row before the trim falls back to the factory value */
+#define USBD_CRS_FALLBACK_NUM               8
+#define USBD_CRS_TRIM_DEFAULT               32
+
+#if (USBD_SUP_LATENCY && !USBD_SUP_HID_TLM)
+#error "USBD_SUP_LATENCY needs USBD_SUP_HID_TLM."
+#endif
+
+#if (USBD_SUP_CRS_STAT && !USBD_SUP_LATENCY)
+#error "USBD_SUP_CRS_STAT needs USBD_SUP_LATENCY."
+#endif
 #define USBD_DEBUG_LEVEL                    1U
 
 #if (USBD_DEBUG_LEVEL > 0U)
@@ -83,6 +133,8 @@
   @{
   */
 
+void USBD_LowPowerSleep(void);
+
 /**@} end of group USBD_HID_Functions */
 /**@} end of group USBD_HID */
 /**@} end of group Examples */
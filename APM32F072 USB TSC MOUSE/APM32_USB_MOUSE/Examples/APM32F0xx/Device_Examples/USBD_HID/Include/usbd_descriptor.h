@@ -29,6 +29,7 @@
 
 /* Includes */
 #include "usbd_core.h"
+#include "usbd_hid.h"
 
 /** @addtogroup Examples
   * @brief USBD HID examples
@@ -44,8 +45,20 @@
 */
 
 #define USBD_DEVICE_DESCRIPTOR_SIZE             18
-#define USBD_CONFIG_DESCRIPTOR_SIZE             34
-#define USBD_SERIAL_STRING_SIZE                 26
+#define USBD_CONFIG_HEADER_SIZE                 9
+#define USBD_ITF_DESC_SIZE                      9
+#define USBD_EP_DESC_SIZE                       7
+/* HID interface with its HID and endpoint descriptors */
+#define USBD_HID_ITF_SIZE(epNum)                (USBD_ITF_DESC_SIZE + USBD_HID_DESC_SIZE + (epNum) * USBD_EP_DESC_SIZE)
+#define USBD_CONFIG_DESCRIPTOR_SIZE             (USBD_CONFIG_HEADER_SIZE + USBD_HID_ITF_SIZE(1) + \
+                                                 USBD_SUP_HID_TLM * USBD_HID_ITF_SIZE(2))
+/* Descriptors of the classes registered by USB_DevClassRegister */
+#define USBD_COMPOSITE_DESC_SIZE                128
+/* Composed configuration, room for an IAD per class */
+#define USBD_CONFIG_COMPOSE_SIZE                (USBD_CONFIG_DESCRIPTOR_SIZE + 8 * USBD_SUP_CLASS_MAX_NUM + \
+                                                 USBD_SUP_COMPOSITE * USBD_COMPOSITE_DESC_SIZE)
+#define USBD_CONFIG_EP_INTERVAL_OFFSET          (USBD_CONFIG_HEADER_SIZE + USBD_HID_ITF_SIZE(0) + 6)
+#define USBD_CONFIG_HID_ITEM_LEN_OFFSET         (USBD_CONFIG_HEADER_SIZE + USBD_ITF_DESC_SIZE + 7)
 #define USBD_LANGID_STRING_SIZE                 4
 #define USBD_DEVICE_QUALIFIER_DESCRIPTOR_SIZE   10
 #define USBD_BOS_DESCRIPTOR_SIZE                12
@@ -67,6 +80,7 @@
   */
 
 extern USBD_DESC_T USBD_DESC_FS;
+extern uint8_t USBD_ConfigDesc[USBD_CONFIG_DESCRIPTOR_SIZE];
 
 /**@} end of group USBD_HID_Variables*/
 
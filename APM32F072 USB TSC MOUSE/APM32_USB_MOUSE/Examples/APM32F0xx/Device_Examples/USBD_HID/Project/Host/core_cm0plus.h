@@ -0,0 +1,147 @@
+/*!
+ * @file        core_cm0plus.h
+ *
+ * @brief       Cortex-M0+ core definitions for the host build, found
+ *              before the CMSIS header whose inline assembly only
+ *              builds for the target
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef __CORE_CM0PLUS_H_GENERIC
+#define __CORE_CM0PLUS_H_GENERIC
+#define __CORE_CM0PLUS_H_DEPENDANT
+
+/* Includes */
+#include <stdint.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define __CORTEX_M                  (0x00)
+
+#define __I                         volatile const
+#define __O                         volatile
+#define __IO                        volatile
+#define __IM                        volatile const
+#define __OM                        volatile
+#define __IOM                       volatile
+
+#define __ASM                       __asm
+#define __INLINE                    inline
+#define __STATIC_INLINE             static inline
+
+#define SCB_SCR_SEVONPEND_Pos       4U
+#define SCB_SCR_SEVONPEND_Msk       (1UL << SCB_SCR_SEVONPEND_Pos)
+#define SCB_SCR_SLEEPDEEP_Pos       2U
+#define SCB_SCR_SLEEPDEEP_Msk       (1UL << SCB_SCR_SLEEPDEEP_Pos)
+#define SCB_SCR_SLEEPONEXIT_Pos     1U
+#define SCB_SCR_SLEEPONEXIT_Msk     (1UL << SCB_SCR_SLEEPONEXIT_Pos)
+
+#define SysTick_CTRL_TICKINT_Pos    1U
+#define SysTick_CTRL_TICKINT_Msk    (1UL << SysTick_CTRL_TICKINT_Pos)
+
+/* The system control block and the SysTick are kept in host memory */
+#define SCB                         (&gHostScb)
+#define SysTick                     (&gHostSysTick)
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+*/
+
+/**
+ * @brief   System control block
+ */
+typedef struct
+{
+    __IM  uint32_t CPUID;
+    __IOM uint32_t ICSR;
+    __IOM uint32_t VTOR;
+    __IOM uint32_t AIRCR;
+    __IOM uint32_t SCR;
+    __IM  uint32_t CCR;
+          uint32_t RESERVED1;
+    __IOM uint32_t SHP[2U];
+    __IOM uint32_t SHCSR;
+} SCB_Type;
+
+/**
+ * @brief   System timer
+ */
+typedef struct
+{
+    __IOM uint32_t CTRL;
+    __IOM uint32_t LOAD;
+    __IOM uint32_t VAL;
+    __IM  uint32_t CALIB;
+} SysTick_Type;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern SCB_Type gHostScb;
+extern SysTick_Type gHostSysTick;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+void Host_WaitForInterrupt(void);
+
+/* The virtual host calls the interrupt handler between transactions,
+   the interrupt never preempts the device code */
+__STATIC_INLINE void __disable_irq(void) {}
+__STATIC_INLINE void __enable_irq(void) {}
+__STATIC_INLINE uint32_t __get_PRIMASK(void) { return 0; }
+__STATIC_INLINE void __set_PRIMASK(uint32_t priMask) { (void)priMask; }
+__STATIC_INLINE void __NOP(void) {}
+__STATIC_INLINE void __WFI(void) { Host_WaitForInterrupt(); }
+__STATIC_INLINE void __WFE(void) {}
+__STATIC_INLINE void __SEV(void) {}
+__STATIC_INLINE void __DSB(void) {}
+__STATIC_INLINE void __ISB(void) {}
+__STATIC_INLINE void __DMB(void) {}
+
+/* The touch sensing ticks come from TMR14 */
+__STATIC_INLINE uint32_t SysTick_Config(uint32_t ticks) { (void)ticks; return 0; }
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
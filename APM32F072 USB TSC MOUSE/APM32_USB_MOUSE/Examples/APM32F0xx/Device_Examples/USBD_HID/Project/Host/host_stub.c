@@ -0,0 +1,136 @@
+/*!
+ * @file        host_stub.c
+ *
+ * @brief       Board and touch sensing functions of the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "host_stub.h"
+#include "usbd_vhost.h"
+#include "bsp_delay.h"
+#include "apm32f0xx_misc.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+SCB_Type gHostScb;
+
+SysTick_Type gHostSysTick;
+
+/* Clock of system_apm32f0xx.c, 48 MHz from the PLL */
+uint32_t SystemCoreClock = 48000000;
+
+HOST_TLM_T gHostTlm;
+
+HOST_CORE_T gHostCore;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Init the delay timer
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void APM_DelayInit(void)
+{
+}
+
+/*!
+ * @brief       Delay, the bus time does not advance. The time the device
+ *              spends detached from the bus is counted.
+ *
+ * @param       nms: delay in ms
+ *
+ * @retval      None
+ */
+void APM_DelayMs(__IO uint32_t nms)
+{
+    if (USBD_Model_ReadPullUp() == 0)
+    {
+        gHostCore.detachMs += nms;
+    }
+}
+
+/*!
+ * @brief       Enable an interrupt, the virtual host calls the USB
+ *              interrupt handler itself
+ *
+ * @param       irq: interrupt
+ *
+ * @param       priority: priority
+ *
+ * @retval      None
+ */
+void NVIC_EnableIRQRequest(IRQn_Type irq, uint8_t priority)
+{
+    (void)irq;
+    (void)priority;
+}
+
+/*!
+ * @brief       Disable an interrupt
+ *
+ * @param       irq: interrupt
+ *
+ * @retval      None
+ */
+void NVIC_DisableIRQRequest(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+/*!
+ * @brief       Wait for interrupt, the sleep is counted and ends at once
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Host_WaitForInterrupt(void)
+{
+    gHostCore.wfiCnt++;
+
+    if (SCB->SCR & SCB_SCR_SLEEPDEEP_Msk)
+    {
+        gHostCore.stopCnt++;
+    }
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
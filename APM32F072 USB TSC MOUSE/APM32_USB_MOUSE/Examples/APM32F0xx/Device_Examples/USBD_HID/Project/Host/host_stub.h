@@ -0,0 +1,82 @@
+/*!
+ * @file        host_stub.h
+ *
+ * @brief       Board and touch sensing functions of the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _HOST_STUB_H_
+#define _HOST_STUB_H_
+
+/* Includes */
+#include "tsc_user.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Telemetry seen by the touch sensing functions
+ */
+typedef struct
+{
+    uint8_t             cmd[64];
+    uint8_t             cmdLen;
+    uint32_t            cmdCnt;
+    uint8_t             param[64];
+    uint32_t            paramWriteCnt;
+} HOST_TLM_T;
+
+/**
+ * @brief   Sleeps and delays of the core
+ */
+typedef struct
+{
+    uint32_t            wfiCnt;
+    uint32_t            stopCnt;        /*!< __WFI with SLEEPDEEP set */
+    uint32_t            detachMs;       /*!< Delay with the D+ pull up off */
+} HOST_CORE_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern HOST_TLM_T gHostTlm;
+extern HOST_CORE_T gHostCore;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
@@ -0,0 +1,181 @@
+/*!
+ * @file        tsc_arb_test.c
+ *
+ * @brief       Arbitration of the touch keys reported by the mouse
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_ARB_DELTA              (TOUCH_KEY_DETECT_IN_TH + 100)
+/* Time to debounce a touch or a release and send the queued reports */
+#define TEST_ARB_SETTLE_MS          50
+#define TEST_ARB_MOVE_MS            100
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Run the touch sensing and poll the mouse endpoint, the
+ *              moves of the mouse reports add up
+ *
+ * @param       ms: time in ms
+ *
+ * @param       x: returns the X move
+ *
+ * @param       y: returns the Y move
+ *
+ * @retval      None
+ */
+static void Test_ArbMove(uint32_t ms, int32_t* x, int32_t* y)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t interval = gTestDev.epInInterval[epNum] ? gTestDev.epInInterval[epNum] : 1;
+    uint8_t data[64];
+    uint16_t length;
+    uint8_t pid;
+
+    *x = 0;
+    *y = 0;
+
+    while (ms--)
+    {
+        Test_TscRun(1);
+
+        if ((gUsbVHostStat.frame % interval) != 0)
+        {
+            continue;
+        }
+
+        if (USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, &length) != USBD_MODEL_HS_ACK)
+        {
+            continue;
+        }
+
+        gTestDev.epInPid[epNum] ^= 1;
+
+        /* Report ID, buttons, X and Y on 16 bits */
+        if ((length >= 6) && (data[0] == USBD_HID_REPORT_ID_MOUSE))
+        {
+            *x += (int16_t)(data[2] | (data[3] << 8));
+            *y += (int16_t)(data[4] | (data[5] << 8));
+        }
+    }
+}
+
+/*!
+ * @brief       Touch the keys of a bitmap, release the others
+ *
+ * @param       keys: bit n is K(n+1)
+ *
+ * @retval      None
+ */
+static void Test_ArbTouch(uint8_t keys)
+{
+    uint8_t i;
+
+    for (i = 0; i < TOUCH_TOTAL_KEYS; i++)
+    {
+        TSC_Model_WriteDelta(i, (keys & (1 << i)) ? TEST_ARB_DELTA : 0);
+    }
+}
+
+/*!
+ * @brief       K1 up and K2 right touched together move the cursor
+ *              diagonally, a third key is a palm and stops it. The first
+ *              key touched wins in the first wins mode.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscArb(void)
+{
+    int32_t x;
+    int32_t y;
+
+    Test_Enumerate();
+    Test_TscRun(200);
+
+    TEST_CHECK(USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_COMPOSITE, "report format %u", \
+               USBD_HID_ReadReportFormat(&gUsbDeviceFS));
+    TEST_CHECK(MyArb.Mode == TSC_DXS_ARB_CHORD, "arbitration mode %u", MyArb.Mode);
+
+    /* Chord of two keys */
+    Test_ArbTouch(TSC_TOUCH_K1 | TSC_TOUCH_K2);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    TEST_CHECK(MyArb.Winners == (TSC_TOUCH_K1 | TSC_TOUCH_K2), "chord winners 0x%02X", (unsigned)MyArb.Winners);
+
+    Test_ArbMove(TEST_ARB_MOVE_MS, &x, &y);
+    TEST_CHECK((x > 0) && (y < 0) && (x == -y), "chord moved %d %d", (int)x, (int)y);
+
+    /* A palm on three keys */
+    Test_ArbTouch(TSC_TOUCH_K1 | TSC_TOUCH_K2 | TSC_TOUCH_K3);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    TEST_CHECK((MyArb.Detected == 0x07) && (MyArb.Winners == 0), "palm detected 0x%02X winners 0x%02X", \
+               (unsigned)MyArb.Detected, (unsigned)MyArb.Winners);
+
+    Test_ArbMove(TEST_ARB_MOVE_MS, &x, &y);
+    TEST_CHECK((x == 0) && (y == 0), "palm moved %d %d", (int)x, (int)y);
+
+    Test_ArbTouch(0);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    TEST_CHECK(MyArb.Detected == 0, "detected 0x%02X after the release", (unsigned)MyArb.Detected);
+
+    /* K2 first, then K1 is not reported */
+    MyArb.Mode = TSC_DXS_ARB_FIRST;
+    Test_ArbTouch(TSC_TOUCH_K2);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    Test_ArbTouch(TSC_TOUCH_K1 | TSC_TOUCH_K2);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    TEST_CHECK(MyArb.Winners == TSC_TOUCH_K2, "first wins winners 0x%02X", (unsigned)MyArb.Winners);
+
+    Test_ArbMove(TEST_ARB_MOVE_MS, &x, &y);
+    TEST_CHECK((x > 0) && (y == 0), "first wins moved %d %d", (int)x, (int)y);
+
+    Test_ArbTouch(0);
+    Test_ArbMove(TEST_ARB_SETTLE_MS, &x, &y);
+    MyArb.Mode = TSC_DXS_ARB_CHORD;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
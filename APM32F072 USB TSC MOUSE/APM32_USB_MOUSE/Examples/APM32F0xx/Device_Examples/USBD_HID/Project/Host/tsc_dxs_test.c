@@ -0,0 +1,281 @@
+/*!
+ * @file        tsc_dxs_test.c
+ *
+ * @brief       Arbitration of an object group, each mode and the cost of
+ *              a frame
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "tsc_lib_test.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Keys of the group, a rotary sensor follows them */
+#define TEST_DXS_KEY_NUM            4
+#define TEST_DXS_ROT_CH_NUM         3
+#define TEST_DXS_ROT                (1 << TEST_DXS_KEY_NUM)
+/* Objects of the cost group, one per bit of the result */
+#define TEST_DXS_COST_NUM           32
+#define TEST_DXS_CYCLE_NUM          100000
+#define TEST_DXS_DELTA              150
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+static TSC_Channel_Data_T testChannel[TEST_DXS_COST_NUM];
+static TSC_TouchKeyData_T testKeyData[TEST_DXS_COST_NUM];
+static TSC_TouchKey_T testKey[TEST_DXS_COST_NUM];
+static TSC_LinRotData_T testRotData;
+static TSC_LinRot_T testRot;
+static TSC_Object_T testObj[TEST_DXS_COST_NUM];
+static TSC_ObjectGroup_T testGroup;
+static TSC_DxsArb_T testArb;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Set up a group of keys, the rotary sensor after them
+ *
+ * @param       keyNum: number of keys
+ *
+ * @param       rot: 1 to add the rotary sensor
+ *
+ * @retval      None
+ */
+static void Test_DxsConfig(uint8_t keyNum, uint8_t rot)
+{
+    uint8_t i;
+
+    memset(testChannel, 0, sizeof(testChannel));
+    memset(testKeyData, 0, sizeof(testKeyData));
+    memset(&testRotData, 0, sizeof(testRotData));
+    memset(&testGroup, 0, sizeof(testGroup));
+
+    for (i = 0; i < keyNum; i++)
+    {
+        testKeyData[i].StateId = TSC_STATEID_RELEASE;
+        testKey[i].p_Data = &testKeyData[i];
+        testKey[i].p_ChD = &testChannel[i];
+        testObj[i].Type = TSC_OBJ_TOUCHKEY;
+        testObj[i].MyObj = &testKey[i];
+    }
+
+    if (rot)
+    {
+        testRotData.StateId = TSC_STATEID_RELEASE;
+        testRot.p_Data = &testRotData;
+        testRot.p_ChD = &testChannel[keyNum];
+        testRot.NumChannel = TEST_DXS_ROT_CH_NUM;
+        testObj[keyNum].Type = TSC_OBJ_ROTARY;
+        testObj[keyNum].MyObj = &testRot;
+    }
+
+    testGroup.p_Obj = testObj;
+    testGroup.NbObjects = keyNum + (rot ? 1 : 0);
+
+    TSC_Dxs_ConfigArbitration(&testArb);
+}
+
+/*!
+ * @brief       One frame, the objects of a bitmap are in detect state
+ *              with the same delta
+ *
+ * @param       detect: objects in detect state, bit n is object n
+ *
+ * @retval      Status of the arbitration
+ */
+static TSC_STATUS_T Test_DxsFrame(uint32_t detect)
+{
+    uint8_t i;
+
+    testGroup.StateMask = detect ? TSC_STATE_DETECT_BIT_MASK : TSC_STATE_RELEASE_BIT_MASK;
+
+    for (i = 0; i < testGroup.NbObjects; i++)
+    {
+        if (testObj[i].Type == TSC_OBJ_TOUCHKEY)
+        {
+            testKeyData[i].StateId = (detect & (1UL << i)) ? TSC_STATEID_DETECT : TSC_STATEID_RELEASE;
+            testChannel[i].Delta = (detect & (1UL << i)) ? TEST_DXS_DELTA : 0;
+        }
+        else
+        {
+            testRotData.StateId = (detect & (1UL << i)) ? TSC_STATEID_DETECT : TSC_STATEID_RELEASE;
+        }
+    }
+
+    return TSC_Dxs_Arbitrate(&testGroup, &testArb);
+}
+
+/*!
+ * @brief       Frames of a mode and the objects reported after each one
+ *
+ * @param       mode: arbitration mode
+ *
+ * @param       detect: objects in detect state of each frame
+ *
+ * @param       winners: objects reported after each frame
+ *
+ * @param       num: number of frames
+ *
+ * @retval      None
+ */
+static void Test_DxsMode(TSC_DXS_ARB_MODE_T mode, const uint32_t* detect, const uint32_t* winners, uint8_t num)
+{
+    TSC_STATUS_T status;
+    uint32_t last = 0;
+    uint8_t i;
+
+    Test_DxsConfig(TEST_DXS_KEY_NUM, 1);
+    testArb.Mode = mode;
+
+    for (i = 0; i < num; i++)
+    {
+        status = Test_DxsFrame(detect[i]);
+
+        TEST_CHECK(testArb.Detected == detect[i], "mode %u frame %u detected 0x%02X", mode, i, \
+                   (unsigned)testArb.Detected);
+        TEST_CHECK(testArb.Winners == winners[i], "mode %u frame %u winners 0x%02X, expected 0x%02X", \
+                   mode, i, (unsigned)testArb.Winners, (unsigned)winners[i]);
+        TEST_CHECK((status == TSC_STATUS_OK) == (winners[i] != last), "mode %u frame %u status %u", \
+                   mode, i, status);
+        last = winners[i];
+    }
+}
+
+/*!
+ * @brief       Host time of an arbitration, every object in detect state
+ *
+ * @param       num: number of objects
+ *
+ * @retval      Time in ns
+ */
+static double Test_DxsCost(uint8_t num)
+{
+    double start;
+    uint32_t i;
+
+    Test_DxsConfig(num, 0);
+    testArb.Mode = TSC_DXS_ARB_STRONGEST;
+    Test_DxsFrame((uint32_t)((1ULL << num) - 1));
+
+    start = Test_ReadTimeNs();
+
+    for (i = 0; i < TEST_DXS_CYCLE_NUM; i++)
+    {
+        TSC_Dxs_Arbitrate(&testGroup, &testArb);
+    }
+
+    return (Test_ReadTimeNs() - start) / TEST_DXS_CYCLE_NUM;
+}
+
+/*!
+ * @brief       Each arbitration mode on four keys and a rotary sensor,
+ *              then the cost of a frame against the group size
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_Dxs(void)
+{
+    /* Alone only */
+    static const uint32_t exclusiveDetect[]  = {0x01, 0x03, 0x02, 0x00, TEST_DXS_ROT};
+    static const uint32_t exclusiveWinners[] = {0x01, 0x00, 0x02, 0x00, TEST_DXS_ROT};
+    /* K3 is kept while K1 comes and goes, K1 takes over when K3 is
+       released */
+    static const uint32_t firstDetect[]      = {0x04, 0x05, 0x04, 0x05, 0x01, 0x05, 0x00, 0x06};
+    static const uint32_t firstWinners[]     = {0x04, 0x04, 0x04, 0x04, 0x01, 0x01, 0x00, 0x02};
+    /* Two objects, up to three with the palm rejection */
+    static const uint32_t chordDetect[]      = {0x01, 0x03, 0x07, 0x03, 0x00, 0x11};
+    static const uint32_t chordWinners[]     = {0x01, 0x03, 0x00, 0x03, 0x00, 0x11};
+    double cost[2];
+    uint8_t i;
+
+    Test_DxsMode(TSC_DXS_ARB_EXCLUSIVE, exclusiveDetect, exclusiveWinners, sizeof(exclusiveDetect) / 4);
+    Test_DxsMode(TSC_DXS_ARB_FIRST, firstDetect, firstWinners, sizeof(firstDetect) / 4);
+    Test_DxsMode(TSC_DXS_ARB_CHORD, chordDetect, chordWinners, sizeof(chordDetect) / 4);
+
+    /* The biggest delta, that of the strongest channel of the rotary
+       sensor, a touch state counts as detected */
+    Test_DxsConfig(TEST_DXS_KEY_NUM, 1);
+    testArb.Mode = TSC_DXS_ARB_STRONGEST;
+
+    Test_DxsFrame(0x07 | TEST_DXS_ROT);
+    testChannel[1].Delta = TEST_DXS_DELTA + 30;
+    testChannel[TEST_DXS_KEY_NUM + 2].Delta = TEST_DXS_DELTA + 20;
+    TSC_Dxs_Arbitrate(&testGroup, &testArb);
+    TEST_CHECK(testArb.Winners == 0x02, "strongest 0x%02X, expected K2", (unsigned)testArb.Winners);
+
+    testChannel[TEST_DXS_KEY_NUM + 2].Delta = TEST_DXS_DELTA + 40;
+    TSC_Dxs_Arbitrate(&testGroup, &testArb);
+    TEST_CHECK(testArb.Winners == TEST_DXS_ROT, "strongest 0x%02X, expected the rotary", (unsigned)testArb.Winners);
+
+    Test_DxsFrame(0);
+    testGroup.StateMask = TSC_STATE_TOUCH_BIT_MASK;
+    testKeyData[3].StateId = TSC_STATEID_TOUCH;
+    TSC_Dxs_Arbitrate(&testGroup, &testArb);
+    TEST_CHECK(testArb.Winners == 0x08, "touch state 0x%02X, expected K4", (unsigned)testArb.Winners);
+
+    /* The chord limit changes at run time */
+    Test_DxsConfig(TEST_DXS_KEY_NUM, 1);
+    testArb.ChordMax = 3;
+    Test_DxsFrame(0x07);
+    TEST_CHECK(testArb.Winners == 0x07, "chord of 3 0x%02X", (unsigned)testArb.Winners);
+
+    /* Each object is visited once, the cost per object does not grow
+       with the group */
+    cost[0] = Test_DxsCost(TEST_DXS_COST_NUM / 4);
+    cost[1] = Test_DxsCost(TEST_DXS_COST_NUM);
+    printf("Host time per frame: %u objects %.0f ns, %u objects %.0f ns\r\n", TEST_DXS_COST_NUM / 4, cost[0], \
+           TEST_DXS_COST_NUM, cost[1]);
+    TEST_CHECK(cost[1] / TEST_DXS_COST_NUM < 2 * cost[0] / (TEST_DXS_COST_NUM / 4), \
+               "%.1f ns per object of %u, %.1f ns of %u", cost[1] / TEST_DXS_COST_NUM, TEST_DXS_COST_NUM, \
+               cost[0] / (TEST_DXS_COST_NUM / 4), TEST_DXS_COST_NUM / 4);
+
+    for (i = 0; i < TEST_DXS_COST_NUM; i++)
+    {
+        TEST_CHECK(testArb.Detected & (1UL << i), "object %u of %u not detected", i, TEST_DXS_COST_NUM);
+    }
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,338 @@
+/*!
+ * @file        tsc_key_test.c
+ *
+ * @brief       Debounce of the GPIO keys on bouncing contacts
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include "board_apm32f072_eval.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Contact bounce of a press or a release, up to 3 edges per ms */
+#define TEST_KEY_BOUNCE_MS          8
+#define TEST_KEY_EDGE_MAX           3
+#define TEST_KEY_HOLD_MS            100
+#define TEST_KEY_CLICK_NUM          100
+/* KEY3 and KEY4 are the left and right buttons */
+#define TEST_KEY_LEFT               BUTTON_KEY3
+#define TEST_KEY_RIGHT              BUTTON_KEY4
+#define TEST_KEY_BTN_LEFT           0x01
+#define TEST_KEY_BTN_RIGHT          0x02
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Button edges of the mouse reports
+ */
+typedef struct
+{
+    uint32_t            ms;             /*!< Time of the trace */
+    uint32_t            reportMs;       /*!< Time of the last button change */
+    uint32_t            changeCnt;      /*!< Reports with other buttons */
+    uint32_t            pressCnt[2];    /*!< Left and right presses */
+    uint32_t            releaseCnt[2];  /*!< Left and right releases */
+    uint8_t             buttons;        /*!< Buttons of the last report */
+} TEST_KEY_STAT_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+static uint32_t testSeed = 1;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Pseudo random number
+ *
+ * @param       range: number of values
+ *
+ * @retval      0 .. range - 1
+ */
+static uint32_t Test_KeyRand(uint32_t range)
+{
+    testSeed = testSeed * 1103515245 + 12345;
+
+    return (testSeed >> 16) % range;
+}
+
+/*!
+ * @brief       Run the keys and poll the mouse endpoint, the button
+ *              edges of the mouse reports are counted
+ *
+ * @param       ms: time in ms
+ *
+ * @param       stat: button edges
+ *
+ * @retval      None
+ */
+static void Test_KeyRun(uint32_t ms, TEST_KEY_STAT_T* stat)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t interval = gTestDev.epInInterval[epNum] ? gTestDev.epInInterval[epNum] : 1;
+    uint8_t data[64];
+    uint16_t length;
+    uint8_t pid;
+    uint8_t change;
+    uint8_t i;
+
+    while (ms--)
+    {
+        Test_TscRun(1);
+        stat->ms++;
+
+        if ((gUsbVHostStat.frame % interval) != 0)
+        {
+            continue;
+        }
+
+        if (USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, &length) != USBD_MODEL_HS_ACK)
+        {
+            continue;
+        }
+
+        gTestDev.epInPid[epNum] ^= 1;
+
+        /* Report ID, buttons */
+        if ((length < 2) || (data[0] != USBD_HID_REPORT_ID_MOUSE) || (data[1] == stat->buttons))
+        {
+            continue;
+        }
+
+        change = data[1] ^ stat->buttons;
+        for (i = 0; i < 2; i++)
+        {
+            if (change & (1 << i))
+            {
+                if (data[1] & (1 << i))
+                {
+                    stat->pressCnt[i]++;
+                }
+                else
+                {
+                    stat->releaseCnt[i]++;
+                }
+            }
+        }
+
+        stat->buttons = data[1];
+        stat->reportMs = stat->ms;
+        stat->changeCnt++;
+    }
+}
+
+/*!
+ * @brief       Bounce the contacts of keys to a level. The last edges of
+ *              the keys come in the same ms.
+ *
+ * @param       keys: BUTTON_KEYx bitmap
+ *
+ * @param       level: pin level at the end, a pressed key is low
+ *
+ * @param       stat: button edges
+ *
+ * @retval      None
+ */
+static void Test_KeyBounce(uint8_t keys, uint8_t level, TEST_KEY_STAT_T* stat)
+{
+    uint32_t ms;
+    uint32_t edge;
+    uint8_t i;
+
+    for (ms = 0; ms < TEST_KEY_BOUNCE_MS - 1; ms++)
+    {
+        for (i = 0; i < BUTTONn; i++)
+        {
+            if ((keys & (1 << i)) == 0)
+            {
+                continue;
+            }
+
+            for (edge = Test_KeyRand(TEST_KEY_EDGE_MAX + 1); edge > 0; edge--)
+            {
+                TSC_Model_WriteKey(i, (gTscModel.keyLevel & (1 << i)) == 0);
+            }
+        }
+
+        Test_KeyRun(1, stat);
+    }
+
+    for (i = 0; i < BUTTONn; i++)
+    {
+        if (keys & (1 << i))
+        {
+            /* A bounced key may already be at the level, make the edge */
+            TSC_Model_WriteKey(i, !level);
+            TSC_Model_WriteKey(i, level);
+        }
+    }
+}
+
+/*!
+ * @brief       Clicks of the left key on bouncing contacts, each press and
+ *              release is reported once a debounce time after the last
+ *              edge
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_KeyClick(void)
+{
+    TEST_KEY_STAT_T stat = {0};
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t interval = gTestDev.epInInterval[epNum] ? gTestDev.epInInterval[epNum] : 1;
+    uint32_t settleMs;
+    uint32_t latency;
+    uint32_t latencyMax = 0;
+    uint32_t latencyMin = 0xFFFFFFFF;
+    uint32_t i;
+    uint8_t level;
+
+    for (i = 0; i < TEST_KEY_CLICK_NUM * 2; i++)
+    {
+        level = (i & 1) ? 1 : 0;
+
+        Test_KeyBounce(1 << TEST_KEY_LEFT, level, &stat);
+        settleMs = stat.ms;
+        Test_KeyRun(TEST_KEY_HOLD_MS, &stat);
+
+        latency = stat.reportMs - settleMs;
+        latencyMax = (latency > latencyMax) ? latency : latencyMax;
+        latencyMin = (latency < latencyMin) ? latency : latencyMin;
+
+        TEST_CHECK(stat.reportMs > settleMs, "click %u reported during the bounce", (unsigned)i);
+        TEST_CHECK((stat.buttons & TEST_KEY_BTN_LEFT) == (level ? 0 : TEST_KEY_BTN_LEFT), "click %u buttons 0x%02X", \
+                   (unsigned)i, stat.buttons);
+    }
+
+    printf("Bounced clicks: %u presses, %u releases of %u, latency after the last edge %u .. %u ms\r\n", \
+           (unsigned)stat.pressCnt[0], (unsigned)stat.releaseCnt[0], TEST_KEY_CLICK_NUM, (unsigned)latencyMin, \
+           (unsigned)latencyMax);
+
+    TEST_CHECK(stat.pressCnt[0] == TEST_KEY_CLICK_NUM, "%u presses", (unsigned)stat.pressCnt[0]);
+    TEST_CHECK(stat.releaseCnt[0] == TEST_KEY_CLICK_NUM, "%u releases", (unsigned)stat.releaseCnt[0]);
+    TEST_CHECK(stat.pressCnt[1] + stat.releaseCnt[1] == 0, "right button reported");
+    TEST_CHECK(latencyMin >= HID_MOUSE_KEY_DEBOUNCE, "reported %u ms after the last edge", (unsigned)latencyMin);
+    TEST_CHECK(latencyMax <= HID_MOUSE_KEY_DEBOUNCE + interval + 1, "reported %u ms after the last edge", \
+               (unsigned)latencyMax);
+}
+
+/*!
+ * @brief       Glitches shorter than the debounce time are not reported
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_KeyGlitch(void)
+{
+    TEST_KEY_STAT_T stat = {0};
+    uint32_t width;
+
+    for (width = 1; width < HID_MOUSE_KEY_DEBOUNCE; width++)
+    {
+        TSC_Model_WriteKey(TEST_KEY_LEFT, 0);
+        Test_KeyRun(width, &stat);
+        TSC_Model_WriteKey(TEST_KEY_LEFT, 1);
+        Test_KeyRun(TEST_KEY_HOLD_MS, &stat);
+    }
+
+    TEST_CHECK(stat.changeCnt == 0, "%u reports of glitches", (unsigned)stat.changeCnt);
+}
+
+/*!
+ * @brief       Left and right pressed together on bouncing contacts are
+ *              reported in one report and released one by one
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_KeyChord(void)
+{
+    TEST_KEY_STAT_T stat = {0};
+
+    Test_KeyBounce((1 << TEST_KEY_LEFT) | (1 << TEST_KEY_RIGHT), 0, &stat);
+    Test_KeyRun(TEST_KEY_HOLD_MS, &stat);
+
+    TEST_CHECK(stat.changeCnt == 1, "%u reports of a chord", (unsigned)stat.changeCnt);
+    TEST_CHECK(stat.buttons == (TEST_KEY_BTN_LEFT | TEST_KEY_BTN_RIGHT), "chord buttons 0x%02X", stat.buttons);
+
+    Test_KeyBounce(1 << TEST_KEY_LEFT, 1, &stat);
+    Test_KeyRun(TEST_KEY_HOLD_MS, &stat);
+    TEST_CHECK(stat.buttons == TEST_KEY_BTN_RIGHT, "buttons 0x%02X after the left release", stat.buttons);
+
+    Test_KeyBounce(1 << TEST_KEY_RIGHT, 1, &stat);
+    Test_KeyRun(TEST_KEY_HOLD_MS, &stat);
+    TEST_CHECK(stat.buttons == 0, "buttons 0x%02X after the right release", stat.buttons);
+
+    TEST_CHECK(stat.changeCnt == 3, "%u reports of a chord and two releases", (unsigned)stat.changeCnt);
+}
+
+/*!
+ * @brief       GPIO keys on simulated contact bounce: clicks, glitches and
+ *              a two button chord
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscKey(void)
+{
+    Test_Enumerate();
+    Test_TscRun(200);
+
+    Test_KeyClick();
+    Test_KeyGlitch();
+    Test_KeyChord();
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,132 @@
+/*!
+ * @file        tsc_lib_test.c
+ *
+ * @brief       Tests of the touch sensing library alone, without the
+ *              instrumentation of the peripheral model
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "tsc_lib_test.h"
+#include <string.h>
+#include <time.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+/* The library is linked without tsc_user.c, no object uses the
+   parameters and the SysTick is never started */
+TSC_Params_T TSC_Params;
+SCB_Type gHostScb;
+SysTick_Type gHostSysTick;
+uint32_t SystemCoreClock = 48000000;
+
+uint32_t gTestFailCnt;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+static const TEST_CASE_T testCase[] =
+{
+    {"linrot",          Test_Linrot},
+    {"dxs",             Test_Dxs},
+};
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Read the host time
+ *
+ * @param       None
+ *
+ * @retval      Monotonic time in ns
+ */
+double Test_ReadTimeNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/*!
+ * @brief       Main program
+ *
+ * @param       argc: 2
+ *
+ * @param       argv: test name
+ *
+ * @retval      0 when every check passed, else 1
+ */
+int main(int argc, char* argv[])
+{
+    uint8_t i;
+
+    for (i = 0; (argc > 1) && (i < sizeof(testCase) / sizeof(testCase[0])); i++)
+    {
+        if (strcmp(argv[1], testCase[i].name) == 0)
+        {
+            break;
+        }
+    }
+
+    if ((argc < 2) || (i == sizeof(testCase) / sizeof(testCase[0])))
+    {
+        printf("Usage: %s test, tests:", argv[0]);
+
+        for (i = 0; i < sizeof(testCase) / sizeof(testCase[0]); i++)
+        {
+            printf(" %s", testCase[i].name);
+        }
+
+        printf("\r\n");
+        return 1;
+    }
+
+    testCase[i].run();
+
+    printf("%s %s, %u failed checks\r\n", testCase[i].name, gTestFailCnt ? "FAILED" : "PASSED", \
+           (unsigned)gTestFailCnt);
+
+    return gTestFailCnt ? 1 : 0;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,96 @@
+/*!
+ * @file        tsc_lib_test.h
+ *
+ * @brief       Tests of the touch sensing library alone, without the
+ *              instrumentation of the peripheral model
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _TSC_LIB_TEST_H_
+#define _TSC_LIB_TEST_H_
+
+/* Includes */
+#include "tsc.h"
+#include <stdio.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_CHECK(cond, ...)       do { \
+                                    if (!(cond)) \
+                                    { \
+                                        printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                                        printf(__VA_ARGS__); \
+                                        printf("\r\n"); \
+                                        gTestFailCnt++; \
+                                    } \
+} while(0)
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Test case
+ */
+typedef struct
+{
+    const char*         name;
+    void                (*run)(void);
+} TEST_CASE_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern uint32_t gTestFailCnt;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+double Test_ReadTimeNs(void);
+
+void Test_Linrot(void);
+void Test_Dxs(void);
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
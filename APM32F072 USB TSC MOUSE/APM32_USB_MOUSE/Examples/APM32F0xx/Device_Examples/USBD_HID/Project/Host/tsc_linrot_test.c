@@ -0,0 +1,440 @@
+/*!
+ * @file        tsc_linrot_test.c
+ *
+ * @brief       Accuracy, jitter and cost of the high resolution LinRot
+ *              position against the offset table one
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "tsc_lib_test.h"
+#include <math.h>
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_LINROT_CH_MAX          5
+/* Finger delta at the center of an electrode */
+#define TEST_LINROT_AMPLITUDE       200
+/* Finger width in electrode pitches, it covers up to three electrodes */
+#define TEST_LINROT_WIDTH           1.5
+#define TEST_LINROT_STEP_NUM        1024
+#define TEST_LINROT_NOISE           4
+#define TEST_LINROT_NOISE_NUM       256
+#define TEST_LINROT_CYCLE_NUM       200000
+#define TEST_LINROT_HIRES_SCALE     (1UL << TOUCH_LINROT_HIRES_RESOLUTION)
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Position error in LSB of a 8-bit position
+ */
+typedef struct
+{
+    double              meanAbs;
+    double              maxAbs;
+} TEST_LINROT_ERR_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+static TSC_Channel_Data_T testChannel[TEST_LINROT_CH_MAX];
+static TSC_LinRotData_T testLegacyData;
+static TSC_LinRotData_T testHiResData;
+static TSC_LinRotParam_T testParam;
+static const uint16_t testDeltaCoeff[TEST_LINROT_CH_MAX] = {0x0100, 0x0100, 0x0100, 0x0100, 0x0100};
+static TSC_LinRot_T testLinRot;
+static TSC_Object_T testObj;
+static uint32_t testSeed = 1;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Set up a sensor, both methods start untouched
+ *
+ * @param       type: TSC_OBJ_LINEAR or TSC_OBJ_ROTARY
+ *
+ * @param       num: number of channels
+ *
+ * @param       posOff: position offset table of the offset table method
+ *
+ * @param       sctComp: sector computation
+ *
+ * @param       posCorr: position correction
+ *
+ * @retval      None
+ */
+static void Test_LinrotConfig(TSC_OBJECT_T type, TSC_tNum_T num, CONST TSC_tPosition_T* posOff, \
+                              TSC_tNum_T sctComp, TSC_tNum_T posCorr)
+{
+    memset(testChannel, 0, sizeof(testChannel));
+    memset(&testLegacyData, 0, sizeof(testLegacyData));
+    memset(&testHiResData, 0, sizeof(testHiResData));
+
+    testParam.DetectInTh = TOUCH_LINROT_DETECT_IN_TH;
+    testParam.DetectOutTh = TOUCH_LINROT_DETECT_OUT_TH;
+    testParam.CalibTh = TOUCH_LINROT_CALIB_TH;
+    testParam.Resolution = TOUCH_LINROT_RESOLUTION;
+    testParam.DirChangePos = TOUCH_LINROT_DIR_CHG_POS;
+    testParam.CounterDebDirection = TOUCH_LINROT_DIR_CHG_DEB;
+    testLegacyData.CounterDirection = TOUCH_LINROT_DIR_CHG_DEB;
+
+    testLinRot.p_Param = &testParam;
+    testLinRot.p_ChD = testChannel;
+    testLinRot.NumChannel = num;
+    testLinRot.p_DeltaCoeff = testDeltaCoeff;
+    testLinRot.p_PosOff = posOff;
+    testLinRot.SctComp = sctComp;
+    testLinRot.PosCorr = posCorr;
+
+    testObj.Type = type;
+    testObj.MyObj = &testLinRot;
+
+    TSC_Globals.For_Obj = &testObj;
+    TSC_Globals.For_LinRot = &testLinRot;
+}
+
+/*!
+ * @brief       Write the deltas of a finger, a raised cosine over the
+ *              electrodes
+ *
+ * @param       x: finger position in electrode pitches from electrode 0
+ *
+ * @param       noise: largest noise added to each delta
+ *
+ * @retval      None
+ */
+static void Test_LinrotTouch(double x, int16_t noise)
+{
+    double d;
+    int32_t delta;
+    uint8_t i;
+
+    for (i = 0; i < testLinRot.NumChannel; i++)
+    {
+        d = fabs(x - i);
+
+        /* The finger of a rotary sensor is at the nearest turn */
+        if ((testObj.Type == TSC_OBJ_ROTARY) && (d > testLinRot.NumChannel / 2.0))
+        {
+            d = testLinRot.NumChannel - d;
+        }
+
+        delta = 0;
+        if (d < TEST_LINROT_WIDTH)
+        {
+            delta = (int32_t)lround(TEST_LINROT_AMPLITUDE * pow(cos(M_PI * d / (2 * TEST_LINROT_WIDTH)), 2));
+        }
+
+        if (noise != 0)
+        {
+            testSeed = testSeed * 1103515245 + 12345;
+            delta += (int32_t)((testSeed >> 16) % (2 * noise + 1)) - noise;
+        }
+
+        testChannel[i].Delta = (TSC_tDelta_T)delta;
+    }
+}
+
+/*!
+ * @brief       Position of the offset table method
+ *
+ * @param       None
+ *
+ * @retval      Position in turns of a rotary sensor or in sensor lengths,
+ *              the last position when this sample is dropped
+ */
+static double Test_LinrotLegacy(void)
+{
+    testLinRot.p_Data = &testLegacyData;
+    TSC_Linrot_CalcPos();
+
+    return (uint8_t)testLegacyData.RawPosition / 256.0;
+}
+
+/*!
+ * @brief       Position of the weighted centroid method
+ *
+ * @param       restart: 1 to restart the jitter filter as on a new touch
+ *
+ * @retval      Position in turns of a rotary sensor or in sensor lengths
+ */
+static double Test_LinrotHiRes(uint8_t restart)
+{
+    testLinRot.p_Data = &testHiResData;
+    testHiResData.Change = restart ? TSC_STATE_CHANGED : TSC_STATE_NOT_CHANGED;
+    TSC_Linrot_CalcPosHiRes();
+
+    return testHiResData.HiResPosition / (double)TEST_LINROT_HIRES_SCALE;
+}
+
+/*!
+ * @brief       Error of a position, a rotary one wrapped to half a turn
+ *
+ * @param       error: position error in turns or in sensor lengths
+ *
+ * @retval      Wrapped error
+ */
+static double Test_LinrotWrap(double error)
+{
+    if (testObj.Type != TSC_OBJ_ROTARY)
+    {
+        return error;
+    }
+
+    return error - floor(error + 0.5);
+}
+
+/*!
+ * @brief       Sweep a finger once around a rotary sensor or from the
+ *              center of the first electrode to the center of the last
+ *              one of a linear sensor. The offset of the electrode 0
+ *              differs between the two methods, the mean error is removed.
+ *
+ * @param       legacy: returns the error of the offset table method
+ *
+ * @param       hiRes: returns the error of the weighted centroid method
+ *
+ * @retval      Steps the weighted centroid position went back
+ */
+static uint16_t Test_LinrotSweep(TEST_LINROT_ERR_T* legacy, TEST_LINROT_ERR_T* hiRes)
+{
+    static double err[2][TEST_LINROT_STEP_NUM];
+    TEST_LINROT_ERR_T* result[2] = {legacy, hiRes};
+    double truth;
+    double mean;
+    double e;
+    double pos;
+    double last = 0;
+    uint16_t backCnt = 0;
+    uint16_t step;
+    uint8_t m;
+
+    /* The offset table method follows the sweep without the direction
+       hysteresis */
+    testParam.DirChangePos = 0;
+
+    for (step = 0; step < TEST_LINROT_STEP_NUM; step++)
+    {
+        if (testObj.Type == TSC_OBJ_ROTARY)
+        {
+            truth = step / (double)TEST_LINROT_STEP_NUM;
+            Test_LinrotTouch(truth * testLinRot.NumChannel, 0);
+        }
+        else
+        {
+            truth = step / (double)(TEST_LINROT_STEP_NUM - 1);
+            Test_LinrotTouch(truth * (testLinRot.NumChannel - 1), 0);
+        }
+
+        err[0][step] = Test_LinrotWrap(Test_LinrotLegacy() - truth);
+
+        pos = Test_LinrotHiRes(1);
+        err[1][step] = Test_LinrotWrap(pos - truth);
+        if ((step != 0) && (Test_LinrotWrap(pos - last) < 0))
+        {
+            backCnt++;
+        }
+        last = pos;
+    }
+
+    testParam.DirChangePos = TOUCH_LINROT_DIR_CHG_POS;
+
+    for (m = 0; m < 2; m++)
+    {
+        mean = 0;
+        for (step = 0; step < TEST_LINROT_STEP_NUM; step++)
+        {
+            mean += err[m][step];
+        }
+        mean /= TEST_LINROT_STEP_NUM;
+
+        result[m]->meanAbs = 0;
+        result[m]->maxAbs = 0;
+        for (step = 0; step < TEST_LINROT_STEP_NUM; step++)
+        {
+            e = fabs(Test_LinrotWrap(err[m][step] - mean)) * 256;
+            result[m]->meanAbs += e;
+            if (e > result[m]->maxAbs)
+            {
+                result[m]->maxAbs = e;
+            }
+        }
+        result[m]->meanAbs /= TEST_LINROT_STEP_NUM;
+    }
+
+    return backCnt;
+}
+
+/*!
+ * @brief       Standard deviation of the position of a still noisy finger
+ *
+ * @param       x: finger position in electrode pitches
+ *
+ * @param       method: 0 offset table, 1 weighted centroid, 2 weighted
+ *              centroid without the jitter filter
+ *
+ * @retval      Standard deviation in LSB of a 8-bit position
+ */
+static double Test_LinrotJitter(double x, uint8_t method)
+{
+    double sum = 0;
+    double sumSq = 0;
+    double pos;
+    double ref = 0;
+    uint16_t i;
+
+    for (i = 0; i < TEST_LINROT_NOISE_NUM; i++)
+    {
+        Test_LinrotTouch(x, TEST_LINROT_NOISE);
+
+        pos = (method == 0) ? Test_LinrotLegacy() : Test_LinrotHiRes((i == 0) || (method == 2));
+        if (i == 0)
+        {
+            ref = pos;
+        }
+        pos = Test_LinrotWrap(pos - ref) * 256;
+
+        sum += pos;
+        sumSq += pos * pos;
+    }
+
+    sum /= TEST_LINROT_NOISE_NUM;
+
+    return sqrt(sumSq / TEST_LINROT_NOISE_NUM - sum * sum);
+}
+
+/*!
+ * @brief       Host time of a position update
+ *
+ * @param       hiRes: 1 for the weighted centroid method
+ *
+ * @retval      Time in ns
+ */
+static double Test_LinrotCost(uint8_t hiRes)
+{
+    double start;
+    uint32_t i;
+
+    Test_LinrotTouch(1.3, 0);
+    start = Test_ReadTimeNs();
+
+    for (i = 0; i < TEST_LINROT_CYCLE_NUM; i++)
+    {
+        if (hiRes)
+        {
+            testLinRot.p_Data = &testHiResData;
+            TSC_Linrot_CalcPosHiRes();
+        }
+        else
+        {
+            testLinRot.p_Data = &testLegacyData;
+            TSC_Linrot_CalcPos();
+        }
+    }
+
+    return (Test_ReadTimeNs() - start) / TEST_LINROT_CYCLE_NUM;
+}
+
+/*!
+ * @brief       A 5-channel rotary sensor swept and touched still with
+ *              noise, then the ends of a 3-channel linear sensor
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_Linrot(void)
+{
+    TEST_LINROT_ERR_T legacy;
+    TEST_LINROT_ERR_T hiRes;
+    double jitter[3];
+    double cost[2];
+    double pos;
+    uint16_t backCnt;
+    uint8_t m;
+
+    Test_LinrotConfig(TSC_OBJ_ROTARY, 5, &TSC_POSOFF_5CH_ROT_M[0][0], TSC_SCTCOMP_5CH_ROT_M, 0);
+
+    backCnt = Test_LinrotSweep(&legacy, &hiRes);
+    printf("Rotary 5 channels, error in 8-bit LSB: offset table mean %.2f max %.2f, " \
+           "weighted centroid mean %.2f max %.2f\r\n", legacy.meanAbs, legacy.maxAbs, hiRes.meanAbs, hiRes.maxAbs);
+    TEST_CHECK(hiRes.meanAbs < legacy.meanAbs, "weighted centroid mean error %.2f, offset table %.2f", \
+               hiRes.meanAbs, legacy.meanAbs);
+    TEST_CHECK(hiRes.maxAbs < legacy.maxAbs, "weighted centroid max error %.2f, offset table %.2f", \
+               hiRes.maxAbs, legacy.maxAbs);
+    TEST_CHECK(backCnt == 0, "weighted centroid went back %u times", backCnt);
+
+    for (m = 0; m < 3; m++)
+    {
+        jitter[m] = Test_LinrotJitter(2.3, m);
+    }
+    printf("Noise of +-%u counts, deviation in 8-bit LSB: offset table %.2f, weighted centroid %.2f, " \
+           "without the filter %.2f\r\n", TEST_LINROT_NOISE, jitter[0], jitter[1], jitter[2]);
+    TEST_CHECK(jitter[1] < jitter[2], "jitter filter %.2f, unfiltered %.2f", jitter[1], jitter[2]);
+    TEST_CHECK(jitter[1] < 1, "jitter filter %.2f", jitter[1]);
+
+    cost[0] = Test_LinrotCost(0);
+    cost[1] = Test_LinrotCost(1);
+    printf("Host time per update: offset table %.0f ns, weighted centroid %.0f ns\r\n", cost[0], cost[1]);
+    TEST_CHECK(cost[1] < cost[0] * 4, "weighted centroid %.0f ns, offset table %.0f ns", cost[1], cost[0]);
+
+    /* The finger spills on a single neighbour at the ends of a linear
+       sensor, the weighted centroid is compressed there */
+    Test_LinrotConfig(TSC_OBJ_LINEAR, 3, &TSC_POSOFF_3CH_LIN_H[0][0], TSC_SCTCOMP_3CH_LIN_H, TSC_POSCORR_3CH_LIN_H);
+
+    backCnt = Test_LinrotSweep(&legacy, &hiRes);
+    printf("Linear 3 channels, error in 8-bit LSB: offset table mean %.2f max %.2f, " \
+           "weighted centroid mean %.2f max %.2f\r\n", legacy.meanAbs, legacy.maxAbs, hiRes.meanAbs, hiRes.maxAbs);
+    TEST_CHECK(hiRes.maxAbs < legacy.maxAbs, "weighted centroid max error %.2f, offset table %.2f", \
+               hiRes.maxAbs, legacy.maxAbs);
+    TEST_CHECK(backCnt == 0, "weighted centroid went back %u times", backCnt);
+
+    Test_LinrotTouch(1, 0);
+    pos = Test_LinrotHiRes(1);
+    TEST_CHECK(fabs(pos - 0.5) * 256 < 1, "middle electrode at %.2f", pos * 256);
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,306 @@
+/*!
+ * @file        tsc_model.c
+ *
+ * @brief       Model of the TSC peripheral, the parameter flash page and
+ *              the GPIO keys for the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "tsc_model.h"
+#include "board_apm32f072_eval.h"
+#include "apm32f0xx_fmc.h"
+#include "apm32f0xx_tmr.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TSC_MODEL_GROUP_NUM         8
+#define TSC_MODEL_CTRL_START        0x02
+#define TSC_MODEL_INTSTS_EOA        0x01
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+TSC_MODEL_T gTscModel;
+
+/* Parameter page, TSC_PARAM_FLASH_ADDR of the host build */
+uint8_t gTscModelFlash[TSC_MODEL_FLASH_SIZE];
+
+/* Channel of each key, the order of MyTouchKeys */
+static const uint32_t tscModelKeyIo[TOUCH_TOTAL_KEYS] =
+{
+    CHANNEL_0_IO_MSK,
+    CHANNEL_1_IO_MSK,
+    CHANNEL_2_IO_MSK,
+    CHANNEL_3_IO_MSK,
+    CHANNEL_4_IO_MSK,
+};
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Init the model, the channels are untouched, the flash page
+ *              erased and the keys released
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void TSC_Model_Init(void)
+{
+    uint8_t i;
+
+    memset(&gTscModel, 0, sizeof(gTscModel));
+    memset(gTscModelFlash, 0xFF, sizeof(gTscModelFlash));
+
+    for (i = 0; i < TSC_MODEL_IO_NUM; i++)
+    {
+        gTscModel.count[i] = TSC_MODEL_COUNT_IDLE;
+    }
+
+    gTscModel.programLimit = TSC_MODEL_NO_RESET;
+    gTscModel.keyLevel = (1 << BUTTONn) - 1;
+    *(__IO uint32_t*)&GPIOC->IDATA = gTscModel.keyLevel;
+}
+
+/*!
+ * @brief       Resolve the register writes of the touch sensing. A flag
+ *              clear clears the status, a start ends the acquisition of
+ *              each enabled group at once.
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ * @note        Called on each function entry and exit of the device code
+ */
+void TSC_Model_Sync(void)
+{
+    uint32_t grp;
+    uint32_t io;
+
+    if (TSC->INTFCLR)
+    {
+        TSC->INTSTS &= ~TSC->INTFCLR;
+        TSC->INTFCLR = 0;
+    }
+
+    if ((TSC->CTRL & TSC_MODEL_CTRL_START) == 0)
+    {
+        return;
+    }
+
+    for (grp = 0; grp < TSC_MODEL_GROUP_NUM; grp++)
+    {
+        if ((TSC->IOGCSTS & (1 << grp)) == 0)
+        {
+            continue;
+        }
+
+        for (io = grp * 4; io < grp * 4 + 4; io++)
+        {
+            if (TSC->IOCHCTRL & (1 << io))
+            {
+                *(__IO uint32_t*)&TSC->IOGxCNT[grp].IOGCNT = gTscModel.count[io];
+                break;
+            }
+        }
+    }
+
+    TSC->CTRL &= ~TSC_MODEL_CTRL_START;
+    TSC->INTSTS |= TSC_MODEL_INTSTS_EOA;
+    gTscModel.acqCnt++;
+}
+
+/*!
+ * @brief       Write the count of the channels
+ *
+ * @param       ioMsk: TSC_GROUPx_IOy channels
+ *
+ * @param       count: count of the next acquisitions
+ *
+ * @retval      None
+ */
+void TSC_Model_WriteCount(uint32_t ioMsk, uint16_t count)
+{
+    uint8_t i;
+
+    for (i = 0; i < TSC_MODEL_IO_NUM; i++)
+    {
+        if (ioMsk & (1 << i))
+        {
+            gTscModel.count[i] = count;
+        }
+    }
+}
+
+/*!
+ * @brief       Write the touch of a key, the count drops from the idle
+ *              count by the delta, a negative delta raises it
+ *
+ * @param       key: index of MyTouchKeys
+ *
+ * @param       delta: delta of the next acquisitions
+ *
+ * @retval      None
+ */
+void TSC_Model_WriteDelta(uint8_t key, int16_t delta)
+{
+    TSC_Model_WriteCount(tscModelKeyIo[key], TSC_MODEL_COUNT_IDLE - delta);
+}
+
+/*!
+ * @brief       One period of TMR14, the update interrupt is served
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void TSC_Model_Tick(void)
+{
+    TMR14->STS |= TMR_INT_FLAG_UPDATE;
+    TMR14_Isr();
+
+    /* The clear writes the other flags as ones */
+    TMR14->STS = 0;
+}
+
+/*!
+ * @brief       Drive the pin of a GPIO key, an edge is served by the
+ *              EINT interrupt
+ *
+ * @param       key: BUTTON_KEYx
+ *
+ * @param       level: pin level, a pressed key is low
+ *
+ * @retval      None
+ */
+void TSC_Model_WriteKey(uint8_t key, uint8_t level)
+{
+    uint8_t mask = 1 << key;
+
+    if (((gTscModel.keyLevel & mask) != 0) == (level != 0))
+    {
+        return;
+    }
+
+    gTscModel.keyLevel ^= mask;
+    *(__IO uint32_t*)&GPIOC->IDATA = gTscModel.keyLevel;
+
+    /* KEYn is on EINT line n, the interrupt clears the flags it serves */
+    EINT->IPEND |= mask;
+    HidMouse_KeyIsr();
+    EINT->IPEND = 0;
+}
+
+/*!
+ * @brief       Unlock the flash
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void FMC_Unlock(void)
+{
+}
+
+/*!
+ * @brief       Lock the flash
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void FMC_Lock(void)
+{
+}
+
+/*!
+ * @brief       Erase the parameter page
+ *
+ * @param       pageAddr: page address
+ *
+ * @retval      Flash status
+ */
+FMC_STATE_T FMC_ErasePage(uint32_t pageAddr)
+{
+    if (pageAddr != (uint32_t)TSC_PARAM_FLASH_ADDR)
+    {
+        return FMC_STATE_PG_ERR;
+    }
+
+    memset(gTscModelFlash, 0xFF, sizeof(gTscModelFlash));
+    gTscModel.eraseCnt++;
+
+    return FMC_STATE_COMPLETE;
+}
+
+/*!
+ * @brief       Program a halfword of the parameter page. A program clears
+ *              bits only. The halfwords past the reset are lost.
+ *
+ * @param       addr: halfword address
+ *
+ * @param       data: halfword
+ *
+ * @retval      Flash status
+ */
+FMC_STATE_T FMC_ProgramHalfWord(uint32_t addr, uint16_t data)
+{
+    uint32_t offset = addr - (uint32_t)TSC_PARAM_FLASH_ADDR;
+
+    if ((offset & 1) || (offset >= TSC_MODEL_FLASH_SIZE))
+    {
+        return FMC_STATE_PG_ERR;
+    }
+
+    if (gTscModel.programCnt < gTscModel.programLimit)
+    {
+        gTscModelFlash[offset] &= (uint8_t)data;
+        gTscModelFlash[offset + 1] &= (uint8_t)(data >> 8);
+    }
+    gTscModel.programCnt++;
+
+    return FMC_STATE_COMPLETE;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
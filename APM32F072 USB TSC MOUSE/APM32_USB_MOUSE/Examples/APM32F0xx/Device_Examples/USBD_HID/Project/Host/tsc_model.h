@@ -0,0 +1,99 @@
+/*!
+ * @file        tsc_model.h
+ *
+ * @brief       Model of the TSC peripheral, the parameter flash page and
+ *              the GPIO keys for the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _TSC_MODEL_H_
+#define _TSC_MODEL_H_
+
+/* Includes */
+#include "tsc_user.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TSC_MODEL_IO_NUM            32
+#define TSC_MODEL_FLASH_SIZE        2048
+/* Count of an untouched channel */
+#define TSC_MODEL_COUNT_IDLE        1000
+/* Halfwords programmed before the reset, no reset */
+#define TSC_MODEL_NO_RESET          0xFFFFFFFFU
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   TSC, flash page and GPIO key model
+ */
+typedef struct
+{
+    uint16_t            count[TSC_MODEL_IO_NUM];    /*!< Count of each group IO, bit n of IOCHCTRL */
+    uint32_t            acqCnt;                     /*!< Block acquisitions */
+    uint32_t            eraseCnt;
+    uint32_t            programCnt;                 /*!< Halfwords programmed */
+    uint32_t            programLimit;               /*!< Halfwords programmed before a reset */
+    uint8_t             keyLevel;                   /*!< Pin level of the GPIO keys, bit n is BUTTON_KEYn+1 */
+} TSC_MODEL_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern TSC_MODEL_T gTscModel;
+extern uint8_t gTscModelFlash[TSC_MODEL_FLASH_SIZE];
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+void TSC_Model_Init(void);
+void TSC_Model_Sync(void);
+void TSC_Model_WriteCount(uint32_t ioMsk, uint16_t count);
+void TSC_Model_WriteDelta(uint8_t key, int16_t delta);
+void TSC_Model_Tick(void);
+void TSC_Model_WriteKey(uint8_t key, uint8_t level);
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
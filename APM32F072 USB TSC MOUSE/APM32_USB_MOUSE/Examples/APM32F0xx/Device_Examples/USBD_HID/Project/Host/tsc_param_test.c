@@ -0,0 +1,190 @@
+/*!
+ * @file        tsc_param_test.c
+ *
+ * @brief       Parameter block of the telemetry interface and its flash page
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+#include "usbd_hid.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Read the parameter block
+ *
+ * @param       block: returns the parameter block
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_ParamRead(uint8_t* block)
+{
+    uint16_t xferLen;
+
+    return Test_Request(TEST_DEV_ADDR, 0xA1, USBD_CLASS_GET_REPORT, USBD_HID_REPORT_TYPE_FEATURE << 8, \
+                        gTestDev.hidItf[1], TSC_PARAM_SIZE, block, &xferLen);
+}
+
+/*!
+ * @brief       Write the parameter block
+ *
+ * @param       block: parameter block
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_ParamWrite(uint8_t* block)
+{
+    uint16_t xferLen;
+
+    return Test_Request(TEST_DEV_ADDR, 0x21, USBD_CLASS_SET_REPORT, USBD_HID_REPORT_TYPE_FEATURE << 8, \
+                        gTestDev.hidItf[1], TSC_PARAM_SIZE, block, &xferLen);
+}
+
+/*!
+ * @brief       Write a parameter block with one byte changed, the block
+ *              is out of range and stalled
+ *
+ * @param       block: valid parameter block
+ *
+ * @param       offset: byte to change
+ *
+ * @param       value: out of range value
+ *
+ * @retval      None
+ */
+static void Test_ParamReject(const uint8_t* block, uint8_t offset, uint8_t value)
+{
+    uint8_t bad[TSC_PARAM_SIZE];
+    uint8_t check[TSC_PARAM_SIZE];
+
+    memcpy(bad, block, TSC_PARAM_SIZE);
+    bad[offset] = value;
+
+    TEST_CHECK(Test_ParamWrite(bad) == USBD_VHOST_STALL, "byte %u of 0x%02X not stalled", offset, value);
+
+    Test_TscRun(10);
+    TEST_CHECK((Test_ParamRead(check) == USBD_VHOST_OK) && (memcmp(check, block, TSC_PARAM_SIZE) == 0), \
+               "byte %u of 0x%02X applied", offset, value);
+}
+
+/*!
+ * @brief       Reset of the device, the keys restart from the defaults
+ *              and load the saved block
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ParamReset(void)
+{
+    TSC_User_Config();
+    TSC_User_ParamLoad();
+}
+
+/*!
+ * @brief       Out of range blocks are stalled, a valid block is applied
+ *              between two frames and saved with the magic last. A save
+ *              cut by a reset keeps the defaults.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscParam(void)
+{
+    uint8_t block[TSC_PARAM_SIZE];
+    uint8_t check[TSC_PARAM_SIZE];
+    uint8_t* record = &block[TSC_PARAM_HEADER_SIZE];
+    uint16_t magic;
+
+    Test_Enumerate();
+    Test_TscRun(100);
+
+    TEST_CHECK(Test_ParamRead(block) == USBD_VHOST_OK, "GET_REPORT parameters");
+    TEST_CHECK((block[0] == TSC_PARAM_VERSION) && (block[1] == TOUCH_TOTAL_KEYS) && \
+               (record[0] == TOUCH_KEY_DETECT_IN_TH) && (record[1] == TOUCH_KEY_DETECT_OUT_TH), \
+               "parameters %u %u %u %u", block[0], block[1], record[0], record[1]);
+
+    /* Header and key ranges */
+    Test_ParamReject(block, 0, TSC_PARAM_VERSION + 1);
+    Test_ParamReject(block, 3, 3);
+    Test_ParamReject(block, 10, 0x04);
+    Test_ParamReject(block, TSC_PARAM_HEADER_SIZE + 1, record[0]);
+#if TOUCH_USE_PROX > 0
+    Test_ParamReject(block, TSC_PARAM_HEADER_SIZE + 1, TOUCH_KEY_PROX_IN_TH);
+#endif
+    Test_ParamReject(block, TSC_PARAM_HEADER_SIZE + 2, 0);
+    Test_ParamReject(block, TSC_PARAM_HEADER_SIZE + 4, TSC_PARAM_DEB_MAX + 1);
+    Test_ParamReject(block, TSC_PARAM_SIZE - 1, TSC_PARAM_DEB_MAX + 1);
+    TEST_CHECK(gTscModel.eraseCnt == 0, "flash erased by a stalled block");
+
+    /* Applied between two frames, then saved */
+    record[0] = TOUCH_KEY_DETECT_IN_TH + 10;
+    block[2] = TSC_PARAM_FLAG_SAVE;
+    TEST_CHECK(Test_ParamWrite(block) == USBD_VHOST_OK, "SET_REPORT parameters");
+    TEST_CHECK(MyTouchKeys[0].p_Param->DetectInTh == TOUCH_KEY_DETECT_IN_TH, "applied in the USB interrupt");
+
+    Test_TscRun(10);
+    TEST_CHECK(MyTouchKeys[0].p_Param->DetectInTh == TOUCH_KEY_DETECT_IN_TH + 10, "not applied");
+    TEST_CHECK(gTscModel.eraseCnt == 1, "%u page erases", (unsigned)gTscModel.eraseCnt);
+
+    magic = gTscModelFlash[0] | (gTscModelFlash[1] << 8);
+    block[2] = 0;
+    TEST_CHECK((magic == TSC_PARAM_FLASH_MAGIC) && (memcmp(&gTscModelFlash[2], block, TSC_PARAM_SIZE) == 0), \
+               "saved block, magic 0x%04X", magic);
+
+    Test_ParamReset();
+    TEST_CHECK(MyTouchKeys[0].p_Param->DetectInTh == TOUCH_KEY_DETECT_IN_TH + 10, "saved block not loaded");
+
+    /* A reset after three halfwords, the erased page has no magic */
+    record[0] = TOUCH_KEY_DETECT_IN_TH + 20;
+    block[2] = TSC_PARAM_FLAG_SAVE;
+    gTscModel.programLimit = gTscModel.programCnt + 3;
+    TEST_CHECK(Test_ParamWrite(block) == USBD_VHOST_OK, "SET_REPORT parameters");
+    Test_TscRun(10);
+
+    magic = gTscModelFlash[0] | (gTscModelFlash[1] << 8);
+    TEST_CHECK(magic == 0xFFFF, "magic 0x%04X of a cut save", magic);
+
+    Test_ParamReset();
+    TEST_CHECK(MyTouchKeys[0].p_Param->DetectInTh == TOUCH_KEY_DETECT_IN_TH, "detect in %u after a cut save", \
+               MyTouchKeys[0].p_Param->DetectInTh);
+    TEST_CHECK((Test_ParamRead(check) == USBD_VHOST_OK) && (check[TSC_PARAM_HEADER_SIZE] == TOUCH_KEY_DETECT_IN_TH), \
+               "GET_REPORT after a cut save");
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
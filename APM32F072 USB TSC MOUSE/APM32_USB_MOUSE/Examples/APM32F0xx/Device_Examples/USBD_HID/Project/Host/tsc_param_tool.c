@@ -0,0 +1,280 @@
+/*!
+ * @file        tsc_param_tool.c
+ *
+ * @brief       Read and write the touch parameter block of the mouse
+ *              through the Linux hidraw device of its telemetry interface
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Parameter block of tsc_user.h, version 1 */
+#define TOOL_PARAM_VERSION          0x01
+#define TOOL_PARAM_HEADER_SIZE      12
+#define TOOL_PARAM_KEY_SIZE         7
+#define TOOL_PARAM_FLAG_SAVE        0x01
+#define TOOL_FEATURE_SIZE           64
+#define TOOL_KEY_ALL                0xFF
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Print the usage
+ *
+ * @param       name: program name
+ *
+ * @retval      1
+ */
+static int Tool_Usage(const char* name)
+{
+    printf("Usage: %s /dev/hidrawN [command] [save]\r\n" \
+           "  (none)                                      print the block\r\n" \
+           "  threshold <key|all> <in> <out> <calib>      detection and calibration thresholds\r\n" \
+           "  debounce <key|all> <calib> <detect> <release> <error>\r\n" \
+           "  interval <ms>                               report interval, 1 2 4 8 or 10\r\n" \
+           "  acq <min> <max>                             acquisition count range\r\n" \
+           "  ecs <differ> <same>                         ECS K coefficients\r\n" \
+           "  filter <bitmap>                             bit0 measure, bit1 delta filter\r\n" \
+           "save writes the block to the flash of the device.\r\n", name);
+
+    return 1;
+}
+
+/*!
+ * @brief       Print a parameter block
+ *
+ * @param       block: parameter block
+ *
+ * @retval      None
+ */
+static void Tool_Print(const uint8_t* block)
+{
+    const uint8_t* record = &block[TOOL_PARAM_HEADER_SIZE];
+    uint8_t i;
+
+    printf("version %u, %u keys, interval %u ms, acquisition %u to %u, ECS K %u %u, filter 0x%02X\r\n", \
+           block[0], block[1], block[3], block[4] | (block[5] << 8), block[6] | (block[7] << 8), \
+           block[8], block[9], block[10]);
+    printf("key  in  out  calib  deb calib  detect  release  error\r\n");
+
+    for (i = 0; i < block[1]; i++)
+    {
+        printf("%3u %3u  %3u  %5u  %9u  %6u  %7u  %5u\r\n", i, record[0], record[1], record[2], \
+               record[3], record[4], record[5], record[6]);
+        record += TOOL_PARAM_KEY_SIZE;
+    }
+}
+
+/*!
+ * @brief       Write the fields of the selected keys
+ *
+ * @param       block: parameter block
+ *
+ * @param       key: key index, or TOOL_KEY_ALL
+ *
+ * @param       offset: first field in the key record
+ *
+ * @param       value: field values
+ *
+ * @param       num: number of fields
+ *
+ * @retval      0, or -1 for a key out of range
+ */
+static int Tool_WriteKeys(uint8_t* block, uint8_t key, uint8_t offset, const uint8_t* value, uint8_t num)
+{
+    uint8_t* record;
+    uint8_t i;
+
+    if ((key != TOOL_KEY_ALL) && (key >= block[1]))
+    {
+        return -1;
+    }
+
+    for (i = 0; i < block[1]; i++)
+    {
+        if ((key == TOOL_KEY_ALL) || (key == i))
+        {
+            record = &block[TOOL_PARAM_HEADER_SIZE + i * TOOL_PARAM_KEY_SIZE];
+            memcpy(&record[offset], value, num);
+        }
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief       Main program
+ *
+ * @param       argc: argument count
+ *
+ * @param       argv: hidraw device, then the command
+ *
+ * @retval      0 on success
+ */
+int main(int argc, char* argv[])
+{
+    /* Byte 0 is the report ID, 0 as the interface has none */
+    uint8_t report[TOOL_FEATURE_SIZE + 1];
+    uint8_t* block = &report[1];
+    uint8_t value[4];
+    uint8_t key = TOOL_KEY_ALL;
+    uint16_t acq;
+    int argNum = argc;
+    int fd;
+    int i;
+
+    if (argc < 2)
+    {
+        return Tool_Usage(argv[0]);
+    }
+
+    if ((argc > 2) && (strcmp(argv[argc - 1], "save") == 0))
+    {
+        argNum--;
+    }
+
+    fd = open(argv[1], O_RDWR);
+
+    if (fd < 0)
+    {
+        printf("Cannot open %s: %s\r\n", argv[1], strerror(errno));
+        return 1;
+    }
+
+    memset(report, 0, sizeof(report));
+
+    if ((ioctl(fd, HIDIOCGFEATURE(sizeof(report)), report) < 0) || (block[0] != TOOL_PARAM_VERSION))
+    {
+        printf("No version %u parameter block on %s\r\n", TOOL_PARAM_VERSION, argv[1]);
+        close(fd);
+        return 1;
+    }
+
+    if (argNum == 2)
+    {
+        Tool_Print(block);
+        close(fd);
+        return 0;
+    }
+
+    if ((argNum > 3) && (strcmp(argv[3], "all") != 0))
+    {
+        key = (uint8_t)strtoul(argv[3], NULL, 0);
+    }
+
+    for (i = 0; (i < 4) && (i + 4 < argNum); i++)
+    {
+        value[i] = (uint8_t)strtoul(argv[i + 4], NULL, 0);
+    }
+
+    if ((strcmp(argv[2], "threshold") == 0) && (argNum == 7))
+    {
+        i = Tool_WriteKeys(block, key, 0, value, 3);
+    }
+    else if ((strcmp(argv[2], "debounce") == 0) && (argNum == 8))
+    {
+        i = Tool_WriteKeys(block, key, 3, value, 4);
+    }
+    else if ((strcmp(argv[2], "interval") == 0) && (argNum == 4))
+    {
+        block[3] = (uint8_t)strtoul(argv[3], NULL, 0);
+        i = 0;
+    }
+    else if ((strcmp(argv[2], "acq") == 0) && (argNum == 5))
+    {
+        acq = (uint16_t)strtoul(argv[3], NULL, 0);
+        block[4] = (uint8_t)acq;
+        block[5] = (uint8_t)(acq >> 8);
+        acq = (uint16_t)strtoul(argv[4], NULL, 0);
+        block[6] = (uint8_t)acq;
+        block[7] = (uint8_t)(acq >> 8);
+        i = 0;
+    }
+    else if ((strcmp(argv[2], "ecs") == 0) && (argNum == 5))
+    {
+        block[8] = (uint8_t)strtoul(argv[3], NULL, 0);
+        block[9] = (uint8_t)strtoul(argv[4], NULL, 0);
+        i = 0;
+    }
+    else if ((strcmp(argv[2], "filter") == 0) && (argNum == 4))
+    {
+        block[10] = (uint8_t)strtoul(argv[3], NULL, 0);
+        i = 0;
+    }
+    else
+    {
+        close(fd);
+        return Tool_Usage(argv[0]);
+    }
+
+    if (i != 0)
+    {
+        printf("No key %s\r\n", argv[3]);
+        close(fd);
+        return 1;
+    }
+
+    block[2] = (argNum != argc) ? TOOL_PARAM_FLAG_SAVE : 0;
+
+    /* The device stalls a block out of range, or received before the
+       last one is applied */
+    if (ioctl(fd, HIDIOCSFEATURE(sizeof(report)), report) < 0)
+    {
+        printf("Block rejected: %s\r\n", strerror(errno));
+        close(fd);
+        return 1;
+    }
+
+    Tool_Print(block);
+    close(fd);
+
+    return 0;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,145 @@
+/*!
+ * @file        tsc_stub.c
+ *
+ * @brief       Touch sensing functions of the host build, the mouse is
+ *              tested without the TSC
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "host_stub.h"
+#include "usbd_vhost.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+/* Remote wakeup latency in ms, counted by the touch scan timer */
+__IO uint16_t cntWake = 0;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Read the time base of the touch sensing
+ *
+ * @param       None
+ *
+ * @retval      Bus time in us
+ */
+uint32_t TSC_User_ReadTimeUs(void)
+{
+    return USBD_VHost_ReadTimeUs();
+}
+
+/*!
+ * @brief       Record a telemetry command
+ *
+ * @param       buffer: command report
+ *
+ * @param       length: command length
+ *
+ * @retval      TSC status
+ */
+TSC_STATUS_T TSC_User_TlmReceive(uint8_t* buffer, uint8_t length)
+{
+    if (length > sizeof(gHostTlm.cmd))
+    {
+        length = sizeof(gHostTlm.cmd);
+    }
+
+    memcpy(gHostTlm.cmd, buffer, length);
+    gHostTlm.cmdLen = length;
+    gHostTlm.cmdCnt++;
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Read the parameter block
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      TSC status
+ */
+TSC_STATUS_T TSC_User_ParamRead(uint8_t* buffer, uint8_t length)
+{
+    if (length > sizeof(gHostTlm.param))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    memcpy(buffer, gHostTlm.param, length);
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Write the parameter block
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      TSC status
+ */
+TSC_STATUS_T TSC_User_ParamWrite(uint8_t* buffer, uint8_t length)
+{
+    if (length > sizeof(gHostTlm.param))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    memcpy(gHostTlm.param, buffer, length);
+    gHostTlm.paramWriteCnt++;
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Load the parameter block
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void TSC_User_ParamLoad(void)
+{
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
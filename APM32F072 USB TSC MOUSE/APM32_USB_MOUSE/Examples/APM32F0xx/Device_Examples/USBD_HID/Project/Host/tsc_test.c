@@ -0,0 +1,140 @@
+/*!
+ * @file        tsc_test.c
+ *
+ * @brief       Main loop of the touch sensing against the TSC model
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Main loop passes per ms, a frame takes one pass per block */
+#define TEST_TSC_LOOP_NUM           (TOUCH_TOTAL_BLOCKS + 1)
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       One pass of the main loop of main.c
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscLoop(void)
+{
+    HidMouse_Proc();
+
+    if (TSC_User_Action() == TSC_STATUS_OK)
+    {
+        if (taskFlag)
+        {
+            TSC_DetectHandler();
+        }
+        else
+        {
+            TSC_ReleaseHandler();
+        }
+
+        if (USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_DIGITIZER)
+        {
+            Digitizer_TSCHandler();
+        }
+        else
+        {
+            Action_TSCHandler();
+            if (tscPressStatus != 0)
+            {
+                Menu_TSCHandler();
+            }
+        }
+#if USBD_SUP_HID_TLM
+        TSC_User_Telemetry();
+#endif
+#if USBD_SUP_REMOTE_WAKEUP
+        if ((gUsbDevAppStatus == USBD_APP_SUSPEND) && (TSC_User_Touched() || HidMouse_ReadKey()))
+        {
+            USB_DevRemoteWakeup();
+        }
+#endif
+    }
+    else if (gUsbDevAppStatus == USBD_APP_SUSPEND)
+    {
+        USBD_LowPowerSleep();
+    }
+
+#if USBD_SUP_REMOTE_WAKEUP
+    USB_DevWakeProc();
+#endif
+#if USBD_SUP_LATENCY
+    USB_DevLatProc();
+#endif
+    USB_DevFormatProc();
+#if USBD_SUP_DEFER_ISR
+    USB_DevEventProc();
+#endif
+}
+
+/*!
+ * @brief       Run the bus, the TMR14 time base and the main loop
+ *
+ * @param       ms: time in ms
+ *
+ * @retval      None
+ */
+void Test_TscRun(uint32_t ms)
+{
+    uint8_t i;
+
+    while (ms--)
+    {
+        TSC_Model_Tick();
+        USBD_VHost_Frame();
+
+        for (i = 0; i < TEST_TSC_LOOP_NUM; i++)
+        {
+            Test_TscLoop();
+        }
+    }
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,319 @@
+/*!
+ * @file        tsc_wake_test.c
+ *
+ * @brief       Touch and key wakeup of a suspended bus
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include "host_stub.h"
+#include "board_apm32f072_eval.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Main loop passes per ms, as in tsc_test.c */
+#define TEST_WAKE_LOOP_NUM          (TOUCH_TOTAL_BLOCKS + 1)
+#define TEST_WAKE_DELTA             (TOUCH_KEY_DETECT_IN_TH + 100)
+#define TEST_WAKE_SCAN_MS           500
+/* A touch is debounced over a few slow scans */
+#define TEST_WAKE_DETECT_MS         (TSC_SUSPEND_SCAN_PERIOD * 8)
+/* Resume signalling of the host */
+#define TEST_WAKE_RESUME_MS         20
+#define TEST_WAKE_POLL_MS           20
+#define TEST_WAKE_SETTLE_MS         200
+#define TEST_WAKE_BTN_LEFT          0x01
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Run the main loop on a suspended bus, no SOF, until the
+ *              device starts the resume signalling
+ *
+ * @param       ms: time in ms
+ *
+ * @retval      Time in ms to the resume signalling, ms if none
+ */
+static uint32_t Test_WakeSuspend(uint32_t ms)
+{
+    uint32_t time;
+    uint8_t i;
+
+    for (time = 0; time < ms; time++)
+    {
+        TSC_Model_Tick();
+        USBD_VHost_Idle(1);
+
+        for (i = 0; i < TEST_WAKE_LOOP_NUM; i++)
+        {
+            Test_TscLoop();
+        }
+
+        if (usbDeviceHandler.resumeCnt != 0)
+        {
+            return time + 1;
+        }
+    }
+
+    return ms;
+}
+
+/*!
+ * @brief       End the resume signalling of the device, resume the bus
+ *              from the host and poll the report that woke the device
+ *
+ * @param       data: report
+ *
+ * @param       length: report length
+ *
+ * @retval      1 if a report was polled
+ */
+static uint8_t Test_WakeResume(uint8_t* data, uint16_t* length)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint32_t ms;
+    uint8_t pid;
+
+    for (ms = 0; (ms < USBD_RESUME_SIGNAL_TIME * 2) && (usbDeviceHandler.resumeCnt != 0); ms++)
+    {
+        TSC_Model_Tick();
+        USBD_VHost_Idle(1);
+        Test_TscLoop();
+    }
+
+    TEST_CHECK(usbDeviceHandler.resumeCnt == 0, "resume signalling for %u more ms", usbDeviceHandler.resumeCnt);
+
+    /* TMR14 runs through the resume signalling of the host */
+    for (ms = 0; ms < TEST_WAKE_RESUME_MS; ms++)
+    {
+        TSC_Model_Tick();
+    }
+
+    USBD_VHost_Resume();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after resume", gUsbDeviceFS.devState);
+
+    for (ms = 0; ms < TEST_WAKE_POLL_MS; ms++)
+    {
+        Test_TscRun(1);
+
+        if (USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, length) == USBD_MODEL_HS_ACK)
+        {
+            gTestDev.epInPid[epNum] ^= 1;
+
+            /* The wakeup latency is taken on the next pass */
+            Test_TscLoop();
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief       Suspend the bus, the scan slows down and the clocks run on
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WakeEnter(void)
+{
+    uint32_t acqCnt;
+    uint32_t activeCnt;
+    uint32_t wfiCnt;
+    uint32_t stopCnt;
+
+    acqCnt = gTscModel.acqCnt;
+    Test_TscRun(TEST_WAKE_SCAN_MS);
+    activeCnt = gTscModel.acqCnt - acqCnt;
+
+    USBD_VHost_Suspend(3);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+
+    acqCnt = gTscModel.acqCnt;
+    wfiCnt = gHostCore.wfiCnt;
+    stopCnt = gHostCore.stopCnt;
+
+    TEST_CHECK(Test_WakeSuspend(TEST_WAKE_SCAN_MS) == TEST_WAKE_SCAN_MS, "wakeup without a touch");
+
+    printf("Block acquisitions in %u ms: %u active, %u suspended\r\n", TEST_WAKE_SCAN_MS, (unsigned)activeCnt, \
+           (unsigned)(gTscModel.acqCnt - acqCnt));
+
+    TEST_CHECK((gTscModel.acqCnt - acqCnt) * (TSC_SUSPEND_SCAN_PERIOD / 2) <= activeCnt, \
+               "%u block acquisitions suspended, %u active", (unsigned)(gTscModel.acqCnt - acqCnt), \
+               (unsigned)activeCnt);
+    TEST_CHECK(gTscModel.acqCnt != acqCnt, "no scan in suspend");
+    TEST_CHECK(gHostCore.wfiCnt != wfiCnt, "no sleep between the scans");
+    TEST_CHECK(gHostCore.stopCnt == stopCnt, "clocks stopped with the touch wakeup armed");
+}
+
+/*!
+ * @brief       A touch does not wake the bus before the host enables the
+ *              remote wakeup
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WakeDisabled(void)
+{
+    USBD_VHost_Suspend(3);
+
+    TSC_Model_WriteDelta(0, TEST_WAKE_DELTA);
+    TEST_CHECK(Test_WakeSuspend(TEST_WAKE_DETECT_MS) == TEST_WAKE_DETECT_MS, "wakeup not enabled by the host");
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+
+    TSC_Model_WriteDelta(0, 0);
+    Test_WakeSuspend(TEST_WAKE_DETECT_MS);
+
+    USBD_VHost_Resume();
+    Test_TscRun(TEST_WAKE_SETTLE_MS);
+}
+
+/*!
+ * @brief       A touch wakes the bus, the wakeup latency runs from the
+ *              request to the first report polled
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WakeTouch(void)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t interval = gTestDev.epInInterval[epNum] ? gTestDev.epInInterval[epNum] : 1;
+    uint16_t wakeCnt = gUsbWakeStat.count;
+    uint32_t detectMs;
+    uint8_t data[64];
+    uint16_t length;
+
+    Test_WakeEnter();
+
+    TSC_Model_WriteDelta(0, TEST_WAKE_DELTA);
+    detectMs = Test_WakeSuspend(TEST_WAKE_DETECT_MS);
+
+    TEST_CHECK(detectMs < TEST_WAKE_DETECT_MS, "touch did not wake the bus");
+    TEST_CHECK(Test_WakeResume(data, &length), "no report after the touch wakeup");
+    TEST_CHECK(gUsbWakeStat.count == wakeCnt + 1, "%u wakeups of 1", (unsigned)(gUsbWakeStat.count - wakeCnt));
+
+    printf("Touch wakeup: signalled %u ms after the touch, first report %u ms after the request\r\n", \
+           (unsigned)detectMs, (unsigned)gUsbWakeStat.lastLatency);
+
+    TEST_CHECK(gUsbWakeStat.lastLatency >= USBD_RESUME_SIGNAL_TIME + TEST_WAKE_RESUME_MS, \
+               "wake latency %u ms shorter than the resume", (unsigned)gUsbWakeStat.lastLatency);
+    TEST_CHECK(gUsbWakeStat.lastLatency <= USBD_RESUME_SIGNAL_TIME + TEST_WAKE_RESUME_MS + interval + 2, \
+               "wake latency %u ms", (unsigned)gUsbWakeStat.lastLatency);
+
+    TSC_Model_WriteDelta(0, 0);
+    Test_TscRun(TEST_WAKE_SETTLE_MS);
+}
+
+/*!
+ * @brief       A key press wakes the bus and is the first report polled
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WakeKey(void)
+{
+    uint16_t wakeCnt = gUsbWakeStat.count;
+    uint32_t detectMs;
+    uint8_t data[64];
+    uint16_t length = 0;
+
+    Test_WakeEnter();
+
+    TSC_Model_WriteKey(BUTTON_KEY3, 0);
+    detectMs = Test_WakeSuspend(TEST_WAKE_DETECT_MS);
+
+    TEST_CHECK(detectMs < TEST_WAKE_DETECT_MS, "key did not wake the bus");
+    TEST_CHECK(Test_WakeResume(data, &length), "no report after the key wakeup");
+    TEST_CHECK(gUsbWakeStat.count == wakeCnt + 1, "%u wakeups of 1", (unsigned)(gUsbWakeStat.count - wakeCnt));
+
+    /* Report ID, buttons */
+    TEST_CHECK((length >= 2) && (data[0] == USBD_HID_REPORT_ID_MOUSE) && (data[1] & TEST_WAKE_BTN_LEFT), \
+               "key press lost over the wakeup");
+
+    printf("Key wakeup: signalled %u ms after the press, first report %u ms after the request\r\n", \
+           (unsigned)detectMs, (unsigned)gUsbWakeStat.lastLatency);
+
+    TSC_Model_WriteKey(BUTTON_KEY3, 1);
+    Test_TscRun(TEST_WAKE_SETTLE_MS);
+}
+
+/*!
+ * @brief       Touch and key wakeup of a suspended bus: no wakeup before
+ *              the host enables it, slow scans in suspend and the report
+ *              of the touch or the key polled after the resume
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscWake(void)
+{
+    uint8_t data[64];
+    uint16_t length;
+
+    Test_Enumerate();
+    Test_TscRun(TEST_WAKE_SETTLE_MS);
+
+    Test_WakeDisabled();
+
+    TEST_CHECK(Test_Request(TEST_DEV_ADDR, 0x00, USBD_STD_SET_FEATURE, USBD_FEATURE_REMOTE_WAKEUP, \
+                            0, 0, data, &length) == USBD_VHOST_OK, "SET_FEATURE DEVICE_REMOTE_WAKEUP");
+
+    Test_WakeTouch();
+    Test_WakeKey();
+
+    TEST_CHECK(gUsbWakeStat.timeout == 0, "%u wakeup timeouts", (unsigned)gUsbWakeStat.timeout);
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,326 @@
+/*!
+ * @file        tsc_water_test.c
+ *
+ * @brief       Synthetic water films and fingers on the keys and the
+ *              driven shield
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "tsc_model.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+#if TOUCH_USE_WATER > 0
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_WATER_NOISE            4
+#define TEST_WATER_FINGER           300
+/* Frames of a detection or a release debounce, they are not counted */
+#define TEST_WATER_DEB_MS           20
+#define TEST_WATER_HOLD_MS          400
+#define TEST_WATER_RAMP_MS          100
+/* Key delta of a film as strong as a finger, only the shield tells
+   them apart */
+#define TEST_WATER_FILM             TEST_WATER_FINGER
+#define TEST_WATER_RATIO_NUM        7
+#define TEST_WATER_LEVEL_NUM        5
+/* Slow drift of an untouched key below the proximity, followed by
+   the ECS */
+#define TEST_WATER_DRIFT            8
+#define TEST_WATER_ECS_MS           3000
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Frames of a trace segment
+ */
+typedef struct
+{
+    uint32_t            frameCnt;       /*!< Frames counted */
+    uint32_t            reportCnt;      /*!< Frames with a key reported */
+} TEST_WATER_STAT_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+static uint32_t testSeed = 1;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Noise of an acquisition
+ *
+ * @param       None
+ *
+ * @retval      Noise of +-TEST_WATER_NOISE counts
+ */
+static int16_t Test_WaterNoise(void)
+{
+    testSeed = testSeed * 1103515245 + 12345;
+
+    return (int16_t)((testSeed >> 16) % (2 * TEST_WATER_NOISE + 1)) - TEST_WATER_NOISE;
+}
+
+/*!
+ * @brief       One 1 ms frame of a trace. The film loads each key and the
+ *              shield by the key delta over a ratio, a finger adds to the
+ *              key delta.
+ *
+ * @param       film: key delta of the water film
+ *
+ * @param       ratio: key delta of the film over the shield delta, in
+ *              1/16 unit
+ *
+ * @param       wet: keys under the film, bit n is K(n+1)
+ *
+ * @param       fingers: keys touched, bit n is K(n+1)
+ *
+ * @retval      Keys reported, bit n is K(n+1)
+ */
+static uint8_t Test_WaterFrame(int16_t film, uint16_t ratio, uint8_t wet, uint8_t fingers)
+{
+    int16_t shield = (int16_t)(((int32_t)film << 4) / ratio);
+    int16_t delta;
+    uint8_t i;
+
+    for (i = 0; i < TOUCH_TOTAL_KEYS; i++)
+    {
+        delta = (wet & (1 << i)) ? film : 0;
+        if (fingers & (1 << i))
+        {
+            delta += TEST_WATER_FINGER;
+        }
+
+        TSC_Model_WriteDelta(i, delta + Test_WaterNoise());
+    }
+
+    TSC_Model_WriteCount(CHANNEL_SHIELD_IO_MSK, (uint16_t)(TSC_MODEL_COUNT_IDLE - shield - Test_WaterNoise()));
+
+    Test_TscRun(1);
+
+    /* As TSC_DetectHandler() and Action_TSCHandler() */
+    return (uint8_t)(MyArb.Winners & ~MyWater.Suppressed & TSC_TOUCH_ARB_MASK);
+}
+
+/*!
+ * @brief       A film which spreads, stays and dries, the frames after a
+ *              detection debounce are counted
+ *
+ * @param       film: key delta of the film
+ *
+ * @param       ratio: key delta of the film over the shield delta, in
+ *              1/16 unit
+ *
+ * @param       wet: keys under the film
+ *
+ * @param       fingers: keys touched during the whole trace
+ *
+ * @param       stat: returns the frames with a key reported
+ *
+ * @retval      None
+ */
+static void Test_WaterTrace(int16_t film, uint16_t ratio, uint8_t wet, uint8_t fingers, TEST_WATER_STAT_T* stat)
+{
+    uint32_t ms;
+    int16_t level;
+
+    stat->frameCnt = 0;
+    stat->reportCnt = 0;
+
+    for (ms = 0; ms < TEST_WATER_RAMP_MS + TEST_WATER_HOLD_MS + TEST_WATER_RAMP_MS; ms++)
+    {
+        if (ms < TEST_WATER_RAMP_MS)
+        {
+            level = (int16_t)(film * ms / TEST_WATER_RAMP_MS);
+        }
+        else if (ms < TEST_WATER_RAMP_MS + TEST_WATER_HOLD_MS)
+        {
+            level = film;
+        }
+        else
+        {
+            level = (int16_t)(film * (TEST_WATER_RAMP_MS * 2 + TEST_WATER_HOLD_MS - ms) / TEST_WATER_RAMP_MS);
+        }
+
+        if (Test_WaterFrame(level, ratio, wet, fingers) && (ms >= TEST_WATER_DEB_MS))
+        {
+            stat->reportCnt++;
+        }
+
+        if (ms >= TEST_WATER_DEB_MS)
+        {
+            stat->frameCnt++;
+        }
+    }
+
+    /* Dry and released before the next trace */
+    for (ms = 0; ms < TEST_WATER_RAMP_MS; ms++)
+    {
+        Test_WaterFrame(0, 16, 0, 0);
+    }
+}
+
+/*!
+ * @brief       Films of each key/shield ratio, then fingers through
+ *              films of each level. The rates of the frames with a key
+ *              reported are printed.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WaterRate(void)
+{
+    /* Key/shield ratios of a film, the rejection ratio is
+       TOUCH_WATER_RATIO. Above it the film is a finger. */
+    static const uint16_t filmRatio[TEST_WATER_RATIO_NUM] = {8, 16, 24, 32, 40, 56, 80};
+    static const int16_t filmLevel[TEST_WATER_LEVEL_NUM] = {0, 50, 100, 150, 200};
+    TEST_WATER_STAT_T stat;
+    uint8_t i;
+
+    /* A droplet on K1 and the shield alone, a phantom press is a key
+       reported */
+    for (i = 0; i < TEST_WATER_RATIO_NUM; i++)
+    {
+        Test_WaterTrace(TEST_WATER_FILM, filmRatio[i], TSC_TOUCH_K1, 0, &stat);
+        printf("Droplet of key/shield %u/16: %u of %u frames with a phantom press (%.1f%%)\r\n", filmRatio[i], \
+               (unsigned)stat.reportCnt, (unsigned)stat.frameCnt, 100.0 * stat.reportCnt / stat.frameCnt);
+
+        if (filmRatio[i] < TOUCH_WATER_RATIO)
+        {
+            TEST_CHECK(stat.reportCnt == 0, "droplet of %u/16, %u phantom frames", filmRatio[i], \
+                       (unsigned)stat.reportCnt);
+        }
+    }
+
+    /* A film over the whole sensor */
+    Test_WaterTrace(TEST_WATER_FILM, 16, TSC_TOUCH_ARB_MASK, 0, &stat);
+    printf("Film over the keys: %u of %u frames with a phantom press (%.1f%%)\r\n", (unsigned)stat.reportCnt, \
+           (unsigned)stat.frameCnt, 100.0 * stat.reportCnt / stat.frameCnt);
+    TEST_CHECK(stat.reportCnt == 0, "film over the keys, %u phantom frames", (unsigned)stat.reportCnt);
+
+    /* A finger on K2 through a droplet which loads it as much as the
+       shield */
+    for (i = 0; i < TEST_WATER_LEVEL_NUM; i++)
+    {
+        Test_WaterTrace(filmLevel[i], 16, TSC_TOUCH_K2, TSC_TOUCH_K2, &stat);
+        printf("Finger through a droplet of %u: %u of %u frames reported (%.1f%%)\r\n", filmLevel[i], \
+               (unsigned)stat.reportCnt, (unsigned)stat.frameCnt, 100.0 * stat.reportCnt / stat.frameCnt);
+
+        /* Always reported one shield delta above the rejection ratio */
+        if ((TEST_WATER_FINGER + filmLevel[i]) * 16 >= filmLevel[i] * (TOUCH_WATER_RATIO + 16))
+        {
+            TEST_CHECK(stat.reportCnt == stat.frameCnt, "finger through %u, %u of %u frames", filmLevel[i], \
+                       (unsigned)stat.reportCnt, (unsigned)stat.frameCnt);
+        }
+    }
+}
+
+/*!
+ * @brief       The ECS follows a drift of an untouched key on a dry
+ *              sensor and is paused while a film is present
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_WaterEcs(void)
+{
+    TSC_Channel_Data_T* chData = MyTouchKeys[4].p_ChD;
+    TSC_tTick_ms_T tick = TSC_Globals.Tick_ms;
+    uint32_t ms;
+
+    TSC_Model_WriteDelta(4, TEST_WATER_DRIFT);
+    Test_TscRun(TEST_WATER_ECS_MS);
+
+    TEST_CHECK((TSC_tTick_ms_T)(TSC_Globals.Tick_ms - tick) == TEST_WATER_ECS_MS, "%u ms ticks in %u ms", \
+               (unsigned)(TSC_tTick_ms_T)(TSC_Globals.Tick_ms - tick), TEST_WATER_ECS_MS);
+    TEST_CHECK(chData->Delta <= TEST_WATER_DRIFT / 4, "delta %d of a drift on a dry sensor", chData->Delta);
+
+    /* Drift again under a film the keys do not see, the delta stays
+       below the proximity */
+    TSC_Model_WriteDelta(4, TEST_WATER_DRIFT * 3 / 2);
+
+    for (ms = 0; ms < TEST_WATER_ECS_MS; ms++)
+    {
+        TSC_Model_WriteCount(CHANNEL_SHIELD_IO_MSK, TSC_MODEL_COUNT_IDLE - TEST_WATER_FILM / 2);
+        Test_TscRun(1);
+    }
+
+    TEST_CHECK(MyWater.Wet == TSC_TRUE, "film not detected");
+    TEST_CHECK(chData->Delta >= TEST_WATER_DRIFT / 2, "delta %d of a drift under a film", chData->Delta);
+
+    /* Followed once dry */
+    TSC_Model_WriteCount(CHANNEL_SHIELD_IO_MSK, TSC_MODEL_COUNT_IDLE);
+    Test_TscRun(TEST_WATER_ECS_MS);
+    TEST_CHECK(MyWater.Wet == TSC_FALSE, "film still detected");
+    TEST_CHECK(chData->Delta <= TEST_WATER_DRIFT / 4, "delta %d of a drift after the film", chData->Delta);
+
+    TSC_Model_WriteDelta(4, 0);
+    Test_TscRun(TEST_WATER_ECS_MS);
+}
+
+/*!
+ * @brief       Rejection rates of synthetic water films, fingers through
+ *              a film and the ECS pause
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_TscWater(void)
+{
+    Test_Enumerate();
+    Test_TscRun(200);
+
+    Test_WaterRate();
+    Test_WaterEcs();
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+
+#endif /* TOUCH_USE_WATER > 0 */
+
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
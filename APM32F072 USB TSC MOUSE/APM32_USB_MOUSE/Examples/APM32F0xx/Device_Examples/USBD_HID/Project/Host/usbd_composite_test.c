@@ -0,0 +1,1119 @@
+/*!
+ * @file        usbd_composite_test.c
+ *
+ * @brief       Enumeration of the mouse composed with a CDC, a MSC and a
+ *              WINUSB function
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include "usbd_cdc.h"
+#include "usbd_msc.h"
+#include "usbd_winusb.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Interfaces of the composed device, the mouse is registered first */
+#define TEST_CDC_ITF                1
+#define TEST_MSC_ITF                3
+#define TEST_WINUSB_ITF             4
+#define TEST_COMPOSITE_ITF_NUM      5
+
+#define TEST_CDC_DESC_SIZE          58
+#define TEST_BULK_DESC_SIZE         23
+
+/* RAM disk of the MSC function */
+#define TEST_MSC_BLOCK_NUM          16
+#define TEST_MSC_BLOCK_SIZE         512
+#define TEST_MSC_CBW_LEN            31
+#define TEST_MSC_CSW_LEN            13
+
+/* Bulk packet size and the transfer of the throughput runs */
+#define TEST_BULK_MPS               64
+#define TEST_BULK_XFER_SIZE         4096
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+/* CDC ACM function, interfaces and endpoints numbered from 0 */
+static const uint8_t testCdcDesc[TEST_CDC_DESC_SIZE] =
+{
+    /* Communication interface */
+    0x09, USBD_DESC_INTERFACE, 0x00, 0x00, 0x01, 0x02, 0x02, 0x01, 0x00,
+    /* Header, call management, ACM and union */
+    0x05, USBD_DESC_CS_INTERFACE, 0x00, 0x10, 0x01,
+    0x05, USBD_DESC_CS_INTERFACE, 0x01, 0x00, 0x01,
+    0x04, USBD_DESC_CS_INTERFACE, 0x02, 0x02,
+    0x05, USBD_DESC_CS_INTERFACE, 0x06, 0x00, 0x01,
+    0x07, USBD_DESC_ENDPOINT, USBD_CDC_CMD_EP_ADDR, EP_TYPE_INTERRUPT, USBD_CDC_CMD_MP_SIZE, 0x00,
+    USBD_CDC_FS_INTERVAL,
+    /* Data interface */
+    0x09, USBD_DESC_INTERFACE, 0x01, 0x00, 0x02, 0x0A, 0x00, 0x00, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_CDC_DATA_OUT_EP_ADDR, EP_TYPE_BULK, USBD_CDC_FS_MP_SIZE, 0x00, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_CDC_DATA_IN_EP_ADDR, EP_TYPE_BULK, USBD_CDC_FS_MP_SIZE, 0x00, 0x00,
+};
+
+/* MSC bulk only SCSI function */
+static const uint8_t testMscDesc[TEST_BULK_DESC_SIZE] =
+{
+    0x09, USBD_DESC_INTERFACE, 0x00, 0x00, 0x02, 0x08, 0x06, 0x50, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_MSC_IN_EP_ADDR, EP_TYPE_BULK, USBD_MSC_FS_MP_SIZE, 0x00, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_MSC_OUT_EP_ADDR, EP_TYPE_BULK, USBD_MSC_FS_MP_SIZE, 0x00, 0x00,
+};
+
+/* WINUSB vendor function */
+static const uint8_t testWinUsbDesc[TEST_BULK_DESC_SIZE] =
+{
+    0x09, USBD_DESC_INTERFACE, 0x00, 0x00, 0x02, 0xFF, 0x00, 0x00, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_WINUSB_DATA_OUT_EP_ADDR, EP_TYPE_BULK, USBD_WINUSB_FS_MP_SIZE, 0x00, 0x00,
+    0x07, USBD_DESC_ENDPOINT, USBD_WINUSB_DATA_IN_EP_ADDR, EP_TYPE_BULK, USBD_WINUSB_FS_MP_SIZE, 0x00, 0x00,
+};
+
+/* Last control request of the CDC function and the line coding */
+static uint8_t testCdcCmd = 0xFF;
+static uint8_t testCdcLine[USBD_CDC_DATA_MP_SIZE];
+static uint8_t testCdcRxBuffer[USBD_CDC_FS_MP_SIZE];
+static uint8_t testWinUsbRxBuffer[USBD_WINUSB_FS_MP_SIZE];
+static uint8_t testMscInquiry[USBD_LEN_STD_INQUIRY];
+static uint8_t testMscDisk[TEST_MSC_BLOCK_NUM * TEST_MSC_BLOCK_SIZE];
+
+/* Data received by the CDC function and the transfers it sent */
+static uint8_t testCdcRxData[TEST_BULK_XFER_SIZE];
+static uint32_t testCdcRxLen;
+static uint32_t testCdcSendEndCnt;
+
+/* Data of the host */
+static uint8_t testBulkTx[TEST_BULK_XFER_SIZE];
+static uint8_t testBulkRx[TEST_BULK_XFER_SIZE];
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       CDC interface init
+ *
+ * @param       None
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_CdcItfInit(void)
+{
+    USBD_CDC_ConfigRxBuffer(&gUsbDeviceFS, testCdcRxBuffer);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC interface de-init
+ *
+ * @param       None
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_CdcItfDeInit(void)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC control request, the line coding is kept as set
+ *
+ * @param       command: request
+ *
+ * @param       buffer: data stage
+ *
+ * @param       length: data stage length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_CdcItfCtrl(uint8_t command, uint8_t *buffer, uint16_t length)
+{
+    testCdcCmd = command;
+
+    switch (command)
+    {
+        case USBD_CDC_SET_LINE_CODING:
+            memcpy(testCdcLine, buffer, length < sizeof(testCdcLine) ? length : sizeof(testCdcLine));
+            break;
+
+        case USBD_CDC_GET_LINE_CODING:
+            memcpy(buffer, testCdcLine, sizeof(testCdcLine));
+            break;
+
+        default:
+            break;
+    }
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC or WINUSB send
+ *
+ * @param       buffer: data
+ *
+ * @param       length: data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_ItfSend(uint8_t *buffer, uint16_t length)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC or WINUSB send end
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       buffer: data
+ *
+ * @param       length: data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_ItfSendEnd(uint8_t epNum, uint8_t *buffer, uint32_t *length)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC or WINUSB receive
+ *
+ * @param       buffer: data
+ *
+ * @param       length: data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_ItfReceive(uint8_t *buffer, uint32_t *length)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC send end
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       buffer: data
+ *
+ * @param       length: data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_CdcItfSendEnd(uint8_t epNum, uint8_t *buffer, uint32_t *length)
+{
+    testCdcSendEndCnt++;
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       CDC receive, the data is kept and the next packet is
+ *              received
+ *
+ * @param       buffer: data
+ *
+ * @param       length: data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_CdcItfReceive(uint8_t *buffer, uint32_t *length)
+{
+    if ((testCdcRxLen + *length) <= sizeof(testCdcRxData))
+    {
+        memcpy(&testCdcRxData[testCdcRxLen], buffer, *length);
+        testCdcRxLen += *length;
+    }
+
+    USBD_CDC_RxPacket(&gUsbDeviceFS);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       WINUSB interface init
+ *
+ * @param       None
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_WinUsbItfInit(void)
+{
+    USBD_WINUSB_ConfigRxBuffer(&gUsbDeviceFS, testWinUsbRxBuffer);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       WINUSB control request
+ *
+ * @param       command: request
+ *
+ * @param       buffer: data stage
+ *
+ * @param       length: data stage length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_WinUsbItfCtrl(uint8_t command, uint8_t *buffer, uint16_t length)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       MSC number of the last logical unit
+ *
+ * @param       None
+ *
+ * @retval      Last logical unit
+ */
+static uint8_t Test_MscReadMaxLun(void)
+{
+    return 0;
+}
+
+/*!
+ * @brief       MSC memory init
+ *
+ * @param       lun: logical unit
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_MscInit(uint8_t lun)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       MSC memory capacity
+ *
+ * @param       lun: logical unit
+ *
+ * @param       blockNum: returns the number of blocks
+ *
+ * @param       blockSize: returns the block size
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_MscReadCapacity(uint8_t lun, uint32_t* blockNum, uint16_t* blockSize)
+{
+    *blockNum = TEST_MSC_BLOCK_NUM;
+    *blockSize = TEST_MSC_BLOCK_SIZE;
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       MSC memory ready or write protected
+ *
+ * @param       lun: logical unit
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_MscCheck(uint8_t lun)
+{
+    return USBD_OK;
+}
+
+/*!
+ * @brief       MSC memory read
+ *
+ * @param       lun: logical unit
+ *
+ * @param       buffer: returns the data
+ *
+ * @param       blockAddr: first block
+ *
+ * @param       blockLength: number of blocks
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_MscRead(uint8_t lun, uint8_t* buffer, uint32_t blockAddr, uint16_t blockLength)
+{
+    if ((blockAddr + blockLength) > TEST_MSC_BLOCK_NUM)
+    {
+        return USBD_FAIL;
+    }
+
+    memcpy(buffer, &testMscDisk[blockAddr * TEST_MSC_BLOCK_SIZE], blockLength * TEST_MSC_BLOCK_SIZE);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       MSC memory write
+ *
+ * @param       lun: logical unit
+ *
+ * @param       buffer: data
+ *
+ * @param       blockAddr: first block
+ *
+ * @param       blockLength: number of blocks
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T Test_MscWrite(uint8_t lun, uint8_t* buffer, uint32_t blockAddr, uint16_t blockLength)
+{
+    if ((blockAddr + blockLength) > TEST_MSC_BLOCK_NUM)
+    {
+        return USBD_FAIL;
+    }
+
+    memcpy(&testMscDisk[blockAddr * TEST_MSC_BLOCK_SIZE], buffer, blockLength * TEST_MSC_BLOCK_SIZE);
+
+    return USBD_OK;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+static USBD_CDC_INTERFACE_T testCdcItf =
+{
+    "Test CDC",
+    Test_CdcItfInit,
+    Test_CdcItfDeInit,
+    Test_CdcItfCtrl,
+    Test_ItfSend,
+    Test_CdcItfSendEnd,
+    Test_CdcItfReceive,
+};
+
+static USBD_WINUSB_INTERFACE_T testWinUsbItf =
+{
+    "Test WINUSB",
+    Test_WinUsbItfInit,
+    Test_CdcItfDeInit,
+    Test_WinUsbItfCtrl,
+    Test_ItfSend,
+    Test_ItfSendEnd,
+    Test_ItfReceive,
+};
+
+static USBD_MSC_MEMORY_T testMscMemory =
+{
+    "Test MSC",
+    testMscInquiry,
+    Test_MscReadMaxLun,
+    Test_MscInit,
+    Test_MscReadCapacity,
+    Test_MscCheck,
+    Test_MscCheck,
+    Test_MscRead,
+    Test_MscWrite,
+};
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @addtogroup USBD_HID_Host_Functions
+  @{
+  */
+
+/*!
+ * @brief       Register the CDC, MSC and WINUSB functions after the mouse
+ *
+ * @param       usbInfo: usb device information
+ *
+ * @retval      None
+ */
+void USB_DevClassRegister(USBD_INFO_T* usbInfo)
+{
+    TEST_CHECK(USBD_RegisterClass(usbInfo, &USBD_CDC_CLASS, testCdcDesc, sizeof(testCdcDesc), ENABLE) == USBD_OK, \
+               "CDC not registered");
+    TEST_CHECK(USBD_CDC_RegisterItf(usbInfo, &testCdcItf) == USBD_OK, "CDC interface not registered");
+
+    TEST_CHECK(USBD_RegisterClass(usbInfo, &USBD_MSC_CLASS, testMscDesc, sizeof(testMscDesc), DISABLE) == USBD_OK, \
+               "MSC not registered");
+    TEST_CHECK(USBD_MSC_RegisterMemory(usbInfo, &testMscMemory) == USBD_OK, "MSC memory not registered");
+
+    TEST_CHECK(USBD_RegisterClass(usbInfo, &USBD_WINUSB_CLASS, testWinUsbDesc, sizeof(testWinUsbDesc), \
+                                  DISABLE) == USBD_OK, "WINUSB not registered");
+    TEST_CHECK(USBD_WINUSB_RegisterItf(usbInfo, &testWinUsbItf) == USBD_OK, "WINUSB interface not registered");
+
+    /* The MS OS compatible ID request names no interface */
+    TEST_CHECK(USBD_ConfigDevReqClass(usbInfo, &USBD_WINUSB_CLASS) == USBD_OK, "WINUSB device requests");
+}
+
+/*!
+ * @brief       Check the composed configuration descriptor, an IAD groups
+ *              the CDC interfaces and the interfaces and endpoints of
+ *              every function are renumbered
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ComposedConfig(void)
+{
+    uint8_t* desc;
+    uint8_t* iad = NULL;
+    uint8_t itfClass[TEST_COMPOSITE_ITF_NUM];
+    uint8_t itfNum = 0;
+    uint8_t epIn = 0;
+    uint8_t epOut = 0;
+    uint16_t index;
+    uint8_t prev = 0;
+
+    memset(itfClass, 0xFF, sizeof(itfClass));
+
+    TEST_CHECK(gTestDev.config[4] == TEST_COMPOSITE_ITF_NUM, "bNumInterfaces %u", gTestDev.config[4]);
+
+    for (index = 0; (index + 1) < gTestDev.configLen; index += desc[0])
+    {
+        desc = &gTestDev.config[index];
+
+        if (desc[0] == 0)
+        {
+            break;
+        }
+
+        switch (desc[1])
+        {
+            case USBD_DESC_IAD:
+                iad = desc;
+                TEST_CHECK((desc[2] == TEST_CDC_ITF) && (desc[3] == 2) && (desc[4] == 0x02), \
+                           "IAD interfaces %u+%u class 0x%02X", desc[2], desc[3], desc[4]);
+                break;
+
+            case USBD_DESC_INTERFACE:
+                TEST_CHECK(desc[2] == itfNum, "interface %u, expected %u", desc[2], itfNum);
+
+                if (desc[2] < TEST_COMPOSITE_ITF_NUM)
+                {
+                    itfClass[desc[2]] = desc[5];
+                }
+
+                if (desc[2] == TEST_CDC_ITF)
+                {
+                    TEST_CHECK((iad != NULL) && (prev == USBD_DESC_IAD), "no IAD before the CDC interfaces");
+                }
+
+                itfNum++;
+                break;
+
+            case USBD_DESC_CS_INTERFACE:
+                if (desc[2] == 0x01)
+                {
+                    TEST_CHECK(desc[4] == TEST_CDC_ITF + 1, "call management data interface %u", desc[4]);
+                }
+                else if (desc[2] == 0x06)
+                {
+                    TEST_CHECK((desc[3] == TEST_CDC_ITF) && (desc[4] == TEST_CDC_ITF + 1), \
+                               "union interfaces %u %u", desc[3], desc[4]);
+                }
+                break;
+
+            case USBD_DESC_ENDPOINT:
+                /* An endpoint number serves one function per direction */
+                if (desc[2] & 0x80)
+                {
+                    TEST_CHECK((epIn & (1 << (desc[2] & 0x07))) == 0, "EP 0x%02X twice", desc[2]);
+                    epIn |= 1 << (desc[2] & 0x07);
+                }
+                else
+                {
+                    TEST_CHECK((epOut & (1 << (desc[2] & 0x07))) == 0, "EP 0x%02X twice", desc[2]);
+                    epOut |= 1 << (desc[2] & 0x07);
+                }
+
+                TEST_CHECK(((desc[2] & 0x0F) != 0) && ((desc[2] & 0x0F) < USBD_EP_MAX_NUM), \
+                           "EP 0x%02X out of range", desc[2]);
+                break;
+
+            default:
+                break;
+        }
+
+        prev = desc[1];
+    }
+
+    TEST_CHECK(itfNum == TEST_COMPOSITE_ITF_NUM, "%u interfaces", itfNum);
+    TEST_CHECK((itfClass[0] == 0x03) && (itfClass[TEST_CDC_ITF] == 0x02) && (itfClass[TEST_CDC_ITF + 1] == 0x0A) && \
+               (itfClass[TEST_MSC_ITF] == 0x08) && (itfClass[TEST_WINUSB_ITF] == 0xFF), \
+               "interface classes %02X %02X %02X %02X %02X", itfClass[0], itfClass[1], itfClass[2], \
+               itfClass[3], itfClass[4]);
+}
+
+/*!
+ * @brief       Enumerate the mouse composed with a CDC, a MSC and a
+ *              WINUSB function. The class requests reach the function of
+ *              the interface they name and the mouse reports through
+ *              its own class data whichever class served EP0 last.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_Composite(void)
+{
+    USBD_VHOST_STA_T status;
+    uint8_t line[USBD_CDC_DATA_MP_SIZE] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08};
+    uint8_t data[256];
+    uint16_t length;
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+
+    TEST_CHECK(gUsbDeviceFS.classNum == 4, "%u classes registered", gUsbDeviceFS.classNum);
+
+    Test_Enumerate();
+    Test_ComposedConfig();
+    TEST_CHECK(gTestDev.hidItfNum == 1, "%u HID interfaces", gTestDev.hidItfNum);
+
+    /* CDC line coding on the communication interface */
+    status = Test_Request(TEST_DEV_ADDR, 0x21, USBD_CDC_SET_LINE_CODING, 0, TEST_CDC_ITF, \
+                          sizeof(line), line, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "SET_LINE_CODING status %u", status);
+    TEST_CHECK(memcmp(testCdcLine, line, sizeof(line)) == 0, "line coding not set");
+
+    status = Test_Request(TEST_DEV_ADDR, 0xA1, USBD_CDC_GET_LINE_CODING, 0, TEST_CDC_ITF, \
+                          sizeof(line), data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == sizeof(line)) && (memcmp(data, line, sizeof(line)) == 0), \
+               "GET_LINE_CODING status %u length %u", status, length);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x21, USBD_CDC_SET_CONTROL_LINE_STATE, 0x0003, TEST_CDC_ITF, \
+                          0, NULL, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (testCdcCmd == USBD_CDC_SET_CONTROL_LINE_STATE), \
+               "SET_CONTROL_LINE_STATE status %u", status);
+
+    /* MSC class request */
+    status = Test_Request(TEST_DEV_ADDR, 0xA1, USBD_CLASS_GET_MAX_LUN, 0, TEST_MSC_ITF, 1, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == 1) && (data[0] == 0), "GET_MAX_LUN status %u", status);
+
+    /* The data interface belongs to the CDC function too */
+    testCdcCmd = 0xFF;
+    status = Test_Request(TEST_DEV_ADDR, 0xA1, USBD_CLASS_GET_MAX_LUN, 0, TEST_CDC_ITF + 1, 1, data, &length);
+    TEST_CHECK(testCdcCmd == USBD_CLASS_GET_MAX_LUN, "CDC data interface request not routed to CDC");
+
+    /* MS OS compatible ID to the device, extended properties to the
+       WINUSB interface */
+    status = Test_Request(TEST_DEV_ADDR, 0xC0, USBD_VEN_REQ_MS_CODE, 0, USBD_WINUSB_DESC_FEATURE, \
+                          USBD_WINUSB_OS_FEATURE_DESC_SIZE, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == USBD_WINUSB_OS_FEATURE_DESC_SIZE), \
+               "MS OS compatible ID status %u length %u", status, length);
+
+    status = Test_Request(TEST_DEV_ADDR, 0xC1, USBD_VEN_REQ_MS_CODE, TEST_WINUSB_ITF, USBD_WINUSB_DESC_PROPERTY, \
+                          USBD_WINUSB_OS_PROPERTY_DESC_SIZE, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == USBD_WINUSB_OS_PROPERTY_DESC_SIZE), \
+               "MS OS extended properties status %u length %u", status, length);
+
+    /* Interfaces without a class are stalled, the next request is served */
+    status = Test_Request(TEST_DEV_ADDR, 0x21, USBD_CLASS_SET_IDLE, 0, TEST_COMPOSITE_ITF_NUM, 0, NULL, &length);
+    TEST_CHECK(status == USBD_VHOST_STALL, "request to interface %u status %u", TEST_COMPOSITE_ITF_NUM, status);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x21, USBD_CLASS_SET_IDLE, 0, 0x40, 0, NULL, &length);
+    TEST_CHECK(status == USBD_VHOST_STALL, "request to interface 64 status %u", status);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_STATUS, 0, 0, 2, data, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "GET_STATUS after a stall status %u", status);
+
+    /* The WINUSB function served EP0 last, the mouse still reports */
+    status = Test_Request(TEST_DEV_ADDR, 0xC1, USBD_VEN_REQ_MS_CODE, TEST_WINUSB_ITF, USBD_WINUSB_DESC_PROPERTY, \
+                          USBD_WINUSB_OS_PROPERTY_DESC_SIZE, data, &length);
+    TEST_CHECK(gUsbDeviceFS.classID != 0, "class %u served EP0 last", gUsbDeviceFS.classID);
+
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 5, -5, 0) == USBD_OK, "mouse move");
+    TEST_CHECK(Test_PollIn(epNum, 10, data, &length) < 10, "no mouse report");
+}
+
+/*!
+ * @brief       Find a bulk endpoint of an interface
+ *
+ * @param       itf: interface number
+ *
+ * @param       dir: EP_DIR_IN or EP_DIR_OUT
+ *
+ * @retval      Endpoint number, 0 when there is none
+ */
+static uint8_t Test_FindBulkEP(uint8_t itf, uint8_t dir)
+{
+    uint8_t* desc;
+    uint16_t index;
+    uint8_t itfCur = 0xFF;
+
+    for (index = 0; (index + 1) < gTestDev.configLen; index += desc[0])
+    {
+        desc = &gTestDev.config[index];
+
+        if (desc[0] == 0)
+        {
+            break;
+        }
+
+        if (desc[1] == USBD_DESC_INTERFACE)
+        {
+            itfCur = desc[2];
+        }
+        else if ((desc[1] == USBD_DESC_ENDPOINT) && (itfCur == itf) && (desc[3] == EP_TYPE_BULK) && \
+                 (((desc[2] & 0x80) != 0) == (dir == EP_DIR_IN)))
+        {
+            return desc[2] & 0x0F;
+        }
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief       Bulk OUT transfer, a NAKed packet is sent again in the
+ *              next transaction
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       data: transfer data
+ *
+ * @param       length: transfer length
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_BulkOut(uint8_t epNum, const uint8_t* data, uint32_t length)
+{
+    USBD_MODEL_HS_T hs;
+    uint32_t offset = 0;
+    uint32_t retry = 0;
+    uint16_t size;
+
+    while (offset < length)
+    {
+        size = (uint16_t)(((length - offset) > TEST_BULK_MPS) ? TEST_BULK_MPS : (length - offset));
+
+        hs = USBD_VHost_Out(TEST_DEV_ADDR, epNum, gTestDev.epOutPid[epNum], &data[offset], size);
+
+        if (hs == USBD_MODEL_HS_ACK)
+        {
+            gTestDev.epOutPid[epNum] ^= 1;
+            offset += size;
+            retry = 0;
+        }
+        else if (hs == USBD_MODEL_HS_STALL)
+        {
+            return USBD_VHOST_STALL;
+        }
+        else if (++retry >= USBD_VHOST_RETRY_NUM)
+        {
+            return USBD_VHOST_TIMEOUT;
+        }
+    }
+
+    return USBD_VHOST_OK;
+}
+
+/*!
+ * @brief       Bulk IN transfer up to a short packet, a NAKed token is
+ *              sent again in the next transaction
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       data: returns the transfer data
+ *
+ * @param       length: transfer length the host asks for
+ *
+ * @param       rxLength: returns the length received
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_BulkIn(uint8_t epNum, uint8_t* data, uint32_t length, uint32_t* rxLength)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t packet[TEST_BULK_MPS];
+    uint32_t retry = 0;
+    uint16_t size;
+    uint8_t pid;
+
+    *rxLength = 0;
+
+    do
+    {
+        hs = USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, packet, &size);
+
+        if (hs == USBD_MODEL_HS_STALL)
+        {
+            return USBD_VHOST_STALL;
+        }
+
+        if (hs != USBD_MODEL_HS_ACK)
+        {
+            if (++retry >= USBD_VHOST_RETRY_NUM)
+            {
+                return USBD_VHOST_TIMEOUT;
+            }
+            continue;
+        }
+
+        if (pid != gTestDev.epInPid[epNum])
+        {
+            return USBD_VHOST_TOGGLE_ERR;
+        }
+
+        gTestDev.epInPid[epNum] ^= 1;
+        retry = 0;
+
+        if ((size > TEST_BULK_MPS) || ((*rxLength + size) > length))
+        {
+            return USBD_VHOST_TOGGLE_ERR;
+        }
+
+        memcpy(&data[*rxLength], packet, size);
+        *rxLength += size;
+    } while ((size == TEST_BULK_MPS) && (*rxLength < length));
+
+    return USBD_VHOST_OK;
+}
+
+/*!
+ * @brief       Fill the host data with a pattern
+ *
+ * @param       seed: pattern of the transfer
+ *
+ * @retval      None
+ */
+static void Test_BulkFill(uint8_t seed)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(testBulkTx); i++)
+    {
+        testBulkTx[i] = (uint8_t)(i * 7 + seed + (i >> 8));
+    }
+}
+
+/*!
+ * @brief       Print the throughput of a transfer
+ *
+ * @param       name: transfer name
+ *
+ * @param       length: transfer length
+ *
+ * @param       timeUs: bus time at the start
+ *
+ * @param       stat: traffic counters at the start
+ *
+ * @retval      None
+ */
+static void Test_BulkRate(const char* name, uint32_t length, uint32_t timeUs, const USBD_VHOST_STAT_T* stat)
+{
+    uint32_t us = USBD_VHost_ReadTimeUs() - timeUs;
+
+    printf("%-12s %5u bytes in %6u us, %4u KB/s, %4u transactions, %4u NAK\r\n", name, (unsigned)length, \
+           (unsigned)us, (unsigned)(us ? (length * 1000 / us) : 0), \
+           (unsigned)(gUsbVHostStat.xactCnt - stat->xactCnt), (unsigned)(gUsbVHostStat.nakCnt - stat->nakCnt));
+}
+
+/*!
+ * @brief       The MSC pipes have an endpoint number each and are double
+ *              buffered in two distinct PMA buffers. The CDC data pipes
+ *              share an endpoint register and stay single buffered.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_BulkBuffer(void)
+{
+    uint8_t itf[2] = {TEST_CDC_ITF + 1, TEST_MSC_ITF};
+    uint16_t bufferStatus[2] = {USBD_EP_BUFFER_SINGLE, USBD_EP_BUFFER_DOUBLE};
+    USBD_ENDPOINT_INFO_T* ep;
+    uint8_t epNum;
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        epNum = Test_FindBulkEP(itf[i], EP_DIR_IN);
+        ep = &usbDeviceHandler.epIN[epNum];
+        TEST_CHECK((epNum != 0) && (ep->bufferStatus == bufferStatus[i]), "interface %u IN EP %u buffer %u", \
+                   itf[i], epNum, ep->bufferStatus);
+        TEST_CHECK((ep->bufferStatus == USBD_EP_BUFFER_SINGLE) || (ep->pmaAddr0 != ep->pmaAddr1), \
+                   "interface %u IN EP %u buffers at 0x%03X", itf[i], epNum, ep->pmaAddr0);
+
+        epNum = Test_FindBulkEP(itf[i], EP_DIR_OUT);
+        ep = &usbDeviceHandler.epOUT[epNum];
+        TEST_CHECK((epNum != 0) && (ep->bufferStatus == bufferStatus[i]), "interface %u OUT EP %u buffer %u", \
+                   itf[i], epNum, ep->bufferStatus);
+        TEST_CHECK((ep->bufferStatus == USBD_EP_BUFFER_SINGLE) || (ep->pmaAddr0 != ep->pmaAddr1), \
+                   "interface %u OUT EP %u buffers at 0x%03X", itf[i], epNum, ep->pmaAddr0);
+    }
+}
+
+/*!
+ * @brief       CDC transfers of the sizes around the packet size through
+ *              the double buffered endpoints, each is sent once and the
+ *              endpoint NAKs after it
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_CdcBulk(void)
+{
+    static const uint16_t size[] = {1, 63, 64, 65, 127, 128, 129, 200, 1000, TEST_BULK_XFER_SIZE};
+    USBD_VHOST_STAT_T stat;
+    USBD_VHOST_STA_T status;
+    USBD_MODEL_HS_T hs;
+    uint8_t epIn = Test_FindBulkEP(TEST_CDC_ITF + 1, EP_DIR_IN);
+    uint8_t epOut = Test_FindBulkEP(TEST_CDC_ITF + 1, EP_DIR_OUT);
+    uint32_t sendEndCnt;
+    uint32_t timeUs;
+    uint32_t length;
+    uint16_t zlpLength;
+    uint8_t pid;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++)
+    {
+        Test_BulkFill(i);
+        sendEndCnt = testCdcSendEndCnt;
+        stat = gUsbVHostStat;
+        timeUs = USBD_VHost_ReadTimeUs();
+
+        TEST_CHECK((USBD_CDC_ConfigTxBuffer(&gUsbDeviceFS, testBulkTx, size[i]) == USBD_OK) && \
+                   (USBD_CDC_TxPacket(&gUsbDeviceFS) == USBD_OK), "CDC send of %u bytes", size[i]);
+
+        status = Test_BulkIn(epIn, testBulkRx, size[i], &length);
+        TEST_CHECK((status == USBD_VHOST_OK) && (length == size[i]) && (memcmp(testBulkRx, testBulkTx, length) == 0), \
+                   "CDC IN of %u bytes status %u length %u", size[i], status, (unsigned)length);
+
+        /* A transfer of whole packets ends with a zero length packet */
+        if ((size[i] % TEST_BULK_MPS) == 0)
+        {
+            status = Test_BulkIn(epIn, testBulkRx, TEST_BULK_MPS, &length);
+            TEST_CHECK((status == USBD_VHOST_OK) && (length == 0), "CDC IN of %u bytes, no zero length packet", \
+                       size[i]);
+        }
+
+        if (size[i] == TEST_BULK_XFER_SIZE)
+        {
+            Test_BulkRate("CDC IN", size[i], timeUs, &stat);
+            TEST_CHECK(gUsbVHostStat.nakCnt == stat.nakCnt, "CDC IN of %u bytes NAKed %u times", size[i], \
+                       (unsigned)(gUsbVHostStat.nakCnt - stat.nakCnt));
+        }
+
+        hs = USBD_VHost_In(TEST_DEV_ADDR, epIn, &pid, testBulkRx, &zlpLength);
+        TEST_CHECK(hs == USBD_MODEL_HS_NAK, "CDC IN of %u bytes, handshake %u after it", size[i], hs);
+        TEST_CHECK(testCdcSendEndCnt == sendEndCnt + 1, "CDC IN of %u bytes ended %u times", size[i], \
+                   (unsigned)(testCdcSendEndCnt - sendEndCnt));
+    }
+
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++)
+    {
+        Test_BulkFill(i + 0x80);
+        testCdcRxLen = 0;
+        stat = gUsbVHostStat;
+        timeUs = USBD_VHost_ReadTimeUs();
+
+        status = Test_BulkOut(epOut, testBulkTx, size[i]);
+        TEST_CHECK((status == USBD_VHOST_OK) && (testCdcRxLen == size[i]) && \
+                   (memcmp(testCdcRxData, testBulkTx, size[i]) == 0), \
+                   "CDC OUT of %u bytes status %u, %u bytes received", size[i], status, (unsigned)testCdcRxLen);
+
+        if (size[i] == TEST_BULK_XFER_SIZE)
+        {
+            Test_BulkRate("CDC OUT", size[i], timeUs, &stat);
+        }
+    }
+}
+
+/*!
+ * @brief       MSC command of the bulk only transport
+ *
+ * @param       cb: command block
+ *
+ * @param       cbLen: command block length
+ *
+ * @param       dir: EP_DIR_IN or EP_DIR_OUT
+ *
+ * @param       data: data stage
+ *
+ * @param       length: data stage length
+ *
+ * @retval      Status of the CSW, 0xFF when the transport failed
+ */
+static uint8_t Test_MscCommand(const uint8_t* cb, uint8_t cbLen, uint8_t dir, uint8_t* data, uint32_t length)
+{
+    static uint32_t tag = 0x1000;
+    USBD_VHOST_STA_T status;
+    uint8_t epIn = Test_FindBulkEP(TEST_MSC_ITF, EP_DIR_IN);
+    uint8_t epOut = Test_FindBulkEP(TEST_MSC_ITF, EP_DIR_OUT);
+    uint8_t cbw[TEST_MSC_CBW_LEN] = {0x55, 0x53, 0x42, 0x43};
+    uint8_t csw[TEST_MSC_CSW_LEN];
+    uint32_t rxLength;
+
+    tag++;
+    memcpy(&cbw[4], &tag, 4);
+    memcpy(&cbw[8], &length, 4);
+    cbw[12] = (dir == EP_DIR_IN) ? 0x80 : 0x00;
+    cbw[14] = cbLen;
+    memcpy(&cbw[15], cb, cbLen);
+
+    status = Test_BulkOut(epOut, cbw, sizeof(cbw));
+    TEST_CHECK(status == USBD_VHOST_OK, "CBW 0x%02X status %u", cb[0], status);
+
+    if (length != 0)
+    {
+        if (dir == EP_DIR_IN)
+        {
+            status = Test_BulkIn(epIn, data, length, &rxLength);
+            TEST_CHECK((status == USBD_VHOST_OK) && (rxLength == length), "SCSI 0x%02X IN status %u, %u of %u bytes", \
+                       cb[0], status, (unsigned)rxLength, (unsigned)length);
+        }
+        else
+        {
+            status = Test_BulkOut(epOut, data, length);
+            TEST_CHECK(status == USBD_VHOST_OK, "SCSI 0x%02X OUT status %u", cb[0], status);
+        }
+    }
+
+    status = Test_BulkIn(epIn, csw, sizeof(csw), &rxLength);
+
+    if ((status != USBD_VHOST_OK) || (rxLength != sizeof(csw)) || (memcmp(csw, "USBS", 4) != 0) || \
+        (memcmp(&csw[4], &tag, 4) != 0))
+    {
+        TEST_CHECK(0, "CSW of 0x%02X status %u length %u", cb[0], status, (unsigned)rxLength);
+        return 0xFF;
+    }
+
+    return csw[12];
+}
+
+/*!
+ * @brief       MSC write and read of the RAM disk through the double
+ *              buffered endpoints
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_MscBulk(void)
+{
+    const uint16_t blockNum = TEST_BULK_XFER_SIZE / TEST_MSC_BLOCK_SIZE;
+    const uint32_t lba = 4;
+    uint8_t capacity[] = {0x25, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    uint8_t write[] = {0x2A, 0, 0, 0, 0, lba, 0, 0, blockNum, 0};
+    uint8_t read[] = {0x28, 0, 0, 0, 0, lba, 0, 0, blockNum, 0};
+    USBD_VHOST_STAT_T stat;
+    uint32_t timeUs;
+    uint8_t csw;
+
+    /* The capacity is read before any access as a host does */
+    csw = Test_MscCommand(capacity, sizeof(capacity), EP_DIR_IN, testBulkRx, 8);
+    TEST_CHECK((csw == 0) && (testBulkRx[3] == TEST_MSC_BLOCK_NUM - 1) && \
+               (((testBulkRx[6] << 8) | testBulkRx[7]) == TEST_MSC_BLOCK_SIZE), \
+               "READ CAPACITY status %u last block %u", csw, testBulkRx[3]);
+
+    Test_BulkFill(0x5A);
+    stat = gUsbVHostStat;
+    timeUs = USBD_VHost_ReadTimeUs();
+
+    csw = Test_MscCommand(write, sizeof(write), EP_DIR_OUT, testBulkTx, TEST_BULK_XFER_SIZE);
+    Test_BulkRate("MSC WRITE", TEST_BULK_XFER_SIZE, timeUs, &stat);
+    TEST_CHECK((csw == 0) && (memcmp(&testMscDisk[lba * TEST_MSC_BLOCK_SIZE], testBulkTx, TEST_BULK_XFER_SIZE) == 0), \
+               "WRITE(10) status %u", csw);
+
+    memset(testBulkRx, 0, sizeof(testBulkRx));
+    stat = gUsbVHostStat;
+    timeUs = USBD_VHost_ReadTimeUs();
+
+    csw = Test_MscCommand(read, sizeof(read), EP_DIR_IN, testBulkRx, TEST_BULK_XFER_SIZE);
+    Test_BulkRate("MSC READ", TEST_BULK_XFER_SIZE, timeUs, &stat);
+    TEST_CHECK((csw == 0) && (memcmp(testBulkRx, testBulkTx, TEST_BULK_XFER_SIZE) == 0), "READ(10) status %u", csw);
+}
+
+/*!
+ * @brief       Double buffered IN transfers that end in either buffer
+ *              with no transfer after them. The idle MSC function
+ *              ignores their end, the endpoint NAKs after the last
+ *              packet.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_BulkEnd(void)
+{
+    static const uint16_t size[] = {130, 200};
+    USBD_VHOST_STA_T status;
+    USBD_MODEL_HS_T hs;
+    uint8_t epIn = Test_FindBulkEP(TEST_MSC_ITF, EP_DIR_IN);
+    uint32_t length;
+    uint16_t nakLength;
+    uint8_t pid;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++)
+    {
+        Test_BulkFill(i + 0x40);
+        USBD_EP_Transfer(&usbDeviceHandler, epIn | 0x80, testBulkTx, size[i]);
+
+        status = Test_BulkIn(epIn, testBulkRx, size[i], &length);
+        TEST_CHECK((status == USBD_VHOST_OK) && (length == size[i]) && (memcmp(testBulkRx, testBulkTx, length) == 0), \
+                   "IN of %u bytes status %u length %u", size[i], status, (unsigned)length);
+
+        hs = USBD_VHost_In(TEST_DEV_ADDR, epIn, &pid, testBulkRx, &nakLength);
+        TEST_CHECK(hs == USBD_MODEL_HS_NAK, "IN of %u bytes, handshake %u after it", size[i], hs);
+    }
+}
+
+/*!
+ * @brief       Bulk transfers of the CDC and the MSC functions through
+ *              the double buffered endpoints and their throughput
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_CompositeBulk(void)
+{
+    Test_Enumerate();
+
+    Test_BulkBuffer();
+    Test_CdcBulk();
+    Test_MscBulk();
+    Test_BulkEnd();
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,203 @@
+/*!
+ * @file        usbd_event_test.c
+ *
+ * @brief       Order and overflow of the USB events deferred by the
+ *              interrupt
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Read the events waiting in the queue
+ *
+ * @param       None
+ *
+ * @retval      Queued events
+ */
+static uint8_t Test_EventCount(void)
+{
+    return (uint8_t)(usbDeviceHandler.eventHead - usbDeviceHandler.eventTail);
+}
+
+/*!
+ * @brief       The host takes a report and suspends the bus before the
+ *              main loop runs. The ACK is serviced before the suspend,
+ *              the HID class is idle again after the resume.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_EventOrder(void)
+{
+#if USBD_SUP_DEFER_ISR
+    USBD_MODEL_HS_T hs;
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint32_t ackTime;
+    uint8_t pid;
+
+    Test_Enumerate();
+
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 5, 5, 0) == USBD_OK, "mouse move");
+    USBD_VHost_Frame();
+
+    USBD_VHost_HoldEvents(1);
+
+    hs = USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, &length);
+    TEST_CHECK(hs == USBD_MODEL_HS_ACK, "report handshake %u", hs);
+    gTestDev.epInPid[epNum] ^= 1;
+    ackTime = USBD_VHost_ReadTimeUs();
+
+    USBD_VHost_Suspend(2);
+
+    /* Nothing was serviced by the interrupt */
+    TEST_CHECK(Test_EventCount() == 2, "%u events queued", Test_EventCount());
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u before the main loop", \
+               gUsbDeviceFS.devState);
+#if USBD_SUP_LATENCY
+    /* The ACK is stamped when the interrupt took it */
+    TEST_CHECK(usbDeviceHandler.event[usbDeviceHandler.eventTail & (USBD_EVENT_QUEUE_SIZE - 1)].time == ackTime, \
+               "ACK stamped at %u us, taken at %u us", \
+               (unsigned)usbDeviceHandler.event[usbDeviceHandler.eventTail & (USBD_EVENT_QUEUE_SIZE - 1)].time, \
+               (unsigned)ackTime);
+#endif
+
+    USBD_VHost_HoldEvents(0);
+    USBD_VHost_RunDevice();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+    TEST_CHECK((SCB->SCR & SCB_SCR_SLEEPONEXIT_Msk) == 0, "sleep on exit from the main loop");
+
+    /* A resume and a SETUP queued together are serviced in order */
+    USBD_VHost_HoldEvents(1);
+    USBD_VHost_Resume();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u before the main loop", \
+               gUsbDeviceFS.devState);
+    USBD_VHost_HoldEvents(0);
+    USBD_VHost_RunDevice();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after resume", gUsbDeviceFS.devState);
+
+    /* The class took the ACK before the suspend, the next move is sent */
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, -5, -5, 0) == USBD_OK, "mouse move after resume");
+    TEST_CHECK(Test_PollIn(epNum, 10, data, &length) < 10, "no report after resume");
+#else
+    printf("Events are not deferred\r\n");
+#endif
+}
+
+/*!
+ * @brief       SETUPs fill the queue while the main loop is held. The
+ *              endpoint is left to NAK, the suspend still finds room and
+ *              the held SETUP is serviced once the queue drained.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_EventFull(void)
+{
+#if USBD_SUP_DEFER_ISR
+    USBD_MODEL_HS_T hs;
+    uint8_t setup[8] = {0x80, USBD_STD_GET_STATUS, 0, 0, 0, 0, 2, 0};
+    uint8_t data[64];
+    uint16_t length;
+    uint16_t ackCnt = 0;
+    uint8_t ep0State;
+    uint8_t i;
+
+    Test_Enumerate();
+
+    USBD_VHost_HoldEvents(1);
+    ep0State = gUsbDeviceFS.devEp0State;
+
+    for (i = 0; i < USBD_EVENT_QUEUE_SIZE + 8; i++)
+    {
+        hs = USBD_VHost_Setup(TEST_DEV_ADDR, setup);
+
+        if (hs == USBD_MODEL_HS_ACK)
+        {
+            ackCnt++;
+        }
+    }
+
+    /* The last SETUP taken waits unacknowledged in the endpoint */
+    TEST_CHECK(ackCnt == USBD_EVENT_QUEUE_SIZE - USBD_EVENT_BUS_RESERVE + 1, "%u SETUPs taken", ackCnt);
+    TEST_CHECK(Test_EventCount() == USBD_EVENT_QUEUE_SIZE - USBD_EVENT_BUS_RESERVE, "%u events queued", \
+               Test_EventCount());
+    TEST_CHECK(usbDeviceHandler.eventOvf == 1, "%u overflows", usbDeviceHandler.eventOvf);
+    TEST_CHECK((usbDeviceHandler.usbGlobal->CTRL & USBD_INT_CTR) == 0, "CTR interrupt not masked");
+    TEST_CHECK(gUsbDeviceFS.devEp0State == ep0State, "SETUP serviced by the interrupt");
+
+    USBD_VHost_Suspend(0);
+    TEST_CHECK(Test_EventCount() == USBD_EVENT_QUEUE_SIZE - USBD_EVENT_BUS_RESERVE + 1, \
+               "suspend not queued, %u events", Test_EventCount());
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "suspend serviced by the interrupt");
+
+    USBD_VHost_HoldEvents(0);
+    USBD_VHost_RunDevice();
+    TEST_CHECK(Test_EventCount() == 0, "%u events left", Test_EventCount());
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+    TEST_CHECK(usbDeviceHandler.usbGlobal->CTRL & USBD_INT_CTR, "CTR interrupt still masked");
+    TEST_CHECK(usbDeviceHandler.eventMax == USBD_EVENT_QUEUE_SIZE - USBD_EVENT_BUS_RESERVE + 1, \
+               "%u events queued at most", usbDeviceHandler.eventMax);
+
+    USBD_VHost_Resume();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after resume", gUsbDeviceFS.devState);
+
+    /* Control transfers run again */
+    TEST_CHECK(Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_STATUS, 0, 0, 2, data, &length) == USBD_VHOST_OK, \
+               "GET_STATUS after the overflow");
+    TEST_CHECK(usbDeviceHandler.eventOvf == 1, "%u overflows", usbDeviceHandler.eventOvf);
+#else
+    printf("Events are not deferred\r\n");
+#endif
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,173 @@
+/*!
+ * @file        usbd_format_test.c
+ *
+ * @brief       Report formats of the mouse and their device mode
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "host_stub.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Set the feature report of the mouse interface
+ *
+ * @param       feature: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_SetFeature(uint8_t* feature, uint16_t length)
+{
+    uint16_t xferLen;
+
+    return Test_Request(TEST_DEV_ADDR, 0x21, USBD_CLASS_SET_REPORT, USBD_HID_REPORT_TYPE_FEATURE << 8, \
+                        gTestDev.hidItf[0], length, feature, &xferLen);
+}
+
+/*!
+ * @brief       Read the feature report of the mouse interface
+ *
+ * @param       feature: returns the feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_GetFeature(uint8_t* feature, uint16_t length)
+{
+    uint16_t xferLen;
+
+    return Test_Request(TEST_DEV_ADDR, 0xA1, USBD_CLASS_GET_REPORT, USBD_HID_REPORT_TYPE_FEATURE << 8, \
+                        gTestDev.hidItf[0], length, feature, &xferLen);
+}
+
+/*!
+ * @brief       Read the report descriptor of the mouse interface
+ *
+ * @param       None
+ *
+ * @retval      Descriptor length
+ */
+static uint16_t Test_ReadReportDesc(void)
+{
+    USBD_VHOST_STA_T status;
+    uint8_t data[256];
+    uint16_t length;
+
+    status = Test_Request(TEST_DEV_ADDR, 0x81, USBD_STD_GET_DESCRIPTOR, USBD_DESC_HID_REPORT << 8, \
+                          gTestDev.hidItf[0], sizeof(data), data, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "report descriptor status %u", status);
+
+    return length;
+}
+
+/*!
+ * @brief       The format is latched by the configuration. Reading the
+ *              report descriptor changes nothing, the device mode the
+ *              host sets is served after a re-enumeration and a mode
+ *              without a collection is stalled.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_DeviceMode(void)
+{
+    uint8_t feature[2];
+    uint16_t hiresLen;
+    uint8_t mps0;
+
+    USBD_HID_ConfigReportFormat(USBD_HID_FORMAT_HIRES);
+    Test_Enumerate();
+    TEST_CHECK(USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_HIRES, "format %u", \
+               USBD_HID_ReadReportFormat(&gUsbDeviceFS));
+    hiresLen = gTestDev.hidReportLen[0];
+
+    /* Resolution multiplier and mouse mode */
+    feature[0] = USBD_HID_RES_MUL_WHEEL;
+    feature[1] = USBD_HID_DEVICE_MODE_MOUSE;
+    TEST_CHECK(Test_SetFeature(feature, 2) == USBD_VHOST_OK, "SET_REPORT mouse mode");
+    TEST_CHECK(USBD_HID_ReadFormatChange(&gUsbDeviceFS) == 0, "mouse mode changes the format");
+
+    /* The report descriptor has no side effect on the multiplier */
+    TEST_CHECK(Test_ReadReportDesc() == hiresLen, "report descriptor length");
+    memset(feature, 0xFF, sizeof(feature));
+    TEST_CHECK((Test_GetFeature(feature, 2) == USBD_VHOST_OK) && (feature[0] == USBD_HID_RES_MUL_WHEEL) && \
+               (feature[1] == USBD_HID_DEVICE_MODE_MOUSE), "feature %02X %02X", feature[0], feature[1]);
+
+    /* No multi-input collection */
+    feature[1] = USBD_HID_DEVICE_MODE_MULTI;
+    TEST_CHECK(Test_SetFeature(feature, 2) == USBD_VHOST_STALL, "multi-input mode not stalled");
+    TEST_CHECK(USBD_HID_ReadFormatChange(&gUsbDeviceFS) == 0, "multi-input mode changes the format");
+
+    /* Single-input mode, the configured format is kept until the device
+       re-enumerates */
+    feature[1] = USBD_HID_DEVICE_MODE_SINGLE;
+    TEST_CHECK(Test_SetFeature(feature, 2) == USBD_VHOST_OK, "SET_REPORT single-input mode");
+    TEST_CHECK(USBD_HID_ReadFormatChange(&gUsbDeviceFS) == 1, "no format change");
+    TEST_CHECK(USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_HIRES, "format changed before a " \
+               "re-enumeration");
+    TEST_CHECK(Test_ReadReportDesc() == hiresLen, "report descriptor changed before a re-enumeration");
+    TEST_CHECK((Test_GetFeature(feature, 2) == USBD_VHOST_OK) && (feature[1] == USBD_HID_DEVICE_MODE_SINGLE), \
+               "device mode %u", feature[1]);
+
+    USB_DevFormatProc();
+    TEST_CHECK(gHostCore.detachMs >= USBD_DETACH_TIME, "detached %u ms", (unsigned)gHostCore.detachMs);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_DEFAULT, "state %u after the detach", gUsbDeviceFS.devState);
+
+    /* The host enumerates the digitizer */
+    mps0 = gTestDev.mps0;
+    memset(&gTestDev, 0, sizeof(gTestDev));
+    gTestDev.mps0 = mps0;
+
+    Test_Enumerate();
+    TEST_CHECK(USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_DIGITIZER, "format %u after the " \
+               "re-enumeration", USBD_HID_ReadReportFormat(&gUsbDeviceFS));
+    TEST_CHECK((gTestDev.hidReportLen[0] != hiresLen) && (Test_ReadReportDesc() == gTestDev.hidReportLen[0]), \
+               "digitizer report descriptor of %u bytes", gTestDev.hidReportLen[0]);
+
+    /* Back to the mouse */
+    feature[0] = USBD_HID_DEVICE_MODE_MOUSE;
+    TEST_CHECK(Test_SetFeature(feature, 1) == USBD_VHOST_OK, "SET_REPORT mouse mode");
+    TEST_CHECK(USBD_HID_ReadFormatChange(&gUsbDeviceFS) == 1, "no format change");
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
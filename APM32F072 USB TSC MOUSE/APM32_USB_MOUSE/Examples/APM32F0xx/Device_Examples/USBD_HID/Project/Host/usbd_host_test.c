@@ -0,0 +1,628 @@
+/*!
+ * @file        usbd_host_test.c
+ *
+ * @brief       Scripted enumeration and HID polling of the example by the
+ *              virtual host, and the test selection
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "host_stub.h"
+#include "usb_device_user.h"
+#include "usbd_descriptor.h"
+#include "usbd_hid.h"
+#if HOST_SUP_TSC
+#include "tsc_model.h"
+#include "board_apm32f072_eval.h"
+#endif
+#include <stdio.h>
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+TEST_DEV_T gTestDev;
+uint32_t gTestFailCnt;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Control transfer to the device
+ *
+ * @param       addr: device address
+ *
+ * @param       bmRequestType: request type
+ *
+ * @param       bRequest: request
+ *
+ * @param       wValue: request value
+ *
+ * @param       wIndex: request index
+ *
+ * @param       wLength: data stage length
+ *
+ * @param       data: data stage
+ *
+ * @param       length: returns the data stage length
+ *
+ * @retval      Transfer status
+ */
+USBD_VHOST_STA_T Test_Request(uint8_t addr, uint8_t bmRequestType, uint8_t bRequest, \
+                              uint16_t wValue, uint16_t wIndex, uint16_t wLength, \
+                              uint8_t* data, uint16_t* length)
+{
+    uint8_t setup[8];
+
+    setup[0] = bmRequestType;
+    setup[1] = bRequest;
+    setup[2] = (uint8_t)wValue;
+    setup[3] = (uint8_t)(wValue >> 8);
+    setup[4] = (uint8_t)wIndex;
+    setup[5] = (uint8_t)(wIndex >> 8);
+    setup[6] = (uint8_t)wLength;
+    setup[7] = (uint8_t)(wLength >> 8);
+
+    return USBD_VHost_Control(addr, gTestDev.mps0, setup, data, length);
+}
+
+/*!
+ * @brief       Read a descriptor and compare it with the descriptor
+ *              table of the device
+ *
+ * @param       type: descriptor type
+ *
+ * @param       index: descriptor index
+ *
+ * @param       expect: descriptor of the device, NULL to not compare
+ *
+ * @param       data: returns the descriptor
+ *
+ * @retval      Descriptor length
+ */
+static uint16_t Test_ReadDesc(uint8_t type, uint8_t index, const USBD_DESC_INFO_T* expect, uint8_t* data)
+{
+    USBD_VHOST_STA_T status;
+    uint16_t wIndex = (type == USBD_DESC_STRING) && (index != 0) ? 0x0409 : 0;
+    uint16_t length;
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_DESCRIPTOR, (uint16_t)((type << 8) | index), \
+                          wIndex, 255, data, &length);
+
+    TEST_CHECK(status == USBD_VHOST_OK, "GET_DESCRIPTOR 0x%02X %u status %u", type, index, status);
+
+    if (status != USBD_VHOST_OK)
+    {
+        return 0;
+    }
+
+    TEST_CHECK((length >= 2) && (data[1] == type), "descriptor 0x%02X %u type 0x%02X", type, index, data[1]);
+
+    if (expect != NULL)
+    {
+        TEST_CHECK((length == expect->size) && (memcmp(data, expect->desc, length) == 0), \
+                   "descriptor 0x%02X %u differs, %u of %u bytes", type, index, length, expect->size);
+    }
+
+    return length;
+}
+
+/*!
+ * @brief       Walk the configuration descriptor
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ParseConfig(void)
+{
+    uint8_t* desc;
+    uint16_t index;
+    uint8_t itf = 0xFF;
+
+    for (index = 0; (index + 1) < gTestDev.configLen; index += desc[0])
+    {
+        desc = &gTestDev.config[index];
+
+        if (desc[0] == 0)
+        {
+            break;
+        }
+
+        switch (desc[1])
+        {
+            case USBD_DESC_INTERFACE:
+                itf = 0xFF;
+
+                if ((desc[5] == 0x03) && (gTestDev.hidItfNum < 2))
+                {
+                    itf = gTestDev.hidItfNum++;
+                    gTestDev.hidItf[itf] = desc[2];
+                }
+                break;
+
+            case USBD_DESC_HID:
+                if (itf != 0xFF)
+                {
+                    gTestDev.hidReportLen[itf] = (uint16_t)(desc[7] | (desc[8] << 8));
+                }
+                break;
+
+            case USBD_DESC_ENDPOINT:
+                if (desc[2] & 0x80)
+                {
+                    gTestDev.epInInterval[desc[2] & 0x0F] = desc[6];
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+/*!
+ * @brief       Enumerate the device as a host does
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_Enumerate(void)
+{
+    USBD_DESC_INFO_T descInfo;
+    USBD_VHOST_STA_T status;
+    uint8_t data[256];
+    uint16_t length;
+    uint8_t i;
+
+    TEST_CHECK(USBD_Model_ReadPullUp(), "no D+ pull up");
+
+    USBD_VHost_BusReset();
+
+    /* Packet size of the endpoint 0 from the first 8 bytes */
+    gTestDev.mps0 = 64;
+    status = Test_Request(0, 0x80, USBD_STD_GET_DESCRIPTOR, USBD_DESC_DEVICE << 8, 0, 8, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == 8), "device descriptor status %u length %u", status, length);
+    gTestDev.mps0 = data[7];
+    TEST_CHECK((gTestDev.mps0 == 8) || (gTestDev.mps0 == 16) || (gTestDev.mps0 == 32) || (gTestDev.mps0 == 64), \
+               "bMaxPacketSize0 %u", gTestDev.mps0);
+
+    USBD_VHost_BusReset();
+
+    status = Test_Request(0, 0x00, USBD_STD_SET_ADDRESS, TEST_DEV_ADDR, 0, 0, NULL, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "SET_ADDRESS status %u", status);
+
+    /* 2 ms to take the new address */
+    USBD_VHost_Frame();
+    USBD_VHost_Frame();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_ADDRESS, "state %u after SET_ADDRESS", gUsbDeviceFS.devState);
+
+    descInfo = USBD_DESC_FS.deviceDescHandler(USBD_SPEED_FS);
+    Test_ReadDesc(USBD_DESC_DEVICE, 0, &descInfo, data);
+
+    /* Configuration header, then the whole configuration */
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_DESCRIPTOR, USBD_DESC_CONFIGURATION << 8, 0, 9, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == 9), "configuration header status %u length %u", status, length);
+
+    gTestDev.configLen = (uint16_t)(data[2] | (data[3] << 8));
+    TEST_CHECK(gTestDev.configLen <= sizeof(gTestDev.config), "wTotalLength %u", gTestDev.configLen);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_DESCRIPTOR, USBD_DESC_CONFIGURATION << 8, 0, \
+                          gTestDev.configLen, gTestDev.config, &length);
+    descInfo = USBD_DESC_FS.configDescHandler(USBD_SPEED_FS);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == gTestDev.configLen) && (length == descInfo.size) && \
+               (memcmp(gTestDev.config, descInfo.desc, length) == 0), \
+               "configuration status %u, %u of %u bytes", status, length, descInfo.size);
+
+    Test_ParseConfig();
+    TEST_CHECK(gTestDev.hidItfNum != 0, "no HID interface");
+
+#if USBD_SUP_LPM
+    /* LPM is advertised by a BOS descriptor with bcdUSB 2.01 */
+    descInfo = USBD_DESC_FS.deviceDescHandler(USBD_SPEED_FS);
+    TEST_CHECK((descInfo.desc[2] | (descInfo.desc[3] << 8)) >= 0x0201, "bcdUSB 0x%04X", \
+               descInfo.desc[2] | (descInfo.desc[3] << 8));
+    descInfo = USBD_DESC_FS.bosDescHandler(USBD_SPEED_FS);
+    Test_ReadDesc(USBD_DESC_BOS, 0, &descInfo, data);
+#endif
+
+    /* Language and the strings of the device descriptor */
+    descInfo = USBD_DESC_FS.langIdStrDescHandler(USBD_SPEED_FS);
+    Test_ReadDesc(USBD_DESC_STRING, 0, &descInfo, data);
+
+    descInfo = USBD_DESC_FS.deviceDescHandler(USBD_SPEED_FS);
+
+    for (i = 14; i < 17; i++)
+    {
+        if (descInfo.desc[i] != 0)
+        {
+            length = Test_ReadDesc(USBD_DESC_STRING, descInfo.desc[i], NULL, data);
+            TEST_CHECK((length > 2) && (length == data[0]), "string %u length %u", descInfo.desc[i], length);
+        }
+    }
+
+    /* Configure */
+    status = Test_Request(TEST_DEV_ADDR, 0x00, USBD_STD_SET_CONFIGURATION, gTestDev.config[5], 0, 0, NULL, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "SET_CONFIGURATION status %u", status);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after SET_CONFIGURATION", gUsbDeviceFS.devState);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_CONFIGURATION, 0, 0, 1, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == 1) && (data[0] == gTestDev.config[5]), \
+               "GET_CONFIGURATION status %u value %u", status, data[0]);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_STATUS, 0, 0, 2, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) && (length == 2), "GET_STATUS status %u length %u", status, length);
+
+    /* HID class requests of a HID driver */
+    for (i = 0; i < gTestDev.hidItfNum; i++)
+    {
+        status = Test_Request(TEST_DEV_ADDR, 0x21, USBD_CLASS_SET_IDLE, 0, gTestDev.hidItf[i], 0, NULL, &length);
+        TEST_CHECK((status == USBD_VHOST_OK) || (status == USBD_VHOST_STALL), "SET_IDLE %u status %u", \
+                   gTestDev.hidItf[i], status);
+
+        status = Test_Request(TEST_DEV_ADDR, 0x81, USBD_STD_GET_DESCRIPTOR, USBD_DESC_HID_REPORT << 8, \
+                              gTestDev.hidItf[i], gTestDev.hidReportLen[i], data, &length);
+        TEST_CHECK((status == USBD_VHOST_OK) && (length == gTestDev.hidReportLen[i]), \
+                   "report descriptor %u status %u, %u of %u bytes", gTestDev.hidItf[i], status, length, \
+                   gTestDev.hidReportLen[i]);
+    }
+
+    /* An unsupported request is stalled and the next one is served */
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_DESCRIPTOR, USBD_DESC_DEVICE_QUALIFIER << 8, \
+                          0, 10, data, &length);
+    TEST_CHECK((status == USBD_VHOST_OK) || (status == USBD_VHOST_STALL), "DEVICE_QUALIFIER status %u", status);
+
+    status = Test_Request(TEST_DEV_ADDR, 0x80, USBD_STD_GET_STATUS, 0, 0, 2, data, &length);
+    TEST_CHECK(status == USBD_VHOST_OK, "GET_STATUS after a stall status %u", status);
+}
+
+/*!
+ * @brief       Poll an interrupt IN endpoint until it sends a report
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       frames: frames to poll
+ *
+ * @param       data: returns the report
+ *
+ * @param       length: returns the report length
+ *
+ * @retval      Frames until the report, frames when none was sent
+ */
+uint32_t Test_PollIn(uint8_t epNum, uint32_t frames, uint8_t* data, uint16_t* length)
+{
+    USBD_MODEL_HS_T hs;
+    uint32_t frame;
+    uint8_t interval = gTestDev.epInInterval[epNum] ? gTestDev.epInInterval[epNum] : 1;
+    uint8_t pid;
+
+    *length = 0;
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        USBD_VHost_Frame();
+
+        if ((gUsbVHostStat.frame % interval) != 0)
+        {
+            continue;
+        }
+
+        hs = USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, length);
+
+        if (hs == USBD_MODEL_HS_ACK)
+        {
+            TEST_CHECK(pid == gTestDev.epInPid[epNum], "EP 0x%02X DATA%u, expected DATA%u", \
+                       epNum | 0x80, pid, gTestDev.epInPid[epNum]);
+            gTestDev.epInPid[epNum] ^= 1;
+            return frame;
+        }
+
+        TEST_CHECK(hs == USBD_MODEL_HS_NAK, "EP 0x%02X handshake %u", epNum | 0x80, hs);
+    }
+
+    return frames;
+}
+
+/*!
+ * @brief       Poll the mouse endpoint as the HID driver of a host does
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_HidPoll(void)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint32_t frames;
+    uint8_t i;
+
+    /* No report without an input */
+    frames = Test_PollIn(epNum, 20, data, &length);
+    TEST_CHECK(frames == 20, "report of %u bytes without an input", length);
+
+    /* Every move is reported in the next polling interval */
+    for (i = 0; i < 4; i++)
+    {
+        TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 10, -4, 0) == USBD_OK, "mouse move %u", i);
+
+        frames = Test_PollIn(epNum, 10, data, &length);
+        TEST_CHECK(frames < (uint32_t)(gTestDev.epInInterval[epNum] + 2), "move %u reported after %u frames", \
+                   i, frames);
+#if (USBD_HID_REPORT_FORMAT == USBD_HID_FORMAT_COMPOSITE)
+        TEST_CHECK((length != 0) && (data[0] == USBD_HID_REPORT_ID_MOUSE), "move %u report ID 0x%02X", \
+                   i, length ? data[0] : 0);
+#endif
+    }
+
+    /* A move queued while a report is on the bus follows it */
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 1, 0, 0) == USBD_OK, "mouse move");
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x01) == USBD_OK, "mouse button");
+
+    for (i = 0; i < 2; i++)
+    {
+        frames = Test_PollIn(epNum, 10, data, &length);
+        TEST_CHECK(frames < 10, "queued report %u not sent", i);
+    }
+
+    frames = Test_PollIn(epNum, 10, data, &length);
+    TEST_CHECK(frames == 10, "report of %u bytes without an input", length);
+}
+
+#if USBD_SUP_HID_TLM
+/*!
+ * @brief       Send a command to the telemetry interface
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_Telemetry(void)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t epNum = USBD_HID_TLM_EP_OUT_ADDR & 0x0F;
+    uint8_t cmd[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+    uint32_t cmdCnt = gHostTlm.cmdCnt;
+    uint16_t retry;
+
+    for (retry = 0; retry < USBD_VHOST_RETRY_NUM; retry++)
+    {
+        hs = USBD_VHost_Out(TEST_DEV_ADDR, epNum, gTestDev.epOutPid[epNum], cmd, sizeof(cmd));
+
+        if (hs != USBD_MODEL_HS_NAK)
+        {
+            break;
+        }
+    }
+
+    TEST_CHECK(hs == USBD_MODEL_HS_ACK, "telemetry OUT handshake %u", hs);
+    gTestDev.epOutPid[epNum] ^= 1;
+
+    USBD_VHost_Frame();
+    TEST_CHECK((gHostTlm.cmdCnt == cmdCnt + 1) && (gHostTlm.cmdLen == sizeof(cmd)) && \
+               (memcmp(gHostTlm.cmd, cmd, sizeof(cmd)) == 0), "telemetry command not received");
+}
+#endif
+
+/*!
+ * @brief       Suspend and resume the bus
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_SuspendResume(void)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+#if (USBD_SUP_LOW_POWER && USBD_SUP_DEFER_ISR)
+    uint32_t stopCnt;
+#endif
+
+    USBD_VHost_Suspend(10);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+#if USBD_SUP_LOW_POWER
+#if USBD_SUP_DEFER_ISR
+    /* The main loop keeps running and stops the clocks itself */
+    TEST_CHECK((SCB->SCR & SCB_SCR_SLEEPONEXIT_Msk) == 0, "sleep on exit in suspend");
+    stopCnt = gHostCore.stopCnt;
+    USBD_LowPowerSleep();
+    TEST_CHECK(gHostCore.stopCnt == stopCnt + 1, "no stop mode in suspend");
+#else
+    TEST_CHECK(SCB->SCR & SCB_SCR_SLEEPDEEP_Msk, "no deep sleep in suspend");
+#endif
+#endif
+
+    USBD_VHost_Resume();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after resume", gUsbDeviceFS.devState);
+    TEST_CHECK((SCB->SCR & SCB_SCR_SLEEPDEEP_Msk) == 0, "deep sleep after resume");
+
+    /* The endpoints survive the suspend */
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, -3, 7, 0) == USBD_OK, "mouse move");
+    TEST_CHECK(Test_PollIn(epNum, 10, data, &length) < 10, "no report after resume");
+}
+
+/*!
+ * @brief       Enumerate the device, poll the HID endpoints, suspend
+ *              and resume the bus
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_Enum(void)
+{
+    Test_Enumerate();
+    Test_HidPoll();
+#if USBD_SUP_HID_TLM
+    Test_Telemetry();
+#endif
+    Test_SuspendResume();
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/* Tests selected by the first argument */
+static const TEST_CASE_T testCase[] =
+{
+#if HOST_SUP_TSC
+    {"tsc_param",       Test_TscParam},
+    {"tsc_arb",         Test_TscArb},
+    {"tsc_key",         Test_TscKey},
+    {"tsc_wake",        Test_TscWake},
+#if TOUCH_USE_WATER > 0
+    {"tsc_water",       Test_TscWater},
+#endif
+#else
+    {"enum",            Test_Enum},
+    {"event_order",     Test_EventOrder},
+    {"event_full",      Test_EventFull},
+    {"remote_wakeup",   Test_RemoteWakeup},
+#if USBD_SUP_LPM
+    {"lpm",             Test_Lpm},
+#endif
+    {"pma_alloc",       Test_PmaAlloc},
+    {"pma_copy",        Test_PmaCopy},
+    {"device_mode",     Test_DeviceMode},
+    {"report_queue",    Test_ReportQueue},
+    {"report_idle",     Test_ReportIdle},
+#if USBD_SUP_COMPOSITE
+    {"composite",       Test_Composite},
+    {"composite_bulk",  Test_CompositeBulk},
+#endif
+#endif
+};
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @addtogroup USBD_HID_Host_Functions
+  @{
+  */
+
+/*!
+ * @brief       Main program
+ *
+ * @param       argc: 2, or 3 with a trace file
+ *
+ * @param       argv: test name, then the trace file of the traffic. The
+ *              traffic is printed without it.
+ *
+ * @retval      0 when every check passed, else 1
+ */
+int main(int argc, char* argv[])
+{
+    FILE* trace = stdout;
+    uint8_t i;
+
+    for (i = 0; (argc > 1) && (i < sizeof(testCase) / sizeof(testCase[0])); i++)
+    {
+        if (strcmp(argv[1], testCase[i].name) == 0)
+        {
+            break;
+        }
+    }
+
+    if ((argc < 2) || (i == sizeof(testCase) / sizeof(testCase[0])))
+    {
+        printf("Usage: %s test [trace], tests:", argv[0]);
+
+        for (i = 0; i < sizeof(testCase) / sizeof(testCase[0]); i++)
+        {
+            printf(" %s", testCase[i].name);
+        }
+
+        printf("\r\n");
+        return 1;
+    }
+
+    if (argc > 2)
+    {
+        trace = fopen(argv[2], "w");
+
+        if (trace == NULL)
+        {
+            printf("Cannot open %s\r\n", argv[2]);
+            return 1;
+        }
+    }
+
+    memset(&gTestDev, 0, sizeof(gTestDev));
+
+    USBD_Model_Init();
+    USBD_VHost_Init(trace);
+
+#if HOST_SUP_TSC
+    /* Board setup of main.c */
+    TSC_Model_Init();
+    APM_EVAL_PBInit(BUTTON_KEY1, BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY2, BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY3, BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY4, BUTTON_MODE_EINT);
+    APM_EVAL_TMR14_Init(1000, 48);
+    TSC_User_Config();
+#endif
+
+    USB_DeviceInit();
+
+    testCase[i].run();
+
+    TEST_CHECK(gUsbdModel.epErrCnt == 0, "%u PMA or endpoint errors", (unsigned)gUsbdModel.epErrCnt);
+
+    printf("%u frames, %u transactions, %u ACK, %u NAK, %u STALL, %u no handshake, " \
+           "%u bytes OUT, %u bytes IN, %u endpoint register writes\r\n", \
+           (unsigned)gUsbVHostStat.frame, (unsigned)gUsbVHostStat.xactCnt, (unsigned)gUsbVHostStat.ackCnt, \
+           (unsigned)gUsbVHostStat.nakCnt, (unsigned)gUsbVHostStat.stallCnt, (unsigned)gUsbVHostStat.noneCnt, \
+           (unsigned)gUsbVHostStat.byteCnt[0], (unsigned)gUsbVHostStat.byteCnt[1], (unsigned)gUsbdModel.epWriteCnt);
+    printf("%s %s, %u failed checks\r\n", testCase[i].name, gTestFailCnt ? "FAILED" : "PASSED", \
+           (unsigned)gTestFailCnt);
+
+    if (trace != stdout)
+    {
+        fclose(trace);
+    }
+
+    return gTestFailCnt ? 1 : 0;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,137 @@
+/*!
+ * @file        usbd_host_test.h
+ *
+ * @brief       Test functions of the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _USBD_HOST_TEST_H_
+#define _USBD_HOST_TEST_H_
+
+/* Includes */
+#include "usbd_vhost.h"
+#include <stdio.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_DEV_ADDR               0x05
+#define TEST_EP_NUM                 8
+
+#define TEST_CHECK(cond, ...)       do { \
+                                    if (!(cond)) \
+                                    { \
+                                        printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+                                        printf(__VA_ARGS__); \
+                                        printf("\r\n"); \
+                                        gTestFailCnt++; \
+                                    } \
+} while(0)
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Device as seen by the virtual host
+ */
+typedef struct
+{
+    uint8_t             mps0;
+    uint8_t             config[256];
+    uint16_t            configLen;
+    uint8_t             hidItf[2];
+    uint16_t            hidReportLen[2];
+    uint8_t             hidItfNum;
+    uint8_t             epInInterval[TEST_EP_NUM];
+    uint8_t             epInPid[TEST_EP_NUM];
+    uint8_t             epOutPid[TEST_EP_NUM];
+} TEST_DEV_T;
+
+/**
+ * @brief   Test case
+ */
+typedef struct
+{
+    const char*         name;
+    void                (*run)(void);
+} TEST_CASE_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern TEST_DEV_T gTestDev;
+extern uint32_t gTestFailCnt;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+USBD_VHOST_STA_T Test_Request(uint8_t addr, uint8_t bmRequestType, uint8_t bRequest, \
+                              uint16_t wValue, uint16_t wIndex, uint16_t wLength, \
+                              uint8_t* data, uint16_t* length);
+void Test_Enumerate(void);
+uint32_t Test_PollIn(uint8_t epNum, uint32_t frames, uint8_t* data, uint16_t* length);
+
+void Test_EventOrder(void);
+void Test_EventFull(void);
+void Test_RemoteWakeup(void);
+void Test_Lpm(void);
+void Test_PmaAlloc(void);
+void Test_PmaCopy(void);
+void Test_Composite(void);
+void Test_CompositeBulk(void);
+void Test_DeviceMode(void);
+void Test_ReportQueue(void);
+void Test_ReportIdle(void);
+#if HOST_SUP_TSC
+void Test_TscLoop(void);
+void Test_TscRun(uint32_t ms);
+void Test_TscParam(void);
+void Test_TscArb(void);
+void Test_TscKey(void);
+void Test_TscWake(void);
+void Test_TscWater(void);
+#endif
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
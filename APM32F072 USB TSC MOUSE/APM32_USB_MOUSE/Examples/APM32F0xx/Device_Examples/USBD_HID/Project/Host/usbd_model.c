@@ -0,0 +1,806 @@
+/*!
+ * @file        usbd_model.c
+ *
+ * @brief       USB device peripheral model of the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_model.h"
+#include "apm32f0xx_usb.h"
+#if HOST_SUP_TSC
+#include "tsc_model.h"
+#endif
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Buffer descriptor table entry */
+#define USBD_MODEL_BD_TXADDR        0
+#define USBD_MODEL_BD_TXCNT         2
+#define USBD_MODEL_BD_RXADDR        4
+#define USBD_MODEL_BD_RXCNT         6
+
+#define USBD_MODEL_EP_RW            (USBD_EP_BIT_ADDR | USBD_EP_BIT_KIND | USBD_EP_BIT_TYPE)
+#define USBD_MODEL_EP_TOGGLE        (USBD_EP_BIT_TXSTS | USBD_EP_BIT_TXDTOG | USBD_EP_BIT_RXSTS | USBD_EP_BIT_RXDTOG)
+#define USBD_MODEL_EP_RC_W0         (USBD_EP_BIT_CTFR | USBD_EP_BIT_CTFT)
+
+#define USBD_MODEL_TXSTS(ep)        (((ep) >> 4) & 0x03)
+#define USBD_MODEL_RXSTS(ep)        (((ep) >> 12) & 0x03)
+#define USBD_MODEL_TYPE(ep)         (((ep) >> 9) & 0x03)
+/* Double buffered bulk endpoint */
+#define USBD_MODEL_DB_BULK(ep)      (((ep) & USBD_EP_BIT_KIND) && (USBD_MODEL_TYPE(ep) == USBD_REG_EP_TYPE_BULK))
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+USBD_MODEL_T gUsbdModel;
+uint8_t gUsbdModelPeriph[USBD_MODEL_PERIPH_SIZE];
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Read a buffer descriptor table field
+ *
+ * @param       epNum: endpoint register number
+ *
+ * @param       field: USBD_MODEL_BD_* offset
+ *
+ * @retval      Field value
+ */
+static uint16_t USBD_Model_ReadBD(uint8_t epNum, uint8_t field)
+{
+    uint16_t offset;
+
+    offset = (uint16_t)(((gUsbdModel.reg.BUFFTB & 0xFFF8) + epNum * 8 + field) % USBD_MODEL_PMA_SIZE);
+
+    return (uint16_t)(gUsbdModel.pma[offset] | (gUsbdModel.pma[offset + 1] << 8));
+}
+
+/*!
+ * @brief       Write a buffer descriptor table field
+ *
+ * @param       epNum: endpoint register number
+ *
+ * @param       field: USBD_MODEL_BD_* offset
+ *
+ * @param       value: field value
+ *
+ * @retval      None
+ */
+static void USBD_Model_WriteBD(uint8_t epNum, uint8_t field, uint16_t value)
+{
+    uint16_t offset;
+
+    offset = (uint16_t)(((gUsbdModel.reg.BUFFTB & 0xFFF8) + epNum * 8 + field) % USBD_MODEL_PMA_SIZE);
+
+    gUsbdModel.pma[offset] = (uint8_t)value;
+    gUsbdModel.pma[offset + 1] = (uint8_t)(value >> 8);
+}
+
+/*!
+ * @brief       Read the size of a receive buffer
+ *
+ * @param       epNum: endpoint register number
+ *
+ * @param       field: count field of the buffer, USBD_MODEL_BD_RXCNT or
+ *              USBD_MODEL_BD_TXCNT for the buffer 0 of a double
+ *              buffered OUT endpoint
+ *
+ * @retval      Buffer size in bytes
+ */
+static uint16_t USBD_Model_ReadRxSize(uint8_t epNum, uint8_t field)
+{
+    uint16_t rxCnt = USBD_Model_ReadBD(epNum, field);
+    uint16_t block = (rxCnt >> 10) & 0x1F;
+
+    if (rxCnt & BIT15)
+    {
+        return (uint16_t)((block + 1) * 32);
+    }
+
+    return (uint16_t)(block * 2);
+}
+
+/*!
+ * @brief       Apply a write of the device code to an endpoint register
+ *
+ * @param       epNum: endpoint register number
+ *
+ * @param       value: written value
+ *
+ * @retval      None
+ */
+static void USBD_Model_WriteEP(uint8_t epNum, uint16_t value)
+{
+    uint16_t ep = gUsbdModel.ep[epNum];
+
+    gUsbdModel.ep[epNum] = (uint16_t)((value & USBD_MODEL_EP_RW) | \
+                                      (ep & USBD_EP_BIT_SETUP) | \
+                                      ((ep ^ value) & USBD_MODEL_EP_TOGGLE) | \
+                                      (ep & value & USBD_MODEL_EP_RC_W0));
+
+    gUsbdModel.epWriteCnt++;
+}
+
+/*!
+ * @brief       Update the correct transfer flag and the endpoint
+ *              identifier from the endpoint registers
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void USBD_Model_UpdateCTR(void)
+{
+    uint32_t intSts;
+    uint8_t i;
+
+    intSts = gUsbdModel.reg.INTSTS & ~(uint32_t)(USBD_INT_CTR | 0x1F);
+
+    for (i = 0; i < 8; i++)
+    {
+        if (gUsbdModel.ep[i] & USBD_MODEL_EP_RC_W0)
+        {
+            intSts |= USBD_INT_CTR | i;
+
+            if (gUsbdModel.ep[i] & USBD_EP_BIT_CTFR)
+            {
+                intSts |= BIT4;
+            }
+            break;
+        }
+    }
+
+    gUsbdModel.reg.INTSTS = intSts;
+}
+
+/*!
+ * @brief       Put the peripheral in the state of a USB reset
+ *
+ * @param       busReset: 1 for a bus reset that also clears the device
+ *              address, 0 for a forced reset
+ *
+ * @retval      None
+ */
+static void USBD_Model_ResetState(uint8_t busReset)
+{
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        gUsbdModel.ep[i] = 0;
+        gUsbdModel.reg.EP[i].EP = USBD_MODEL_EP_TAG;
+    }
+
+    if (busReset)
+    {
+        gUsbdModel.reg.ADDR = 0;
+    }
+
+    gUsbdModel.reg.INTSTS |= USBD_INT_RST;
+}
+
+/*!
+ * @brief       Find the endpoint register of an endpoint address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       dir: EP_DIR_IN or EP_DIR_OUT
+ *
+ * @retval      Endpoint register number, 0xFF when none is enabled
+ */
+static uint8_t USBD_Model_FindEP(uint8_t epNum, uint8_t dir)
+{
+    uint16_t ep;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        ep = gUsbdModel.ep[i];
+
+        if ((ep & USBD_EP_BIT_ADDR) != epNum)
+        {
+            continue;
+        }
+
+        if (dir == EP_DIR_IN)
+        {
+            if (USBD_MODEL_TXSTS(ep) != USBD_EP_STATUS_DISABLE)
+            {
+                return i;
+            }
+        }
+        else if (USBD_MODEL_RXSTS(ep) != USBD_EP_STATUS_DISABLE)
+        {
+            return i;
+        }
+    }
+
+    return 0xFF;
+}
+
+/*!
+ * @brief       Check that the device answers a token to an address
+ *
+ * @param       addr: device address of the token
+ *
+ * @retval      1 when the device answers, else 0
+ */
+static uint8_t USBD_Model_Listen(uint8_t addr)
+{
+    /* Forced reset or powered down */
+    if (gUsbdModel.reg.CTRL & (BIT0 | BIT1))
+    {
+        return 0;
+    }
+
+    if ((gUsbdModel.reg.ADDR_B.USBDEN == BIT_RESET) || (gUsbdModel.reg.ADDR_B.ADDR != addr))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*!
+ * @brief       Reset the model to the state after a system reset
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_Init(void)
+{
+    uint8_t i;
+
+    memset(&gUsbdModel, 0, sizeof(gUsbdModel));
+    memset(gUsbdModelPeriph, 0, sizeof(gUsbdModelPeriph));
+
+    for (i = 0; i < 8; i++)
+    {
+        gUsbdModel.reg.EP[i].EP = USBD_MODEL_EP_TAG;
+    }
+
+    /* Forced reset and powered down */
+    gUsbdModel.reg.CTRL = BIT0 | BIT1;
+    gUsbdModel.forceReset = 1;
+}
+
+/*!
+ * @brief       Resolve the register writes of the device code since the
+ *              last call
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ * @note        The endpoint registers have bits that toggle or clear on
+ *              a write of 1 or 0, plain memory cannot hold them. The
+ *              model keeps them in ep[] and presents them with
+ *              USBD_MODEL_EP_TAG in the reserved bits. The device code
+ *              writes only the low 16 bits, a register without the tag
+ *              has been written since the last call. The device code is
+ *              built with -finstrument-functions, every function entry
+ *              and exit calls this function and the driver writes each
+ *              endpoint register at most once in a function.
+ */
+void USBD_Model_Sync(void)
+{
+    uint32_t reg;
+    uint8_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        reg = gUsbdModel.reg.EP[i].EP;
+
+        if ((reg & 0xFFFF0000U) != USBD_MODEL_EP_TAG)
+        {
+            USBD_Model_WriteEP(i, (uint16_t)reg);
+        }
+
+        gUsbdModel.reg.EP[i].EP = gUsbdModel.ep[i] | USBD_MODEL_EP_TAG;
+    }
+
+    /* The release of a forced reset resets the endpoints, the device
+       code restores them after a suspend */
+    if (gUsbdModel.reg.CTRL_B.FORRST)
+    {
+        gUsbdModel.forceReset = 1;
+    }
+    else if (gUsbdModel.forceReset)
+    {
+        gUsbdModel.forceReset = 0;
+        USBD_Model_ResetState(0);
+    }
+
+    /* The 50 us L1 resume signalling of the device ends at once, the
+       host answers with its own resume */
+    if (gUsbdModel.reg.CTRL_B.L1WKUPREQ)
+    {
+        gUsbdModel.reg.CTRL_B.L1WKUPREQ = BIT_RESET;
+        gUsbdModel.reg.INTSTS |= USBD_INT_WKUP;
+        gUsbdModel.l1WakeCnt++;
+    }
+
+    USBD_Model_UpdateCTR();
+}
+
+/*!
+ * @brief       Read the D+ pull up
+ *
+ * @param       None
+ *
+ * @retval      1 when the device is connected to the bus, else 0
+ */
+uint8_t USBD_Model_ReadPullUp(void)
+{
+    return (uint8_t)gUsbdModel.reg.BCD_B.DPPUCTRL;
+}
+
+/*!
+ * @brief       Read the interrupt request line
+ *
+ * @param       None
+ *
+ * @retval      1 when an enabled interrupt is pending, else 0
+ */
+uint8_t USBD_Model_ReadIrq(void)
+{
+    USBD_Model_Sync();
+
+    return (gUsbdModel.reg.INTSTS & gUsbdModel.reg.CTRL & (USBD_INT_ALL | USBD_INT_L1REQ)) ? 1 : 0;
+}
+
+/*!
+ * @brief       Bus reset
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_BusReset(void)
+{
+    USBD_Model_Sync();
+    USBD_Model_ResetState(1);
+    USBD_Model_UpdateCTR();
+}
+
+/*!
+ * @brief       Start of frame
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_SOF(void)
+{
+    USBD_Model_Sync();
+
+    gUsbdModel.reg.FRANUM_B.FRANUM = (gUsbdModel.reg.FRANUM_B.FRANUM + 1) & 0x7FF;
+    gUsbdModel.reg.INTSTS |= USBD_INT_SOF;
+}
+
+/*!
+ * @brief       Frame without a SOF
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_ESOF(void)
+{
+    USBD_Model_Sync();
+
+    gUsbdModel.reg.INTSTS |= USBD_INT_ESOF;
+}
+
+/*!
+ * @brief       Bus idle for 3 ms
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_Suspend(void)
+{
+    USBD_Model_Sync();
+
+    gUsbdModel.reg.INTSTS |= USBD_INT_SUS;
+}
+
+/*!
+ * @brief       Resume signalling of the host
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_Model_Resume(void)
+{
+    USBD_Model_Sync();
+
+    gUsbdModel.reg.INTSTS |= USBD_INT_WKUP;
+}
+
+/*!
+ * @brief       LPM extended token of an L1 request. A device without LPM
+ *              ignores it, a device that does not accept it answers NYET.
+ *
+ * @param       addr: device address
+ *
+ * @param       besl: best effort service latency of the host
+ *
+ * @param       remoteWake: 1 when the device may wake the host from L1
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_Model_Lpm(uint8_t addr, uint8_t besl, uint8_t remoteWake)
+{
+    USBD_Model_Sync();
+
+    if ((USBD_Model_Listen(addr) == 0) || (gUsbdModel.reg.LPMCTRLSTS_B.LPMEN == BIT_RESET))
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    if (gUsbdModel.reg.LPMCTRLSTS_B.LPMACKEN == BIT_RESET)
+    {
+        return USBD_MODEL_HS_NYET;
+    }
+
+    gUsbdModel.reg.LPMCTRLSTS_B.BESL = besl & 0x0F;
+    gUsbdModel.reg.LPMCTRLSTS_B.REMWAKE = remoteWake ? BIT_SET : BIT_RESET;
+    gUsbdModel.reg.INTSTS |= USBD_INT_L1REQ;
+
+    return USBD_MODEL_HS_ACK;
+}
+
+/*!
+ * @brief       SETUP transaction
+ *
+ * @param       addr: device address
+ *
+ * @param       data: 8 bytes of the request
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_Model_Setup(uint8_t addr, const uint8_t* data)
+{
+    uint16_t ep;
+    uint16_t pmaAddr;
+    uint8_t i;
+
+    USBD_Model_Sync();
+
+    if (USBD_Model_Listen(addr) == 0)
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    for (i = 0; i < 8; i++)
+    {
+        if (((gUsbdModel.ep[i] & USBD_EP_BIT_ADDR) == 0) && \
+            (USBD_MODEL_TYPE(gUsbdModel.ep[i]) == USBD_REG_EP_TYPE_CONTROL))
+        {
+            break;
+        }
+    }
+
+    ep = (i < 8) ? gUsbdModel.ep[i] : 0;
+
+    /* A SETUP is never NAKed, the host retries one that is not
+       acknowledged */
+    if ((i == 8) || (USBD_MODEL_RXSTS(ep) == USBD_EP_STATUS_DISABLE) || (ep & USBD_EP_BIT_CTFR))
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    pmaAddr = USBD_Model_ReadBD(i, USBD_MODEL_BD_RXADDR);
+
+    if ((USBD_Model_ReadRxSize(i, USBD_MODEL_BD_RXCNT) < 8) || ((pmaAddr + 8) > USBD_MODEL_PMA_SIZE))
+    {
+        gUsbdModel.epErrCnt++;
+        return USBD_MODEL_HS_NONE;
+    }
+
+    memcpy(&gUsbdModel.pma[pmaAddr], data, 8);
+    USBD_Model_WriteBD(i, USBD_MODEL_BD_RXCNT, \
+                       (uint16_t)((USBD_Model_ReadBD(i, USBD_MODEL_BD_RXCNT) & 0xFC00) | 8));
+
+    /* Both directions NAK until the request is decoded, the data and
+       status stages start with DATA1 */
+    ep &= (uint16_t)~(USBD_MODEL_EP_TOGGLE);
+    ep |= USBD_EP_BIT_SETUP | USBD_EP_BIT_CTFR | USBD_EP_BIT_RXDTOG | USBD_EP_BIT_TXDTOG;
+    ep |= (USBD_EP_STATUS_NAK << 12) | (USBD_EP_STATUS_NAK << 4);
+
+    gUsbdModel.ep[i] = ep;
+    gUsbdModel.reg.EP[i].EP = ep | USBD_MODEL_EP_TAG;
+    USBD_Model_UpdateCTR();
+
+    return USBD_MODEL_HS_ACK;
+}
+
+/*!
+ * @brief       OUT transaction
+ *
+ * @param       addr: device address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       pid: 0 for DATA0, 1 for DATA1
+ *
+ * @param       data: packet data
+ *
+ * @param       length: packet length
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_Model_Out(uint8_t addr, uint8_t epNum, uint8_t pid, const uint8_t* data, uint16_t length)
+{
+    uint16_t ep;
+    uint16_t pmaAddr;
+    uint8_t addrField = USBD_MODEL_BD_RXADDR;
+    uint8_t cntField = USBD_MODEL_BD_RXCNT;
+    uint8_t i;
+
+    USBD_Model_Sync();
+
+    if (USBD_Model_Listen(addr) == 0)
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    i = USBD_Model_FindEP(epNum, EP_DIR_OUT);
+
+    if (i == 0xFF)
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    ep = gUsbdModel.ep[i];
+
+    switch (USBD_MODEL_RXSTS(ep))
+    {
+        case USBD_EP_STATUS_STALL:
+            return USBD_MODEL_HS_STALL;
+
+        case USBD_EP_STATUS_NAK:
+            return USBD_MODEL_HS_NAK;
+
+        default:
+            break;
+    }
+
+    /* A retry of a packet already received is acknowledged and dropped */
+    if (pid != ((ep & USBD_EP_BIT_RXDTOG) ? 1 : 0))
+    {
+        return USBD_MODEL_HS_ACK;
+    }
+
+    /* A double buffered bulk endpoint receives in the buffer of its
+       DTOG_RX, the buffer 0 takes the transmit fields */
+    if (USBD_MODEL_DB_BULK(ep) && ((ep & USBD_EP_BIT_RXDTOG) == 0))
+    {
+        addrField = USBD_MODEL_BD_TXADDR;
+        cntField = USBD_MODEL_BD_TXCNT;
+    }
+
+    pmaAddr = USBD_Model_ReadBD(i, addrField);
+
+    if ((length > USBD_Model_ReadRxSize(i, cntField)) || ((pmaAddr + length) > USBD_MODEL_PMA_SIZE))
+    {
+        gUsbdModel.epErrCnt++;
+        gUsbdModel.reg.INTSTS |= USBD_INT_PMAOU;
+        return USBD_MODEL_HS_NONE;
+    }
+
+    memcpy(&gUsbdModel.pma[pmaAddr], data, length);
+    USBD_Model_WriteBD(i, cntField, (uint16_t)((USBD_Model_ReadBD(i, cntField) & 0xFC00) | length));
+
+    ep ^= USBD_EP_BIT_RXDTOG;
+    ep &= (uint16_t)~USBD_EP_BIT_SETUP;
+    ep |= USBD_EP_BIT_CTFR;
+
+    /* A double buffered endpoint NAKs once the next buffer is still
+       held by the device code, DTOG_RX equal to SW_BUF in DTOG_TX */
+    if (USBD_MODEL_DB_BULK(ep))
+    {
+        if (((ep & USBD_EP_BIT_RXDTOG) != 0) == ((ep & USBD_EP_BIT_TXDTOG) != 0))
+        {
+            ep = (uint16_t)((ep & ~USBD_EP_BIT_RXSTS) | (USBD_EP_STATUS_NAK << 12));
+        }
+    }
+    else if (USBD_MODEL_TYPE(ep) != USBD_REG_EP_TYPE_ISO)
+    {
+        ep = (uint16_t)((ep & ~USBD_EP_BIT_RXSTS) | (USBD_EP_STATUS_NAK << 12));
+    }
+
+    gUsbdModel.ep[i] = ep;
+    gUsbdModel.reg.EP[i].EP = ep | USBD_MODEL_EP_TAG;
+    USBD_Model_UpdateCTR();
+
+    return USBD_MODEL_HS_ACK;
+}
+
+/*!
+ * @brief       IN transaction, acknowledged by the host
+ *
+ * @param       addr: device address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       pid: returns 0 for DATA0, 1 for DATA1
+ *
+ * @param       data: returns the packet data
+ *
+ * @param       length: returns the packet length
+ *
+ * @retval      Handshake of the device, USBD_MODEL_HS_ACK when it sent
+ *              a packet
+ */
+USBD_MODEL_HS_T USBD_Model_In(uint8_t addr, uint8_t epNum, uint8_t* pid, uint8_t* data, uint16_t* length)
+{
+    uint16_t ep;
+    uint16_t pmaAddr;
+    uint16_t cnt;
+    uint8_t addrField = USBD_MODEL_BD_TXADDR;
+    uint8_t cntField = USBD_MODEL_BD_TXCNT;
+    uint8_t i;
+
+    USBD_Model_Sync();
+
+    *length = 0;
+
+    if (USBD_Model_Listen(addr) == 0)
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    i = USBD_Model_FindEP(epNum, EP_DIR_IN);
+
+    if (i == 0xFF)
+    {
+        return USBD_MODEL_HS_NONE;
+    }
+
+    ep = gUsbdModel.ep[i];
+
+    switch (USBD_MODEL_TXSTS(ep))
+    {
+        case USBD_EP_STATUS_STALL:
+            return USBD_MODEL_HS_STALL;
+
+        case USBD_EP_STATUS_NAK:
+            return USBD_MODEL_HS_NAK;
+
+        default:
+            break;
+    }
+
+    /* A double buffered bulk endpoint sends the buffer of its DTOG_TX,
+       the buffer 1 takes the receive fields */
+    if (USBD_MODEL_DB_BULK(ep) && (ep & USBD_EP_BIT_TXDTOG))
+    {
+        addrField = USBD_MODEL_BD_RXADDR;
+        cntField = USBD_MODEL_BD_RXCNT;
+    }
+
+    pmaAddr = USBD_Model_ReadBD(i, addrField);
+    cnt = USBD_Model_ReadBD(i, cntField) & 0x3FF;
+
+    if ((pmaAddr + cnt) > USBD_MODEL_PMA_SIZE)
+    {
+        gUsbdModel.epErrCnt++;
+        return USBD_MODEL_HS_NONE;
+    }
+
+    memcpy(data, &gUsbdModel.pma[pmaAddr], cnt);
+    *length = cnt;
+    *pid = (ep & USBD_EP_BIT_TXDTOG) ? 1 : 0;
+
+    ep ^= USBD_EP_BIT_TXDTOG;
+    ep |= USBD_EP_BIT_CTFT;
+
+    /* A double buffered endpoint NAKs once the next buffer is still
+       held by the device code, DTOG_TX equal to SW_BUF in DTOG_RX */
+    if (USBD_MODEL_DB_BULK(ep))
+    {
+        if (((ep & USBD_EP_BIT_TXDTOG) != 0) == ((ep & USBD_EP_BIT_RXDTOG) != 0))
+        {
+            ep = (uint16_t)((ep & ~USBD_EP_BIT_TXSTS) | (USBD_EP_STATUS_NAK << 4));
+        }
+    }
+    else if (USBD_MODEL_TYPE(ep) != USBD_REG_EP_TYPE_ISO)
+    {
+        ep = (uint16_t)((ep & ~USBD_EP_BIT_TXSTS) | (USBD_EP_STATUS_NAK << 4));
+    }
+
+    gUsbdModel.ep[i] = ep;
+    gUsbdModel.reg.EP[i].EP = ep | USBD_MODEL_EP_TAG;
+    USBD_Model_UpdateCTR();
+
+    return USBD_MODEL_HS_ACK;
+}
+
+/*!
+ * @brief       Function entry of the device code
+ *
+ * @param       func: function address
+ *
+ * @param       site: call site address
+ *
+ * @retval      None
+ */
+__attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void* func, void* site)
+{
+    (void)func;
+    (void)site;
+
+    USBD_Model_Sync();
+#if HOST_SUP_TSC
+    TSC_Model_Sync();
+#endif
+}
+
+/*!
+ * @brief       Function exit of the device code
+ *
+ * @param       func: function address
+ *
+ * @param       site: call site address
+ *
+ * @retval      None
+ */
+__attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void* func, void* site)
+{
+    (void)func;
+    (void)site;
+
+    USBD_Model_Sync();
+#if HOST_SUP_TSC
+    TSC_Model_Sync();
+#endif
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
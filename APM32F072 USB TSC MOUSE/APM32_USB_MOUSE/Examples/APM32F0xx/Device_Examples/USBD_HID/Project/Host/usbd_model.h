@@ -0,0 +1,145 @@
+/*!
+ * @file        usbd_model.h
+ *
+ * @brief       USB device peripheral model of the host build. Included
+ *              before every source, it moves the peripheral registers
+ *              and the PMA to host memory.
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _USBD_MODEL_H_
+#define _USBD_MODEL_H_
+
+/* Includes */
+#include "apm32f0xx.h"
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define USBD_MODEL_PMA_SIZE         1024
+/* Host memory of the APB and AHB peripherals, the AHB2 GPIO follow */
+#define USBD_MODEL_PERIPH_AHB2      0x00028000
+#define USBD_MODEL_PERIPH_SIZE      0x0002A000
+
+/* Reserved bits 31:16 of an endpoint register read by the device code,
+   a write clears them */
+#define USBD_MODEL_EP_TAG           0xA5A50000U
+
+/* Peripherals other than the USBD read and write plain host memory */
+#undef  PERIPH_BASE
+#define PERIPH_BASE                 ((uintptr_t)gUsbdModelPeriph)
+#undef  AHB2PERIPH_BASE
+#define AHB2PERIPH_BASE             (PERIPH_BASE + USBD_MODEL_PERIPH_AHB2)
+
+/* USBD registers and PMA of the model */
+#undef  USBD
+#define USBD                        (&gUsbdModel.reg)
+#define USBD_PMA_ADDR               ((uintptr_t)gUsbdModel.pma)
+
+#if HOST_SUP_TSC
+/* Parameter page of the touch sensing in the TSC model */
+extern uint8_t gTscModelFlash[];
+#define TSC_PARAM_FLASH_ADDR        ((uintptr_t)gTscModelFlash)
+#endif
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Enumerations Enumerations
+  @{
+  */
+
+/**
+ * @brief   Handshake of a bus transaction
+ */
+typedef enum
+{
+    USBD_MODEL_HS_NONE,
+    USBD_MODEL_HS_ACK,
+    USBD_MODEL_HS_NAK,
+    USBD_MODEL_HS_STALL,
+    USBD_MODEL_HS_NYET,
+} USBD_MODEL_HS_T;
+
+/**@} end of group USBD_HID_Host_Enumerations*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   USB device peripheral model
+ */
+typedef struct
+{
+    USBD_T              reg;
+    uint16_t            ep[8];
+    uint8_t             pma[USBD_MODEL_PMA_SIZE + 4];
+    uint8_t             forceReset;
+    uint32_t            epWriteCnt;
+    uint32_t            epErrCnt;
+    uint32_t            l1WakeCnt;          /*!< L1 resume signalling of the device */
+} USBD_MODEL_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_MODEL_T gUsbdModel;
+extern uint8_t gUsbdModelPeriph[USBD_MODEL_PERIPH_SIZE];
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+void USBD_Model_Init(void);
+void USBD_Model_Sync(void);
+uint8_t USBD_Model_ReadPullUp(void);
+uint8_t USBD_Model_ReadIrq(void);
+void USBD_Model_BusReset(void);
+void USBD_Model_SOF(void);
+void USBD_Model_ESOF(void);
+void USBD_Model_Suspend(void);
+void USBD_Model_Resume(void);
+USBD_MODEL_HS_T USBD_Model_Lpm(uint8_t addr, uint8_t besl, uint8_t remoteWake);
+USBD_MODEL_HS_T USBD_Model_Setup(uint8_t addr, const uint8_t* data);
+USBD_MODEL_HS_T USBD_Model_Out(uint8_t addr, uint8_t epNum, uint8_t pid, const uint8_t* data, uint16_t length);
+USBD_MODEL_HS_T USBD_Model_In(uint8_t addr, uint8_t epNum, uint8_t* pid, uint8_t* data, uint16_t* length);
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
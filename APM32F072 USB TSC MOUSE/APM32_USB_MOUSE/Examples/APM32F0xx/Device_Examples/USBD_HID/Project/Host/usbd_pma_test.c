@@ -0,0 +1,280 @@
+/*!
+ * @file        usbd_pma_test.c
+ *
+ * @brief       Allocation of the packet memory and the copies to and
+ *              from it
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "usb_device_user.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Check the PMA buffers of the endpoints of a handle
+ *
+ * @param       usbdh: USB device handler
+ *
+ * @retval      None
+ */
+static void Test_PmaLayout(USBD_HANDLE_T* usbdh)
+{
+    USBD_ENDPOINT_INFO_T* ep[2 * TEST_EP_NUM];
+    uint16_t start[2 * TEST_EP_NUM];
+    uint16_t used = USBD_BUFFTB_ADDR + usbdh->usbCfg.devEndpointNum * 8;
+    uint8_t epCnt = 0;
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < usbdh->usbCfg.devEndpointNum; i++)
+    {
+        if (usbdh->epIN[i].pmaSize)
+        {
+            ep[epCnt++] = &usbdh->epIN[i];
+        }
+
+        if (usbdh->epOUT[i].pmaSize)
+        {
+            ep[epCnt++] = &usbdh->epOUT[i];
+        }
+    }
+
+    for (i = 0; i < epCnt; i++)
+    {
+        start[i] = (ep[i]->bufferStatus == USBD_EP_BUFFER_SINGLE) ? ep[i]->pmaAddr : ep[i]->pmaAddr0;
+        used += ep[i]->pmaSize;
+
+        TEST_CHECK((start[i] & 1) == 0, "buffer %u at odd address 0x%03X", i, start[i]);
+        TEST_CHECK(start[i] >= USBD_BUFFTB_ADDR + usbdh->usbCfg.devEndpointNum * 8, \
+                   "buffer %u at 0x%03X in the buffer table", i, start[i]);
+        TEST_CHECK(start[i] + ep[i]->pmaSize <= USBD_PMA_SIZE, "buffer %u at 0x%03X past the PMA", i, start[i]);
+
+        if (ep[i]->bufferStatus == USBD_EP_BUFFER_DOUBLE)
+        {
+            TEST_CHECK(ep[i]->pmaAddr1 == ep[i]->pmaAddr0 + ep[i]->pmaSize / 2, \
+                       "buffer %u halves at 0x%03X and 0x%03X", i, ep[i]->pmaAddr0, ep[i]->pmaAddr1);
+        }
+
+        for (j = 0; j < i; j++)
+        {
+            TEST_CHECK((start[i] >= start[j] + ep[j]->pmaSize) || (start[j] >= start[i] + ep[i]->pmaSize), \
+                       "buffers %u and %u overlap", j, i);
+        }
+    }
+
+    TEST_CHECK(epCnt != 0, "no endpoint buffer");
+    TEST_CHECK(usbdh->pmaFree == used, "%u PMA bytes used, %u allocated", usbdh->pmaFree, used);
+}
+
+/*!
+ * @brief       Allocate an endpoint buffer and check its place and size
+ *
+ * @param       usbdh: USB device handler
+ *
+ * @param       epAddr: endpoint address
+ *
+ * @param       bufferStatus: endpoint kind
+ *
+ * @param       mps: endpoint maximum packet size
+ *
+ * @param       size: expected size of one buffer
+ *
+ * @retval      None
+ */
+static void Test_PmaAllocEP(USBD_HANDLE_T* usbdh, uint8_t epAddr, uint16_t bufferStatus, uint16_t mps, \
+                            uint16_t size)
+{
+    USBD_ENDPOINT_INFO_T* ep = (epAddr & 0x80) ? &usbdh->epIN[epAddr & 0x0F] : &usbdh->epOUT[epAddr];
+    uint16_t pmaFree = usbdh->pmaFree;
+    uint16_t total = (bufferStatus == USBD_EP_BUFFER_SINGLE) ? size : size * 2;
+
+    TEST_CHECK(USBD_PMA_Alloc(usbdh, epAddr, bufferStatus, mps) == SUCCESS, "EP 0x%02X of %u bytes", \
+               epAddr, mps);
+    TEST_CHECK((ep->pmaSize == total) && (usbdh->pmaFree == pmaFree + total), \
+               "EP 0x%02X of %u bytes takes %u, expected %u", epAddr, mps, ep->pmaSize, total);
+
+    if (bufferStatus == USBD_EP_BUFFER_SINGLE)
+    {
+        TEST_CHECK(ep->pmaAddr == pmaFree, "EP 0x%02X at 0x%03X, expected 0x%03X", epAddr, ep->pmaAddr, pmaFree);
+    }
+    else
+    {
+        TEST_CHECK((ep->pmaAddr0 == pmaFree) && (ep->pmaAddr1 == pmaFree + size), \
+                   "EP 0x%02X at 0x%03X and 0x%03X", epAddr, ep->pmaAddr0, ep->pmaAddr1);
+    }
+}
+
+/*!
+ * @brief       Endpoint buffers of the enumerated device, then the size
+ *              rounding, the double buffers and the overflow of the PMA
+ *              allocator on a copy of the handle
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_PmaAlloc(void)
+{
+    USBD_HANDLE_T usbdh;
+    uint16_t pmaFree;
+
+    Test_Enumerate();
+    Test_PmaLayout(&usbDeviceHandler);
+
+    usbdh = usbDeviceHandler;
+    USBD_PMA_Reset(&usbdh);
+    TEST_CHECK(usbdh.pmaFree == USBD_BUFFTB_ADDR + usbdh.usbCfg.devEndpointNum * 8, \
+               "PMA free from 0x%03X after reset", usbdh.pmaFree);
+
+    /* Even sizes, OUT buffers over 62 bytes in 32 byte blocks */
+    Test_PmaAllocEP(&usbdh, 0x00, USBD_EP_BUFFER_SINGLE, 64, 64);
+    Test_PmaAllocEP(&usbdh, 0x80, USBD_EP_BUFFER_SINGLE, 64, 64);
+    Test_PmaAllocEP(&usbdh, 0x81, USBD_EP_BUFFER_SINGLE, 7, 8);
+    Test_PmaAllocEP(&usbdh, 0x01, USBD_EP_BUFFER_SINGLE, 62, 62);
+    Test_PmaAllocEP(&usbdh, 0x02, USBD_EP_BUFFER_SINGLE, 63, 64);
+    Test_PmaAllocEP(&usbdh, 0x03, USBD_EP_BUFFER_SINGLE, 65, 96);
+    Test_PmaAllocEP(&usbdh, 0x82, USBD_EP_BUFFER_SINGLE, 65, 66);
+    Test_PmaAllocEP(&usbdh, 0x83, USBD_EP_BUFFER_DOUBLE, 64, 64);
+    Test_PmaAllocEP(&usbdh, 0x04, USBD_EP_BUFFER_DOUBLE, 33, 34);
+    Test_PmaLayout(&usbdh);
+
+    /* Fill the PMA to the last byte, a larger buffer is refused */
+    while (usbdh.pmaFree + 64 <= USBD_PMA_SIZE)
+    {
+        Test_PmaAllocEP(&usbdh, 0x84, USBD_EP_BUFFER_SINGLE, 64, 64);
+    }
+
+    pmaFree = usbdh.pmaFree;
+    TEST_CHECK(USBD_PMA_Alloc(&usbdh, 0x85, USBD_EP_BUFFER_SINGLE, 64) == ERROR, "%u bytes allocated past the PMA", \
+               pmaFree + 64 - USBD_PMA_SIZE);
+    TEST_CHECK(usbdh.pmaFree == pmaFree, "failed allocation took %u bytes", usbdh.pmaFree - pmaFree);
+
+    if (usbdh.pmaFree < USBD_PMA_SIZE)
+    {
+        Test_PmaAllocEP(&usbdh, 0x85, USBD_EP_BUFFER_SINGLE, USBD_PMA_SIZE - usbdh.pmaFree, \
+                        USBD_PMA_SIZE - usbdh.pmaFree);
+    }
+
+    TEST_CHECK(usbdh.pmaFree == USBD_PMA_SIZE, "PMA full at %u bytes", usbdh.pmaFree);
+    TEST_CHECK(USBD_PMA_Alloc(&usbdh, 0x86, USBD_EP_BUFFER_SINGLE, 2) == ERROR, "buffer allocated in a full PMA");
+
+    /* A reset frees the whole PMA */
+    USBD_PMA_Reset(&usbdh);
+    Test_PmaAllocEP(&usbdh, 0x05, USBD_EP_BUFFER_DOUBLE, 64, 64);
+}
+
+/*!
+ * @brief       Copy packets of every length up to 67 bytes to and from
+ *              the PMA, from even and odd buffer addresses. The copies
+ *              are bit exact and stop at the halfword of the last byte.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_PmaCopy(void)
+{
+    uint16_t buf[48];
+    uint8_t* data;
+    uint16_t pmaAddr = 0x100;
+    uint16_t length;
+    uint16_t i;
+    uint8_t offset;
+
+    for (offset = 0; offset < 2; offset++)
+    {
+        for (length = 0; length < 68; length++)
+        {
+            /* Write, the PMA after the last halfword is untouched */
+            memset(&gUsbdModel.pma[pmaAddr], 0xA5, 96);
+            data = (uint8_t*)buf + offset;
+
+            for (i = 0; i < sizeof(buf) - offset; i++)
+            {
+                data[i] = (uint8_t)(i * 7 + length + 1);
+            }
+
+            USBD_EP_WritePacketData(usbDeviceHandler.usbGlobal, pmaAddr, data, length);
+
+            TEST_CHECK(memcmp(&gUsbdModel.pma[pmaAddr], data, length) == 0, \
+                       "write of %u bytes from offset %u differs", length, offset);
+
+            for (i = (length + 1) & ~1; i < 96; i++)
+            {
+                if (gUsbdModel.pma[pmaAddr + i] != 0xA5)
+                {
+                    TEST_CHECK(0, "write of %u bytes from offset %u wrote PMA byte %u", length, offset, i);
+                    break;
+                }
+            }
+
+            /* Read, the buffer after the last byte is untouched */
+            for (i = 0; i < 96; i++)
+            {
+                gUsbdModel.pma[pmaAddr + i] = (uint8_t)(i * 13 + length);
+            }
+
+            memset(buf, 0x5A, sizeof(buf));
+
+            USBD_EP_ReadPacketData(usbDeviceHandler.usbGlobal, pmaAddr, data, length);
+
+            TEST_CHECK(memcmp(data, &gUsbdModel.pma[pmaAddr], length) == 0, \
+                       "read of %u bytes to offset %u differs", length, offset);
+
+            for (i = 0; i < sizeof(buf); i++)
+            {
+                if ((i < offset || i >= offset + length) && (((uint8_t*)buf)[i] != 0x5A))
+                {
+                    TEST_CHECK(0, "read of %u bytes to offset %u wrote buffer byte %u", length, offset, i);
+                    break;
+                }
+            }
+        }
+    }
+
+    memset(&gUsbdModel.pma[pmaAddr], 0, 96);
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,261 @@
+/*!
+ * @file        usbd_power_test.c
+ *
+ * @brief       Suspend, remote wakeup and link power management of the
+ *              device
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include "usbd_board.h"
+#include "host_stub.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       The device wakes a suspended bus. The ESOFs of the resume
+ *              signalling are not counted as missed SOFs and the report
+ *              that woke the device is polled after the resume.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_RemoteWakeup(void)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint16_t sofMissCnt;
+
+    Test_Enumerate();
+
+    /* No wakeup before the host enables it */
+    USBD_VHost_Suspend(3);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+    TEST_CHECK(USB_DevRemoteWakeup() != USBD_OK, "remote wakeup not enabled by the host");
+    USBD_VHost_Resume();
+
+    TEST_CHECK(Test_Request(TEST_DEV_ADDR, 0x00, USBD_STD_SET_FEATURE, USBD_FEATURE_REMOTE_WAKEUP, \
+                            0, 0, data, &length) == USBD_VHOST_OK, "SET_FEATURE DEVICE_REMOTE_WAKEUP");
+
+    USBD_VHost_Suspend(3);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in suspend", gUsbDeviceFS.devState);
+
+    sofMissCnt = usbDeviceHandler.linkStat.sofMissCnt;
+
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 2, 2, 0) == USBD_OK, "mouse move in suspend");
+    TEST_CHECK(USB_DevRemoteWakeup() == USBD_OK, "remote wakeup");
+    TEST_CHECK(usbDeviceHandler.resumeCnt != 0, "no resume signalling");
+
+    /* The device drives the bus, no SOF until the signalling ends */
+    USBD_VHost_Idle(USBD_RESUME_SIGNAL_TIME + 1);
+    TEST_CHECK(usbDeviceHandler.resumeCnt == 0, "resume signalling for %u more ms", usbDeviceHandler.resumeCnt);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after the wakeup", gUsbDeviceFS.devState);
+    TEST_CHECK(usbDeviceHandler.linkStat.sofMissCnt == sofMissCnt, "%u SOFs missed in the resume signalling", \
+               usbDeviceHandler.linkStat.sofMissCnt - sofMissCnt);
+
+    /* The host answers with its own resume and polls again */
+    USBD_VHost_Resume();
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after resume", gUsbDeviceFS.devState);
+    TEST_CHECK(Test_PollIn(epNum, 10, data, &length) < 10, "no report after the wakeup");
+
+    /* Missed SOFs of an active bus are still counted */
+    sofMissCnt = usbDeviceHandler.linkStat.sofMissCnt;
+    USBD_VHost_Idle(2);
+    TEST_CHECK(usbDeviceHandler.linkStat.sofMissCnt == sofMissCnt + 2, "%u SOFs missed of 2", \
+               usbDeviceHandler.linkStat.sofMissCnt - sofMissCnt);
+}
+
+#if USBD_SUP_LPM
+/*!
+ * @brief       Put the bus in L1 and check the sleep of the device
+ *
+ * @param       besl: BESL of the LPM token
+ *
+ * @param       remoteWake: bRemoteWake of the LPM token
+ *
+ * @retval      None
+ */
+static void Test_LpmEnter(uint8_t besl, uint8_t remoteWake)
+{
+    TEST_CHECK(USBD_VHost_Lpm(TEST_DEV_ADDR, besl, remoteWake) == USBD_MODEL_HS_ACK, "LPM token not acknowledged");
+    TEST_CHECK(USBD_VHost_L1Sleep(3) == 3, "L1 ended by the device");
+
+    TEST_CHECK(usbDeviceHandler.lpMode == USBD_LPM_LV1_SLEEP, "link state %u in L1", usbDeviceHandler.lpMode);
+    TEST_CHECK(usbDeviceHandler.beslVal == besl, "BESL %u of %u", (unsigned)usbDeviceHandler.beslVal, besl);
+    TEST_CHECK(usbDeviceHandler.l1WakeStatus == (remoteWake ? ENABLE : DISABLE), "L1 remote wakeup %u", \
+               usbDeviceHandler.l1WakeStatus);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_SUSPEND, "state %u in L1", gUsbDeviceFS.devState);
+}
+
+/*!
+ * @brief       The main loop sleeps in L1, in stop mode or not
+ *
+ * @param       stop: 1 when the clocks are expected to stop
+ *
+ * @retval      None
+ */
+static void Test_LpmSleep(uint8_t stop)
+{
+    uint32_t wfiCnt = gHostCore.wfiCnt;
+    uint32_t stopCnt = gHostCore.stopCnt;
+
+    USBD_LowPowerSleep();
+
+    TEST_CHECK(gHostCore.wfiCnt == wfiCnt + 1, "no sleep in L1");
+    TEST_CHECK(gHostCore.stopCnt == stopCnt + stop, "%s stop mode in L1", stop ? "no" : "a");
+    TEST_CHECK((SCB->SCR & SCB_SCR_SLEEPDEEP_Msk) == 0, "deep sleep after the stop mode");
+}
+
+/*!
+ * @brief       The device is back in L0 before the first SOF and the
+ *              report queued in L1 is sent in the first frame
+ *
+ * @param       None
+ *
+ * @retval      Bus time in us from the end of L1 to the report
+ */
+static uint32_t Test_LpmExit(void)
+{
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint32_t timeUs = USBD_VHost_ReadTimeUs();
+
+    TEST_CHECK(usbDeviceHandler.lpMode == USBD_LPM_LV0_ON, "link state %u after L1", usbDeviceHandler.lpMode);
+    TEST_CHECK(gUsbDeviceFS.devState == USBD_DEV_CONFIGURE, "state %u after L1", gUsbDeviceFS.devState);
+    TEST_CHECK(Test_PollIn(epNum, 3, data, &length) == 0, "report queued in L1 not sent in the first frame");
+
+    return USBD_VHost_ReadTimeUs() - timeUs;
+}
+
+/*!
+ * @brief       L1 sleep of the device. A short BESL keeps the clocks
+ *              running, a long one stops them unless the host allows an
+ *              L1 remote wakeup. The host or the device ends L1 with a
+ *              50 us resume and the reports go on in the next frame. A
+ *              bus reset also ends L1.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_Lpm(void)
+{
+    uint8_t data[64];
+    uint16_t length;
+    uint32_t timeUs;
+    uint32_t l1WakeCnt;
+#if USBD_SUP_REMOTE_WAKEUP
+    uint32_t wakeCnt;
+#endif
+
+    Test_Enumerate();
+
+    TEST_CHECK(USBD->LPMCTRLSTS_B.LPMEN && USBD->LPMCTRLSTS_B.LPMACKEN, "LPM not enabled");
+    TEST_CHECK(USBD_VHost_Lpm(TEST_DEV_ADDR + 1, USBD_LPM_BESL_BASELINE, 0) == USBD_MODEL_HS_NONE, \
+               "LPM token of another device answered");
+
+    /* Shallow sleep, the clocks keep running */
+    Test_LpmEnter(USBD_LPM_BESL_BASELINE, 0);
+    Test_LpmSleep(0);
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 1, 1, 0) == USBD_OK, "mouse move in L1");
+    USBD_VHost_L1Resume();
+    timeUs = Test_LpmExit();
+    printf("L1 resume: BESL %u, the device in L0 at the end of the 50 us resume, the report polled %u us " \
+           "later in the first frame\r\n", USBD_LPM_BESL_BASELINE, (unsigned)timeUs);
+
+    /* Deep sleep, the host waits for the clocks to restart */
+    Test_LpmEnter(USBD_LPM_BESL_DEEP, 0);
+    Test_LpmSleep(1);
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 1, 1, 0) == USBD_OK, "mouse move in L1");
+    USBD_VHost_L1Resume();
+    Test_LpmExit();
+
+    TEST_CHECK(Test_Request(TEST_DEV_ADDR, 0x00, USBD_STD_SET_FEATURE, USBD_FEATURE_REMOTE_WAKEUP, \
+                            0, 0, data, &length) == USBD_VHOST_OK, "SET_FEATURE DEVICE_REMOTE_WAKEUP");
+
+#if USBD_SUP_REMOTE_WAKEUP
+    /* An L1 remote wakeup needs the touch scans, the clocks keep running */
+    Test_LpmEnter(USBD_LPM_BESL_DEEP, 1);
+    Test_LpmSleep(0);
+
+    l1WakeCnt = gUsbdModel.l1WakeCnt;
+    wakeCnt = gUsbWakeStat.count;
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 1, 1, 0) == USBD_OK, "mouse move in L1");
+    TEST_CHECK(USB_DevRemoteWakeup() == USBD_OK, "L1 remote wakeup");
+    TEST_CHECK(USBD_VHost_L1Sleep(10) == 0, "no L1 resume signalling");
+    TEST_CHECK(gUsbdModel.l1WakeCnt == l1WakeCnt + 1, "%u L1 resume signallings", \
+               (unsigned)(gUsbdModel.l1WakeCnt - l1WakeCnt));
+    TEST_CHECK(usbDeviceHandler.resumeCnt == 0, "L0 resume signalling from L1");
+    Test_LpmExit();
+
+    USB_DevWakeProc();
+    TEST_CHECK(gUsbWakeStat.count == wakeCnt + 1, "L1 wakeup not measured");
+
+    /* Without bRemoteWake the device waits for the host */
+    Test_LpmEnter(USBD_LPM_BESL_BASELINE, 0);
+    l1WakeCnt = gUsbdModel.l1WakeCnt;
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 1, 1, 0) == USBD_OK, "mouse move in L1");
+    USBD_RemoteWakeup(&gUsbDeviceFS);
+    TEST_CHECK(USBD_VHost_L1Sleep(10) == 10, "L1 ended by the device");
+    TEST_CHECK(gUsbdModel.l1WakeCnt == l1WakeCnt, "L1 resume signalling without bRemoteWake");
+    USBD_VHost_L1Resume();
+    Test_LpmExit();
+#else
+    (void)l1WakeCnt;
+#endif
+
+    /* A bus reset ends L1 */
+    Test_LpmEnter(USBD_LPM_BESL_BASELINE, 0);
+    Test_Enumerate();
+    TEST_CHECK(usbDeviceHandler.lpMode == USBD_LPM_LV0_ON, "link state %u after a bus reset", \
+               usbDeviceHandler.lpMode);
+}
+#endif
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
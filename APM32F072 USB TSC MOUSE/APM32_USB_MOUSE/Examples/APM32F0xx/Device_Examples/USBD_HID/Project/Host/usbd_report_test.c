@@ -0,0 +1,642 @@
+/*!
+ * @file        usbd_report_test.c
+ *
+ * @brief       Report queue, idle rates and protocols of the mouse
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_host_test.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+#define TEST_STRESS_MS              10000
+/* Moves of up to 3 x 50 counts and a button change every 4 ms on average */
+#define TEST_STRESS_MOVE_NUM        3
+#define TEST_STRESS_MOVE_MAX        50
+#define TEST_STRESS_BUTTON_RATE     4
+/* The host stops polling for up to 20 ms, once in 100 ms on average */
+#define TEST_STRESS_GAP_MAX         20
+#define TEST_STRESS_GAP_RATE        100
+#define TEST_STRESS_EDGE_NUM        4096
+/* Frames without a report that end the draining */
+#define TEST_STRESS_DRAIN_MS        20
+/* Idle rate of 100 ms in 4 ms units */
+#define TEST_IDLE_RATE              25
+#define TEST_IDLE_MS                (TEST_IDLE_RATE * USBD_HID_IDLE_UNIT)
+/* Report IDs of the composite format, 0 for the boot report */
+#define TEST_IDLE_ID_NUM            4
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Mouse reports as seen by the host
+ */
+typedef struct
+{
+    int32_t             x;              /*!< Sum of the X motion */
+    int32_t             y;              /*!< Sum of the Y motion */
+    int32_t             wheel;          /*!< Sum of the wheel detents */
+    uint32_t            reportCnt;
+    uint32_t            edgeCnt;        /*!< Button changes */
+    uint32_t            orderErrCnt;    /*!< Button changes out of order */
+    uint8_t             buttons;        /*!< Buttons of the last report */
+} TEST_REPORT_STAT_T;
+
+/**
+ * @brief   Reports of each report ID and the time between them
+ */
+typedef struct
+{
+    uint32_t            reportCnt[TEST_IDLE_ID_NUM];
+    uint32_t            frame[TEST_IDLE_ID_NUM];        /*!< Frame of the last report */
+    uint32_t            periodMin[TEST_IDLE_ID_NUM];
+    uint32_t            periodMax[TEST_IDLE_ID_NUM];
+    uint8_t             report[16];                     /*!< Last report */
+    uint16_t            length;
+} TEST_IDLE_STAT_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+static uint32_t testSeed = 1;
+
+/* Button states accepted by the device, in order */
+static uint8_t testEdge[TEST_STRESS_EDGE_NUM];
+static uint32_t testEdgeNum;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Pseudo random number
+ *
+ * @param       range: number of values
+ *
+ * @retval      0 .. range - 1
+ */
+static uint32_t Test_ReportRand(uint32_t range)
+{
+    testSeed = testSeed * 1103515245 + 12345;
+
+    return (testSeed >> 16) % range;
+}
+
+/*!
+ * @brief       Poll the mouse endpoint once and add the report to the
+ *              host view. A button change must be the next state the
+ *              device accepted.
+ *
+ * @param       stat: host view of the reports
+ *
+ * @retval      1 when a report was sent, 0 on a NAK
+ */
+static uint8_t Test_ReportPoll(TEST_REPORT_STAT_T* stat)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint8_t pid;
+
+    hs = USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, &length);
+
+    if (hs != USBD_MODEL_HS_ACK)
+    {
+        TEST_CHECK(hs == USBD_MODEL_HS_NAK, "EP 0x%02X handshake %u", epNum | 0x80, hs);
+        return 0;
+    }
+
+    TEST_CHECK(pid == gTestDev.epInPid[epNum], "EP 0x%02X DATA%u, expected DATA%u", \
+               epNum | 0x80, pid, gTestDev.epInPid[epNum]);
+    gTestDev.epInPid[epNum] ^= 1;
+    stat->reportCnt++;
+
+    /* Report ID, buttons, X and Y of 16 bits, wheel */
+    if ((length != USBD_HID_MOUSE_HIRES_REPORT_SIZE) || (data[0] != USBD_HID_REPORT_ID_MOUSE))
+    {
+        TEST_CHECK(0, "report %u of %u bytes, ID 0x%02X", (unsigned)stat->reportCnt, length, data[0]);
+        return 1;
+    }
+
+    stat->x += (int16_t)(data[2] | (data[3] << 8));
+    stat->y += (int16_t)(data[4] | (data[5] << 8));
+    stat->wheel += (int8_t)data[6];
+
+    if (data[1] != stat->buttons)
+    {
+        if ((stat->edgeCnt >= testEdgeNum) || (testEdge[stat->edgeCnt] != data[1]))
+        {
+            stat->orderErrCnt++;
+        }
+
+        stat->edgeCnt++;
+        stat->buttons = data[1];
+    }
+
+    return 1;
+}
+
+/*!
+ * @brief       Random moves and button changes of every ms, with the host
+ *              polling in irregular gaps. A button change the full queue
+ *              refuses is retried in the next ms. Each button change is
+ *              reported once in order and no motion is lost.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ReportStress(void)
+{
+    TEST_REPORT_STAT_T stat = {0};
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t wheel = 0;
+    int16_t dx;
+    int16_t dy;
+    int8_t dw;
+    uint32_t busyCnt = 0;
+    uint32_t gapMax = 0;
+    uint32_t gap = 0;
+    uint32_t idle = 0;
+    uint32_t ms;
+    uint32_t i;
+    uint8_t buttons = 0;
+    uint8_t accepted = 0;
+    USBD_STA_T status;
+
+    testEdgeNum = 0;
+
+    for (ms = 0; ms < TEST_STRESS_MS; ms++)
+    {
+        for (i = Test_ReportRand(TEST_STRESS_MOVE_NUM + 1); i > 0; i--)
+        {
+            dx = (int16_t)Test_ReportRand(2 * TEST_STRESS_MOVE_MAX + 1) - TEST_STRESS_MOVE_MAX;
+            dy = (int16_t)Test_ReportRand(2 * TEST_STRESS_MOVE_MAX + 1) - TEST_STRESS_MOVE_MAX;
+            dw = (int8_t)Test_ReportRand(3) - 1;
+
+            TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, dx, dy, dw) == USBD_OK, "move in ms %u", (unsigned)ms);
+            x += dx;
+            y += dy;
+            wheel += dw;
+        }
+
+        /* Left, right or middle, a press and its release can come in one ms */
+        if (Test_ReportRand(TEST_STRESS_BUTTON_RATE) == 0)
+        {
+            buttons ^= 1 << Test_ReportRand(3);
+        }
+
+        if ((buttons != accepted) && (testEdgeNum < TEST_STRESS_EDGE_NUM))
+        {
+            status = USBD_HID_MouseButton(&gUsbDeviceFS, buttons);
+
+            if (status == USBD_OK)
+            {
+                testEdge[testEdgeNum++] = buttons;
+                accepted = buttons;
+            }
+            else
+            {
+                TEST_CHECK(status == USBD_BUSY, "button status %u in ms %u", status, (unsigned)ms);
+                busyCnt++;
+            }
+        }
+
+        USBD_VHost_Frame();
+
+        if ((gap == 0) && (Test_ReportRand(TEST_STRESS_GAP_RATE) == 0))
+        {
+            gap = Test_ReportRand(TEST_STRESS_GAP_MAX) + 1;
+            gapMax = (gap > gapMax) ? gap : gapMax;
+        }
+
+        if (gap != 0)
+        {
+            gap--;
+            continue;
+        }
+
+        Test_ReportPoll(&stat);
+    }
+
+    /* A refused change is taken once the queue has room */
+    while (buttons != accepted)
+    {
+        if (USBD_HID_MouseButton(&gUsbDeviceFS, buttons) == USBD_OK)
+        {
+            testEdge[testEdgeNum++] = buttons;
+            accepted = buttons;
+        }
+
+        USBD_VHost_Frame();
+        Test_ReportPoll(&stat);
+    }
+
+    for (idle = 0; idle < TEST_STRESS_DRAIN_MS; idle++)
+    {
+        USBD_VHost_Frame();
+
+        if (Test_ReportPoll(&stat))
+        {
+            idle = 0;
+        }
+    }
+
+    printf("Report stress: %u ms, %u reports, %u button changes, %u refused by the full queue, " \
+           "polling gaps up to %u ms\r\n", TEST_STRESS_MS, (unsigned)stat.reportCnt, (unsigned)testEdgeNum, \
+           (unsigned)busyCnt, (unsigned)gapMax);
+
+    TEST_CHECK(busyCnt != 0, "the queue never ran full");
+    TEST_CHECK(stat.edgeCnt == testEdgeNum, "%u of %u button changes reported", (unsigned)stat.edgeCnt, \
+               (unsigned)testEdgeNum);
+    TEST_CHECK(stat.orderErrCnt == 0, "%u button changes out of order", (unsigned)stat.orderErrCnt);
+    TEST_CHECK(stat.buttons == buttons, "buttons 0x%02X, pressed 0x%02X", stat.buttons, buttons);
+    TEST_CHECK((stat.x == x) && (stat.y == y), "motion %d, %d of %d, %d", (int)stat.x, (int)stat.y, \
+               (int)x, (int)y);
+    TEST_CHECK(stat.wheel == wheel, "wheel %d of %d detents", (int)stat.wheel, (int)wheel);
+}
+
+/*!
+ * @brief       Motion past the range of the queue saturates and is not
+ *              wrapped, a button change after it keeps its own report
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ReportSaturate(void)
+{
+    TEST_REPORT_STAT_T stat = {0};
+    uint32_t idle;
+    uint8_t i;
+
+    testEdgeNum = 0;
+
+    for (i = 0; i < 3; i++)
+    {
+        TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 30000, -30000, 0) == USBD_OK, "move %u", i);
+    }
+
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x01) == USBD_OK, "button");
+    testEdge[testEdgeNum++] = 0x01;
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x00) == USBD_OK, "button");
+    testEdge[testEdgeNum++] = 0x00;
+
+    for (idle = 0; idle < TEST_STRESS_DRAIN_MS; idle++)
+    {
+        USBD_VHost_Frame();
+
+        if (Test_ReportPoll(&stat))
+        {
+            idle = 0;
+        }
+    }
+
+    TEST_CHECK((stat.x == INT16_MAX) && (stat.y == -INT16_MAX), "saturated motion %d, %d", (int)stat.x, \
+               (int)stat.y);
+    TEST_CHECK(stat.reportCnt == 3, "%u reports of a move, a press and a release", (unsigned)stat.reportCnt);
+    TEST_CHECK((stat.edgeCnt == 2) && (stat.orderErrCnt == 0), "%u button changes, %u out of order", \
+               (unsigned)stat.edgeCnt, (unsigned)stat.orderErrCnt);
+}
+
+/*!
+ * @brief       Class request to the mouse interface
+ *
+ * @param       bRequest: HID class request
+ *
+ * @param       wValue: request value
+ *
+ * @param       value: value of a SET request, returns the value of a GET
+ *              request
+ *
+ * @retval      Transfer status
+ */
+static USBD_VHOST_STA_T Test_IdleRequest(uint8_t bRequest, uint16_t wValue, uint8_t* value)
+{
+    uint16_t length;
+
+    if ((bRequest == USBD_CLASS_GET_IDLE) || (bRequest == USBD_CLASS_GET_PROTOCOL))
+    {
+        *value = 0xFF;
+        return Test_Request(TEST_DEV_ADDR, 0xA1, bRequest, wValue, gTestDev.hidItf[0], 1, value, &length);
+    }
+
+    return Test_Request(TEST_DEV_ADDR, 0x21, bRequest, wValue, gTestDev.hidItf[0], 0, NULL, &length);
+}
+
+/*!
+ * @brief       Poll the mouse endpoint in every frame and time the reports
+ *              of each report ID
+ *
+ * @param       ms: time in ms
+ *
+ * @param       stat: reports of each report ID
+ *
+ * @retval      None
+ */
+static void Test_IdleRun(uint32_t ms, TEST_IDLE_STAT_T* stat)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t epNum = USBD_HID_EP_IN_ADDR & 0x0F;
+    uint8_t data[64];
+    uint16_t length;
+    uint32_t period;
+    uint8_t pid;
+    uint8_t id;
+
+    while (ms--)
+    {
+        USBD_VHost_Frame();
+
+        hs = USBD_VHost_In(TEST_DEV_ADDR, epNum, &pid, data, &length);
+
+        if (hs != USBD_MODEL_HS_ACK)
+        {
+            TEST_CHECK(hs == USBD_MODEL_HS_NAK, "EP 0x%02X handshake %u", epNum | 0x80, hs);
+            continue;
+        }
+
+        gTestDev.epInPid[epNum] ^= 1;
+
+        stat->length = (length < sizeof(stat->report)) ? length : sizeof(stat->report);
+        memcpy(stat->report, data, stat->length);
+
+        /* The boot report has no report ID */
+        id = (length == USBD_HID_MOUSE_REPORT_SIZE) ? 0 : data[0];
+        if (id >= TEST_IDLE_ID_NUM)
+        {
+            TEST_CHECK(0, "report ID 0x%02X", id);
+            continue;
+        }
+
+        if (stat->reportCnt[id] != 0)
+        {
+            period = gUsbVHostStat.frame - stat->frame[id];
+
+            if ((stat->reportCnt[id] == 1) || (period < stat->periodMin[id]))
+            {
+                stat->periodMin[id] = period;
+            }
+
+            if (period > stat->periodMax[id])
+            {
+                stat->periodMax[id] = period;
+            }
+        }
+
+        stat->frame[id] = gUsbVHostStat.frame;
+        stat->reportCnt[id]++;
+    }
+}
+
+/*!
+ * @brief       The idle rate of the mouse repeats its state with no motion,
+ *              a change restarts the period and a rate of 0 suppresses
+ *              unchanged reports. A rate set for a report ID leaves the
+ *              others.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ReportIdleRate(void)
+{
+    TEST_IDLE_STAT_T stat;
+    uint8_t value;
+    uint8_t id;
+
+    /* Enumerated with SET_IDLE 0 */
+    TEST_CHECK((Test_IdleRequest(USBD_CLASS_GET_IDLE, 0, &value) == USBD_VHOST_OK) && (value == 0), \
+               "GET_IDLE %u", value);
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS * 2, &stat);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] == 0, "%u reports without a change at the idle rate 0", \
+               (unsigned)stat.reportCnt[USBD_HID_REPORT_ID_MOUSE]);
+
+    /* The mouse report only */
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_IDLE, (TEST_IDLE_RATE << 8) | USBD_HID_REPORT_ID_MOUSE, NULL) == \
+               USBD_VHOST_OK, "SET_IDLE");
+    TEST_CHECK((Test_IdleRequest(USBD_CLASS_GET_IDLE, USBD_HID_REPORT_ID_MOUSE, &value) == USBD_VHOST_OK) && \
+               (value == TEST_IDLE_RATE), "GET_IDLE of the mouse %u", value);
+    TEST_CHECK((Test_IdleRequest(USBD_CLASS_GET_IDLE, USBD_HID_REPORT_ID_KEYBOARD, &value) == USBD_VHOST_OK) && \
+               (value == 0), "GET_IDLE of the keyboard %u", value);
+
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x01) == USBD_OK, "button");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS * 10, &stat);
+    TEST_CHECK((stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] >= 10) && (stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] <= 11), \
+               "%u mouse reports in %u ms", (unsigned)stat.reportCnt[USBD_HID_REPORT_ID_MOUSE], TEST_IDLE_MS * 10);
+    TEST_CHECK((stat.periodMin[USBD_HID_REPORT_ID_MOUSE] == TEST_IDLE_MS) && \
+               (stat.periodMax[USBD_HID_REPORT_ID_MOUSE] == TEST_IDLE_MS), "idle period %u .. %u ms", \
+               (unsigned)stat.periodMin[USBD_HID_REPORT_ID_MOUSE], (unsigned)stat.periodMax[USBD_HID_REPORT_ID_MOUSE]);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_KEYBOARD] + stat.reportCnt[USBD_HID_REPORT_ID_CONSUMER] == 0, \
+               "keyboard or consumer reports without a rate");
+
+    /* The repeated state has the button and no motion */
+    TEST_CHECK((stat.length == USBD_HID_MOUSE_HIRES_REPORT_SIZE) && (stat.report[1] == 0x01) && \
+               (stat.report[2] == 0) && (stat.report[3] == 0) && (stat.report[4] == 0) && (stat.report[5] == 0) && \
+               (stat.report[6] == 0), "idle report buttons 0x%02X", stat.report[1]);
+
+    /* A move in the middle of the period restarts it */
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS / 2, &stat);
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 5, 5, 0) == USBD_OK, "move");
+    Test_IdleRun(2, &stat);
+    TEST_CHECK(stat.report[2] == 5, "move not reported");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS - 2, &stat);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] == 0, "idle report %u ms after a move", \
+               (unsigned)(stat.frame[USBD_HID_REPORT_ID_MOUSE] + TEST_IDLE_MS - 2 - gUsbVHostStat.frame));
+    Test_IdleRun(3, &stat);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] == 1, "no idle report a period after a move");
+
+    /* Report ID 0 sets every report */
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_IDLE, TEST_IDLE_RATE << 8, NULL) == USBD_VHOST_OK, "SET_IDLE");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS * 10, &stat);
+
+    for (id = USBD_HID_REPORT_ID_MOUSE; id <= USBD_HID_REPORT_ID_CONSUMER; id++)
+    {
+        TEST_CHECK((stat.reportCnt[id] >= 9) && (stat.periodMax[id] <= TEST_IDLE_MS + 2), \
+                   "report ID %u, %u reports, period up to %u ms", id, (unsigned)stat.reportCnt[id], \
+                   (unsigned)stat.periodMax[id]);
+    }
+
+    printf("Idle rate %u ms: periods of the mouse, keyboard and consumer reports up to %u, %u, %u ms\r\n", \
+           TEST_IDLE_MS, (unsigned)stat.periodMax[USBD_HID_REPORT_ID_MOUSE], \
+           (unsigned)stat.periodMax[USBD_HID_REPORT_ID_KEYBOARD], \
+           (unsigned)stat.periodMax[USBD_HID_REPORT_ID_CONSUMER]);
+
+    /* Back to no repeats */
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_IDLE, 0, NULL) == USBD_VHOST_OK, "SET_IDLE");
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x00) == USBD_OK, "button");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS * 2, &stat);
+    TEST_CHECK((stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] == 1) && (stat.report[1] == 0), \
+               "%u reports after the release at the idle rate 0", (unsigned)stat.reportCnt[USBD_HID_REPORT_ID_MOUSE]);
+}
+
+/*!
+ * @brief       The boot protocol sends the boot mouse report without a
+ *              report ID, with the motion split in 8-bit steps, and no
+ *              keyboard report. The report protocol is restored.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void Test_ReportProtocol(void)
+{
+    TEST_IDLE_STAT_T stat;
+    uint8_t keys[USBD_HID_KEYBOARD_KEYS] = {0x04};
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t wheel = 0;
+    uint32_t reportCnt = 0;
+    uint32_t i;
+    uint8_t value;
+
+    TEST_CHECK((Test_IdleRequest(USBD_CLASS_GET_PROTOCOL, 0, &value) == USBD_VHOST_OK) && \
+               (value == USBD_HID_PROTOCOL_REPORT), "GET_PROTOCOL %u", value);
+
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_PROTOCOL, USBD_HID_PROTOCOL_BOOT, NULL) == USBD_VHOST_OK, \
+               "SET_PROTOCOL boot");
+    TEST_CHECK((Test_IdleRequest(USBD_CLASS_GET_PROTOCOL, 0, &value) == USBD_VHOST_OK) && \
+               (value == USBD_HID_PROTOCOL_BOOT), "GET_PROTOCOL %u", value);
+
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x02) == USBD_OK, "button");
+    TEST_CHECK(USBD_HID_MouseMove(&gUsbDeviceFS, 300, -5, 1) == USBD_OK, "move");
+    TEST_CHECK(USBD_HID_KeyboardWrite(&gUsbDeviceFS, 0, keys) == USBD_OK, "keyboard");
+
+    memset(&stat, 0, sizeof(stat));
+
+    for (i = 0; i < TEST_STRESS_DRAIN_MS; i++)
+    {
+        Test_IdleRun(1, &stat);
+
+        if (stat.reportCnt[0] == reportCnt)
+        {
+            continue;
+        }
+
+        /* Buttons, X, Y and wheel of 8 bits */
+        reportCnt = stat.reportCnt[0];
+        TEST_CHECK(stat.report[0] == 0x02, "boot report %u buttons 0x%02X", (unsigned)reportCnt, stat.report[0]);
+        x += (int8_t)stat.report[1];
+        y += (int8_t)stat.report[2];
+        wheel += (int8_t)stat.report[3];
+    }
+
+    TEST_CHECK(stat.reportCnt[0] == 3, "%u boot reports of a 300 count move", (unsigned)stat.reportCnt[0]);
+    TEST_CHECK((x == 300) && (y == -5) && (wheel == 1), "boot motion %d, %d, wheel %d", (int)x, (int)y, (int)wheel);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] + stat.reportCnt[USBD_HID_REPORT_ID_KEYBOARD] + \
+               stat.reportCnt[USBD_HID_REPORT_ID_CONSUMER] == 0, "report with an ID in the boot protocol");
+
+    /* Only the boot report repeats at the idle rate */
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_IDLE, TEST_IDLE_RATE << 8, NULL) == USBD_VHOST_OK, "SET_IDLE");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_IDLE_MS * 5, &stat);
+    TEST_CHECK((stat.reportCnt[0] >= 4) && (stat.periodMax[0] == TEST_IDLE_MS), "%u boot reports, period %u ms", \
+               (unsigned)stat.reportCnt[0], (unsigned)stat.periodMax[0]);
+    TEST_CHECK(stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] + stat.reportCnt[USBD_HID_REPORT_ID_KEYBOARD] + \
+               stat.reportCnt[USBD_HID_REPORT_ID_CONSUMER] == 0, "report with an ID in the boot protocol");
+
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_IDLE, 0, NULL) == USBD_VHOST_OK, "SET_IDLE");
+
+    /* The report protocol brings the report IDs back */
+    TEST_CHECK(Test_IdleRequest(USBD_CLASS_SET_PROTOCOL, USBD_HID_PROTOCOL_REPORT, NULL) == USBD_VHOST_OK, \
+               "SET_PROTOCOL report");
+    TEST_CHECK(USBD_HID_MouseButton(&gUsbDeviceFS, 0x00) == USBD_OK, "button");
+
+    memset(&stat, 0, sizeof(stat));
+    Test_IdleRun(TEST_STRESS_DRAIN_MS, &stat);
+    TEST_CHECK((stat.reportCnt[USBD_HID_REPORT_ID_MOUSE] == 1) && (stat.reportCnt[0] == 0) && \
+               (stat.length == USBD_HID_MOUSE_HIRES_REPORT_SIZE) && (stat.report[1] == 0), \
+               "release in the report protocol, %u reports", (unsigned)stat.reportCnt[USBD_HID_REPORT_ID_MOUSE]);
+}
+
+/*!
+ * @brief       Report queue of the mouse under random input and irregular
+ *              polling, and at the range of the motion
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_ReportQueue(void)
+{
+    Test_Enumerate();
+
+    Test_ReportStress();
+    Test_ReportSaturate();
+}
+
+/*!
+ * @brief       SET_IDLE and GET_IDLE, SET_PROTOCOL and GET_PROTOCOL of the
+ *              mouse interface
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void Test_ReportIdle(void)
+{
+    Test_Enumerate();
+
+    Test_ReportIdleRate();
+    Test_ReportProtocol();
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,651 @@
+/*!
+ * @file        usbd_vhost.c
+ *
+ * @brief       Virtual USB host of the host build. It schedules the
+ *              tokens of the transfers in 1 ms frames, runs the device
+ *              after each transaction and records the traffic.
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "usbd_vhost.h"
+#include "usbd_board.h"
+#include "usb_device_user.h"
+#include <string.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Interrupts serviced in a row before the main loop runs */
+#define USBD_VHOST_IRQ_NUM          8
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_HANDLE_T usbDeviceHandler;
+
+USBD_VHOST_STAT_T gUsbVHostStat;
+
+static FILE* vhostTrace;
+static uint8_t vhostSlot;
+static uint32_t vhostTime;
+static uint8_t vhostHoldStatus;
+/* L1 resume signalling of the device seen by the host */
+static uint32_t vhostL1WakeCnt;
+
+static const char* const vhostTokenName[] = {"SETUP", "OUT", "IN", "LPM"};
+static const char* const vhostHsName[] = {"-", "ACK", "NAK", "STALL", "NYET"};
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+/*!
+ * @brief       Record a transaction
+ *
+ * @param       token: USBD_VHOST_TOKEN_T value
+ *
+ * @param       addr: device address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       pid: 0 for DATA0, 1 for DATA1
+ *
+ * @param       hs: handshake
+ *
+ * @param       data: packet data, NULL without a data packet
+ *
+ * @param       length: packet length
+ *
+ * @retval      None
+ */
+static void USBD_VHost_Record(uint8_t token, uint8_t addr, uint8_t epNum, uint8_t pid, \
+                              USBD_MODEL_HS_T hs, const uint8_t* data, uint16_t length)
+{
+    uint16_t i;
+
+    gUsbVHostStat.xactCnt++;
+
+    switch (hs)
+    {
+        case USBD_MODEL_HS_ACK:
+            gUsbVHostStat.ackCnt++;
+            gUsbVHostStat.byteCnt[token == USBD_VHOST_TOKEN_IN] += length;
+            break;
+
+        case USBD_MODEL_HS_NAK:
+        case USBD_MODEL_HS_NYET:
+            gUsbVHostStat.nakCnt++;
+            break;
+
+        case USBD_MODEL_HS_STALL:
+            gUsbVHostStat.stallCnt++;
+            break;
+
+        default:
+            gUsbVHostStat.noneCnt++;
+            break;
+    }
+
+    if (vhostTrace == NULL)
+    {
+        return;
+    }
+
+    fprintf(vhostTrace, "%6u.%02u %-5s %3u.%u %-5s", (unsigned)gUsbVHostStat.frame, vhostSlot, \
+            vhostTokenName[token], addr, epNum, vhostHsName[hs]);
+
+    if (data != NULL)
+    {
+        fprintf(vhostTrace, " DATA%u %3u:", pid, length);
+
+        for (i = 0; i < length; i++)
+        {
+            fprintf(vhostTrace, " %02X", data[i]);
+        }
+    }
+
+    fprintf(vhostTrace, "\n");
+}
+
+/*!
+ * @brief       Record a bus event
+ *
+ * @param       event: event name
+ *
+ * @retval      None
+ */
+static void USBD_VHost_RecordEvent(const char* event)
+{
+    if (vhostTrace != NULL)
+    {
+        fprintf(vhostTrace, "%6u.%02u %s\n", (unsigned)gUsbVHostStat.frame, vhostSlot, event);
+    }
+}
+
+/*!
+ * @brief       Take a transaction slot, the next frame starts when the
+ *              current one is full
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void USBD_VHost_Slot(void)
+{
+    if (vhostSlot >= USBD_VHOST_FRAME_XACT_NUM)
+    {
+        USBD_VHost_Frame();
+    }
+
+    vhostSlot++;
+    vhostTime += 1000 / USBD_VHOST_FRAME_XACT_NUM;
+}
+
+/*!
+ * @brief       Init the virtual host
+ *
+ * @param       trace: traffic record, NULL for none
+ *
+ * @retval      None
+ */
+void USBD_VHost_Init(FILE* trace)
+{
+    memset(&gUsbVHostStat, 0, sizeof(gUsbVHostStat));
+
+    vhostTrace = trace;
+    vhostSlot = 0;
+    vhostTime = 0;
+    vhostHoldStatus = 0;
+    vhostL1WakeCnt = gUsbdModel.l1WakeCnt;
+}
+
+/*!
+ * @brief       Hold the main loop, the deferred events stay queued
+ *
+ * @param       hold: 1 to hold, 0 to run the main loop again
+ *
+ * @retval      None
+ */
+void USBD_VHost_HoldEvents(uint8_t hold)
+{
+    vhostHoldStatus = hold;
+}
+
+/*!
+ * @brief       Read the bus time
+ *
+ * @param       None
+ *
+ * @retval      Time in us
+ */
+uint32_t USBD_VHost_ReadTimeUs(void)
+{
+    return vhostTime;
+}
+
+/*!
+ * @brief       Run the device, the USB interrupt while it is pending
+ *              and then a pass of the main loop unless it is held
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_VHost_RunDevice(void)
+{
+    uint8_t i;
+
+    for (i = 0; (i < USBD_VHOST_IRQ_NUM) && USBD_Model_ReadIrq(); i++)
+    {
+        USBD_IsrHandler(&usbDeviceHandler);
+    }
+
+#if USBD_SUP_DEFER_ISR
+    if (vhostHoldStatus == 0)
+    {
+        USB_DevEventProc();
+    }
+#endif
+}
+
+/*!
+ * @brief       Start a frame
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_VHost_Frame(void)
+{
+    gUsbVHostStat.frame++;
+    vhostSlot = 0;
+    vhostTime = gUsbVHostStat.frame * 1000;
+
+    USBD_Model_SOF();
+    USBD_VHost_RunDevice();
+}
+
+/*!
+ * @brief       Frames without a SOF, the device sees an ESOF in each
+ *
+ * @param       frames: idle frames
+ *
+ * @retval      None
+ */
+void USBD_VHost_Idle(uint32_t frames)
+{
+    while (frames--)
+    {
+        gUsbVHostStat.frame++;
+        vhostSlot = 0;
+        vhostTime = gUsbVHostStat.frame * 1000;
+
+        USBD_Model_ESOF();
+        USBD_VHost_RunDevice();
+    }
+}
+
+/*!
+ * @brief       Reset the bus for 10 ms and let the device recover for
+ *              10 ms
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_VHost_BusReset(void)
+{
+    uint8_t i;
+
+    USBD_VHost_RecordEvent("RESET");
+
+    USBD_Model_BusReset();
+    gUsbVHostStat.frame += 10;
+    vhostTime = gUsbVHostStat.frame * 1000;
+    vhostSlot = 0;
+    USBD_VHost_RunDevice();
+
+    for (i = 0; i < 10; i++)
+    {
+        USBD_VHost_Frame();
+    }
+}
+
+/*!
+ * @brief       Suspend the bus
+ *
+ * @param       frames: idle frames after the suspend
+ *
+ * @retval      None
+ */
+void USBD_VHost_Suspend(uint32_t frames)
+{
+    USBD_VHost_RecordEvent("SUSPEND");
+
+    gUsbVHostStat.frame += 3;
+    vhostTime = gUsbVHostStat.frame * 1000;
+    USBD_Model_Suspend();
+    USBD_VHost_RunDevice();
+
+    while (frames--)
+    {
+        gUsbVHostStat.frame++;
+        vhostTime = gUsbVHostStat.frame * 1000;
+        USBD_VHost_RunDevice();
+    }
+}
+
+/*!
+ * @brief       Resume the bus, the SOFs restart after 20 ms
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_VHost_Resume(void)
+{
+    uint8_t i;
+
+    USBD_VHost_RecordEvent("RESUME");
+
+    USBD_Model_Resume();
+    gUsbVHostStat.frame += 20;
+    vhostTime = gUsbVHostStat.frame * 1000;
+    USBD_VHost_RunDevice();
+
+    for (i = 0; i < 10; i++)
+    {
+        USBD_VHost_Frame();
+    }
+}
+
+/*!
+ * @brief       L1 request, the SOFs stop once the device has acknowledged
+ *              it
+ *
+ * @param       addr: device address
+ *
+ * @param       besl: best effort service latency of the host
+ *
+ * @param       remoteWake: 1 when the device may wake the host from L1
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_VHost_Lpm(uint8_t addr, uint8_t besl, uint8_t remoteWake)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t attr[2];
+
+    USBD_VHost_Slot();
+
+    hs = USBD_Model_Lpm(addr, besl, remoteWake);
+
+    /* bmAttributes of the extended token: L1, BESL and bRemoteWake */
+    attr[0] = (uint8_t)(0x01 | (besl << 4));
+    attr[1] = remoteWake ? 0x01 : 0x00;
+    USBD_VHost_Record(USBD_VHOST_TOKEN_LPM, addr, 0, 0, hs, attr, 2);
+
+    USBD_VHost_RunDevice();
+
+    return hs;
+}
+
+/*!
+ * @brief       Frames of L1 sleep without a SOF, ended early by the L1
+ *              resume signalling of the device
+ *
+ * @param       frames: sleep frames
+ *
+ * @retval      Frames until the device woke the bus, frames when it did
+ *              not
+ */
+uint32_t USBD_VHost_L1Sleep(uint32_t frames)
+{
+    uint32_t frame;
+
+    for (frame = 0; frame < frames; frame++)
+    {
+        gUsbVHostStat.frame++;
+        vhostSlot = 0;
+        vhostTime = gUsbVHostStat.frame * 1000;
+        USBD_VHost_RunDevice();
+
+        if (gUsbdModel.l1WakeCnt != vhostL1WakeCnt)
+        {
+            vhostL1WakeCnt = gUsbdModel.l1WakeCnt;
+            USBD_VHost_RecordEvent("L1 WAKEUP");
+            return frame;
+        }
+    }
+
+    return frames;
+}
+
+/*!
+ * @brief       Resume the bus from L1 for 50 us, the SOFs restart in the
+ *              next frame
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USBD_VHost_L1Resume(void)
+{
+    USBD_VHost_RecordEvent("L1 RESUME");
+
+    USBD_Model_Resume();
+    vhostTime += 50;
+    USBD_VHost_RunDevice();
+}
+
+/*!
+ * @brief       SETUP transaction
+ *
+ * @param       addr: device address
+ *
+ * @param       data: 8 bytes of the request
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_VHost_Setup(uint8_t addr, const uint8_t* data)
+{
+    USBD_MODEL_HS_T hs;
+
+    USBD_VHost_Slot();
+
+    hs = USBD_Model_Setup(addr, data);
+    USBD_VHost_Record(USBD_VHOST_TOKEN_SETUP, addr, 0, 0, hs, data, 8);
+
+    USBD_VHost_RunDevice();
+
+    return hs;
+}
+
+/*!
+ * @brief       OUT transaction
+ *
+ * @param       addr: device address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       pid: 0 for DATA0, 1 for DATA1
+ *
+ * @param       data: packet data
+ *
+ * @param       length: packet length
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_VHost_Out(uint8_t addr, uint8_t epNum, uint8_t pid, const uint8_t* data, uint16_t length)
+{
+    USBD_MODEL_HS_T hs;
+
+    USBD_VHost_Slot();
+
+    hs = USBD_Model_Out(addr, epNum, pid, data, length);
+    USBD_VHost_Record(USBD_VHOST_TOKEN_OUT, addr, epNum, pid, hs, data, length);
+
+    USBD_VHost_RunDevice();
+
+    return hs;
+}
+
+/*!
+ * @brief       IN transaction
+ *
+ * @param       addr: device address
+ *
+ * @param       epNum: endpoint number
+ *
+ * @param       pid: returns 0 for DATA0, 1 for DATA1
+ *
+ * @param       data: returns the packet data
+ *
+ * @param       length: returns the packet length
+ *
+ * @retval      Handshake of the device
+ */
+USBD_MODEL_HS_T USBD_VHost_In(uint8_t addr, uint8_t epNum, uint8_t* pid, uint8_t* data, uint16_t* length)
+{
+    USBD_MODEL_HS_T hs;
+
+    USBD_VHost_Slot();
+
+    hs = USBD_Model_In(addr, epNum, pid, data, length);
+    USBD_VHost_Record(USBD_VHOST_TOKEN_IN, addr, epNum, *pid, hs, \
+                      (hs == USBD_MODEL_HS_ACK) ? data : NULL, *length);
+
+    USBD_VHost_RunDevice();
+
+    return hs;
+}
+
+/*!
+ * @brief       Control transfer
+ *
+ * @param       addr: device address
+ *
+ * @param       mps: max packet size of the endpoint 0
+ *
+ * @param       setup: 8 bytes of the request
+ *
+ * @param       data: data stage, IN data returned here
+ *
+ * @param       length: returns the data stage length
+ *
+ * @retval      Transfer status
+ */
+USBD_VHOST_STA_T USBD_VHost_Control(uint8_t addr, uint8_t mps, const uint8_t* setup, uint8_t* data, uint16_t* length)
+{
+    USBD_MODEL_HS_T hs;
+    uint8_t packet[64];
+    uint16_t wLength = (uint16_t)(setup[6] | (setup[7] << 8));
+    uint16_t count = 0;
+    uint16_t packetLen;
+    uint16_t retry;
+    uint8_t pid = 1;
+    uint8_t rxPid = 0;
+
+    *length = 0;
+
+    /* SETUP stage */
+    for (retry = 0; USBD_VHost_Setup(addr, setup) != USBD_MODEL_HS_ACK; retry++)
+    {
+        if (retry >= USBD_VHOST_RETRY_NUM)
+        {
+            return USBD_VHOST_TIMEOUT;
+        }
+    }
+
+    /* Data stage */
+    while (count < wLength)
+    {
+        packetLen = ((wLength - count) > mps) ? mps : (wLength - count);
+
+        for (retry = 0; ; retry++)
+        {
+            if (retry >= USBD_VHOST_RETRY_NUM)
+            {
+                return USBD_VHOST_TIMEOUT;
+            }
+
+            if (setup[0] & 0x80)
+            {
+                hs = USBD_VHost_In(addr, 0, &rxPid, packet, &packetLen);
+            }
+            else
+            {
+                hs = USBD_VHost_Out(addr, 0, pid, data + count, packetLen);
+            }
+
+            if (hs == USBD_MODEL_HS_STALL)
+            {
+                return USBD_VHOST_STALL;
+            }
+
+            if (hs == USBD_MODEL_HS_ACK)
+            {
+                break;
+            }
+        }
+
+        if (setup[0] & 0x80)
+        {
+            if ((rxPid != pid) || (packetLen > mps))
+            {
+                return USBD_VHOST_TOGGLE_ERR;
+            }
+
+            if (packetLen > (wLength - count))
+            {
+                packetLen = wLength - count;
+            }
+
+            memcpy(data + count, packet, packetLen);
+        }
+
+        count += packetLen;
+        pid ^= 1;
+
+        /* A short packet ends the data stage */
+        if (packetLen < mps)
+        {
+            break;
+        }
+    }
+
+    *length = count;
+
+    /* Status stage, a zero length DATA1 packet in the other direction */
+    for (retry = 0; ; retry++)
+    {
+        if (retry >= USBD_VHOST_RETRY_NUM)
+        {
+            return USBD_VHOST_TIMEOUT;
+        }
+
+        if ((setup[0] & 0x80) && (wLength != 0))
+        {
+            hs = USBD_VHost_Out(addr, 0, 1, packet, 0);
+        }
+        else
+        {
+            hs = USBD_VHost_In(addr, 0, &rxPid, packet, &packetLen);
+
+            if ((hs == USBD_MODEL_HS_ACK) && ((rxPid != 1) || (packetLen != 0)))
+            {
+                return USBD_VHOST_TOGGLE_ERR;
+            }
+        }
+
+        if (hs == USBD_MODEL_HS_STALL)
+        {
+            return USBD_VHOST_STALL;
+        }
+
+        if (hs == USBD_MODEL_HS_ACK)
+        {
+            break;
+        }
+    }
+
+    return USBD_VHOST_OK;
+}
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
@@ -0,0 +1,135 @@
+/*!
+ * @file        usbd_vhost.h
+ *
+ * @brief       Virtual USB host of the host build
+ *
+ * @version     V1.0.0
+ *
+ * @date        2023-01-16
+ *
+ * @attention
+ *
+ *  Copyright (C) 2023 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef _USBD_VHOST_H_
+#define _USBD_VHOST_H_
+
+/* Includes */
+#include "usbd_model.h"
+#include <stdio.h>
+
+/** @addtogroup Examples
+  * @brief USBD HID examples
+  @{
+  */
+
+/** @addtogroup USBD_HID
+  @{
+  */
+
+/** @defgroup USBD_HID_Host_Macros Macros
+  @{
+*/
+
+/* Transactions the host schedules in a frame */
+#define USBD_VHOST_FRAME_XACT_NUM   16
+/* Attempts of a transaction before a transfer times out */
+#define USBD_VHOST_RETRY_NUM        2000
+
+/**@} end of group USBD_HID_Host_Macros*/
+
+/** @defgroup USBD_HID_Host_Enumerations Enumerations
+  @{
+  */
+
+/**
+ * @brief   Bus token
+ */
+typedef enum
+{
+    USBD_VHOST_TOKEN_SETUP,
+    USBD_VHOST_TOKEN_OUT,
+    USBD_VHOST_TOKEN_IN,
+    USBD_VHOST_TOKEN_LPM,
+} USBD_VHOST_TOKEN_T;
+
+/**
+ * @brief   Result of a transfer
+ */
+typedef enum
+{
+    USBD_VHOST_OK,
+    USBD_VHOST_STALL,
+    USBD_VHOST_TIMEOUT,
+    USBD_VHOST_TOGGLE_ERR,
+} USBD_VHOST_STA_T;
+
+/**@} end of group USBD_HID_Host_Enumerations*/
+
+/** @defgroup USBD_HID_Host_Structures Structures
+  @{
+  */
+
+/**
+ * @brief   Traffic counters of the virtual host
+ */
+typedef struct
+{
+    uint32_t            frame;
+    uint32_t            xactCnt;
+    uint32_t            ackCnt;
+    uint32_t            nakCnt;
+    uint32_t            stallCnt;
+    uint32_t            noneCnt;
+    uint32_t            byteCnt[2];
+} USBD_VHOST_STAT_T;
+
+/**@} end of group USBD_HID_Host_Structures*/
+
+/** @defgroup USBD_HID_Host_Variables Variables
+  @{
+  */
+
+extern USBD_VHOST_STAT_T gUsbVHostStat;
+
+/**@} end of group USBD_HID_Host_Variables*/
+
+/** @defgroup USBD_HID_Host_Functions Functions
+  @{
+  */
+
+void USBD_VHost_Init(FILE* trace);
+uint32_t USBD_VHost_ReadTimeUs(void);
+void USBD_VHost_HoldEvents(uint8_t hold);
+void USBD_VHost_RunDevice(void);
+void USBD_VHost_Frame(void);
+void USBD_VHost_Idle(uint32_t frames);
+void USBD_VHost_BusReset(void);
+void USBD_VHost_Suspend(uint32_t frames);
+void USBD_VHost_Resume(void);
+USBD_MODEL_HS_T USBD_VHost_Lpm(uint8_t addr, uint8_t besl, uint8_t remoteWake);
+uint32_t USBD_VHost_L1Sleep(uint32_t frames);
+void USBD_VHost_L1Resume(void);
+USBD_MODEL_HS_T USBD_VHost_Setup(uint8_t addr, const uint8_t* data);
+USBD_MODEL_HS_T USBD_VHost_Out(uint8_t addr, uint8_t epNum, uint8_t pid, const uint8_t* data, uint16_t length);
+USBD_MODEL_HS_T USBD_VHost_In(uint8_t addr, uint8_t epNum, uint8_t* pid, uint8_t* data, uint16_t* length);
+USBD_VHOST_STA_T USBD_VHost_Control(uint8_t addr, uint8_t mps, const uint8_t* setup, uint8_t* data, uint16_t* length);
+
+/**@} end of group USBD_HID_Host_Functions */
+/**@} end of group USBD_HID */
+/**@} end of group Examples */
+
+#endif
@@ -26,7 +26,10 @@
 /* Includes */
 #include "apm32f0xx_int.h"
 #include "main.h"
+#include "usbd_board.h"
 #include "apm32f0xx_usb_device.h"
+#include "apm32f0xx_eint.h"
+#include "usb_device_user.h"
 #include "bsp_delay.h"
 #include "tsc_user.h"
 /** @addtogroup Examples
@@ -144,9 +147,35 @@ void SysTick_Handler(void)
  */
 void USBD_IRQHandler(void)
 {
+#if USBD_SUP_LOW_POWER
+    EINT_ClearIntFlag(EINT_LINE18);
+#endif
+
+#if USBD_SUP_LATENCY
+    uint32_t time = TSC_User_ReadTimeUs();
+
+    USBD_IsrHandler(&usbDeviceHandler);
+
+    USB_DevIsrTime(TSC_User_ReadTimeUs() - time);
+#else
     USBD_IsrHandler(&usbDeviceHandler);
+#endif
 }
 
+#if USBD_SUP_CRS_STAT
+/*!
+ * @brief       This function handles RCM and CRS Handler
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void RCM_CRS_IRQHandler(void)
+{
+    USB_DevCrsIsr();
+}
+#endif
+
 /**@} end of group USBD_HID_INT_Functions */
 /**@} end of group USBD_HID */
 /**@} end of group Examples */
@@ -183,4 +212,32 @@ void TSC_IRQHandler(void)
 void TMR14_IRQHandler(void)
 {
     TMR14_Isr();
+}
+
+/*!
+ * @brief        This function handles EINT0_1 Handler
+ *
+ * @param        None
+ *
+ * @retval       None
+ *
+ * @note
+ */
+void EINT0_1_IRQHandler(void)
+{
+    HidMouse_KeyIsr();
+}
+
+/*!
+ * @brief        This function handles EINT2_3 Handler
+ *
+ * @param        None
+ *
+ * @retval       None
+ *
+ * @note
+ */
+void EINT2_3_IRQHandler(void)
+{
+    HidMouse_KeyIsr();
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include "apm32f0xx_gpio.h"
 #include "apm32f0xx_eint.h"
+#include "apm32f0xx_syscfg.h"
 #include "apm32f0xx_misc.h"
 
 /** @addtogroup Board
@@ -48,6 +49,10 @@ const RCM_AHB_PERIPH_T GPIO_CLK[LEDn] = {LED1_GPIO_CLK, LED2_GPIO_CLK, LED3_GPIO
 GPIO_T* BUTTON_PORT[BUTTONn] = {KEY1_BUTTON_GPIO_PORT, KEY2_BUTTON_GPIO_PORT, KEY3_BUTTON_GPIO_PORT, KEY4_BUTTON_GPIO_PORT};
 const GPIO_PIN_T BUTTON_PIN[BUTTONn] = {KEY1_BUTTON_PIN, KEY2_BUTTON_PIN, KEY3_BUTTON_PIN, KEY4_BUTTON_PIN};
 const RCM_AHB_PERIPH_T BUTTON_CLK[BUTTONn] = {KEY1_BUTTON_GPIO_CLK, KEY2_BUTTON_GPIO_CLK, KEY3_BUTTON_GPIO_CLK, KEY4_BUTTON_GPIO_CLK};
+const EINT_LINE_T BUTTON_EINT_LINE[BUTTONn] = {KEY1_BUTTON_EINT_LINE, KEY2_BUTTON_EINT_LINE, KEY3_BUTTON_EINT_LINE, KEY4_BUTTON_EINT_LINE};
+const SYSCFG_PORT_T BUTTON_PORT_SOURCE[BUTTONn] = {KEY1_BUTTON_EINT_PORT_SOURCE, KEY2_BUTTON_EINT_PORT_SOURCE, KEY3_BUTTON_EINT_PORT_SOURCE, KEY4_BUTTON_EINT_PORT_SOURCE};
+const SYSCFG_PIN_T BUTTON_PIN_SOURCE[BUTTONn] = {KEY1_BUTTON_EINT_PIN_SOURCE, KEY2_BUTTON_EINT_PIN_SOURCE, KEY3_BUTTON_EINT_PIN_SOURCE, KEY4_BUTTON_EINT_PIN_SOURCE};
+const IRQn_Type BUTTON_IRQn[BUTTONn] = {KEY1_BUTTON_EINT_IRQn, KEY2_BUTTON_EINT_IRQn, KEY3_BUTTON_EINT_IRQn, KEY4_BUTTON_EINT_IRQn};
 
 USART_T* COM_USART[COMn] = {EVAL_COM1, EVAL_COM2};
 GPIO_T* COM_TX_PORT[COMn] = {EVAL_COM1_TX_GPIO_PORT, EVAL_COM2_TX_GPIO_PORT};
@@ -176,7 +181,8 @@ void APM_EVAL_LEDToggle(Led_TypeDef Led)
  *
  * @retval      None
  *
- * @note
+ * @note        The EINT line triggers on both edges, the press and the
+ *              release
  */
 void APM_EVAL_PBInit(Button_TypeDef Button, ButtonMode_TypeDef Button_Mode)
 {
@@ -194,28 +200,18 @@ void APM_EVAL_PBInit(Button_TypeDef Button, ButtonMode_TypeDef Button_Mode)
 
     if (Button_Mode == BUTTON_MODE_EINT)
     {
-        /* Configure EINT1 line */
-        if (Button == BUTTON_KEY1)
-        {
-            eintConfig.line    =  EINT_LINE1;
-            eintConfig.lineCmd =  ENABLE;
-            eintConfig.mode    =  EINT_MODE_INTERRUPT;
-            eintConfig.trigger =  EINT_TRIGGER_FALLING;
-            EINT_Config(&eintConfig);
-        }
-        /* Configure EINT0 line */
-        else if (Button == BUTTON_KEY2)
-        {
-            eintConfig.line    =  EINT_LINE0;
-            eintConfig.lineCmd =  ENABLE;
-            eintConfig.mode    =  EINT_MODE_INTERRUPT;
-            eintConfig.trigger =  EINT_TRIGGER_FALLING;
-            EINT_Config(&eintConfig);
-        }
+        /* Connect the Button pin to its EINT line */
+        SYSCFG_EINTLine(BUTTON_PORT_SOURCE[Button], BUTTON_PIN_SOURCE[Button]);
 
-        /* Enable and set EINTx Interrupt to the lowest priority */
-        NVIC_EnableIRQRequest(EINT0_1_IRQn, 0x0f);
+        eintConfig.line    =  BUTTON_EINT_LINE[Button];
+        eintConfig.lineCmd =  ENABLE;
+        eintConfig.mode    =  EINT_MODE_INTERRUPT;
+        eintConfig.trigger =  EINT_TRIGGER_ALL;
+        EINT_Config(&eintConfig);
+        EINT_ClearIntFlag(BUTTON_EINT_LINE[Button]);
 
+        /* Enable and set EINTx Interrupt to the lowest priority */
+        NVIC_EnableIRQRequest(BUTTON_IRQn[Button], 0x0f);
     }
 }
 
@@ -236,6 +232,30 @@ uint32_t APM_EVAL_PBGetState(Button_TypeDef Button)
     return GPIO_ReadInputBit(BUTTON_PORT[Button], BUTTON_PIN[Button]);
 }
 
+/*!
+ * @brief       Read the EINT line pending flag of the selected Button.
+ *
+ * @param       Button: Specifies the Button, BUTTON_KEY1 .. BUTTON_KEY4
+ *
+ * @retval      SET or RESET
+ */
+uint8_t APM_EVAL_PBReadEintFlag(Button_TypeDef Button)
+{
+    return EINT_ReadIntFlag(BUTTON_EINT_LINE[Button]);
+}
+
+/*!
+ * @brief       Clear the EINT line pending flag of the selected Button.
+ *
+ * @param       Button: Specifies the Button, BUTTON_KEY1 .. BUTTON_KEY4
+ *
+ * @retval      None
+ */
+void APM_EVAL_PBClearEintFlag(Button_TypeDef Button)
+{
+    EINT_ClearIntFlag(BUTTON_EINT_LINE[Button]);
+}
+
 /*!
  * @brief       The interrupt will happen when the button is press ,
  *              and the Led will be on
@@ -84,10 +84,10 @@ int main(void)
     APM_EVAL_LEDInit(LED1);
     APM_EVAL_LEDInit(LED2);
     APM_EVAL_LEDInit(LED3);
-    APM_EVAL_PBInit(BUTTON_KEY1,BUTTON_MODE_GPIO);
-    APM_EVAL_PBInit(BUTTON_KEY2,BUTTON_MODE_GPIO);
-    APM_EVAL_PBInit(BUTTON_KEY3,BUTTON_MODE_GPIO);
-    APM_EVAL_PBInit(BUTTON_KEY4,BUTTON_MODE_GPIO);
+    APM_EVAL_PBInit(BUTTON_KEY1,BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY2,BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY3,BUTTON_MODE_EINT);
+    APM_EVAL_PBInit(BUTTON_KEY4,BUTTON_MODE_EINT);
     APM_EVAL_COMInit(COM1);
 	
 	  APM_EVAL_TMR14_Init(1000,48);
@@ -102,6 +102,12 @@ int main(void)
         HidMouse_Proc();
 			  if (TSC_User_Action() == TSC_STATUS_OK)
         {
+#if USBD_SUP_LATENCY
+            if (MyObjGroup.Change == TSC_STATE_CHANGED)
+            {
+                USB_DevLatStamp(USBD_LAT_STATE);
+            }
+#endif
             if(taskFlag)
             {
                 TSC_DetectHandler();
@@ -111,13 +117,48 @@ int main(void)
                 TSC_ReleaseHandler();
             }
             
-						if(tscPressStatus!=0)
-							Menu_TSCHandler();
+						if(USBD_HID_ReadReportFormat(&gUsbDeviceFS) == USBD_HID_FORMAT_DIGITIZER)
+						{
+							Digitizer_TSCHandler();
+						}
+						else
+						{
+							Action_TSCHandler();
+							if(tscPressStatus!=0)
+								Menu_TSCHandler();
+						}
+#if USBD_SUP_HID_TLM
+            TSC_User_Telemetry();
+#endif
+#if USBD_SUP_REMOTE_WAKEUP
+            /* The handlers above queued the touch, it is replayed after the resume */
+            if ((gUsbDevAppStatus == USBD_APP_SUSPEND) && (TSC_User_Touched() || HidMouse_ReadKey()))
+            {
+                USB_DevRemoteWakeup();
+            }
+#endif
         }
         else
         {
-            
+            /* Sleep between the suspend scans, the clocks stop when the
+               suspend allowed it */
+            if (gUsbDevAppStatus == USBD_APP_SUSPEND)
+            {
+                USBD_LowPowerSleep();
+            }
         }
+
+#if USBD_SUP_REMOTE_WAKEUP
+        USB_DevWakeProc();
+#endif
+#if USBD_SUP_LATENCY
+        /* The report queued above is stamped before its ACK is serviced */
+        USB_DevLatProc();
+#endif
+        USB_DevFormatProc();
+#if USBD_SUP_DEFER_ISR
+        USB_DevEventProc();
+#endif
 				
     }		
 }
@@ -132,14 +173,11 @@ int main(void)
 void USB_DevUserApplication(void)
 {
     static uint8_t userAppState = USER_APP_INIT;
-    static uint8_t interval = 0;
     static int8_t report[4] = { 0 };
 
     switch (userAppState)
     {
         case USER_APP_INIT:
-            interval = USBD_HID_ReadInterval(&gUsbDeviceFS);
-
             report[0] = 0;
             report[1] = 0;
             report[2] = 0;
@@ -168,7 +206,6 @@ void USB_DevUserApplication(void)
 //                }
 //            }
 
-            APM_DelayMs(interval);
             break;
     }
 }
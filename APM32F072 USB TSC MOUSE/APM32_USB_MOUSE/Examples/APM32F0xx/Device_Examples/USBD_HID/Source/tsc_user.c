@@ -31,12 +31,27 @@
 #include "board_apm32f072_eval.h"
 #include "usbd_hid.h"
 #include "usb_device_user.h"
+#include "apm32f0xx_fmc.h"
+#include <string.h>
 /* Timer tick */
 uint8_t cnt50ms = 0;
 uint8_t taskFlag = 0;
 uint8_t tscPressStatus = 0;
 uint16_t cntTick = 0;
-uint8_t keyRecord=0;
+__IO uint16_t cntMotion = 0;
+__IO uint16_t cntFrame = 0;
+__IO uint16_t cntWake = 0;
+__IO uint32_t cntMs = 0;
+/* TSC_TLM_FILTER_x applied to the acquisition results */
+static uint8_t tscFilter = 0;
+/* GPIO keys: edges pending debounce, debounced level and last edge time */
+static __IO uint8_t keyPending = 0;
+static __IO uint8_t keyLevel = 0;
+static uint16_t keyEdgeTime[BUTTONn];
+/* Mouse buttons of the touch keys and the GPIO keys, and the last sent */
+static uint8_t touchButtons = 0;
+static uint8_t keyButtons = 0;
+static uint8_t sentButtons = 0;
 
 /** @addtogroup Examples
   * @brief TSC touch examples
@@ -52,37 +67,55 @@ uint8_t keyRecord=0;
   */
 
 /* Source and Configuration (ROM) */
-CONST TSC_Channel_Src_T MyChannels_Src[TOUCH_TOTAL_CHANNELS] =
+CONST TSC_Channel_Src_T MyChannels_Src[BLOCK_TOTAL_CHANNELS] =
 {
     /* Block 0 */
     { CHANNEL_1_SRC, CHANNEL_1_IO_MSK, CHANNEL_1_GRP_MSK },
     { CHANNEL_2_SRC, CHANNEL_2_IO_MSK, CHANNEL_2_GRP_MSK },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_SRC, CHANNEL_SHIELD_IO_MSK, CHANNEL_SHIELD_GRP_MSK },
+#endif
 
     /* Block 1 */
     { CHANNEL_0_SRC, CHANNEL_0_IO_MSK, CHANNEL_0_GRP_MSK },
     { CHANNEL_4_SRC, CHANNEL_4_IO_MSK, CHANNEL_4_GRP_MSK },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_SRC, CHANNEL_SHIELD_IO_MSK, CHANNEL_SHIELD_GRP_MSK },
+#endif
     
     /* Block 2 */
     { CHANNEL_3_SRC, CHANNEL_3_IO_MSK, CHANNEL_3_GRP_MSK },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_SRC, CHANNEL_SHIELD_IO_MSK, CHANNEL_SHIELD_GRP_MSK },
+#endif
 };
 
 /* Destination (ROM) */
-CONST TSC_Channel_Dest_T MyChannels_Dest[TOUCH_TOTAL_CHANNELS] =
+CONST TSC_Channel_Dest_T MyChannels_Dest[BLOCK_TOTAL_CHANNELS] =
 {
     /* Block 0 */
     { CHANNEL_1_DEST },
     { CHANNEL_2_DEST },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_DEST },
+#endif
 
     /* Block 1 */
     { CHANNEL_0_DEST },
     { CHANNEL_4_DEST },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_DEST },
+#endif
     
     /* Block 2 */
     { CHANNEL_3_DEST },
+#if TOUCH_USE_WATER > 0
+    { CHANNEL_SHIELD_DEST },
+#endif
 };
 
 /* Data (RAM) */
-TSC_Channel_Data_T MyChannels_Data[TOUCH_TOTAL_CHANNELS];
+TSC_Channel_Data_T MyChannels_Data[TOUCH_TOTAL_CHANNELS + SHIELD_NUMCHANNELS];
 
 /**@} Channels_Config */
 
@@ -91,9 +124,9 @@ TSC_Channel_Data_T MyChannels_Data[TOUCH_TOTAL_CHANNELS];
 */
 /** List (ROM) */
 CONST TSC_Block_T MyBlocks[TOUCH_TOTAL_BLOCKS] = {
-    {&MyChannels_Src[0], &MyChannels_Dest[0], MyChannels_Data, BLOCK_0_NUMCHANNELS, BLOCK_0_MSK_CHANNELS, BLOCK_0_MSK_GROUPS},
-    {&MyChannels_Src[2], &MyChannels_Dest[2], MyChannels_Data, BLOCK_1_NUMCHANNELS, BLOCK_1_MSK_CHANNELS, BLOCK_1_MSK_GROUPS},
-    {&MyChannels_Src[4], &MyChannels_Dest[4], MyChannels_Data, BLOCK_2_NUMCHANNELS, BLOCK_2_MSK_CHANNELS, BLOCK_2_MSK_GROUPS}
+    {&MyChannels_Src[BLOCK_0_FIRST_CHANNEL], &MyChannels_Dest[BLOCK_0_FIRST_CHANNEL], MyChannels_Data, BLOCK_0_NUMCHANNELS, BLOCK_0_MSK_CHANNELS, BLOCK_0_MSK_GROUPS},
+    {&MyChannels_Src[BLOCK_1_FIRST_CHANNEL], &MyChannels_Dest[BLOCK_1_FIRST_CHANNEL], MyChannels_Data, BLOCK_1_NUMCHANNELS, BLOCK_1_MSK_CHANNELS, BLOCK_1_MSK_GROUPS},
+    {&MyChannels_Src[BLOCK_2_FIRST_CHANNEL], &MyChannels_Dest[BLOCK_2_FIRST_CHANNEL], MyChannels_Data, BLOCK_2_NUMCHANNELS, BLOCK_2_MSK_CHANNELS, BLOCK_2_MSK_GROUPS}
 };
 
 /**@} Blocks_Config */
@@ -200,12 +233,46 @@ TSC_ObjectGroup_T MyObjGroup =
     TSC_STATE_NOT_CHANGED /*!< Current state */
 };
 
+#if TOUCH_USE_DXS_ARB > 0
+/* Arbitration of the group (RAM) */
+TSC_DxsArb_T MyArb;
+#endif
+
+#if TOUCH_USE_WATER > 0
+/* Shield sensor: calibrated like a TouchKey, in its own group (RAM/ROM) */
+TSC_TouchKeyData_T MyShield_Data;
+TSC_TouchKeyParam_T MyShield_Param;
+
+CONST TSC_TouchKey_T MyShieldKey =
+{
+    &MyShield_Data, &MyShield_Param, &MyChannels_Data[CHANNEL_SHIELD_DEST], MyKeys_StateMachine, &MyKeys_Methods
+};
+
+CONST TSC_Object_T MyShieldObject =
+{
+    TSC_OBJ_TOUCHKEY, (TSC_TouchKey_T *)&MyShieldKey
+};
+
+TSC_ObjectGroup_T MyShieldGroup =
+{
+    &MyShieldObject,      /*!< First object */
+    1,                    /*!< Number of objects */
+    0x00,                 /*!< State mask reset value */
+    TSC_STATE_NOT_CHANGED /*!< Current state */
+};
+
+/* Water rejection of the group (RAM) */
+TSC_Water_T MyWater;
+#endif
+
 TSC_Params_T TSC_Params =
 {
     TOUCH_ACQ_MIN,
     TOUCH_ACQ_MAX,
     TOUCH_CALIB_SAMPLES,
     TOUCH_DTO,
+    TOUCH_ECS_K_DIFFER,
+    TOUCH_ECS_K_SAME,
 #if TOUCH_TOTAL_KEYS > 0
     MyKeys_StateMachine,    /*!< Default state machine for TouchKeys */
     &MyKeys_Methods,        /*!< Default methods for TouchKeys */
@@ -241,6 +308,13 @@ void TSC_User_Config(void)
     /* This function must be created by the user to initialize the Touch Sensing GPIOs */
 #endif
     TSC_Obj_ConfigGroup(&MyObjGroup);
+#if TOUCH_USE_DXS_ARB > 0
+    TSC_Dxs_ConfigArbitration(&MyArb);
+#endif
+#if TOUCH_USE_WATER > 0
+    TSC_Obj_ConfigGroup(&MyShieldGroup);
+    TSC_Water_Config(&MyWater, &MyChannels_Data[CHANNEL_SHIELD_DEST]);
+#endif
     TSC_Config(MyBlocks);
     TSC_User_Thresholds();
 }
@@ -257,6 +331,25 @@ TSC_STATUS_T TSC_User_Action(void)
     static uint32_t idx_block = 0;
     static uint32_t config_done = 0;
     TSC_STATUS_T status;
+    uint16_t period = USBD_HID_ReadInterval(&gUsbDeviceFS);
+
+#if USBD_SUP_REMOTE_WAKEUP
+    /* Slow scan while the bus is suspended, a touch wakes the host */
+    if (gUsbDevAppStatus == USBD_APP_SUSPEND)
+    {
+        period = TSC_SUSPEND_SCAN_PERIOD;
+    }
+#endif
+
+    /* Start one acquisition frame per HID report interval */
+    if ((idx_block == 0) && (!config_done))
+    {
+        if (cntFrame < period)
+        {
+            return TSC_STATUS_BUSY;
+        }
+        cntFrame = 0;
+    }
 
     /* Configure block */
     if (!config_done)
@@ -276,7 +369,9 @@ TSC_STATUS_T TSC_User_Action(void)
     if (TSC_Acq_WaitBlockEOA() == TSC_STATUS_OK)
     #endif
     {
-        TSC_Acq_ReadBlockResult(idx_block, 0, 0);
+        TSC_Acq_ReadBlockResult(idx_block, \
+                                (tscFilter & TSC_TLM_FILTER_MEAS) ? TSC_Filt_MeasFilter : 0, \
+                                (tscFilter & TSC_TLM_FILTER_DELTA) ? TSC_Filt_DeltaFilter : 0);
         idx_block++;
         config_done = 0;
     }
@@ -284,16 +379,34 @@ TSC_STATUS_T TSC_User_Action(void)
     /* Process objects, DxS and ECS, Check if all blocks have been acquired */
     if (idx_block > TOUCH_TOTAL_BLOCKS-1)
     {
+#if USBD_SUP_LATENCY
+        USB_DevLatStamp(USBD_LAT_EOA);
+#endif
         idx_block = 0;
         config_done = 0;
 
         TSC_Obj_ProcessGroup(&MyObjGroup);
         TSC_Dxs_FirstObj(&MyObjGroup);
+#if TOUCH_USE_DXS_ARB > 0
+        TSC_Dxs_Arbitrate(&MyObjGroup, &MyArb);
+#endif
+#if TOUCH_USE_WATER > 0
+        TSC_Obj_ProcessGroup(&MyShieldGroup);
+        TSC_Water_Process(&MyObjGroup, &MyWater);
+#endif
 
-        /* ECS every 100ms */
+        /* ECS every 100ms, paused while water is present */
         if (TSC_Time_Delay_ms(100, &Global_ECS_last_tick) == TSC_STATUS_OK)
         {
+#if TOUCH_USE_WATER > 0
+            if (MyWater.Wet == TSC_FALSE)
+            {
+                TSC_Ecs_Process(&MyShieldGroup);
+            }
+            if ((MyWater.Wet == TSC_FALSE) && (TSC_Ecs_Process(&MyObjGroup) == TSC_STATUS_OK))
+#else
             if (TSC_Ecs_Process(&MyObjGroup) == TSC_STATUS_OK)
+#endif
             {
                 Global_ProcessSensor = 0;
             }
@@ -311,6 +424,67 @@ TSC_STATUS_T TSC_User_Action(void)
     return status;
 }
 
+/*!
+ * @brief       Check if a finger is on or near any key
+ *
+ * @param       None
+ *
+ * @retval      1 if a key is in detect or proximity state, 0 otherwise
+ */
+uint8_t TSC_User_Touched(void)
+{
+    uint8_t idx_key;
+
+    for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+    {
+        if (TOUCHKEY_PRESS(idx_key))
+        {
+            return 1;
+        }
+#if TOUCH_USE_PROX > 0
+        if (MyTouchKeys[idx_key].p_Data->StateId == TSC_STATEID_PROX)
+        {
+            return 1;
+        }
+#endif
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief       Read the TMR14 time base in us, wrapping every 71 minutes
+ *
+ * @param       None
+ *
+ * @retval      time in us
+ *
+ * @note        TMR14 counts at 1 MHz with a 1 ms period. It may be
+ *              called from an interrupt that blocks the TMR14 one.
+ */
+uint32_t TSC_User_ReadTimeUs(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t ms;
+    uint32_t us;
+
+    __disable_irq();
+
+    ms = cntMs;
+    us = TMR14->CNT;
+
+    /* The counter wrapped and the update is not counted yet */
+    if (TMR_ReadIntFlag(TMR14, TMR_INT_FLAG_UPDATE) == SET)
+    {
+        ms++;
+        us = TMR14->CNT;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ms * 1000 + us;
+}
+
 /*!
  * @brief       Set thresholds for each object (optional).
  *
@@ -336,6 +510,12 @@ void TSC_User_Thresholds(void)
  */
 void TSC_DetectHandler(void)
 {
+#if TOUCH_USE_DXS_ARB > 0
+    /* Object n of MyObjGroup is reported as TSC_TOUCH_K(n+1), a key that
+       loses the arbitration is no longer reported even if still detected */
+    tscPressStatus = (tscPressStatus & (uint8_t)~TSC_TOUCH_ARB_MASK) | \
+                     ((uint8_t)MyArb.Winners & TSC_TOUCH_ARB_MASK);
+#else
     uint8_t idx_key;
 
     for(idx_key = 0; idx_key < TOUCH_TOTAL_CHANNELS; idx_key++)
@@ -366,6 +546,12 @@ void TSC_DetectHandler(void)
             }
         }
     }
+#endif
+
+#if TOUCH_USE_WATER > 0
+    /* Drop the detections correlated with the water on the shield */
+    tscPressStatus &= (uint8_t)~MyWater.Suppressed;
+#endif
 }
 
 /*!
@@ -490,8 +676,25 @@ void TMR14_Isr(void)
     if(TMR_ReadIntFlag(TMR14,TMR_INT_FLAG_UPDATE) == SET)
     {
         TMR_ClearIntFlag(TMR14,TMR_INT_FLAG_UPDATE);
+        /* 1 ms time base of the TSC library, TOUCH_TICK_FREQ, for the
+           ECS period and delay */
+        TSC_Time_ProcessInterrupt();
         cntTick++;
+        cntMs++;
+        HidMouse_KeyTick();
 			  cnt50ms++;
+        if(cntMotion < HID_MOUSE_MOTION_PERIOD)
+        {
+            cntMotion++;
+        }
+        if(cntFrame < 0xFFFF)
+        {
+            cntFrame++;
+        }
+        if(cntWake < 0xFFFF)
+        {
+            cntWake++;
+        }
         if(cnt50ms >= 80)
         {
             cnt50ms = 0;
@@ -503,89 +706,145 @@ void TMR14_Isr(void)
         if(cntTick >= 500)
         {
             cntTick = 0;
-            APM_EVAL_LEDToggle(LED1);
+#if USBD_SUP_REMOTE_WAKEUP
+            /* Keep the suspend current low */
+            if(gUsbDevAppStatus == USBD_APP_SUSPEND)
+            {
+                APM_EVAL_LEDOff(LED1);
+            }
+            else
+#endif
+            {
+                APM_EVAL_LEDToggle(LED1);
+            }
         }
     }
 }
 
 /*!
- * @brief       Mouse write
+ * @brief       GPIO key edge interrupt, stamps the edge and leaves the
+ *              level to HidMouse_KeyTick
  *
- * @param       key:    Mouse key
+ * @param       None
  *
  * @retval      None
+ *
+ * @note        Called from the EINT0_1 and EINT2_3 interrupts
  */
-void HidMouse_Write(uint8_t key)
+void HidMouse_KeyIsr(void)
 {
-    int8_t x = 0;
-    int8_t y = 0;
-	
-	  int8_t Button = 0;
-	
-    uint8_t buffer[4] = {0, 0, 0, 0};
-    keyRecord=key;
-    switch (key)
-    {
-        case HID_MOUSE_KEY_RIGHT:
-            Button =0x02;
-        break;
+    uint8_t i;
 
-        case HID_MOUSE_KEY_LEFT:
-            Button =0x01;
-        break;
+    for(i = 0; i < BUTTONn; i++)
+    {
+        if(APM_EVAL_PBReadEintFlag((Button_TypeDef)i) == SET)
+        {
+            APM_EVAL_PBClearEintFlag((Button_TypeDef)i);
 
-        case HID_MOUSE_KEY_UP:
-            //y -= 10;
-        break;
+            /* Every bounce restarts the debounce time, TMR14 may preempt */
+            __disable_irq();
+            keyEdgeTime[i] = (uint16_t)cntMs;
+            keyPending |= (0x01 << i);
+            __enable_irq();
+        }
+    }
+}
 
-        case HID_MOUSE_KEY_DOWN:
-            //y += 10;
-        break;
+/*!
+ * @brief       GPIO key debounce, samples a key once no edge has come
+ *              for HID_MOUSE_KEY_DEBOUNCE ms
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ * @note        Called from the 1 ms TMR14 interrupt
+ */
+void HidMouse_KeyTick(void)
+{
+    uint8_t i;
+    uint8_t mask;
 
-        default:
-            return;
+    if(keyPending == 0)
+    {
+        return;
     }
 
-		buffer[0] = Button;
-    buffer[1] = x;
-    buffer[2] = y;
-		
-    USBD_HID_TxReport(&gUsbDeviceFS, (uint8_t*)buffer, 4);
+    for(i = 0; i < BUTTONn; i++)
+    {
+        mask = 0x01 << i;
+
+        if((keyPending & mask) && ((uint16_t)((uint16_t)cntMs - keyEdgeTime[i]) >= HID_MOUSE_KEY_DEBOUNCE))
+        {
+            keyPending &= (uint8_t)~mask;
+
+            /* The keys pull the pin low */
+            if(APM_EVAL_PBGetState((Button_TypeDef)i) == Bit_RESET)
+            {
+                keyLevel |= mask;
+            }
+            else
+            {
+                keyLevel &= (uint8_t)~mask;
+            }
+        }
+    }
 }
+
 /*!
- * @brief       Read key
+ * @brief       Send the touch and GPIO key buttons together
  *
  * @param       None
  *
  * @retval      None
+ *
+ * @note        A full report queue is retried on the next call
  */
-uint8_t HidMouse_ReadKey(void)
+static void HidMouse_ButtonSync(void)
 {
-    /** Up key */
-    if(!GPIO_ReadInputBit(GPIOC, GPIO_PIN_0))
-    {
-        return HID_MOUSE_KEY_UP;
-    }
+    uint8_t buttons = touchButtons | keyButtons;
 
-    /** Down key */
-    if(!GPIO_ReadInputBit(GPIOC, GPIO_PIN_1))
+    if((buttons != sentButtons) && (USBD_HID_MouseButton(&gUsbDeviceFS, buttons) != USBD_BUSY))
     {
-        return HID_MOUSE_KEY_DOWN;
+        sentButtons = buttons;
     }
+}
+
+/*!
+ * @brief       Mouse write
+ *
+ * @param       keys:    HID_MOUSE_KEY_x bitmap
+ *
+ * @retval      None
+ */
+void HidMouse_Write(uint8_t keys)
+{
+    uint8_t buttons = 0;
 
-    /** Left key */
-    if(!GPIO_ReadInputBit(GPIOC, GPIO_PIN_2))
+    if(keys & HID_MOUSE_KEY_LEFT)
     {
-        return HID_MOUSE_KEY_LEFT;
+        buttons |= 0x01;
     }
-    
-    /** Right key */
-    if(!GPIO_ReadInputBit(GPIOC, GPIO_PIN_3))
+
+    if(keys & HID_MOUSE_KEY_RIGHT)
     {
-        return HID_MOUSE_KEY_RIGHT;
+        buttons |= 0x02;
     }
 
-    return HID_MOUSE_KEY_NULL;
+    keyButtons = buttons;
+    HidMouse_ButtonSync();
+}
+
+/*!
+ * @brief       Read key
+ *
+ * @param       None
+ *
+ * @retval      Debounced HID_MOUSE_KEY_x bitmap
+ */
+uint8_t HidMouse_ReadKey(void)
+{
+    return keyLevel;
 }
 
 /*!
@@ -597,29 +856,7 @@ uint8_t HidMouse_ReadKey(void)
  */
 void HidMouse_Proc(void)
 {
-    uint8_t key = HID_MOUSE_KEY_NULL;
-	  uint8_t bufferM[4] = {0, 0, 0, 0};
-
-
-
-    key = HidMouse_ReadKey();
-    if(key != HID_MOUSE_KEY_NULL)
-    {
-            HidMouse_Write(key);
-
-    }
-		else
-		{
-			 if(keyRecord)
-						{
-							 keyRecord=0;
-							 bufferM[0] = 0;
-               bufferM[1] = 0;
-               bufferM[2] = 0;
-		           APM_DelayMs(20);
-               USBD_HID_TxReport(&gUsbDeviceFS, (uint8_t*)bufferM, 4);
-						}
-		}
+    HidMouse_Write(HidMouse_ReadKey());
 }
 
 
@@ -635,48 +872,654 @@ void HidMouse_Proc(void)
  */
 
 #define  vector  5
+
+/* Action of each touch key, K1 .. K5 */
+CONST TSC_ACTION_T MyKeyActions[TOUCH_TOTAL_CHANNELS] =
+{
+    { TSC_ACTION_MOVE,     0, 0,       -vector, 0 },
+    { TSC_ACTION_MOVE,     0, vector,  0,       0 },
+    { TSC_ACTION_MOVE,     0, 0,       vector,  0 },
+    { TSC_ACTION_CONSUMER, 0, 0,       0,       HID_CONSUMER_PLAY_PAUSE },
+    { TSC_ACTION_MOVE,     0, -vector, 0,       0 },
+};
+
 void Menu_TSCHandler(void)
 {
+    static int16_t fracX = 0;
+    static int16_t fracY = 0;
     uint8_t i;
-    uint8_t temp;
+    uint16_t elapsed;
 	
-	  int8_t x = 0;
-    int8_t y = 0;
-    uint8_t buffer[4] = {0, 0, 0, 0};
+	  int16_t x = 0;
+    int16_t y = 0;
+
+    /* Step the cursor once per report interval without blocking the acquisition */
+    if(cntMotion < USBD_HID_ReadInterval(&gUsbDeviceFS))
+    {
+        return;
+    }
+    elapsed = cntMotion;
+    cntMotion = 0;
    
     for(i = 0; i < TOUCH_TOTAL_CHANNELS; i++)
     {
-        
-        temp = tscPressStatus & (0x01 << i);
-			
-        switch(temp)
+        if((tscPressStatus & (0x01 << i)) && (MyKeyActions[i].type == TSC_ACTION_MOVE))
+        {
+            x += MyKeyActions[i].x;
+            y += MyKeyActions[i].y;
+        }
+    }
+		tscPressStatus =0;
+
+    /* Keep the speed at vector counts per HID_MOUSE_MOTION_PERIOD ms at any report rate */
+    fracX = (x == 0) ? 0 : (int16_t)(fracX + x * (int16_t)elapsed);
+    fracY = (y == 0) ? 0 : (int16_t)(fracY + y * (int16_t)elapsed);
+    x = fracX / HID_MOUSE_MOTION_PERIOD;
+    y = fracY / HID_MOUSE_MOTION_PERIOD;
+    fracX -= x * HID_MOUSE_MOTION_PERIOD;
+    fracY -= y * HID_MOUSE_MOTION_PERIOD;
+
+    USBD_HID_MouseMove(&gUsbDeviceFS, x, y, 0);
+}
+
+
+/*!
+ * @brief       TSC touch digitizer, maps each touch key to a region of
+ *              the absolute surface
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ * @note        Adjacent keys touched together report the point between them
+ */
+void Digitizer_TSCHandler(void)
+{
+    /* Region centre of K1 .. K5 on the 0 .. 32767 surface */
+    static const uint16_t regionX[TOUCH_TOTAL_CHANNELS] = {16384, 28672, 16384, 16384, 4096};
+    static const uint16_t regionY[TOUCH_TOTAL_CHANNELS] = {4096, 16384, 28672, 16384, 16384};
+    static uint16_t lastX = 16384;
+    static uint16_t lastY = 16384;
+    uint32_t sumX = 0;
+    uint32_t sumY = 0;
+    uint8_t touched = 0;
+    uint8_t i;
+
+    for(i = 0; i < TOUCH_TOTAL_CHANNELS; i++)
+    {
+        if(tscPressStatus & (0x01 << i))
         {
-            case TSC_TOUCH_K1:
-						     y -= vector;
+            sumX += regionX[i];
+            sumY += regionY[i];
+            touched++;
+        }
+    }
+
+    if(touched)
+    {
+        lastX = (uint16_t)(sumX / touched);
+        lastY = (uint16_t)(sumY / touched);
+        USBD_HID_DigitizerWrite(&gUsbDeviceFS, USBD_HID_DIGITIZER_TIP | USBD_HID_DIGITIZER_IN_RANGE, lastX, lastY);
+    }
+    else
+    {
+        /* Lift keeps the last position */
+        USBD_HID_DigitizerWrite(&gUsbDeviceFS, 0, lastX, lastY);
+    }
+}
+
+/*!
+ * @brief       TSC touch key actions, sends the button, keyboard and
+ *              consumer actions of the keys currently touched
+ *
+ * @param       None
+ *
+ * @retval      None
+ *
+ * @note        The HID class only queues a report when a state changes, a
+ *              full queue is retried on the next call
+ */
+void Action_TSCHandler(void)
+{
+    uint8_t keys[USBD_HID_KEYBOARD_KEYS] = {0};
+    uint8_t level = 0;
+    uint8_t buttons = 0;
+    uint8_t modifier = 0;
+    uint8_t numKeys = 0;
+    uint16_t consumer = 0;
+    uint8_t i;
+
+#if TOUCH_USE_DXS_ARB > 0
+    level = (uint8_t)MyArb.Winners;
+#else
+    for(i = 0; i < TOUCH_TOTAL_CHANNELS; i++)
+    {
+        if(TOUCHKEY_PRESS(i))
+        {
+            level |= (0x01 << i);
+        }
+    }
+#endif
+#if TOUCH_USE_WATER > 0
+    level &= (uint8_t)~MyWater.Suppressed;
+#endif
+
+    for(i = 0; i < TOUCH_TOTAL_CHANNELS; i++)
+    {
+        if((level & (0x01 << i)) == 0)
+        {
+            continue;
+        }
+
+        switch(MyKeyActions[i].type)
+        {
+            case TSC_ACTION_BUTTON:
+                buttons |= (uint8_t)MyKeyActions[i].code;
                 break;
-            
-            case TSC_TOUCH_K2:
-						    x += vector;
+
+            case TSC_ACTION_KEY:
+                modifier |= MyKeyActions[i].modifier;
+                if((MyKeyActions[i].code != 0) && (numKeys < USBD_HID_KEYBOARD_KEYS))
+                {
+                    keys[numKeys++] = (uint8_t)MyKeyActions[i].code;
+                }
                 break;
-            
-            case TSC_TOUCH_K3:
-						     y += vector;
+
+            case TSC_ACTION_CONSUMER:
+                if(consumer == 0)
+                {
+                    consumer = MyKeyActions[i].code;
+                }
                 break;
-            
-            case TSC_TOUCH_K4:
 
+            default:
                 break;
-            
-            case TSC_TOUCH_K5:
-						    x -= vector;
+        }
+    }
+
+    /* The GPIO keys share the buttons */
+    touchButtons = buttons;
+    HidMouse_ButtonSync();
+    USBD_HID_KeyboardWrite(&gUsbDeviceFS, modifier, keys);
+    USBD_HID_ConsumerWrite(&gUsbDeviceFS, consumer);
+}
+
+#if USBD_SUP_HID_TLM
+
+#if (TSC_TLM_HEADER_SIZE + TSC_TLM_CHANNELS * TSC_TLM_CHANNEL_SIZE) > USBD_HID_TLM_EP_SIZE
+#error "TSC telemetry does not fit in one report"
+#endif
+
+#if TSC_PARAM_SIZE > USBD_HID_TLM_EP_SIZE
+#error "TSC parameter block does not fit in one feature report"
+#endif
+
+/* Telemetry report, copied to the endpoint when it is sent */
+static uint8_t tlmReport[USBD_HID_TLM_EP_SIZE];
+/* Command received by the OUT endpoint, applied between frames */
+static uint8_t tlmCmd[USBD_HID_TLM_EP_SIZE];
+static __IO uint8_t tlmCmdLen = 0;
+static uint8_t tlmStream = 0;
+static uint16_t tlmSeq = 0;
+/* Parameter block received by SET_REPORT, applied between frames */
+static uint8_t paramPending[TSC_PARAM_SIZE];
+static __IO uint8_t paramPendingFlag = 0;   /*!< 1 to apply, 2 to save */
+
+/*!
+ * @brief       Store a telemetry command, called from the USB interrupt
+ *
+ * @param       buffer: command report
+ *
+ * @param       length: command length
+ *
+ * @retval      TSC_STATUS_BUSY if the previous command is not applied yet
+ */
+TSC_STATUS_T TSC_User_TlmReceive(uint8_t* buffer, uint8_t length)
+{
+    if ((tlmCmdLen != 0) || (length == 0))
+    {
+        return TSC_STATUS_BUSY;
+    }
+
+    memcpy(tlmCmd, buffer, length);
+    tlmCmdLen = length;
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Apply a telemetry command to one key
+ *
+ * @param       param: key parameters
+ *
+ * @retval      None
+ */
+static void TSC_User_TlmApply(TSC_TouchKeyParam_T* param)
+{
+    switch (tlmCmd[0])
+    {
+        case TSC_TLM_CMD_THRESHOLD:
+            param->DetectInTh = tlmCmd[2];
+            param->DetectOutTh = tlmCmd[3];
+            param->CalibTh = tlmCmd[4];
+            break;
+
+        case TSC_TLM_CMD_DEBOUNCE:
+            param->CounterDebDetect = tlmCmd[2];
+            param->CounterDebRelease = tlmCmd[3];
+            param->CounterDebCalib = tlmCmd[4];
+            param->CounterDebError = tlmCmd[5];
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief       Apply the pending telemetry command
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void TSC_User_TlmCommand(void)
+{
+    uint8_t idx_key;
+
+    switch (tlmCmd[0])
+    {
+        case TSC_TLM_CMD_STREAM:
+            tlmStream = tlmCmd[1];
+            break;
+
+        case TSC_TLM_CMD_THRESHOLD:
+        case TSC_TLM_CMD_DEBOUNCE:
+            for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+            {
+                if ((tlmCmd[1] == idx_key) || (tlmCmd[1] == TSC_TLM_KEY_ALL))
+                {
+                    TSC_User_TlmApply(MyTouchKeys[idx_key].p_Param);
+                }
+            }
+            break;
+
+        case TSC_TLM_CMD_FILTER:
+            tscFilter = tlmCmd[1];
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief       Pack one channel record of the telemetry report
+ *
+ * @param       record: record in the report
+ *
+ * @param       key: touch key of the channel
+ *
+ * @retval      None
+ */
+static void TSC_User_TlmPack(uint8_t* record, CONST TSC_TouchKey_T* key)
+{
+#if TOUCH_USE_MEAS > 0
+    record[0] = (uint8_t)key->p_ChD->Meas;
+    record[1] = (uint8_t)(key->p_ChD->Meas >> 8);
+#else
+    record[0] = 0;
+    record[1] = 0;
+#endif
+    record[2] = (uint8_t)key->p_ChD->Delta;
+    record[3] = (uint8_t)((uint16_t)key->p_ChD->Delta >> 8);
+    record[4] = (uint8_t)key->p_ChD->Refer;
+    record[5] = (uint8_t)(key->p_ChD->Refer >> 8);
+    record[6] = (uint8_t)key->p_Data->StateId;
+}
+
+/*!
+ * @brief       Check the record of one key against the ranges of tsc_check.h
+ *
+ * @param       record: key record of a parameter block
+ *
+ * @param       param: key parameters, for the proximity threshold
+ *
+ * @retval      TSC_STATUS_OK if the record can be applied
+ */
+static TSC_STATUS_T TSC_User_ParamKeyCheck(const uint8_t* record, CONST TSC_TouchKeyParam_T* param)
+{
+    uint8_t i;
+
+    /* Detect out below detect in, and above the proximity in threshold */
+    if (record[1] >= record[0])
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+#if TOUCH_USE_PROX > 0
+    if (record[1] <= param->ProxInTh)
+    {
+        return TSC_STATUS_ERROR;
+    }
+#else
+    (void)param;
+#endif
+
+    /* A calibration threshold of 0 recalibrates on any negative delta */
+    if (record[2] == 0)
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    /* Calibration, detect, release and error debounce */
+    for (i = 3; i < TSC_PARAM_KEY_SIZE; i++)
+    {
+        if (record[i] > TSC_PARAM_DEB_MAX)
+        {
+            return TSC_STATUS_ERROR;
+        }
+    }
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Check a parameter block
+ *
+ * @param       block: parameter block
+ *
+ * @retval      TSC_STATUS_OK if the block can be applied
+ */
+static TSC_STATUS_T TSC_User_ParamCheck(const uint8_t* block)
+{
+    uint16_t acqMin = block[4] | (block[5] << 8);
+    uint16_t acqMax = block[6] | (block[7] << 8);
+    const uint8_t* record = &block[TSC_PARAM_HEADER_SIZE];
+    uint8_t idx_key;
+
+    if ((block[0] != TSC_PARAM_VERSION) || (block[1] != TOUCH_TOTAL_KEYS))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    if ((acqMin < 1) || (acqMin >= acqMax) || (acqMax > 50000))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    if (block[10] & (uint8_t)~(TSC_TLM_FILTER_MEAS | TSC_TLM_FILTER_DELTA))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+    {
+        if (TSC_User_ParamKeyCheck(record, MyTouchKeys[idx_key].p_Param) != TSC_STATUS_OK)
+        {
+            return TSC_STATUS_ERROR;
+        }
+        record += TSC_PARAM_KEY_SIZE;
+    }
+
+    switch (block[3])
+    {
+        case 1:
+        case 2:
+        case 4:
+        case 8:
+        case 10:
+            break;
+
+        default:
+            return TSC_STATUS_ERROR;
+    }
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Apply a checked parameter block.
+ *              The report interval takes effect at the next enumeration.
+ *
+ * @param       block: parameter block
+ *
+ * @retval      None
+ */
+static void TSC_User_ParamApply(const uint8_t* block)
+{
+    TSC_TouchKeyParam_T* param;
+    const uint8_t* record = &block[TSC_PARAM_HEADER_SIZE];
+    uint8_t idx_key;
+
+    /* GET_REPORT reads the parameters from the USB interrupt */
+    __disable_irq();
+
+    USBD_HID_ConfigInterval(block[3]);
+    TSC_Params.AcqMin = block[4] | (block[5] << 8);
+    TSC_Params.AcqMax = block[6] | (block[7] << 8);
+    TSC_Params.EcsKDiffer = block[8];
+    TSC_Params.EcsKSame = block[9];
+    tscFilter = block[10];
+
+    for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+    {
+        param = MyTouchKeys[idx_key].p_Param;
+        param->DetectInTh = record[0];
+        param->DetectOutTh = record[1];
+        param->CalibTh = record[2];
+        param->CounterDebCalib = record[3];
+        param->CounterDebDetect = record[4];
+        param->CounterDebRelease = record[5];
+        param->CounterDebError = record[6];
+        record += TSC_PARAM_KEY_SIZE;
+    }
+
+    __enable_irq();
+}
+
+/*!
+ * @brief       Write a parameter block to flash.
+ *              The page erase stalls the CPU for some ms, the USB
+ *              interrupt included. The host sees the endpoints NAK.
+ *
+ * @param       block: parameter block
+ *
+ * @retval      None
+ */
+static void TSC_User_ParamSave(const uint8_t* block)
+{
+    uint8_t image[TSC_PARAM_SIZE + 1];
+    uint32_t addr = TSC_PARAM_FLASH_ADDR;
+    uint8_t i;
+
+    /* The save flag is not stored, pad to whole half words */
+    memcpy(image, block, TSC_PARAM_SIZE);
+    image[2] = 0;
+    image[TSC_PARAM_SIZE] = 0;
+
+    FMC_Unlock();
+
+    /* The magic is programmed last, a save cut by a reset leaves the
+       page without it and the defaults are kept */
+    if (FMC_ErasePage(addr) == FMC_STATE_COMPLETE)
+    {
+        for (i = 0; i < TSC_PARAM_SIZE; i += 2)
+        {
+            if (FMC_ProgramHalfWord(addr + 2 + i, image[i] | (image[i + 1] << 8)) != FMC_STATE_COMPLETE)
+            {
                 break;
+            }
+        }
+
+        if (i >= TSC_PARAM_SIZE)
+        {
+            FMC_ProgramHalfWord(addr, TSC_PARAM_FLASH_MAGIC);
         }
     }
-		tscPressStatus =0;
-		buffer[1] = x;
-		buffer[2] = y;
 
-		APM_DelayMs(20);
-    USBD_HID_TxReport(&gUsbDeviceFS, (uint8_t*)buffer, 4);		
+    FMC_Lock();
+}
+
+/*!
+ * @brief       Load the parameter block saved in flash, if any
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void TSC_User_ParamLoad(void)
+{
+    const uint8_t* block = (const uint8_t*)(TSC_PARAM_FLASH_ADDR + 2);
+
+    if (*(__IO uint16_t*)TSC_PARAM_FLASH_ADDR != TSC_PARAM_FLASH_MAGIC)
+    {
+        return;
+    }
+
+    if (TSC_User_ParamCheck(block) == TSC_STATUS_OK)
+    {
+        TSC_User_ParamApply(block);
+    }
+}
+
+/*!
+ * @brief       Read the parameter block, called from the USB interrupt
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      TSC_STATUS_ERROR if the report is too short
+ */
+TSC_STATUS_T TSC_User_ParamRead(uint8_t* buffer, uint8_t length)
+{
+    CONST TSC_TouchKeyParam_T* param;
+    uint8_t* record = &buffer[TSC_PARAM_HEADER_SIZE];
+    uint8_t idx_key;
+
+    if (length < TSC_PARAM_SIZE)
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    buffer[0] = TSC_PARAM_VERSION;
+    buffer[1] = TOUCH_TOTAL_KEYS;
+    buffer[2] = 0;
+    buffer[3] = USBD_HID_ReadInterval(&gUsbDeviceFS);
+    buffer[4] = (uint8_t)TSC_Params.AcqMin;
+    buffer[5] = (uint8_t)(TSC_Params.AcqMin >> 8);
+    buffer[6] = (uint8_t)TSC_Params.AcqMax;
+    buffer[7] = (uint8_t)(TSC_Params.AcqMax >> 8);
+    buffer[8] = (uint8_t)TSC_Params.EcsKDiffer;
+    buffer[9] = (uint8_t)TSC_Params.EcsKSame;
+    buffer[10] = tscFilter;
+    buffer[11] = 0;
+
+    for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+    {
+        param = MyTouchKeys[idx_key].p_Param;
+        record[0] = param->DetectInTh;
+        record[1] = param->DetectOutTh;
+        record[2] = param->CalibTh;
+        record[3] = param->CounterDebCalib;
+        record[4] = param->CounterDebDetect;
+        record[5] = param->CounterDebRelease;
+        record[6] = param->CounterDebError;
+        record += TSC_PARAM_KEY_SIZE;
+    }
+
+    return TSC_STATUS_OK;
 }
 
+/*!
+ * @brief       Store a parameter block, called from the USB interrupt
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      TSC_STATUS_ERROR if the block is rejected,
+ *              TSC_STATUS_BUSY if the previous block is not applied or
+ *              saved yet
+ */
+TSC_STATUS_T TSC_User_ParamWrite(uint8_t* buffer, uint8_t length)
+{
+    if ((length < TSC_PARAM_SIZE) || (TSC_User_ParamCheck(buffer) != TSC_STATUS_OK))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    if (paramPendingFlag != 0)
+    {
+        return TSC_STATUS_BUSY;
+    }
+
+    memcpy(paramPending, buffer, TSC_PARAM_SIZE);
+    paramPendingFlag = 1;
+
+    return TSC_STATUS_OK;
+}
+
+/*!
+ * @brief       Apply the received command and stream the last frame,
+ *              called after each acquisition frame.
+ *              A frame is dropped while the previous report is still
+ *              waiting for the host, the sequence number shows the gap.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void TSC_User_Telemetry(void)
+{
+    uint8_t idx_key;
+    uint8_t* record = &tlmReport[TSC_TLM_HEADER_SIZE];
+
+    if (tlmCmdLen != 0)
+    {
+        TSC_User_TlmCommand();
+        tlmCmdLen = 0;
+    }
+
+    if (paramPendingFlag == 1)
+    {
+        TSC_User_ParamApply(paramPending);
+        paramPendingFlag = (paramPending[2] & TSC_PARAM_FLAG_SAVE) ? 2 : 0;
+    }
+
+    /* The page erase stalls the USB servicing, wait for the end of the
+       SET_REPORT and of the queued events */
+    if ((paramPendingFlag == 2) && (USB_DevCtrlIdle() != 0))
+    {
+        TSC_User_ParamSave(paramPending);
+        paramPendingFlag = 0;
+    }
+
+    tlmSeq++;
+
+    if (tlmStream == 0)
+    {
+        return;
+    }
+
+    tlmReport[0] = (uint8_t)tlmSeq;
+    tlmReport[1] = (uint8_t)(tlmSeq >> 8);
+    tlmReport[2] = TSC_TLM_CHANNELS;
+    tlmReport[3] = Global_ProcessSensor ? TSC_TLM_FLAG_PROCESS : 0;
+#if TOUCH_USE_WATER > 0
+    tlmReport[3] |= (MyWater.Wet == TSC_TRUE) ? TSC_TLM_FLAG_WET : 0;
+#endif
+
+    for (idx_key = 0; idx_key < TOUCH_TOTAL_KEYS; idx_key++)
+    {
+        TSC_User_TlmPack(record, &MyTouchKeys[idx_key]);
+        record += TSC_TLM_CHANNEL_SIZE;
+    }
+#if TOUCH_USE_WATER > 0
+    TSC_User_TlmPack(record, &MyShieldKey);
+#endif
+
+    USBD_HID_TlmTxReport(&gUsbDeviceFS, tlmReport, USBD_HID_TLM_EP_SIZE);
+}
+#endif
@@ -27,7 +27,11 @@
 #include "usb_device_user.h"
 #include "usbd_descriptor.h"
 #include "usbd_hid.h"
+#include "tsc_user.h"
+#include "apm32f0xx_crs.h"
+#include "bsp_delay.h"
 #include <stdio.h>
+#include <string.h>
 
 /** @addtogroup Examples
   * @brief USBD HID examples
@@ -46,8 +50,65 @@ USBD_INFO_T gUsbDeviceFS;
 
 USBD_APP_STA_T gUsbDevAppStatus = USBD_APP_IDLE;
 
+#if USBD_SUP_REMOTE_WAKEUP
+USBD_WAKE_STAT_T gUsbWakeStat;
+
+static USBD_WAKE_STA_T wakeStatus = USBD_WAKE_IDLE;
+static uint16_t wakeTxCnt;
+#endif
+
+#if USBD_SUP_LATENCY
+USBD_LAT_STAT_T gUsbLatStat;
+
+static USBD_LAT_TRACE_T latTrace;
+static __IO uint8_t latStatus = USBD_LAT_STA_IDLE;
+static uint32_t latEoaTime;
+static uint16_t latEoaFrame;
+static uint16_t latInputCnt;
+#endif
+
+#if USBD_SUP_CRS_STAT
+USBD_CRS_STAT_T gUsbCrsStat;
+
+static uint32_t crsLockStart;
+static uint8_t crsLockStatus;
+static uint8_t crsErrCnt;
+#endif
+
 /**@} end of group USBD_HID_Variables*/
 
+#if USBD_SUP_HID_TLM
+/** @defgroup USBD_HID_Functions Functions
+  @{
+  */
+
+static USBD_STA_T USB_DevTlmReceive(uint8_t* buffer, uint8_t length);
+static USBD_STA_T USB_DevTlmGetFeature(uint8_t* buffer, uint8_t length);
+static USBD_STA_T USB_DevTlmSetFeature(uint8_t* buffer, uint8_t length);
+static USBD_STA_T USB_DevTlmVendor(uint8_t request, uint16_t value, uint8_t* buffer, uint8_t length);
+#if USBD_SUP_CRS_STAT
+static void USB_DevCrsLockStart(void);
+#endif
+
+/**@} end of group USBD_HID_Functions */
+
+/** @defgroup USBD_HID_Structures Structures
+  @{
+  */
+
+/* HID telemetry interface handler */
+USBD_HID_TLM_INTERFACE_T USBD_HID_TLM_INTERFACE =
+{
+    "TSC Telemetry",
+    USB_DevTlmReceive,
+    USB_DevTlmGetFeature,
+    USB_DevTlmSetFeature,
+    USB_DevTlmVendor,
+};
+
+/**@} end of group USBD_HID_Structures*/
+#endif
+
 /** @defgroup USBD_HID_Functions Functions
   @{
   */
@@ -96,9 +157,17 @@ static void USB_DevUserHandler(USBD_INFO_T* usbInfo, uint8_t userStatus)
     switch (userStatus)
     {
         case USBD_USER_RESET:
+            gUsbDevAppStatus = USBD_APP_IDLE;
+#if USBD_SUP_CRS_STAT
+            USB_DevCrsLockStart();
+#endif
             break;
 
         case USBD_USER_RESUME:
+            gUsbDevAppStatus = USBD_APP_READY;
+#if USBD_SUP_CRS_STAT
+            USB_DevCrsLockStart();
+#endif
             break;
 
         case USBD_USER_SUSPEND:
@@ -120,6 +189,683 @@ static void USB_DevUserHandler(USBD_INFO_T* usbInfo, uint8_t userStatus)
     }
 }
 
+#if USBD_SUP_REMOTE_WAKEUP
+/*!
+ * @brief       USB device remote wakeup. The queued reports are sent
+ *              once the host has resumed the bus.
+ *
+ * @param       None
+ *
+ * @retval      USB device operation status, USBD_BUSY while a wakeup
+ *              is in progress
+ */
+USBD_STA_T USB_DevRemoteWakeup(void)
+{
+    USBD_STA_T usbStatus;
+
+    if (wakeStatus != USBD_WAKE_IDLE)
+    {
+        return USBD_BUSY;
+    }
+
+    usbStatus = USBD_RemoteWakeup(&gUsbDeviceFS);
+    if (usbStatus == USBD_OK)
+    {
+        wakeTxCnt = USBD_HID_ReadTxCount(&gUsbDeviceFS);
+        cntWake = 0;
+        wakeStatus = USBD_WAKE_RESUME;
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief       USB device remote wakeup process, measure the latency
+ *              from the wakeup request to the first report polled
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USB_DevWakeProc(void)
+{
+    if (wakeStatus != USBD_WAKE_RESUME)
+    {
+        return;
+    }
+
+    if (USBD_HID_ReadTxCount(&gUsbDeviceFS) != wakeTxCnt)
+    {
+        gUsbWakeStat.count++;
+        gUsbWakeStat.lastLatency = cntWake;
+        if (gUsbWakeStat.lastLatency > gUsbWakeStat.maxLatency)
+        {
+            gUsbWakeStat.maxLatency = gUsbWakeStat.lastLatency;
+        }
+
+        USBD_USR_LOG("Wake latency %d ms", gUsbWakeStat.lastLatency);
+        wakeStatus = USBD_WAKE_IDLE;
+    }
+    else if (cntWake >= USBD_WAKE_TIMEOUT)
+    {
+        /* The host did not resume or nothing was queued */
+        gUsbWakeStat.timeout++;
+        wakeStatus = USBD_WAKE_IDLE;
+    }
+}
+#endif
+
+#if USBD_SUP_LATENCY
+/*!
+ * @brief       USB device add a latency to a histogram
+ *
+ * @param       hist: histogram
+ *
+ * @param       time: latency in us
+ *
+ * @retval      None
+ */
+static void USB_DevLatAdd(uint16_t* hist, uint32_t time)
+{
+    uint8_t bin = 0;
+    uint32_t limit = USBD_LAT_BIN_BASE;
+
+    while ((bin < USBD_LAT_BIN_NUM - 1) && (time >= limit))
+    {
+        bin++;
+        limit <<= 1;
+    }
+
+    if (hist[bin] < 0xFFFF)
+    {
+        hist[bin]++;
+    }
+}
+
+/*!
+ * @brief       USB device record a latency stage. One trace runs at a
+ *              time, a state change while the previous trace waits for
+ *              the host is counted as dropped.
+ *
+ * @param       stage: USBD_LAT_STAGE_T value
+ *
+ * @param       time: stage time in us
+ *
+ * @param       frame: USB frame number of the stage
+ *
+ * @retval      None
+ */
+static void USB_DevLatRecord(USBD_LAT_STAGE_T stage, uint32_t time, uint16_t frame)
+{
+    switch (stage)
+    {
+        case USBD_LAT_EOA:
+            /* Taken by the next state change */
+            latEoaTime = time;
+            latEoaFrame = frame;
+            return;
+
+        case USBD_LAT_STATE:
+            if (latStatus != USBD_LAT_STA_IDLE)
+            {
+                gUsbLatStat.drop++;
+                return;
+            }
+
+            latTrace.time[USBD_LAT_EOA] = latEoaTime;
+            latTrace.frame[USBD_LAT_EOA] = latEoaFrame;
+            latInputCnt = USBD_HID_ReadInputCount(&gUsbDeviceFS);
+            break;
+
+        case USBD_LAT_QUEUE:
+            if (latStatus != USBD_LAT_STA_STATE)
+            {
+                return;
+            }
+            break;
+
+        case USBD_LAT_ACK:
+            if (latStatus != USBD_LAT_STA_QUEUE)
+            {
+                return;
+            }
+
+            /* The queue stage is stamped when USB_DevLatProc sees the
+               report, the host may have taken it already */
+            if ((int32_t)(time - latTrace.time[USBD_LAT_QUEUE]) < 0)
+            {
+                time = latTrace.time[USBD_LAT_QUEUE];
+            }
+            break;
+
+        default:
+            return;
+    }
+
+    latTrace.time[stage] = time;
+    latTrace.frame[stage] = frame;
+    latStatus = stage == USBD_LAT_ACK ? USBD_LAT_STA_DONE : stage;
+}
+
+/*!
+ * @brief       USB device latency time stamp of the main loop stages
+ *
+ * @param       stage: USBD_LAT_EOA, USBD_LAT_STATE or USBD_LAT_QUEUE
+ *
+ * @retval      None
+ */
+void USB_DevLatStamp(USBD_LAT_STAGE_T stage)
+{
+    USB_DevLatRecord(stage, TSC_User_ReadTimeUs(), USBD_ReadFrameNumber(USBD));
+}
+
+/*!
+ * @brief       USB device latency stamp of the host ACK of the mouse
+ *              report
+ *
+ * @param       time: time in us the USB interrupt took the ACK at
+ *
+ * @param       frame: USB frame number of the ACK
+ *
+ * @retval      None
+ *
+ * @note        The stamp is taken by the USB interrupt and carried in
+ *              the deferred event, the stage is recorded when the event
+ *              is serviced
+ */
+void USB_DevLatAck(uint32_t time, uint16_t frame)
+{
+    USB_DevLatRecord(USBD_LAT_ACK, time, frame);
+}
+
+/*!
+ * @brief       USB device latency process. Called after the TSC
+ *              handlers, so a state change that queued no report ends
+ *              its trace here.
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USB_DevLatProc(void)
+{
+    uint8_t stage;
+
+    switch (latStatus)
+    {
+        case USBD_LAT_STA_STATE:
+            if (USBD_HID_ReadInputCount(&gUsbDeviceFS) != latInputCnt)
+            {
+                USB_DevLatStamp(USBD_LAT_QUEUE);
+            }
+            else
+            {
+                latStatus = USBD_LAT_STA_IDLE;
+            }
+            break;
+
+        case USBD_LAT_STA_QUEUE:
+            if ((TSC_User_ReadTimeUs() - latTrace.time[USBD_LAT_QUEUE]) >= (USBD_LAT_TIMEOUT * 1000))
+            {
+                __disable_irq();
+                if (latStatus == USBD_LAT_STA_QUEUE)
+                {
+                    gUsbLatStat.drop++;
+                    latStatus = USBD_LAT_STA_IDLE;
+                }
+                __enable_irq();
+            }
+            break;
+
+        case USBD_LAT_STA_DONE:
+            for (stage = USBD_LAT_STATE; stage < USBD_LAT_STAGE_NUM; stage++)
+            {
+                USB_DevLatAdd(gUsbLatStat.hist[stage], latTrace.time[stage] - latTrace.time[stage - 1]);
+            }
+            USB_DevLatAdd(gUsbLatStat.hist[USBD_LAT_EOA], latTrace.time[USBD_LAT_ACK] - latTrace.time[USBD_LAT_EOA]);
+
+            gUsbLatStat.last = latTrace;
+            gUsbLatStat.count++;
+            latStatus = USBD_LAT_STA_IDLE;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief       USB device record the duration of an USB interrupt
+ *
+ * @param       time: interrupt duration in us
+ *
+ * @retval      None
+ *
+ * @note        Called from the USB interrupt
+ */
+void USB_DevIsrTime(uint32_t time)
+{
+    if (time > gUsbLatStat.isrMax)
+    {
+        gUsbLatStat.isrMax = time > 0xFFFF ? 0xFFFF : (uint16_t)time;
+    }
+}
+
+/*!
+ * @brief       USB device read a latency page, 16 and 32-bit values
+ *              are little endian
+ *
+ * @param       page: USBD_LAT_PAGE_x
+ *
+ * @param       buffer: page buffer
+ *
+ * @param       length: page buffer length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USB_DevLatRead(uint16_t page, uint8_t* buffer, uint8_t length)
+{
+    USBD_HANDLE_T* usbdh = (USBD_HANDLE_T*)gUsbDeviceFS.dataPoint;
+    uint8_t image[USBD_HID_TLM_EP_SIZE] = {0};
+    uint8_t* data = image;
+    uint8_t stage;
+    uint8_t bin;
+    uint8_t dir;
+    uint8_t epNum;
+
+    switch (page)
+    {
+        case USBD_LAT_PAGE_HIST:
+            for (stage = 0; stage < USBD_LAT_STAGE_NUM; stage++)
+            {
+                for (bin = 0; bin < USBD_LAT_BIN_NUM; bin++)
+                {
+                    *data++ = (uint8_t)gUsbLatStat.hist[stage][bin];
+                    *data++ = (uint8_t)(gUsbLatStat.hist[stage][bin] >> 8);
+                }
+            }
+            break;
+
+        case USBD_LAT_PAGE_TRACE:
+            *data++ = (uint8_t)gUsbLatStat.count;
+            *data++ = (uint8_t)(gUsbLatStat.count >> 8);
+            *data++ = (uint8_t)gUsbLatStat.drop;
+            *data++ = (uint8_t)(gUsbLatStat.drop >> 8);
+
+            for (stage = 0; stage < USBD_LAT_STAGE_NUM; stage++)
+            {
+                *data++ = (uint8_t)gUsbLatStat.last.time[stage];
+                *data++ = (uint8_t)(gUsbLatStat.last.time[stage] >> 8);
+                *data++ = (uint8_t)(gUsbLatStat.last.time[stage] >> 16);
+                *data++ = (uint8_t)(gUsbLatStat.last.time[stage] >> 24);
+                *data++ = (uint8_t)gUsbLatStat.last.frame[stage];
+                *data++ = (uint8_t)(gUsbLatStat.last.frame[stage] >> 8);
+            }
+            break;
+
+        case USBD_LAT_PAGE_ISR:
+            *data++ = (uint8_t)gUsbLatStat.isrMax;
+            *data++ = (uint8_t)(gUsbLatStat.isrMax >> 8);
+            *data++ = usbdh->eventMax;
+            *data++ = USBD_EVENT_QUEUE_SIZE;
+            *data++ = (uint8_t)usbdh->eventOvf;
+            *data++ = (uint8_t)(usbdh->eventOvf >> 8);
+            break;
+
+        case USBD_LAT_PAGE_LINK:
+            *data++ = (uint8_t)usbdh->linkStat.stallCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.stallCnt >> 8);
+            *data++ = (uint8_t)usbdh->linkStat.errCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.errCnt >> 8);
+            *data++ = (uint8_t)usbdh->linkStat.pmaOvrCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.pmaOvrCnt >> 8);
+            *data++ = (uint8_t)usbdh->linkStat.sofMissCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.sofMissCnt >> 8);
+            *data++ = (uint8_t)usbdh->linkStat.suspendCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.suspendCnt >> 8);
+            *data++ = (uint8_t)usbdh->linkStat.resetCnt;
+            *data++ = (uint8_t)(usbdh->linkStat.resetCnt >> 8);
+
+            for (dir = 0; dir < 2; dir++)
+            {
+                for (epNum = 0; epNum < 8; epNum++)
+                {
+                    *data++ = (uint8_t)usbdh->linkStat.xferCnt[dir][epNum];
+                    *data++ = (uint8_t)(usbdh->linkStat.xferCnt[dir][epNum] >> 8);
+                }
+            }
+            break;
+
+        case USBD_LAT_PAGE_BYTE:
+            for (dir = 0; dir < 2; dir++)
+            {
+                for (epNum = 0; epNum < 8; epNum++)
+                {
+                    *data++ = (uint8_t)usbdh->linkStat.byteCnt[dir][epNum];
+                    *data++ = (uint8_t)(usbdh->linkStat.byteCnt[dir][epNum] >> 8);
+                    *data++ = (uint8_t)(usbdh->linkStat.byteCnt[dir][epNum] >> 16);
+                    *data++ = (uint8_t)(usbdh->linkStat.byteCnt[dir][epNum] >> 24);
+                }
+            }
+            break;
+
+#if USBD_SUP_CRS_STAT
+        case USBD_LAT_PAGE_CRS:
+            *data++ = (uint8_t)gUsbCrsStat.syncOk;
+            *data++ = (uint8_t)(gUsbCrsStat.syncOk >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.syncWarn;
+            *data++ = (uint8_t)(gUsbCrsStat.syncWarn >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.syncErr;
+            *data++ = (uint8_t)(gUsbCrsStat.syncErr >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.syncMiss;
+            *data++ = (uint8_t)(gUsbCrsStat.syncMiss >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.trimOvf;
+            *data++ = (uint8_t)(gUsbCrsStat.trimOvf >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.fallback;
+            *data++ = (uint8_t)(gUsbCrsStat.fallback >> 8);
+            *data++ = gUsbCrsStat.trim;
+            *data++ = gUsbCrsStat.trimMin;
+            *data++ = gUsbCrsStat.trimMax;
+            *data++ = (uint8_t)gUsbCrsStat.freqErr;
+            *data++ = (uint8_t)((uint16_t)gUsbCrsStat.freqErr >> 8);
+            *data++ = (uint8_t)gUsbCrsStat.lockTime;
+            *data++ = (uint8_t)(gUsbCrsStat.lockTime >> 8);
+            *data++ = (uint8_t)(gUsbCrsStat.lockTime >> 16);
+            *data++ = (uint8_t)(gUsbCrsStat.lockTime >> 24);
+            break;
+#endif
+
+        default:
+            return USBD_FAIL;
+    }
+
+    memcpy(buffer, image, length < sizeof(image) ? length : sizeof(image));
+
+    return USBD_OK;
+}
+#endif
+
+#if USBD_SUP_CRS_STAT
+/*!
+ * @brief       USB device start to measure the time until the CRS
+ *              locks the HSI48 on the host SOF
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+static void USB_DevCrsLockStart(void)
+{
+    crsLockStart = TSC_User_ReadTimeUs();
+    crsLockStatus = RESET;
+}
+
+/*!
+ * @brief       USB device CRS interrupt, count the SYNC results and
+ *              restore the factory trim after USBD_CRS_FALLBACK_NUM
+ *              errors in a row
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USB_DevCrsIsr(void)
+{
+    uint8_t trim;
+
+    if (CRS_ReadIntFlag(CRS_INT_SYNCOK))
+    {
+        CRS_ClearIntFlag(CRS_INT_SYNCOK);
+        gUsbCrsStat.syncOk++;
+        crsErrCnt = 0;
+
+        if (crsLockStatus == RESET)
+        {
+            gUsbCrsStat.lockTime = TSC_User_ReadTimeUs() - crsLockStart;
+            crsLockStatus = SET;
+        }
+    }
+
+    if (CRS_ReadIntFlag(CRS_INT_SYNCWARN))
+    {
+        CRS_ClearIntFlag(CRS_INT_SYNCWARN);
+        gUsbCrsStat.syncWarn++;
+    }
+
+    if (CRS_ReadIntFlag(CRS_INT_ERR))
+    {
+        if (CRS_ReadStatusFlag(CRS_FLAG_SYNCERR))
+        {
+            gUsbCrsStat.syncErr++;
+        }
+
+        if (CRS_ReadStatusFlag(CRS_FLAG_SYNCMISS))
+        {
+            gUsbCrsStat.syncMiss++;
+        }
+
+        if (CRS_ReadStatusFlag(CRS_FLAG_TRIMOVF))
+        {
+            gUsbCrsStat.trimOvf++;
+        }
+
+        /* Clears the SYNC error, SYNC missed and trim overflow flags */
+        CRS_ClearIntFlag(CRS_INT_ERR);
+
+        /* The trim has drifted on a noisy or lost SOF, start again from
+           the factory value. The trim is written by the hardware while
+           the automatic trimming is on. */
+        if (++crsErrCnt >= USBD_CRS_FALLBACK_NUM)
+        {
+            CRS_DisableAutomaticCalibration();
+            CRS_AdjustHSI48CalibrationValue(USBD_CRS_TRIM_DEFAULT);
+            CRS_EnableAutomaticCalibration();
+            gUsbCrsStat.fallback++;
+            crsErrCnt = 0;
+            USB_DevCrsLockStart();
+        }
+    }
+
+    trim = (uint8_t)CRS_ReadHSI48CalibrationValue();
+    gUsbCrsStat.trim = trim;
+    gUsbCrsStat.trimMin = trim < gUsbCrsStat.trimMin ? trim : gUsbCrsStat.trimMin;
+    gUsbCrsStat.trimMax = trim > gUsbCrsStat.trimMax ? trim : gUsbCrsStat.trimMax;
+
+    /* The counter direction is set when the HSI48 runs slow */
+    gUsbCrsStat.freqErr = (int16_t)CRS_ReadFrequencyErrorValue();
+    if (CRS_ReadFrequencyErrorDirection())
+    {
+        gUsbCrsStat.freqErr = -gUsbCrsStat.freqErr;
+    }
+}
+#endif
+
+#if USBD_SUP_DEFER_ISR
+/*!
+ * @brief       USB device process the events deferred by the USB
+ *              interrupt
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USB_DevEventProc(void)
+{
+    USBD_EventHandler((USBD_HANDLE_T*)gUsbDeviceFS.dataPoint);
+}
+#endif
+
+/*!
+ * @brief       USB device check that no control transfer is in progress
+ *              and no USB event waits to be serviced
+ *
+ * @param       None
+ *
+ * @retval      1 when idle, else 0
+ */
+uint8_t USB_DevCtrlIdle(void)
+{
+    USBD_HANDLE_T* usbdh = (USBD_HANDLE_T*)gUsbDeviceFS.dataPoint;
+
+    /* A stalled request has ended too */
+    if ((gUsbDeviceFS.devEp0State != USBD_DEV_EP0_IDLE) && \
+        (gUsbDeviceFS.devEp0State != USBD_DEV_EP0_STALL))
+    {
+        return 0;
+    }
+
+    if (usbdh->eventHead != usbdh->eventTail)
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*!
+ * @brief       USB device re-enumerate in the report format the host
+ *              set through the device mode, once the control transfer
+ *              that set it has ended
+ *
+ * @param       None
+ *
+ * @retval      None
+ */
+void USB_DevFormatProc(void)
+{
+    if ((USBD_HID_ReadFormatChange(&gUsbDeviceFS) == 0) || (USB_DevCtrlIdle() == 0))
+    {
+        return;
+    }
+
+    USBD_USR_LOG("Re-enumerate, report descriptor of %d bytes", USBD_HID_ReadReportDescSize());
+
+    /* The host sees a disconnect and enumerates the device again */
+    USBD_StopCallback(&gUsbDeviceFS);
+    USBD_Disconnect(&gUsbDeviceFS);
+    APM_DelayMs(USBD_DETACH_TIME);
+    USBD_StartCallback(&gUsbDeviceFS);
+}
+
+#if USBD_SUP_HID_TLM
+/*!
+ * @brief       USB device telemetry command handler
+ *
+ * @param       buffer: command report
+ *
+ * @param       length: command length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USB_DevTlmReceive(uint8_t* buffer, uint8_t length)
+{
+    if (TSC_User_TlmReceive(buffer, length) != TSC_STATUS_OK)
+    {
+        return USBD_BUSY;
+    }
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       USB device telemetry feature report read handler
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USB_DevTlmGetFeature(uint8_t* buffer, uint8_t length)
+{
+    if (TSC_User_ParamRead(buffer, length) != TSC_STATUS_OK)
+    {
+        return USBD_FAIL;
+    }
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       USB device telemetry feature report write handler
+ *
+ * @param       buffer: feature report
+ *
+ * @param       length: feature report length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USB_DevTlmSetFeature(uint8_t* buffer, uint8_t length)
+{
+    if (TSC_User_ParamWrite(buffer, length) != TSC_STATUS_OK)
+    {
+        return USBD_FAIL;
+    }
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief       USB device telemetry vendor request handler
+ *
+ * @param       request: vendor request
+ *
+ * @param       value: request wValue
+ *
+ * @param       buffer: IN data, NULL for a request without data
+ *
+ * @param       length: IN data length
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USB_DevTlmVendor(uint8_t request, uint16_t value, uint8_t* buffer, uint8_t length)
+{
+#if USBD_SUP_LATENCY
+    if ((request == USBD_LAT_REQ_READ) && (length != 0))
+    {
+        return USB_DevLatRead(value, buffer, length);
+    }
+
+    if ((request == USBD_LAT_REQ_CLEAR) && (length == 0))
+    {
+        __disable_irq();
+        memset(&gUsbLatStat, 0, sizeof(gUsbLatStat));
+        latStatus = USBD_LAT_STA_IDLE;
+        ((USBD_HANDLE_T*)gUsbDeviceFS.dataPoint)->eventMax = 0;
+        ((USBD_HANDLE_T*)gUsbDeviceFS.dataPoint)->eventOvf = 0;
+        memset(&((USBD_HANDLE_T*)gUsbDeviceFS.dataPoint)->linkStat, 0, sizeof(USBD_LINK_STAT_T));
+#if USBD_SUP_CRS_STAT
+        gUsbCrsStat.syncOk = 0;
+        gUsbCrsStat.syncWarn = 0;
+        gUsbCrsStat.syncErr = 0;
+        gUsbCrsStat.syncMiss = 0;
+        gUsbCrsStat.trimOvf = 0;
+        gUsbCrsStat.fallback = 0;
+        gUsbCrsStat.trimMin = gUsbCrsStat.trim;
+        gUsbCrsStat.trimMax = gUsbCrsStat.trim;
+#endif
+        __enable_irq();
+
+        return USBD_OK;
+    }
+#endif
+
+    return USBD_FAIL;
+}
+#endif
+
+/*!
+ * @brief       Register the classes of a composite device after the
+ *              mouse, a composite build provides it
+ *
+ * @param       usbInfo: usb device information
+ *
+ * @retval      None
+ */
+__weak void USB_DevClassRegister(USBD_INFO_T* usbInfo)
+{
+}
+
 /*!
  * @brief       USB device init
  *
@@ -129,8 +875,39 @@ static void USB_DevUserHandler(USBD_INFO_T* usbInfo, uint8_t userStatus)
  */
 void USB_DeviceInit(void)
 {
-    /* USB device and class init */
-    USBD_Init(&gUsbDeviceFS, USBD_SPEED_FS, &USBD_DESC_FS, &USBD_HID_CLASS, USB_DevUserHandler);
+#if USBD_SUP_CRS_STAT
+    gUsbCrsStat.trim = USBD_CRS_TRIM_DEFAULT;
+    gUsbCrsStat.trimMin = USBD_CRS_TRIM_DEFAULT;
+    gUsbCrsStat.trimMax = USBD_CRS_TRIM_DEFAULT;
+    USB_DevCrsLockStart();
+#endif
+
+    /* HID report rate */
+    USBD_HID_ConfigInterval(USBD_HID_REPORT_INTERVAL);
+    USBD_HID_ConfigReportFormat(USBD_HID_REPORT_FORMAT);
+
+#if USBD_SUP_HID_TLM
+    /* Parameters tuned over the telemetry interface and saved to flash */
+    TSC_User_ParamLoad();
+#endif
+
+    /* Register the classes with their descriptors, a class added here
+       takes the next interface and endpoint numbers. The mouse and the
+       telemetry interfaces are separate functions, not grouped. */
+    USBD_RegisterClass(&gUsbDeviceFS, &USBD_HID_CLASS, \
+                       USBD_ConfigDesc + USBD_CONFIG_HEADER_SIZE, \
+                       USBD_CONFIG_DESCRIPTOR_SIZE - USBD_CONFIG_HEADER_SIZE, DISABLE);
+#if USBD_SUP_COMPOSITE
+    USB_DevClassRegister(&gUsbDeviceFS);
+#endif
+
+    /* USB device init */
+    USBD_Init(&gUsbDeviceFS, USBD_SPEED_FS, &USBD_DESC_FS, NULL, USB_DevUserHandler);
+
+#if USBD_SUP_HID_TLM
+    /* Register HID telemetry interface */
+    USBD_HID_RegisterTlmItf(&gUsbDeviceFS, &USBD_HID_TLM_INTERFACE);
+#endif
 }
 
 /*!
@@ -28,11 +28,16 @@
 #include "bsp_delay.h"
 #include "usbd_board.h"
 #include "usbd_core.h"
+#include "usb_device_user.h"
+#include "usbd_hid.h"
+#include "tsc_user.h"
 #include "apm32f0xx_gpio.h"
 #include "apm32f0xx_fmc.h"
 #include "apm32f0xx_rcm.h"
 #include "apm32f0xx_crs.h"
 #include "apm32f0xx_misc.h"
+#include "apm32f0xx_eint.h"
+#include <stdio.h>
 #include "apm32f0xx_usb_device.h"
 
 /** @addtogroup Examples
@@ -50,6 +55,9 @@
 
 USBD_HANDLE_T usbDeviceHandler;
 
+/* The suspend or L1 callback allowed the main loop to stop the clocks */
+static __IO uint8_t usbStopStatus = DISABLE;
+
 /**@} end of group USBD_HID_Variables*/
 
 /** @defgroup USBD_HID_Functions Functions
@@ -67,6 +75,7 @@ void USBD_ClockInit(void)
 {
     uint32_t i;
 
+#if USBD_SUP_HSE_CLOCK
     RCM->CTRL1_B.HSEEN = BIT_SET;
 
     for (i = 0; i < HSE_STARTUP_TIMEOUT; i++)
@@ -108,6 +117,38 @@ void USBD_ClockInit(void)
     }
     
     RCM_EnableHSI48();
+#else
+    RCM_EnableHSI48();
+
+    for (i = 0; i < HSE_STARTUP_TIMEOUT; i++)
+    {
+        if (RCM_ReadStatusFlag(RCM_FLAG_HSI48RDY))
+        {
+            break;
+        }
+    }
+
+    if (RCM_ReadStatusFlag(RCM_FLAG_HSI48RDY))
+    {
+        /* Enable Prefetch Buffer */
+        FMC->CTRL1_B.PBEN = BIT_SET;
+        /* Flash 1 wait state */
+        FMC->CTRL1_B.WS = 1;
+
+        /* HCLK = SYSCLK */
+        RCM->CFG1_B.AHBPSC = 0X00;
+
+        /* PCLK = HCLK */
+        RCM->CFG1_B.APB1PSC = 0X00;
+
+        /* Select HSI48 as system clock source, the CRS keeps it on the
+           host frame rate */
+        RCM_ConfigSYSCLK(RCM_SYSCLK_SEL_HSI48);
+
+        while (RCM_ReadSYSCLKSource() != RCM_SYSCLK_SEL_HSI48);
+    }
+#endif
+    
     RCM_ConfigUSBCLK(RCM_USBCLK_HSI48);
     RCM_EnableAPB1PeriphClock(RCM_APB1_PERIPH_USB);
     
@@ -115,6 +156,51 @@ void USBD_ClockInit(void)
     CRS_ConfigSynchronizationSource(CRS_SYNC_SOURCE_USB);
     CRS_EnableAutomaticCalibration();
     CRS_EnableFrequencyErrorCounter();
+
+#if USBD_SUP_CRS_STAT
+    CRS_EnableInterrupt((CRS_INT_T)(CRS_INT_SYNCOK | CRS_INT_SYNCWARN | CRS_INT_ERR));
+    NVIC_EnableIRQRequest(RCM_CRS_IRQn, 2);
+#endif
+}
+
+/*!
+ * @brief       Allocate the PMA buffers of a class endpoint and log
+ *              them. Stops here if the endpoints overflow the PMA.
+ *
+ * @param       epAddr: endpoint address
+ *
+ * @param       bufferStatus: endpoint kind
+ *
+ * @param       mps: endpoint maximum packet size
+ *
+ * @retval      None
+ */
+static void USBD_ConfigEPBuffer(uint8_t epAddr, uint16_t bufferStatus, uint16_t mps)
+{
+#if (USBD_DEBUG_LEVEL > 1U)
+    USBD_ENDPOINT_INFO_T* ep;
+#endif
+
+    if (USBD_PMA_Alloc(&usbDeviceHandler, epAddr, bufferStatus, mps) != SUCCESS)
+    {
+        USBD_USR_LOG("USB PMA overflow at EP 0x%02X, %d bytes free", \
+                     epAddr, USBD_PMA_SIZE - usbDeviceHandler.pmaFree);
+        while (1);
+    }
+
+#if (USBD_DEBUG_LEVEL > 1U)
+    if ((epAddr & 0x80) == 0x80)
+    {
+        ep = &usbDeviceHandler.epIN[epAddr & 0x0F];
+    }
+    else
+    {
+        ep = &usbDeviceHandler.epOUT[epAddr];
+    }
+
+    USBD_USR_Debug("USB EP 0x%02X PMA 0x%03X, %d bytes", epAddr, \
+                   (bufferStatus == USBD_EP_BUFFER_SINGLE) ? ep->pmaAddr : ep->pmaAddr0, ep->pmaSize);
+#endif
 }
 
 /*!
@@ -126,6 +212,16 @@ void USBD_ClockInit(void)
  */
 void USBD_HardwareInit(USBD_INFO_T* usbInfo)
 {
+    USBD_DESC_INFO_T descInfo;
+    uint16_t bufferStatus;
+    uint8_t epInMask = 0;
+    uint8_t epOutMask = 0;
+    uint8_t epType;
+    uint8_t index;
+#if USBD_SUP_LOW_POWER
+    EINT_Config_T eintConfig;
+#endif
+
     /* Configure USB clock */
     USBD_ClockInit();
     
@@ -142,13 +238,36 @@ void USBD_HardwareInit(USBD_INFO_T* usbInfo)
     usbDeviceHandler.usbCfg.sofStatus           = DISABLE;
     usbDeviceHandler.usbCfg.speed               = USB_SPEED_FSLS;
     usbDeviceHandler.usbCfg.devEndpointNum      = 8;
+#if USBD_SUP_LOW_POWER
+    usbDeviceHandler.usbCfg.lowPowerStatus      = ENABLE;
+#else
     usbDeviceHandler.usbCfg.lowPowerStatus      = DISABLE;
+#endif
+#if USBD_SUP_LPM
+    usbDeviceHandler.usbCfg.lpmStatus           = ENABLE;
+#else
     usbDeviceHandler.usbCfg.lpmStatus           = DISABLE;
+#endif
     usbDeviceHandler.usbCfg.batteryStatus       = DISABLE;
+#if USBD_SUP_DEFER_ISR
+    usbDeviceHandler.usbCfg.deferStatus         = ENABLE;
+#else
+    usbDeviceHandler.usbCfg.deferStatus         = DISABLE;
+#endif
 
     /* NVIC */
     NVIC_EnableIRQRequest(USBD_IRQn, 1);
 
+#if USBD_SUP_LOW_POWER
+    /* The bus activity wakes the stop mode through EINT line 18 */
+    eintConfig.line    = EINT_LINE18;
+    eintConfig.lineCmd = ENABLE;
+    eintConfig.mode    = EINT_MODE_INTERRUPT;
+    eintConfig.trigger = EINT_TRIGGER_RISING;
+    EINT_Config(&eintConfig);
+    EINT_ClearIntFlag(EINT_LINE18);
+#endif
+
     /* Disable USB all global interrupt */
     USBD_DisableInterrupt(usbDeviceHandler.usbGlobal, 
                           USBD_INT_CTR | \
@@ -163,7 +282,58 @@ void USBD_HardwareInit(USBD_INFO_T* usbInfo)
     /* Init USB Core */
     USBD_Config(&usbDeviceHandler);
 
-    USBD_ConfigPMA(&usbDeviceHandler, USBD_HID_EP_IN_ADDR, USBD_EP_BUFFER_SINGLE, USBD_HID_EP_IN_SIZE);
+    /* EP0 is allocated by USBD_Config, the endpoints of the composed
+       configuration follow. Interrupt endpoints cannot be double
+       buffered, bulk and isochronous ones are so that the next packet
+       is in the PMA while the current one is on the bus. A double
+       buffered endpoint takes both halves of its endpoint register, an
+       endpoint number used in both directions stays single buffered. */
+    descInfo = usbInfo->devDesc->configDescHandler(usbInfo->devSpeed);
+
+    for (index = 0; (index + 5) < descInfo.size; index += descInfo.desc[index])
+    {
+        if (descInfo.desc[index] == 0)
+        {
+            break;
+        }
+
+        if (descInfo.desc[index + 1] == USBD_DESC_ENDPOINT)
+        {
+            if (descInfo.desc[index + 2] & 0x80)
+            {
+                epInMask |= 1 << (descInfo.desc[index + 2] & 0x07);
+            }
+            else
+            {
+                epOutMask |= 1 << (descInfo.desc[index + 2] & 0x07);
+            }
+        }
+    }
+
+    for (index = 0; (index + 5) < descInfo.size; index += descInfo.desc[index])
+    {
+        if (descInfo.desc[index] == 0)
+        {
+            break;
+        }
+
+        if (descInfo.desc[index + 1] == USBD_DESC_ENDPOINT)
+        {
+            epType = descInfo.desc[index + 3] & 0x03;
+            bufferStatus = USBD_EP_BUFFER_SINGLE;
+
+            if (((epType == 0x01) || (epType == 0x02)) && \
+                ((epInMask & epOutMask & (1 << (descInfo.desc[index + 2] & 0x07))) == 0))
+            {
+                bufferStatus = USBD_EP_BUFFER_DOUBLE;
+            }
+
+            USBD_ConfigEPBuffer(descInfo.desc[index + 2], bufferStatus, \
+                                descInfo.desc[index + 4] | (descInfo.desc[index + 5] << 8));
+        }
+    }
+
+    USBD_USR_Debug("USB PMA %d of %d bytes used", usbDeviceHandler.pmaFree, USBD_PMA_SIZE);
 
     USBD_StartCallback(usbInfo);
 }
@@ -218,6 +388,65 @@ void USBD_StopDeviceCallback(USBD_INFO_T* usbInfo)
     USBD_StopDevice(usbInfo->dataPoint);
 }
 
+/*!
+ * @brief     Allow the clocks to stop while the bus sleeps. Called from
+ *            the interrupt, the core stops on its exit. With the events
+ *            deferred USBD_LowPowerSleep stops it from the main loop.
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    None
+ */
+static void USBD_LowPowerStop(USBD_HANDLE_T* usbdh)
+{
+    if (usbdh->usbCfg.deferStatus == ENABLE)
+    {
+        usbStopStatus = ENABLE;
+    }
+    else
+    {
+        /* Set SLEEPDEEP bit and SLEEPONEXIT SCR */
+        SCB->SCR |= (uint32_t)((uint32_t)(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk));
+    }
+}
+
+/*!
+ * @brief     Sleep the main loop while the bus is suspended, in stop
+ *            mode when the suspend or L1 callback allowed it
+ *
+ * @param     None
+ *
+ * @retval    None
+ *
+ * @note      The decision is taken with the interrupts masked. An
+ *            event posted since the main loop chose to sleep, a resume
+ *            above all, is serviced first. A pending interrupt ends the
+ *            __WFI and its handler runs once the clocks are back.
+ */
+void USBD_LowPowerSleep(void)
+{
+    __disable_irq();
+
+    if (usbDeviceHandler.eventHead == usbDeviceHandler.eventTail)
+    {
+        if (usbStopStatus == ENABLE)
+        {
+            SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+            __WFI();
+            SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+            /* The stop mode leaves the HSI as system clock */
+            USBD_ClockInit();
+        }
+        else
+        {
+            __WFI();
+        }
+    }
+
+    __enable_irq();
+}
+
 /*!
  * @brief     USB OTG device resume callback
  *
@@ -227,7 +456,10 @@ void USBD_StopDeviceCallback(USBD_INFO_T* usbInfo)
  */
 void USBD_ResumeCallback(USBD_HANDLE_T* usbdh)
 {
-    if (usbdh->usbCfg.lowPowerStatus == ENABLE)
+    usbStopStatus = DISABLE;
+
+    /* A short L1 sleep keeps the clocks running */
+    if ((usbdh->usbCfg.lowPowerStatus == ENABLE) && (SCB->SCR & SCB_SCR_SLEEPDEEP_Msk))
     {
         /* Reset SLEEPDEEP bit and SLEEPONEXIT SCR */
         SCB->SCR &= ~((uint32_t)((uint32_t)(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk)));
@@ -248,12 +480,42 @@ void USBD_SuspendCallback(USBD_HANDLE_T* usbdh)
 {
     USBD_Suspend(usbdh->dataPoint);
 
-    if (usbdh->usbCfg.lowPowerStatus == ENABLE)
+    /* A remote wakeup needs the touch scans of the main loop */
+    if ((usbdh->usbCfg.lowPowerStatus == ENABLE) && \
+        (((USBD_INFO_T*)usbdh->dataPoint)->devRemoteWakeUpStatus != ENABLE))
     {
-        /* Set SLEEPDEEP bit and SLEEPONEXIT SCR */
-        SCB->SCR |= (uint32_t)((uint32_t)(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk));
+        USBD_LowPowerStop(usbdh);
+    }
+}
+
+#if USBD_SUP_LPM
+/*!
+ * @brief     USB device link power mode callback
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @param     lpMode: link power mode
+ *
+ * @retval    None
+ */
+void USBD_LpmModeCallback(USBD_HANDLE_T* usbdh, USBD_LOW_POWER_MODE_T lpMode)
+{
+    if (lpMode == USBD_LPM_LV1)
+    {
+        /* Sleep as in suspend, USBD_ResumeCallback ends the L1 sleep */
+        USBD_Suspend(usbdh->dataPoint);
+
+        /* Stop the clocks only when the host waits for their restart
+           and no L1 remote wakeup needs the touch scans */
+        if ((usbdh->usbCfg.lowPowerStatus == ENABLE) && \
+            (usbdh->beslVal >= USBD_LPM_BESL_DEEP) && \
+            (usbdh->l1WakeStatus != ENABLE))
+        {
+            USBD_LowPowerStop(usbdh);
+        }
     }
 }
+#endif
 
 /*!
  * @brief     USB OTG device enum done callback
@@ -281,6 +543,7 @@ void USBD_EnumDoneCallback(USBD_HANDLE_T* usbdh)
     USBD_SetSpeed(usbdh->dataPoint, speed);
 
     /* Reset device */
+    usbStopStatus = DISABLE;
     USBD_Reset(usbdh->dataPoint);
 }
 
@@ -321,9 +584,31 @@ void USBD_DataOutStageCallback(USBD_HANDLE_T* usbdh, uint8_t epNum)
  */
 void USBD_DataInStageCallback(USBD_HANDLE_T* usbdh, uint8_t epNum)
 {
+#if USBD_SUP_LATENCY
+    /* Stamped when the interrupt took the ACK */
+    if (epNum == (USBD_HID_EP_IN_ADDR & 0x0F))
+    {
+        USB_DevLatAck(usbdh->eventTime, usbdh->eventFrame);
+    }
+#endif
+
     USBD_DataInStage(usbdh->dataPoint, epNum, usbdh->epIN[epNum].buffer);
 }
 
+#if USBD_SUP_LATENCY
+/*!
+ * @brief     USB device read time callback
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    Time in us of the touch sensing time base
+ */
+uint32_t USBD_ReadTimeCallback(USBD_HANDLE_T* usbdh)
+{
+    return TSC_User_ReadTimeUs();
+}
+#endif
+
 /*!
  * @brief     USB device set EP on stall status callback
  *
@@ -503,6 +788,32 @@ USBD_STA_T USBD_SetDevAddressCallback(USBD_INFO_T* usbInfo, uint8_t address)
     return usbStatus;
 }
 
+/*!
+ * @brief     USB device remote wakeup handler callback
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @retval    usb device status
+ */
+USBD_STA_T USBD_RemoteWakeupCallback(USBD_INFO_T* usbInfo)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+    USBD_HANDLE_T* usbdh = (USBD_HANDLE_T*)usbInfo->dataPoint;
+
+    /* Only a stop mode has left the clocks to restore, the touch scans
+       of a remote wakeup normally keep them running */
+    if ((usbdh->usbCfg.lowPowerStatus == ENABLE) && (SCB->SCR & SCB_SCR_SLEEPDEEP_Msk))
+    {
+        /* Reset SLEEPDEEP bit and SLEEPONEXIT SCR */
+        SCB->SCR &= ~((uint32_t)((uint32_t)(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk)));
+        USBD_ClockInit();
+    }
+
+    USBD_StartRemoteWakeup(usbdh);
+
+    return usbStatus;
+}
+
 /*!
  * @brief       USB OTG device SOF event callback function
  *
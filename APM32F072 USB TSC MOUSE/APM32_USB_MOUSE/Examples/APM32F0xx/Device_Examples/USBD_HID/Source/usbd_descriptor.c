@@ -26,6 +26,7 @@
 /* Includes */
 #include "usbd_descriptor.h"
 #include "usbd_hid.h"
+#include "usb_device_user.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -45,10 +46,23 @@
 #define USBD_GEEHY_VID              12619
 #define USBD_FS_PID                 1001
 #define USBD_LANGID_STR             0x0409
-#define USBD_MANUFACTURER_STR       "Geehy"
-#define USBD_PRODUCT_STR            "APM32 HID"
-#define USBD_CONFIGURATION_STR      "HID Config"
-#define USBD_INTERFACE_STR          "HID Interface"
+/* Strings as UTF-16 code units */
+#define USBD_MANUFACTURER_STR       'G', 'e', 'e', 'h', 'y'
+#define USBD_PRODUCT_STR            'A', 'P', 'M', '3', '2', ' ', 'H', 'I', 'D'
+#define USBD_SERIAL_STR             '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '0', '1'
+#define USBD_INTERFACE_STR          'H', 'I', 'D', ' ', 'I', 'n', 't', 'e', 'r', 'f', 'a', 'c', 'e'
+
+/* Number of UTF-16 code units of a string */
+#define USBD_STR_LEN(...)           (sizeof((const uint16_t[]){__VA_ARGS__}) / sizeof(uint16_t))
+
+/* String descriptor in flash with its length counted at build time */
+#define USBD_STR_DESC(name, ...) \
+    const struct \
+    { \
+        uint8_t     bLength; \
+        uint8_t     bDescriptorType; \
+        uint16_t    wString[USBD_STR_LEN(__VA_ARGS__)]; \
+    } name = { 2 + 2 * USBD_STR_LEN(__VA_ARGS__), USBD_DESC_STRING, { __VA_ARGS__ } }
 
 /**@} end of group USBD_HID_Macros*/
 
@@ -103,7 +117,7 @@ USBD_DESC_T USBD_DESC_FS =
 /**
  * @brief   Device descriptor
  */
-uint8_t USBD_DeviceDesc[USBD_DEVICE_DESCRIPTOR_SIZE] =
+const uint8_t USBD_DeviceDesc[USBD_DEVICE_DESCRIPTOR_SIZE] =
 {
     /* bLength */
     0x12,
@@ -141,7 +155,8 @@ uint8_t USBD_DeviceDesc[USBD_DEVICE_DESCRIPTOR_SIZE] =
 };
 
 /**
- * @brief   Configuration descriptor
+ * @brief   Configuration descriptor, the classes are registered with
+ *          their part after the header and composed again on request
  */
 uint8_t USBD_ConfigDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
 {
@@ -154,16 +169,16 @@ uint8_t USBD_ConfigDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
     USBD_CONFIG_DESCRIPTOR_SIZE >> 8,
 
     /* bNumInterfaces */
-    0x01,
+    USBD_SUP_INTERFACE_MAX_NUM,
     /* bConfigurationValue */
     0x01,
     /* iConfiguration */
     0x00,
     /* bmAttributes */
 #if USBD_SUP_SELF_PWR
-    0xE0,
+    0xC0 | (USBD_SUP_REMOTE_WAKEUP << 5),
 #else
-    0xA0,
+    0x80 | (USBD_SUP_REMOTE_WAKEUP << 5),
 #endif
     /* MaxPower */
     0x32,
@@ -201,8 +216,8 @@ uint8_t USBD_ConfigDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
     0x01,
     /* bDescriptorType */
     USBD_DESC_HID_REPORT,
-    /* wItemLength */
-    USBD_HID_MOUSE_REPORT_DESC_SIZE & 0xFF, USBD_HID_MOUSE_REPORT_DESC_SIZE >> 8,
+    /* wItemLength: filled from the selected report descriptor */
+    0x00, 0x00,
 
     /* HID Mouse Endpoint */
     /* bLength */
@@ -218,57 +233,28 @@ uint8_t USBD_ConfigDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
     USBD_HID_IN_EP_SIZE >> 8,
     /* bInterval: */
     USBD_HID_FS_INTERVAL,
-};
-
-/**
- * @brief   Other speed configuration descriptor
- */
-uint8_t USBD_OtherSpeedCfgDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
-{
-    /* bLength */
-    0x09,
-    /* bDescriptorType */
-    USBD_DESC_OTHER_SPEED,
-    /* wTotalLength */
-    USBD_CONFIG_DESCRIPTOR_SIZE & 0xFF,
-    USBD_CONFIG_DESCRIPTOR_SIZE >> 8,
-
-    /* bNumInterfaces */
-    0x01,
-    /* bConfigurationValue */
-    0x01,
-    /* iConfiguration */
-    0x00,
-    /* bmAttributes */
-#if USBD_SUP_SELF_PWR
-    0xE0,
-#else
-    0xA0,
-#endif
-    /* MaxPower */
-    0x32,
-
-    /* HID Mouse Interface */
+#if USBD_SUP_HID_TLM
+    /* HID Telemetry Interface */
     /* bLength */
     0x09,
     /* bDescriptorType */
     USBD_DESC_INTERFACE,
     /* bInterfaceNumber */
-    0x00,
+    USBD_HID_TLM_ITF_NUM,
     /* bAlternateSetting */
     0x00,
     /* bNumEndpoints */
-    0x01,
+    0x02,
     /* bInterfaceClass */
     USBD_HID_ITF_CLASS_ID,
     /* bInterfaceSubClass */
-    USBD_HID_SUB_CLASS_BOOT,
+    USBD_HID_SUB_CLASS_NBOOT,
     /* bInterfaceProtocol */
-    USBD_HID_ITF_PORTOCOL_MOUSE,
+    USBD_HID_ITF_PORTOCOL_NONE,
     /* iInterface */
     0x00,
 
-    /* HID descriptor of Mouse */
+    /* HID descriptor of Telemetry */
     /* bLength */
     0x09,
     /* bDescriptorType: HID */
@@ -282,29 +268,79 @@ uint8_t USBD_OtherSpeedCfgDesc[USBD_CONFIG_DESCRIPTOR_SIZE] =
     /* bDescriptorType */
     USBD_DESC_HID_REPORT,
     /* wItemLength */
-    USBD_HID_MOUSE_REPORT_DESC_SIZE & 0xFF, USBD_HID_MOUSE_REPORT_DESC_SIZE >> 8,
+    USBD_HID_TLM_REPORT_DESC_SIZE & 0xFF,
+    USBD_HID_TLM_REPORT_DESC_SIZE >> 8,
 
-    /* HID Mouse Endpoint */
+    /* HID Telemetry IN Endpoint */
     /* bLength */
     0x07,
     /* bDescriptorType: Endpoint */
     USBD_DESC_ENDPOINT,
     /* bEndpointAddress */
-    USBD_HID_IN_EP_ADDR,
+    USBD_HID_TLM_IN_EP_ADDR,
     /* bmAttributes */
     0x03,
     /* wMaxPacketSize: */
-    USBD_HID_IN_EP_SIZE & 0xFF,
-    USBD_HID_IN_EP_SIZE >> 8,
+    USBD_HID_TLM_EP_SIZE & 0xFF,
+    USBD_HID_TLM_EP_SIZE >> 8,
     /* bInterval: */
-    USBD_HID_FS_INTERVAL,
+    USBD_HID_TLM_FS_INTERVAL,
+
+    /* HID Telemetry OUT Endpoint */
+    /* bLength */
+    0x07,
+    /* bDescriptorType: Endpoint */
+    USBD_DESC_ENDPOINT,
+    /* bEndpointAddress */
+    USBD_HID_TLM_OUT_EP_ADDR,
+    /* bmAttributes */
+    0x03,
+    /* wMaxPacketSize: */
+    USBD_HID_TLM_EP_SIZE & 0xFF,
+    USBD_HID_TLM_EP_SIZE >> 8,
+    /* bInterval: */
+    USBD_HID_TLM_FS_INTERVAL,
+#endif
+};
+
+/**
+ * @brief   Composed configuration descriptor
+ */
+uint8_t USBD_ComposedCfgDesc[USBD_CONFIG_COMPOSE_SIZE];
+
+/**
+ * @brief   Other speed configuration descriptor header, the classes
+ *          follow as in the configuration descriptor
+ */
+const uint8_t USBD_OtherSpeedCfgHeader[USBD_CONFIG_HEADER_SIZE] =
+{
+    /* bLength */
+    0x09,
+    /* bDescriptorType */
+    USBD_DESC_OTHER_SPEED,
+    /* wTotalLength, filled by the composition */
+    0x00, 0x00,
+    /* bNumInterfaces */
+    USBD_SUP_INTERFACE_MAX_NUM,
+    /* bConfigurationValue */
+    0x01,
+    /* iConfiguration */
+    0x00,
+    /* bmAttributes */
+#if USBD_SUP_SELF_PWR
+    0xC0 | (USBD_SUP_REMOTE_WAKEUP << 5),
+#else
+    0x80 | (USBD_SUP_REMOTE_WAKEUP << 5),
+#endif
+    /* MaxPower */
+    0x32,
 };
 
 #if USBD_SUP_LPM
 /**
  * @brief   BOS descriptor
  */
-uint8_t USBD_BosDesc[USBD_BOS_DESCRIPTOR_SIZE] =
+const uint8_t USBD_BosDesc[USBD_BOS_DESCRIPTOR_SIZE] =
 {
     /* bLength */
     0x05,
@@ -322,37 +358,25 @@ uint8_t USBD_BosDesc[USBD_BOS_DESCRIPTOR_SIZE] =
     USBD_DEVICE_CAPABILITY_TYPE,
     /* bDevCapabilityType */
     USBD_20_EXTENSION_TYPE,
-    /* bmAttributes */
-    0x02, 0x02, 0x00, 0x00,
+    /* bmAttributes: LPM, BESL, baseline and deep BESL valid */
+    0x1E,
+    USBD_LPM_BESL_BASELINE | (USBD_LPM_BESL_DEEP << 4),
+    0x00, 0x00,
 };
 #endif
 
 /**
- * @brief   Serial string descriptor
+ * @brief   String descriptors
  */
-uint8_t USBD_SerialStrDesc[USBD_SERIAL_STRING_SIZE] =
-{
-    USBD_SERIAL_STRING_SIZE,
-    USBD_DESC_STRING,
-
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '0', 0,
-    '1', 0
-};
+static USBD_STR_DESC(USBD_ManufacturerStrDesc, USBD_MANUFACTURER_STR);
+static USBD_STR_DESC(USBD_ProductStrDesc, USBD_PRODUCT_STR);
+static USBD_STR_DESC(USBD_SerialStrDesc, USBD_SERIAL_STR);
+static USBD_STR_DESC(USBD_InterfaceStrDesc, USBD_INTERFACE_STR);
 
 /**
  * @brief   Language ID string descriptor
  */
-uint8_t USBD_LandIDStrDesc[USBD_LANGID_STRING_SIZE] =
+const uint8_t USBD_LandIDStrDesc[USBD_LANGID_STRING_SIZE] =
 {
     /* Size */
     USBD_LANGID_STRING_SIZE,
@@ -364,7 +388,7 @@ uint8_t USBD_LandIDStrDesc[USBD_LANGID_STRING_SIZE] =
 /**
  * @brief   Device qualifier descriptor
  */
-uint8_t USBD_DevQualifierDesc[USBD_DEVICE_QUALIFIER_DESCRIPTOR_SIZE] =
+const uint8_t USBD_DevQualifierDesc[USBD_DEVICE_QUALIFIER_DESCRIPTOR_SIZE] =
 {
     /* Size */
     USBD_DEVICE_QUALIFIER_DESCRIPTOR_SIZE,
@@ -386,56 +410,6 @@ uint8_t USBD_DevQualifierDesc[USBD_DEVICE_QUALIFIER_DESCRIPTOR_SIZE] =
   @{
   */
 
-/*!
- * @brief     USB device convert ascii string descriptor to unicode format
- *
- * @param     desc : descriptor string
- *
- * @retval    usb descriptor information
- */
-static USBD_DESC_INFO_T USBD_DESC_Ascii2Unicode(uint8_t* desc)
-{
-    USBD_DESC_INFO_T descInfo;
-    uint8_t* buffer;
-    uint8_t str[USBD_SUP_STR_DESC_MAX_NUM];
-
-    uint8_t* unicode = str;
-    uint16_t length;
-    uint8_t index = 0;
-
-    if (desc == NULL)
-    {
-        descInfo.desc = NULL;
-        descInfo.size = 0;
-    }
-    else
-    {
-        buffer = desc;
-        length = (strlen((char*)buffer) * 2) + 2;
-        /* Get unicode descriptor */
-        unicode[index] = length;
-
-        index++;
-        unicode[index] = USBD_DESC_STRING;
-        index++;
-
-        while (*buffer != '\0')
-        {
-            unicode[index] = *buffer;
-            buffer++;
-            index++;
-
-            unicode[index] = 0x00;
-            index++;
-        }
-    }
-
-    descInfo.desc = unicode;
-    descInfo.size = length;
-
-    return descInfo;
-}
-
 /*!
  * @brief     USB device FS device descriptor
  *
@@ -447,7 +421,7 @@ static USBD_DESC_INFO_T USBD_FS_DeviceDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo.desc = USBD_DeviceDesc;
+    descInfo.desc = (uint8_t*)USBD_DeviceDesc;
     descInfo.size = sizeof(USBD_DeviceDesc);
 
     return descInfo;
@@ -463,9 +437,24 @@ static USBD_DESC_INFO_T USBD_FS_DeviceDescHandler(uint8_t usbSpeed)
 static USBD_DESC_INFO_T USBD_FS_ConfigDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
+    uint16_t length = sizeof(USBD_ComposedCfgDesc);
 
-    descInfo.desc = USBD_ConfigDesc;
-    descInfo.size = sizeof(USBD_ConfigDesc);
+    /* Report the polling interval and report descriptor selected at runtime */
+    USBD_ConfigDesc[USBD_CONFIG_EP_INTERVAL_OFFSET] = USBD_HID_ReadInterval(&gUsbDeviceFS);
+    USBD_ConfigDesc[USBD_CONFIG_HID_ITEM_LEN_OFFSET] = USBD_HID_ReadReportDescSize() & 0xFF;
+    USBD_ConfigDesc[USBD_CONFIG_HID_ITEM_LEN_OFFSET + 1] = USBD_HID_ReadReportDescSize() >> 8;
+
+    /* Interfaces and endpoints numbered for the registered classes */
+    if (USBD_ComposeConfigDesc(&gUsbDeviceFS, USBD_ConfigDesc, USBD_ComposedCfgDesc, &length) == USBD_OK)
+    {
+        descInfo.desc = USBD_ComposedCfgDesc;
+        descInfo.size = length;
+    }
+    else
+    {
+        descInfo.desc = USBD_ConfigDesc;
+        descInfo.size = sizeof(USBD_ConfigDesc);
+    }
 
     return descInfo;
 }
@@ -482,7 +471,7 @@ static USBD_DESC_INFO_T USBD_FS_BosDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo.desc = USBD_BosDesc;
+    descInfo.desc = (uint8_t*)USBD_BosDesc;
     descInfo.size = sizeof(USBD_BosDesc);
 
     return descInfo;
@@ -500,7 +489,8 @@ static USBD_DESC_INFO_T USBD_FS_InterfaceDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo = USBD_DESC_Ascii2Unicode((uint8_t*)USBD_INTERFACE_STR);
+    descInfo.desc = (uint8_t*)&USBD_InterfaceStrDesc;
+    descInfo.size = sizeof(USBD_InterfaceStrDesc);
 
     return descInfo;
 }
@@ -516,7 +506,7 @@ static USBD_DESC_INFO_T USBD_FS_LangIdDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo.desc = USBD_LandIDStrDesc;
+    descInfo.desc = (uint8_t*)USBD_LandIDStrDesc;
     descInfo.size = sizeof(USBD_LandIDStrDesc);
 
     return descInfo;
@@ -533,7 +523,8 @@ static USBD_DESC_INFO_T USBD_FS_ManufacturerDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo = USBD_DESC_Ascii2Unicode((uint8_t*)USBD_MANUFACTURER_STR);
+    descInfo.desc = (uint8_t*)&USBD_ManufacturerStrDesc;
+    descInfo.size = sizeof(USBD_ManufacturerStrDesc);
 
     return descInfo;
 }
@@ -549,7 +540,8 @@ static USBD_DESC_INFO_T USBD_FS_ProductDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo = USBD_DESC_Ascii2Unicode((uint8_t*)USBD_PRODUCT_STR);
+    descInfo.desc = (uint8_t*)&USBD_ProductStrDesc;
+    descInfo.size = sizeof(USBD_ProductStrDesc);
 
     return descInfo;
 }
@@ -565,7 +557,7 @@ static USBD_DESC_INFO_T USBD_FS_SerialDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
 
-    descInfo.desc = USBD_SerialStrDesc;
+    descInfo.desc = (uint8_t*)&USBD_SerialStrDesc;
     descInfo.size = sizeof(USBD_SerialStrDesc);
 
     return descInfo;
@@ -581,10 +573,23 @@ static USBD_DESC_INFO_T USBD_FS_SerialDescHandler(uint8_t usbSpeed)
 static USBD_DESC_INFO_T USBD_OtherSpeedConfigDescHandler(uint8_t usbSpeed)
 {
     USBD_DESC_INFO_T descInfo;
+    uint16_t length = sizeof(USBD_ComposedCfgDesc);
+
+    USBD_ConfigDesc[USBD_CONFIG_EP_INTERVAL_OFFSET] = USBD_HID_ReadInterval(&gUsbDeviceFS);
+    USBD_ConfigDesc[USBD_CONFIG_HID_ITEM_LEN_OFFSET] = USBD_HID_ReadReportDescSize() & 0xFF;
+    USBD_ConfigDesc[USBD_CONFIG_HID_ITEM_LEN_OFFSET + 1] = USBD_HID_ReadReportDescSize() >> 8;
 
     /* Use FS configuration */
-    descInfo.desc = USBD_OtherSpeedCfgDesc;
-    descInfo.size = sizeof(USBD_OtherSpeedCfgDesc);
+    if (USBD_ComposeConfigDesc(&gUsbDeviceFS, USBD_OtherSpeedCfgHeader, USBD_ComposedCfgDesc, &length) == USBD_OK)
+    {
+        descInfo.desc = USBD_ComposedCfgDesc;
+        descInfo.size = length;
+    }
+    else
+    {
+        descInfo.desc = NULL;
+        descInfo.size = 0;
+    }
 
     return descInfo;
 }
@@ -601,7 +606,7 @@ static USBD_DESC_INFO_T USBD_DevQualifierDescHandler(uint8_t usbSpeed)
     USBD_DESC_INFO_T descInfo;
 
     /* Use FS configuration */
-    descInfo.desc = USBD_DevQualifierDesc;
+    descInfo.desc = (uint8_t*)USBD_DevQualifierDesc;
     descInfo.size = sizeof(USBD_DevQualifierDesc);
 
     return descInfo;
@@ -48,8 +48,12 @@ extern "C" {
 
 #if defined (USB_DEVICE)
 
+/* A simulated peripheral may place the packet memory in RAM */
+#ifndef USBD_PMA_ADDR
 #define USBD_PMA_ADDR               (USBD_BASE + 0x400)
+#endif
 #define USBD_PMA_ACCESS             1
+#define USBD_PMA_SIZE               1024
 #define USBD_BUFFTB_ADDR            0x0000
 
 /**@} end of group USB_Macros*/
@@ -193,6 +197,7 @@ typedef struct
     uint16_t            pmaAddr;
     uint16_t            pmaAddr0;
     uint16_t            pmaAddr1;
+    uint16_t            pmaSize;
     
     USBD_EP_BUFFER_T    bufferStatus;
     uint8_t*            buffer;
@@ -211,6 +216,7 @@ typedef struct
     uint32_t            lpmStatus;
     uint32_t            lowPowerStatus;     /*!< Low power mode status */
     uint32_t            sofStatus;          /*!< SOF output status */
+    uint32_t            deferStatus;        /*!< Service the events from USBD_EventHandler */
     uint32_t            ep0MaxPackSize;
     uint32_t            devEndpointNum;     /*!< USB device endpoint number */
     uint32_t            speed;              /*!< USB core speed */
@@ -228,6 +234,8 @@ void USBD_Disable(USBD_T *usbx);
 void USBD_EnablePullUpDP(USBD_T *usbx);
 void USBD_DisablePullUpDP(USBD_T *usbx);
 uint8_t USBD_ReadBESL(USBD_T *usbx);
+uint8_t USBD_ReadL1RemoteWakeup(USBD_T *usbx);
+uint16_t USBD_ReadFrameNumber(USBD_T *usbx);
 void USBD_EnableLPM(USBD_T *usbx);
 void USBD_DisableLPM(USBD_T *usbx);
 void USBD_EnableAckLPM(USBD_T *usbx);
@@ -266,6 +274,9 @@ void USBD_SetForceSuspend(USBD_T *usbx);
 void USBD_ResetForceSuspend(USBD_T *usbx);
 void USBD_SetLowerPowerMode(USBD_T *usbx);
 void USBD_ResetLowerPowerMode(USBD_T *usbx);
+void USBD_SetWakeupRequest(USBD_T *usbx);
+void USBD_ResetWakeupRequest(USBD_T *usbx);
+void USBD_SetL1WakeupRequest(USBD_T *usbx);
 void USBD_SetDeviceAddr(USBD_T *usbx, uint8_t address);
 
 void USBD_EnableInterrupt(USBD_T *usbx, uint32_t interrupt);
@@ -48,10 +48,26 @@
 #define USBD_WAKEUP_EINT_LINE                   0x40000
 
 #define USBD_EP0_OUT_ADDR                       0x00
-#define USBD_EP0_OUT_SIZE                       0x18
-
 #define USBD_EP0_IN_ADDR                        0x80
-#define USBD_EP0_IN_SIZE                        0x58
+#define USBD_EP0_MAX_PACKET_SIZE                64
+
+/* Resume signalling length in ms, 1 to 15 ms */
+#define USBD_RESUME_SIGNAL_TIME                 10
+
+/* Deferred events, a power of 2 up to 128. Each endpoint direction
+   completes at most its two buffers before it is serviced, the rest is
+   room for the SETUP and bus events. An interrupt finding no room is
+   masked with its flag set, the endpoints NAK until the queue drains. */
+#define USBD_EVENT_QUEUE_SIZE                   64
+/* Entries the transfers leave to the reset, suspend and resume events */
+#define USBD_EVENT_BUS_RESERVE                  4
+
+#if (USBD_EVENT_QUEUE_SIZE < (2 * 2 * 8)) || (USBD_EVENT_QUEUE_SIZE > 128)
+#error "USBD_EVENT_QUEUE_SIZE must hold two events per endpoint"
+#endif
+
+/* PMA address of a double buffered endpoint for USBD_ConfigPMA */
+#define USBD_EP_PMA_DB(addr0, addr1)            ((uint32_t)(addr0) | ((uint32_t)(addr1) << 16))
 
 /**@} end of group USB_Device_Macros*/
 
@@ -70,6 +86,18 @@ typedef enum
     USBD_LPM_LV3_OFF,
 } USBD_LPM_STA_T;
 
+/**
+ * @brief USB device deferred event
+ */
+typedef enum
+{
+    USBD_EVENT_CTR,         /*!< Correct transfer of an endpoint */
+    USBD_EVENT_RESET,
+    USBD_EVENT_SUSPEND,
+    USBD_EVENT_RESUME,
+    USBD_EVENT_LPM,         /*!< Link power mode change */
+} USBD_EVENT_T;
+
 /**
  * @brief USB device link power mode
  */
@@ -85,6 +113,34 @@ typedef enum
   @{
 */
 
+/**
+ * @brief USB device event, queued by the interrupt when the event
+ *        handling is deferred
+ */
+typedef struct
+{
+    uint8_t                     type;
+    uint8_t                     epNum;
+    uint16_t                    epStatus;
+    uint16_t                    frame;              /*!< Frame number when posted */
+    uint32_t                    time;               /*!< USBD_ReadTimeCallback when posted */
+} USBD_EVENT_INFO_T;
+
+/**
+ * @brief USB device link statistics, the counters wrap
+ */
+typedef struct
+{
+    uint16_t                    xferCnt[2][8];      /*!< Transactions of the OUT [0] and IN [1] endpoints */
+    uint32_t                    byteCnt[2][8];      /*!< Bytes of the OUT [0] and IN [1] endpoints */
+    uint16_t                    stallCnt;           /*!< Endpoints stalled by the device */
+    uint16_t                    errCnt;             /*!< CRC, bit stuffing, framing or timeout errors */
+    uint16_t                    pmaOvrCnt;          /*!< Packet memory overruns or underruns */
+    uint16_t                    sofMissCnt;         /*!< SOFs missed while the bus was active */
+    uint16_t                    suspendCnt;
+    uint16_t                    resetCnt;
+} USBD_LINK_STAT_T;
+
 /**
  * @brief USB device handle
  */
@@ -102,7 +158,22 @@ typedef struct
     uint8_t                     lpmStatus;
     uint8_t                     batteryStatus;
     USBD_LPM_STA_T              lpMode;
-    uint32_t                    beslVal;
+    uint32_t                    beslVal;            /*!< BESL of the last L1 entry */
+    uint8_t                     l1WakeStatus;       /*!< Remote wakeup allowed from L1 */
+    __IO uint8_t                resumeCnt;
+    uint16_t                    pmaFree;
+    
+    USBD_EVENT_INFO_T           event[USBD_EVENT_QUEUE_SIZE];
+    __IO uint8_t                eventHead;
+    __IO uint8_t                eventTail;
+    uint8_t                     eventMax;           /*!< Most events queued at once */
+    __IO uint16_t               eventOvf;           /*!< Interrupts masked on a full queue */
+    __IO uint16_t               eventMask;          /*!< Interrupts masked until the queue drains */
+    uint16_t                    eventFrame;         /*!< Frame of the event in service */
+    uint32_t                    eventTime;          /*!< Time of the event in service */
+    __IO uint16_t               sofCnt;
+    
+    USBD_LINK_STAT_T            linkStat;
     
     void*                       dataPoint;
 } USBD_HANDLE_T;
@@ -114,13 +185,17 @@ typedef struct
 */
 
 void USBD_IsrHandler(USBD_HANDLE_T* usbdh);
+void USBD_EventHandler(USBD_HANDLE_T* usbdh);
 void USBD_ConfigPMA(USBD_HANDLE_T* usbdh, uint16_t epAddr, uint16_t bufferStatus, uint32_t pmaAddr);
+void USBD_PMA_Reset(USBD_HANDLE_T* usbdh);
+uint8_t USBD_PMA_Alloc(USBD_HANDLE_T* usbdh, uint16_t epAddr, uint16_t bufferStatus, uint16_t mps);
 
 void USBD_Start(USBD_HANDLE_T* usbdh);
 void USBD_Stop(USBD_HANDLE_T* usbdh);
 void USBD_StopDevice(USBD_HANDLE_T* usbdh);
 void USBD_Config(USBD_HANDLE_T* usbdh);
 void USBD_SetDevAddress(USBD_HANDLE_T* usbdh, uint8_t address);
+void USBD_StartRemoteWakeup(USBD_HANDLE_T* usbdh);
 void USBD_EP_Open(USBD_HANDLE_T* usbdh, uint8_t epAddr, \
                   USB_EP_TYPE_T epType, uint16_t epMps);
 void USBD_EP_Close(USBD_HANDLE_T* usbdh, uint8_t epAddr);
@@ -148,6 +223,7 @@ void USBD_IsoInInCompleteCallback(USBD_HANDLE_T* usbdh, uint8_t epNum);
 void USBD_IsoOutInCompleteCallback(USBD_HANDLE_T* usbdh, uint8_t epNum);
 
 void USBD_LpmModeCallback(USBD_HANDLE_T* usbdh, USBD_LOW_POWER_MODE_T lpMode);
+uint32_t USBD_ReadTimeCallback(USBD_HANDLE_T* usbdh);
 
 /**@} end of group USB_Device_Functions*/
 /**@} end of group USB_Device_Driver*/
@@ -756,22 +756,45 @@ void USBD_EP_SetTxRxStatus(USBD_T *usbx, uint8_t epNum, USBD_EP_STATUS_T txStatu
 void USBD_EP_ReadPacketData(USBD_T *usbx, uint16_t pmaBufAddr, uint8_t* rBuf, uint32_t rLen)
 {
     __IO uint16_t* epAddr;
-    uint32_t i, temp, cnt;
+    uint16_t* dst;
+    uint32_t temp, cnt;
 
     cnt = rLen >> 1;
 
-    //epAddr = (__IO uint16_t *)USBD_EP_ReadRxBufferPointer(usbx, epNum);
     epAddr = (__IO uint16_t *)(USBD_PMA_ADDR + ((uint32_t)pmaBufAddr * USBD_PMA_ACCESS));
-    
-    for (i = 0; i < cnt; i++)
+
+    if (((uint32_t)rBuf & 0x01) == 0)
     {
-        temp = *epAddr++;
-        *rBuf++ = temp & 0xFF;
-        *rBuf++ = (temp >> 8) & 0xFF;
-        
-#if USBD_PMA_ACCESS > 1
-        epAddr++;
-#endif
+        /* Aligned buffer, store the little endian halfwords directly */
+        dst = (uint16_t*)rBuf;
+
+        for (; cnt >= 4; cnt -= 4)
+        {
+            dst[0] = epAddr[0];
+            dst[1] = epAddr[1 * USBD_PMA_ACCESS];
+            dst[2] = epAddr[2 * USBD_PMA_ACCESS];
+            dst[3] = epAddr[3 * USBD_PMA_ACCESS];
+            dst += 4;
+            epAddr += 4 * USBD_PMA_ACCESS;
+        }
+
+        for (; cnt != 0; cnt--)
+        {
+            *dst++ = *epAddr;
+            epAddr += USBD_PMA_ACCESS;
+        }
+
+        rBuf = (uint8_t*)dst;
+    }
+    else
+    {
+        for (; cnt != 0; cnt--)
+        {
+            temp = *epAddr;
+            epAddr += USBD_PMA_ACCESS;
+            *rBuf++ = temp & 0xFF;
+            *rBuf++ = (temp >> 8) & 0xFF;
+        }
     }
 
     if (rLen & 1)
@@ -796,27 +819,46 @@ void USBD_EP_ReadPacketData(USBD_T *usbx, uint16_t pmaBufAddr, uint8_t* rBuf, ui
  */
 void USBD_EP_WritePacketData(USBD_T *usbx, uint16_t pmaBufAddr, uint8_t* wBuf, uint32_t wLen)
 {
-    uint32_t i;
-
     __IO uint16_t* epAddr;
-    uint32_t temp;
-
-    wLen = (wLen + 1) >> 1;
+    const uint16_t* src;
+    uint32_t temp, cnt;
 
-    //epAddr = USBD_EP_ReadTxBufferPointer(usbx, epNum);
+    /* An odd length writes the byte after the buffer too */
+    cnt = (wLen + 1) >> 1;
 
     epAddr = (__IO uint16_t *)(USBD_PMA_ADDR + ((uint32_t)pmaBufAddr * USBD_PMA_ACCESS));
-    
-    for (i = 0; i < wLen; i++)
+
+    if (((uint32_t)wBuf & 0x01) == 0)
     {
-        temp = *wBuf++;
-        temp = ((*wBuf++) << 8) | temp;
+        /* Aligned buffer, load the little endian halfwords directly */
+        src = (const uint16_t*)wBuf;
 
-        *epAddr++ = temp;
-        
-#if USBD_PMA_ACCESS > 1
-        epAddr++;
-#endif
+        for (; cnt >= 4; cnt -= 4)
+        {
+            epAddr[0] = src[0];
+            epAddr[1 * USBD_PMA_ACCESS] = src[1];
+            epAddr[2 * USBD_PMA_ACCESS] = src[2];
+            epAddr[3 * USBD_PMA_ACCESS] = src[3];
+            src += 4;
+            epAddr += 4 * USBD_PMA_ACCESS;
+        }
+
+        for (; cnt != 0; cnt--)
+        {
+            *epAddr = *src++;
+            epAddr += USBD_PMA_ACCESS;
+        }
+    }
+    else
+    {
+        for (; cnt != 0; cnt--)
+        {
+            temp = *wBuf++;
+            temp = ((*wBuf++) << 8) | temp;
+
+            *epAddr = temp;
+            epAddr += USBD_PMA_ACCESS;
+        }
     }
 }
 
@@ -948,6 +990,43 @@ void USBD_ResetLowerPowerMode(USBD_T *usbx)
     usbx->CTRL_B.LPWREN = BIT_RESET;
 }
 
+/*!
+ * @brief     Set wakeup request, drive resume signalling on the bus
+ *
+ * @param     usbx: USB peripheral
+ *
+ * @retval    None
+ */
+void USBD_SetWakeupRequest(USBD_T *usbx)
+{
+    usbx->CTRL_B.WKUPREQ = BIT_SET;
+}
+
+/*!
+ * @brief     Reset wakeup request
+ *
+ * @param     usbx: USB peripheral
+ *
+ * @retval    None
+ */
+void USBD_ResetWakeupRequest(USBD_T *usbx)
+{
+    usbx->CTRL_B.WKUPREQ = BIT_RESET;
+}
+
+/*!
+ * @brief     Set L1 wakeup request, drive the 50 us L1 resume signalling.
+ *            The hardware clears it at the end of the signalling.
+ *
+ * @param     usbx: USB peripheral
+ *
+ * @retval    None
+ */
+void USBD_SetL1WakeupRequest(USBD_T *usbx)
+{
+    usbx->CTRL_B.L1WKUPREQ = BIT_SET;
+}
+
 /*!
  * @brief     Set force suspend
  *
@@ -1008,6 +1087,30 @@ uint8_t USBD_ReadBESL(USBD_T *usbx)
     return (usbx->LPMCTRLSTS_B.BESL);
 }
 
+/*!
+ * @brief     Read the bRemoteWake of the last LPM token
+ *
+ * @param     usbx: USB peripheral
+ *
+ * @retval    1 if the host allows the remote wakeup from L1
+ */
+uint8_t USBD_ReadL1RemoteWakeup(USBD_T *usbx)
+{
+    return (usbx->LPMCTRLSTS_B.REMWAKE);
+}
+
+/*!
+ * @brief     Read the frame number of the last SOF
+ *
+ * @param     usbx: USB peripheral
+ *
+ * @retval    11-bit frame number
+ */
+uint16_t USBD_ReadFrameNumber(USBD_T *usbx)
+{
+    return (uint16_t)(usbx->FRANUM_B.FRANUM);
+}
+
 /*!
  * @brief     Enable LPM
  *
@@ -122,6 +122,7 @@ void USBD_EP_Open(USBD_HANDLE_T* usbdh, uint8_t epAddr, \
                   USB_EP_TYPE_T epType, uint16_t epMps)
 {
     uint8_t epAddrTemp = epAddr & 0x0F;
+    USBD_ENDPOINT_INFO_T *ep;
 
     if ((epAddr & 0x80) == 0x80)
     {
@@ -132,6 +133,8 @@ void USBD_EP_Open(USBD_HANDLE_T* usbdh, uint8_t epAddr, \
         usbdh->epIN[epAddrTemp].mps     = epMps;
 
         usbdh->epIN[epAddrTemp].txFifoNum = usbdh->epIN[epAddrTemp].epNum;
+
+        ep = &usbdh->epIN[epAddrTemp];
     }
     else
     {
@@ -140,6 +143,17 @@ void USBD_EP_Open(USBD_HANDLE_T* usbdh, uint8_t epAddr, \
         usbdh->epOUT[epAddrTemp].epNum   = epAddrTemp;
         usbdh->epOUT[epAddrTemp].epType  = epType;
         usbdh->epOUT[epAddrTemp].mps     = epMps;
+
+        ep = &usbdh->epOUT[epAddrTemp];
+    }
+
+    /* Only bulk and isochronous endpoints have a double buffer, the
+       others run single buffered from the buffer 0 address */
+    if ((ep->bufferStatus == USBD_EP_BUFFER_DOUBLE) && \
+        (epType != EP_TYPE_BULK) && (epType != EP_TYPE_ISO))
+    {
+        ep->bufferStatus = USBD_EP_BUFFER_SINGLE;
+        ep->pmaAddr = ep->pmaAddr0;
     }
 
     /* Init data PID */
@@ -274,6 +288,8 @@ void USBD_EP_Stall(USBD_HANDLE_T* usbdh, uint8_t epAddr)
     ep->stallStatus = ENABLE;
     ep->epNum = epAddr & 0x0F;
     
+    usbdh->linkStat.stallCnt++;
+    
     if (ep->epDir == EP_DIR_IN)
     {
         USBD_EP_SetTxStatus(usbdh->usbGlobal, ep->epNum, USBD_EP_STATUS_STALL);
@@ -755,6 +771,7 @@ static void USBD_EP_DB_Transmit(USBD_HANDLE_T* usbdh, USBD_ENDPOINT_INFO_T* ep,
     if(epStatus & USBD_EP_BIT_TXDTOG)
     {
         cnt = USBD_EP_ReadTxCnt(usbdh->usbGlobal, ep->epNum);
+        usbdh->linkStat.byteCnt[EP_DIR_IN][ep->epNum] += cnt;
         
         if(ep->bufLen > cnt)
         {
@@ -793,6 +810,9 @@ static void USBD_EP_DB_Transmit(USBD_HANDLE_T* usbdh, USBD_ENDPOINT_INFO_T* ep,
             {
                 USBD_EP_ToggleRx(usbdh->usbGlobal, ep->epNum);
             }
+            
+            /* Both buffers are sent, the endpoint NAKs until the next transfer */
+            return;
         }
         else
         {
@@ -843,6 +863,7 @@ static void USBD_EP_DB_Transmit(USBD_HANDLE_T* usbdh, USBD_ENDPOINT_INFO_T* ep,
     {
         /* Buffer1 */
         cnt = USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
+        usbdh->linkStat.byteCnt[EP_DIR_IN][ep->epNum] += cnt;
         
         if(ep->bufLen >= cnt)
         {
@@ -881,6 +902,9 @@ static void USBD_EP_DB_Transmit(USBD_HANDLE_T* usbdh, USBD_ENDPOINT_INFO_T* ep,
             {
                 USBD_EP_ToggleRx(usbdh->usbGlobal, ep->epNum);
             }
+            
+            /* Both buffers are sent, the endpoint NAKs until the next transfer */
+            return;
         }
         else
         {
@@ -1017,213 +1041,398 @@ static uint16_t USBD_EP_DB_Receive(USBD_HANDLE_T* usbdh, USBD_ENDPOINT_INFO_T* e
 }
 
 /*!
- * @brief     Handle USB device correct transfer interrupt
+ * @brief     Service a correct transfer of an endpoint, the OUT
+ *            transfer before the IN one
  *
  * @param     usbdh: USB device handler
  *
+ * @param     epNum: endpoint number
+ *
+ * @param     epStatus: endpoint register read when the transfer was
+ *            acknowledged
+ *
  * @retval    None
  */
-static void USBD_EP_CTRHandler(USBD_HANDLE_T* usbdh)
+static void USBD_EP_CTRService(USBD_HANDLE_T* usbdh, uint8_t epNum, uint16_t epStatus)
 {
     USBD_ENDPOINT_INFO_T* ep;
-    uint8_t epNum;
-    uint8_t epDir;
-    uint16_t epStatus;
     
     uint16_t bufCnt;
     uint16_t txBufCnt;
+    uint16_t ctrStatus = epStatus;
     
-    while(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_CTR) == SET)
+    /* EP0 */
+    if(epNum == USBD_EP_0)
     {
-        epNum = USBD_EP_ReadID(usbdh->usbGlobal);
-        epDir = USBD_EP_ReadDir(usbdh->usbGlobal);
-        
-        /* EP0 */
-        if(epNum == USBD_EP_0)
+        if(ctrStatus & USBD_EP_BIT_CTFR)
         {
-            /* EP IN */
-            if(epDir == 0)
+            ep = &usbdh->epOUT[USBD_EP_0];
+            
+            /* SETUP */
+            if(epStatus & USBD_EP_BIT_SETUP)
             {
-                USBD_EP_ResetTxFlag(usbdh->usbGlobal, USBD_EP_0);
-                ep = &usbdh->epIN[USBD_EP_0];
-                
-                ep->bufCount = USBD_EP_ReadTxCnt(usbdh->usbGlobal, epNum);
-                ep->buffer += ep->bufCount;
-                
-                /* IN stage */
-                USBD_DataInStageCallback(usbdh, USBD_EP_0);
+                ep->bufCount = USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
+                usbdh->linkStat.byteCnt[EP_DIR_OUT][USBD_EP_0] += ep->bufCount;
+                USBD_EP_ReadPacketData(usbdh->usbGlobal, \
+                                       ep->pmaAddr, \
+                                       (uint8_t *)usbdh->setup, \
+                                       ep->bufCount);
                 
-                if((ep->bufLen == 0) && (usbdh->address > 0))
-                {
-                    USBD_SetDeviceAddr(usbdh->usbGlobal, usbdh->address);
-                    USBD_Enable(usbdh->usbGlobal);
-                    usbdh->address = 0;
-                }
+                USBD_SetupStageCallback(usbdh);
             }
+            /* OUT */
             else
             {
-                ep = &usbdh->epOUT[USBD_EP_0];
-                epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, USBD_EP_0);
+                ep->bufCount = USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
+                usbdh->linkStat.byteCnt[EP_DIR_OUT][USBD_EP_0] += ep->bufCount;
                 
-                /* SETUP */
-                if(epStatus & USBD_EP_BIT_SETUP)
+                if((ep->bufCount !=0) && (ep->buffer != 0))
                 {
-                    ep->bufCount = USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
                     USBD_EP_ReadPacketData(usbdh->usbGlobal, \
                                            ep->pmaAddr, \
-                                           (uint8_t *)usbdh->setup, \
+                                           ep->buffer, \
                                            ep->bufCount);
                     
-                    USBD_EP_ResetRxFlag(usbdh->usbGlobal, USBD_EP_0);
+                    ep->buffer += ep->bufCount;
                     
-                    USBD_SetupStageCallback(usbdh);
+                    USBD_DataOutStageCallback(usbdh, USBD_EP_0);
                 }
-                /* OUT or SETUP */
-                else if(epStatus & USBD_EP_BIT_CTFR)
+                /* Status stage of a control read */
+                else if(ep->bufCount == 0)
                 {
-                    USBD_EP_ResetRxFlag(usbdh->usbGlobal, USBD_EP_0);
-                    
-                    ep->bufCount = USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
-                    
-                    if((ep->bufCount !=0) && (ep->buffer != 0))
-                    {
-                        USBD_EP_ReadPacketData(usbdh->usbGlobal, \
-                                               ep->pmaAddr, \
-                                               ep->buffer, \
-                                               ep->bufCount);
-                        
-                        ep->buffer += ep->bufCount;
-                        
-                        USBD_DataOutStageCallback(usbdh, USBD_EP_0);
-                    }
-                    
-                    epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, USBD_EP_0);
-                    
-                    if((epStatus & USBD_EP_BIT_SETUP) == 0)
-                    {
-                        USBD_EP_SetRxCnt(usbdh->usbGlobal, USBD_EP_0, ep->mps);
-                        USBD_EP_SetRxStatus(usbdh->usbGlobal, USBD_EP_0, USBD_EP_STATUS_VALID);
-                    }
+                    USBD_DataOutStageCallback(usbdh, USBD_EP_0);
+                }
+                
+                epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, USBD_EP_0);
+                
+                if((epStatus & USBD_EP_BIT_SETUP) == 0)
+                {
+                    USBD_EP_SetRxCnt(usbdh->usbGlobal, USBD_EP_0, ep->mps);
+                    USBD_EP_SetRxStatus(usbdh->usbGlobal, USBD_EP_0, USBD_EP_STATUS_VALID);
                 }
             }
         }
-        else
+        
+        /* EP IN */
+        if(ctrStatus & USBD_EP_BIT_CTFT)
         {
-            epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, epNum);
+            ep = &usbdh->epIN[USBD_EP_0];
+            
+            ep->bufCount = USBD_EP_ReadTxCnt(usbdh->usbGlobal, epNum);
+            usbdh->linkStat.byteCnt[EP_DIR_IN][USBD_EP_0] += ep->bufCount;
+            ep->buffer += ep->bufCount;
             
-            if(epStatus & USBD_EP_BIT_CTFR)
+            /* IN stage */
+            USBD_DataInStageCallback(usbdh, USBD_EP_0);
+            
+            if((ep->bufLen == 0) && (usbdh->address > 0))
             {
-                USBD_EP_ResetRxFlag(usbdh->usbGlobal, epNum);
+                USBD_SetDeviceAddr(usbdh->usbGlobal, usbdh->address);
+                USBD_Enable(usbdh->usbGlobal);
+                usbdh->address = 0;
+            }
+        }
+        
+        return;
+    }
+    
+    if(ctrStatus & USBD_EP_BIT_CTFR)
+    {
+        ep = &usbdh->epOUT[epNum];
+        
+        /* Single Buffer */
+        if(ep->bufferStatus == USBD_EP_BUFFER_SINGLE)
+        {
+            bufCnt = (uint16_t)USBD_EP_ReadRxCnt(usbdh->usbGlobal, epNum);
+            
+            if(bufCnt)
+            {
+                USBD_EP_ReadPacketData(usbdh->usbGlobal, \
+                                       ep->pmaAddr, \
+                                       ep->buffer, \
+                                       bufCnt);
+            }
+        }
+        else
+        {
+            /* DB bulk OUT */
+            if(ep->epType == EP_TYPE_BULK)
+            {
+                bufCnt = USBD_EP_DB_Receive(usbdh, ep, epStatus);
+            }
+            /* DB iso OUT */
+            else
+            {
+                USBD_EP_ToggleTx(usbdh->usbGlobal, ep->epNum);
                 
-                ep = &usbdh->epOUT[epNum];
+                epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, epNum);
                 
-                /* Single Buffer */
-                if(ep->bufferStatus == USBD_EP_BUFFER_SINGLE)
+                if(epStatus & USBD_EP_BIT_RXDTOG)
                 {
-                    bufCnt = (uint16_t)USBD_EP_ReadRxCnt(usbdh->usbGlobal, epNum);
+                    /* Buffer0 */
+                    bufCnt = (uint16_t)USBD_EP_ReadTxCnt(usbdh->usbGlobal, ep->epNum);
                     
                     if(bufCnt)
                     {
                         USBD_EP_ReadPacketData(usbdh->usbGlobal, \
-                                               ep->pmaAddr, \
+                                               ep->pmaAddr0, \
                                                ep->buffer, \
                                                bufCnt);
                     }
                 }
                 else
                 {
-                    /* DB bulk OUT */
-                    if(ep->epType == EP_TYPE_BULK)
-                    {
-                        bufCnt = USBD_EP_DB_Receive(usbdh, ep, epStatus);
-                    }
-                    /* DB iso OUT */
-                    else
+                    /* Buffer1 */
+                    bufCnt = (uint16_t)USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
+                    
+                    if(bufCnt)
                     {
-                        USBD_EP_ToggleTx(usbdh->usbGlobal, ep->epNum);
-                        
-                        epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, epNum);
-                        
-                        if(epStatus & USBD_EP_BIT_RXDTOG)
-                        {
-                            /* Buffer0 */
-                            bufCnt = (uint16_t)USBD_EP_ReadTxCnt(usbdh->usbGlobal, ep->epNum);
-                            
-                            if(bufCnt)
-                            {
-                                USBD_EP_ReadPacketData(usbdh->usbGlobal, \
-                                                       ep->pmaAddr0, \
-                                                       ep->buffer, \
-                                                       bufCnt);
-                            }
-                        }
-                        else
-                        {
-                            /* Buffer1 */
-                            bufCnt = (uint16_t)USBD_EP_ReadRxCnt(usbdh->usbGlobal, ep->epNum);
-                            
-                            if(bufCnt)
-                            {
-                                USBD_EP_ReadPacketData(usbdh->usbGlobal, \
-                                                       ep->pmaAddr1, \
-                                                       ep->buffer, \
-                                                       bufCnt);
-                            }
-                        }
+                        USBD_EP_ReadPacketData(usbdh->usbGlobal, \
+                                               ep->pmaAddr1, \
+                                               ep->buffer, \
+                                               bufCnt);
                     }
                 }
-                
-                /* Multi packets */
-                ep->bufCount += bufCnt;
-                ep->buffer += bufCnt;
-                
-                if((ep->bufLen == 0) || (bufCnt < ep->mps))
-                {
-                    USBD_DataOutStageCallback(usbdh, epNum);
-                }
-                else
-                {
-                    USBD_EP_XferStart(usbdh, ep);
-                }
             }
-            else if(epStatus & USBD_EP_BIT_CTFT)
+        }
+        
+        usbdh->linkStat.byteCnt[EP_DIR_OUT][epNum] += bufCnt;
+        
+        /* Multi packets */
+        ep->bufCount += bufCnt;
+        ep->buffer += bufCnt;
+        
+        if((ep->bufLen == 0) || (bufCnt < ep->mps))
+        {
+            USBD_DataOutStageCallback(usbdh, epNum);
+        }
+        else
+        {
+            USBD_EP_XferStart(usbdh, ep);
+        }
+    }
+    
+    if(ctrStatus & USBD_EP_BIT_CTFT)
+    {
+        ep = &usbdh->epIN[epNum];
+        epStatus = ctrStatus;
+        
+        /* A double buffered bulk endpoint runs single buffered for a
+           transfer of one packet, USBD_EP_XferStart clears its kind */
+        if((ep->epType == EP_TYPE_INTERRUPT) || \
+           (ep->epType == EP_TYPE_CONTROL) || \
+           ((ep->epType == EP_TYPE_BULK) && ((epStatus & USBD_EP_BIT_KIND) == 0)))
+        {
+            txBufCnt = (uint16_t)USBD_EP_ReadTxCnt(usbdh->usbGlobal, ep->epNum);
+            usbdh->linkStat.byteCnt[EP_DIR_IN][epNum] += txBufCnt;
+            
+            if(ep->bufLen > txBufCnt)
             {
-                USBD_EP_ResetTxFlag(usbdh->usbGlobal, epNum);
-                
-                ep = &usbdh->epIN[epNum];
-                
-                if((ep->epType == EP_TYPE_BULK) || \
-                   (ep->epType == EP_TYPE_CONTROL) || \
-                   ((ep->epType == EP_TYPE_INTERRUPT) && (epStatus & USBD_EP_BIT_KIND) == 0))
-                {
-                    txBufCnt = (uint16_t)USBD_EP_ReadTxCnt(usbdh->usbGlobal, ep->epNum);
-                    
-                    if(ep->bufLen > txBufCnt)
-                    {
-                        ep->bufLen -= txBufCnt;
-                    }
-                    else
-                    {
-                        ep->bufLen = 0;
-                    }
-                    
-                    if(ep->bufLen == 0)
-                    {
-                        USBD_DataInStageCallback(usbdh, ep->epNum);
-                    }
-                    else
-                    {
-                        ep->buffer += txBufCnt;
-                        ep->bufCount += txBufCnt;
-                        USBD_EP_XferStart(usbdh, ep);
-                    }
-                }
-                else
-                {
-                    USBD_EP_DB_Transmit(usbdh, ep, epStatus);
-                }
+                ep->bufLen -= txBufCnt;
+            }
+            else
+            {
+                ep->bufLen = 0;
+            }
+            
+            if(ep->bufLen == 0)
+            {
+                USBD_DataInStageCallback(usbdh, ep->epNum);
+            }
+            else
+            {
+                ep->buffer += txBufCnt;
+                ep->bufCount += txBufCnt;
+                USBD_EP_XferStart(usbdh, ep);
             }
         }
+        else
+        {
+            USBD_EP_DB_Transmit(usbdh, ep, epStatus);
+        }
+    }
+}
+
+/*!
+ * @brief     Service a USB device event
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @param     event: event to service
+ *
+ * @retval    None
+ */
+static void USBD_EventService(USBD_HANDLE_T* usbdh, USBD_EVENT_INFO_T* event)
+{
+    /* The callbacks read when the interrupt took the event */
+    usbdh->eventFrame = event->frame;
+    usbdh->eventTime = event->time;
+    
+    switch(event->type)
+    {
+        case USBD_EVENT_CTR:
+            USBD_EP_CTRService(usbdh, event->epNum, event->epStatus);
+            break;
+        
+        case USBD_EVENT_RESET:
+            USBD_EnumDoneCallback(usbdh);
+            
+            USBD_SetDevAddress(usbdh, 0x00);
+            break;
+        
+        case USBD_EVENT_SUSPEND:
+            USBD_SuspendCallback(usbdh);
+            break;
+        
+        case USBD_EVENT_RESUME:
+            USBD_ResumeCallback(usbdh);
+            break;
+        
+        case USBD_EVENT_LPM:
+            USBD_LpmModeCallback(usbdh, (USBD_LOW_POWER_MODE_T)event->epNum);
+            break;
+        
+        default:
+            break;
+    }
+}
+
+/*!
+ * @brief     Read the free entries of the event queue
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    Free entries, USBD_EVENT_QUEUE_SIZE when the event
+ *            handling is not deferred
+ */
+static uint8_t USBD_EventRoom(USBD_HANDLE_T* usbdh)
+{
+    if(usbdh->usbCfg.deferStatus != ENABLE)
+    {
+        return USBD_EVENT_QUEUE_SIZE;
+    }
+    
+    return (uint8_t)(USBD_EVENT_QUEUE_SIZE - (uint8_t)(usbdh->eventHead - usbdh->eventTail));
+}
+
+/*!
+ * @brief     Check that the queue has room for the events of an
+ *            interrupt. Without room the interrupt is masked with its
+ *            flag set, USBD_EventHandler unmasks it once the queue is
+ *            drained.
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @param     interrupt: USBD_INT_T value
+ *
+ * @param     count: entries the interrupt needs
+ *
+ * @retval    1 when the interrupt can be handled, else 0
+ */
+static uint8_t USBD_EventReserve(USBD_HANDLE_T* usbdh, uint16_t interrupt, uint8_t count)
+{
+    if(usbdh->eventMask & interrupt)
+    {
+        return 0;
+    }
+    
+    if(USBD_EventRoom(usbdh) >= count)
+    {
+        return 1;
+    }
+    
+    USBD_DisableInterrupt(usbdh->usbGlobal, interrupt);
+    usbdh->eventMask |= interrupt;
+    usbdh->eventOvf++;
+    
+    return 0;
+}
+
+/*!
+ * @brief     Service an event now, or queue it for USBD_EventHandler
+ *            when the event handling is deferred. The event is stamped
+ *            with the frame and the time it is posted at.
+ *
+ * @note      The caller has reserved the entry with USBD_EventReserve
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @param     type: USBD_EVENT_T value
+ *
+ * @param     epNum: endpoint number, or the low power mode of an
+ *            USBD_EVENT_LPM
+ *
+ * @param     epStatus: endpoint register of an USBD_EVENT_CTR
+ *
+ * @retval    None
+ */
+static void USBD_EventPost(USBD_HANDLE_T* usbdh, uint8_t type, uint8_t epNum, uint16_t epStatus)
+{
+    USBD_EVENT_INFO_T event;
+    uint8_t count;
+    
+    event.type = type;
+    event.epNum = epNum;
+    event.epStatus = epStatus;
+    event.frame = USBD_ReadFrameNumber(usbdh->usbGlobal);
+    event.time = USBD_ReadTimeCallback(usbdh);
+    
+    if(usbdh->usbCfg.deferStatus != ENABLE)
+    {
+        USBD_EventService(usbdh, &event);
+        return;
+    }
+    
+    count = (uint8_t)(usbdh->eventHead - usbdh->eventTail);
+    
+    usbdh->event[usbdh->eventHead & (USBD_EVENT_QUEUE_SIZE - 1)] = event;
+    usbdh->eventHead++;
+    
+    if(count >= usbdh->eventMax)
+    {
+        usbdh->eventMax = count + 1;
+    }
+}
+
+/*!
+ * @brief     Handle USB device correct transfer interrupt. The flags
+ *            are acknowledged here and the transfers are serviced
+ *            with the endpoint register read before, in the order the
+ *            interrupt saw them.
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    None
+ */
+static void USBD_EP_CTRHandler(USBD_HANDLE_T* usbdh)
+{
+    uint8_t epNum;
+    uint16_t epStatus;
+    
+    while(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_CTR) == SET)
+    {
+        /* Left unacknowledged the endpoint NAKs the next transactions */
+        if(USBD_EventReserve(usbdh, USBD_INT_CTR, 1 + USBD_EVENT_BUS_RESERVE) == 0)
+        {
+            break;
+        }
+        
+        epNum = USBD_EP_ReadID(usbdh->usbGlobal);
+        epStatus = USBD_EP_ReadStatus(usbdh->usbGlobal, epNum);
+        
+        if(epStatus & USBD_EP_BIT_CTFR)
+        {
+            USBD_EP_ResetRxFlag(usbdh->usbGlobal, epNum);
+            usbdh->linkStat.xferCnt[EP_DIR_OUT][epNum]++;
+        }
+        
+        if(epStatus & USBD_EP_BIT_CTFT)
+        {
+            USBD_EP_ResetTxFlag(usbdh->usbGlobal, epNum);
+            usbdh->linkStat.xferCnt[EP_DIR_IN][epNum]++;
+        }
+        
+        USBD_EventPost(usbdh, USBD_EVENT_CTR, epNum, epStatus);
     }
 }
 
@@ -1293,7 +1502,8 @@ void USBD_SetDevAddress(USBD_HANDLE_T* usbdh, uint8_t address)
  *
  * @param     bufferStatus: endpoint kind
  *
- * @param     pmaAddr: PMA address
+ * @param     pmaAddr: PMA address, USBD_EP_PMA_DB() for a double
+ *            buffered endpoint
  *
  * @retval    None
  */
@@ -1323,6 +1533,128 @@ void USBD_ConfigPMA(USBD_HANDLE_T* usbdh, uint16_t epAddr, uint16_t bufferStatus
     }
 }
 
+/*!
+ * @brief     USB device reset the PMA allocator. The buffer table
+ *            takes the start of the PMA, 8 bytes per endpoint.
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    None
+ */
+void USBD_PMA_Reset(USBD_HANDLE_T* usbdh)
+{
+    uint8_t i;
+
+    usbdh->pmaFree = USBD_BUFFTB_ADDR + usbdh->usbCfg.devEndpointNum * 8;
+
+    for (i = 0; i < usbdh->usbCfg.devEndpointNum; i++)
+    {
+        usbdh->epIN[i].pmaSize = 0;
+        usbdh->epOUT[i].pmaSize = 0;
+    }
+}
+
+/*!
+ * @brief     USB device allocate the PMA buffers of an endpoint after
+ *            the ones already allocated
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @param     epAddr: endpoint address
+ *
+ * @param     bufferStatus: endpoint kind
+ *
+ * @param     mps: endpoint maximum packet size
+ *
+ * @retval    SUCCESS, or ERROR if the PMA is full
+ */
+uint8_t USBD_PMA_Alloc(USBD_HANDLE_T* usbdh, uint16_t epAddr, uint16_t bufferStatus, uint16_t mps)
+{
+    USBD_ENDPOINT_INFO_T *ep;
+    uint16_t size;
+    uint16_t total;
+
+    /* An OUT buffer over 62 bytes is counted in 32 byte blocks */
+    if (((epAddr & 0x80) == 0) && (mps > 62))
+    {
+        size = (mps + 31) & ~31;
+    }
+    else
+    {
+        size = (mps + 1) & ~1;
+    }
+
+    total = (bufferStatus == USBD_EP_BUFFER_SINGLE) ? size : size * 2;
+
+    if ((usbdh->pmaFree + total) > USBD_PMA_SIZE)
+    {
+        return ERROR;
+    }
+
+    if (bufferStatus == USBD_EP_BUFFER_SINGLE)
+    {
+        USBD_ConfigPMA(usbdh, epAddr, USBD_EP_BUFFER_SINGLE, usbdh->pmaFree);
+    }
+    else
+    {
+        USBD_ConfigPMA(usbdh, epAddr, USBD_EP_BUFFER_DOUBLE, \
+                       USBD_EP_PMA_DB(usbdh->pmaFree, usbdh->pmaFree + size));
+    }
+
+    if ((epAddr & 0x80) == 0x80)
+    {
+        ep = &usbdh->epIN[epAddr & 0x07];
+    }
+    else
+    {
+        ep = &usbdh->epOUT[epAddr];
+    }
+
+    ep->pmaSize = total;
+    usbdh->pmaFree += total;
+
+    return SUCCESS;
+}
+
+/*!
+ * @brief     Start the resume signalling of a remote wakeup.
+ *            The signalling is stopped by the ESOF interrupt
+ *            after USBD_RESUME_SIGNAL_TIME ms, or by the hardware
+ *            after 50 us from L1 sleep.
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    None
+ */
+void USBD_StartRemoteWakeup(USBD_HANDLE_T* usbdh)
+{
+    if (usbdh->resumeCnt != 0)
+    {
+        return;
+    }
+
+    /* L1 resume is timed by the hardware, the host answers with a
+       resume that ends the sleep in the wakeup interrupt */
+    if (usbdh->lpMode == USBD_LPM_LV1_SLEEP)
+    {
+        if (usbdh->l1WakeStatus == ENABLE)
+        {
+            USBD_ResetLowerPowerMode(usbdh->usbGlobal);
+            USBD_ResetForceSuspend(usbdh->usbGlobal);
+            USBD_SetL1WakeupRequest(usbdh->usbGlobal);
+        }
+        return;
+    }
+
+    /* Leave low power mode before driving the bus */
+    USBD_ResetLowerPowerMode(usbdh->usbGlobal);
+    USBD_ResetForceSuspend(usbdh->usbGlobal);
+
+    /* One more ESOF as the first one may come right away */
+    usbdh->resumeCnt = USBD_RESUME_SIGNAL_TIME + 1;
+    USBD_SetWakeupRequest(usbdh->usbGlobal);
+}
+
 /*!
  * @brief     Config the USB device LPM
  *
@@ -1387,6 +1719,11 @@ void USBD_Config(USBD_HANDLE_T* usbdh)
 
     /* Init address */
     usbdh->address = 0;
+    usbdh->resumeCnt = 0;
+    usbdh->eventHead = 0;
+    usbdh->eventTail = 0;
+    usbdh->eventMask = 0;
+    usbdh->sofCnt = 0;
     
     USBD_SetForceSuspend(usbdh->usbGlobal);
     
@@ -1401,8 +1738,9 @@ void USBD_Config(USBD_HANDLE_T* usbdh)
         USBD_ConfigLinkPowerMode(usbdh, ENABLE);
     }
     
-    USBD_ConfigPMA(usbdh, USBD_EP0_OUT_ADDR, USBD_EP_BUFFER_SINGLE, USBD_EP0_OUT_SIZE);
-    USBD_ConfigPMA(usbdh, USBD_EP0_IN_ADDR, USBD_EP_BUFFER_SINGLE, USBD_EP0_IN_SIZE);
+    USBD_PMA_Reset(usbdh);
+    USBD_PMA_Alloc(usbdh, USBD_EP0_OUT_ADDR, USBD_EP_BUFFER_SINGLE, USBD_EP0_MAX_PACKET_SIZE);
+    USBD_PMA_Alloc(usbdh, USBD_EP0_IN_ADDR, USBD_EP_BUFFER_SINGLE, USBD_EP0_MAX_PACKET_SIZE);
 }
 
 /*!
@@ -1421,31 +1759,34 @@ void USBD_IsrHandler(USBD_HANDLE_T* usbdh)
     }
     
     /* Handle USB Reset interrupt */
-    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_RST))
+    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_RST) && USBD_EventReserve(usbdh, USBD_INT_RST, 1))
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_RST);
+        usbdh->linkStat.resetCnt++;
         
-        USBD_EnumDoneCallback(usbdh);
+        /* A bus reset also ends L1 sleep */
+        usbdh->lpMode = USBD_LPM_LV0_ON;
         
-        USBD_SetDevAddress(usbdh, 0x00);
+        USBD_EventPost(usbdh, USBD_EVENT_RESET, 0, 0);
     }
     
     /* Handle Packet Memory Overflow */
     if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_PMAOU))
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_PMAOU);
+        usbdh->linkStat.pmaOvrCnt++;
     }
     
     /* Handle Failure Of Transfer */
     if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_ERR))
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_ERR);
+        usbdh->linkStat.errCnt++;
     }
     
     /* Handle Wakeup Request */
-    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_WKUP))
+    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_WKUP) && USBD_EventReserve(usbdh, USBD_INT_WKUP, 2))
     {
-        
         USBD_ResetLowerPowerMode(usbdh->usbGlobal);
         USBD_ResetForceSuspend(usbdh->usbGlobal);
         
@@ -1454,24 +1795,25 @@ void USBD_IsrHandler(USBD_HANDLE_T* usbdh)
         {
             usbdh->lpMode = USBD_LPM_LV0_ON;
             
-            USBD_LpmModeCallback(usbdh, USBD_LPM_LV0);
+            USBD_EventPost(usbdh, USBD_EVENT_LPM, USBD_LPM_LV0, 0);
         }
         
-        USBD_ResumeCallback(usbdh);
+        USBD_EventPost(usbdh, USBD_EVENT_RESUME, 0, 0);
         
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_WKUP);
     }
     
     /* Handle Suspend Mode Request */
-    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_SUS))
+    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_SUS) && USBD_EventReserve(usbdh, USBD_INT_SUS, 1))
     {
         USBD_SuspendHandler(usbdh);
+        usbdh->linkStat.suspendCnt++;
         
-        USBD_SuspendCallback(usbdh);
+        USBD_EventPost(usbdh, USBD_EVENT_SUSPEND, 0, 0);
     }
     
     /* Handle low power mode 1 request */
-    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_L1REQ))
+    if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_L1REQ) && USBD_EventReserve(usbdh, USBD_INT_L1REQ, 1))
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_L1REQ);
         
@@ -1481,13 +1823,14 @@ void USBD_IsrHandler(USBD_HANDLE_T* usbdh)
             USBD_SetForceSuspend(usbdh->usbGlobal);
             
             usbdh->lpMode = USBD_LPM_LV1_SLEEP;
-            usbdh->beslVal = USBD_ReadBESL(usbdh->usbGlobal) >> 2;
+            usbdh->beslVal = USBD_ReadBESL(usbdh->usbGlobal);
+            usbdh->l1WakeStatus = USBD_ReadL1RemoteWakeup(usbdh->usbGlobal);
             
-            USBD_LpmModeCallback(usbdh, USBD_LPM_LV1);
+            USBD_EventPost(usbdh, USBD_EVENT_LPM, USBD_LPM_LV1, 0);
         }
         else
         {
-            USBD_SuspendCallback(usbdh);
+            USBD_EventPost(usbdh, USBD_EVENT_SUSPEND, 0, 0);
         }
     }
     
@@ -1496,13 +1839,92 @@ void USBD_IsrHandler(USBD_HANDLE_T* usbdh)
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_SOF);
         
-        USBD_SOFCallback(usbdh);
+        /* Frames are counted rather than queued */
+        if(usbdh->usbCfg.deferStatus == ENABLE)
+        {
+            usbdh->sofCnt++;
+        }
+        else
+        {
+            USBD_SOFCallback(usbdh);
+        }
     }
     
     /* Handle Expected Start of Frame */
     if(USBD_ReadIntFlag(usbdh->usbGlobal, USBD_INT_ESOF))
     {
         USBD_ClearIntFlag(usbdh->usbGlobal, USBD_INT_ESOF);
+        
+        /* The bus is idle while suspended and while the device drives
+           the resume signalling */
+        if((usbdh->usbGlobal->CTRL_B.FORSUS == BIT_RESET) && (usbdh->resumeCnt == 0))
+        {
+            usbdh->linkStat.sofMissCnt++;
+        }
+        
+        /* Time the remote wakeup resume signalling, the last ESOF
+           waits for room to post the resume */
+        if((usbdh->resumeCnt > 1) || ((usbdh->resumeCnt == 1) && USBD_EventRoom(usbdh)))
+        {
+            usbdh->resumeCnt--;
+            
+            if(usbdh->resumeCnt == 0)
+            {
+                USBD_ResetWakeupRequest(usbdh->usbGlobal);
+                
+                USBD_EventPost(usbdh, USBD_EVENT_RESUME, 0, 0);
+            }
+        }
+    }
+}
+
+/*!
+ * @brief     Service the USB device events deferred by the interrupt,
+ *            in thread context
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    None
+ *
+ * @note      Call it from the main loop when usbCfg.deferStatus is
+ *            ENABLE. The interrupt only adds to the queue head and
+ *            this function only moves the tail, no event is serviced
+ *            in the interrupt.
+ */
+void USBD_EventHandler(USBD_HANDLE_T* usbdh)
+{
+    uint16_t sofCnt;
+    uint16_t mask;
+    
+    while(usbdh->eventTail != usbdh->eventHead)
+    {
+        USBD_EventService(usbdh, &usbdh->event[usbdh->eventTail & (USBD_EVENT_QUEUE_SIZE - 1)]);
+        
+        /* Free the entry once serviced */
+        usbdh->eventTail++;
+    }
+    
+    /* The interrupts masked on a full queue take their turn */
+    if(usbdh->eventMask != 0)
+    {
+        __disable_irq();
+        mask = usbdh->eventMask;
+        usbdh->eventMask = 0;
+        USBD_EnableInterrupt(usbdh->usbGlobal, mask);
+        __enable_irq();
+    }
+    
+    if(usbdh->sofCnt != 0)
+    {
+        __disable_irq();
+        sofCnt = usbdh->sofCnt;
+        usbdh->sofCnt = 0;
+        __enable_irq();
+        
+        while(sofCnt--)
+        {
+            USBD_SOFCallback(usbdh);
+        }
     }
 }
 
@@ -1658,6 +2080,18 @@ __weak void USBD_LpmModeCallback(USBD_HANDLE_T* usbdh, USBD_LOW_POWER_MODE_T lpM
     /* callback interface */
 }
 
+/*!
+ * @brief     USB device read time callback, stamps the posted events
+ *
+ * @param     usbdh: USB device handler
+ *
+ * @retval    Time in us, 0 without a time base
+ */
+__weak uint32_t USBD_ReadTimeCallback(USBD_HANDLE_T* usbdh)
+{
+    return 0;
+}
+
 /**@} end of group USB_Device_Functions*/
 /**@} end of group USB_Device_Driver*/
 /**@} end of group APM32F0xx_StdPeriphDriver*/
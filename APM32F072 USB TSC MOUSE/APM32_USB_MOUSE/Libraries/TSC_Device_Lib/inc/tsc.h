@@ -39,6 +39,7 @@ extern "C" {
 #include "tsc_object.h"
 #include "tsc_dxs.h"
 #include "tsc_ecs.h"
+#include "tsc_water.h"
 #include "tsc_filter.h"
 
 /** @addtogroup TSC_Driver_Library TSC Driver Library
@@ -97,6 +98,8 @@ typedef struct
     TSC_tMeas_T       AcqMax;         /*!< Acquisition maximum limit */
     TSC_tNum_T        NumCalibSample; /*!< Number of Calibration samples */
     TSC_tTick_sec_T   DTO;            /*!< Detection Time Out */
+    TSC_tKCoeff_T     EcsKDiffer;     /*!< ECS K coefficient when the delta signs differ */
+    TSC_tKCoeff_T     EcsKSame;       /*!< ECS K coefficient when the delta signs are the same */
 #if TOUCH_TOTAL_KEYS > 0
     CONST TSC_State_T           *p_KeySta; /*!< Default state machine for TouchKey sensors */
     CONST TSC_TouchKeyMethods_T *p_KeyMet; /*!< Default methods for TouchKey sensors */
@@ -405,6 +405,34 @@
 #error "TOUCH_LINROT_RESOLUTION can be (1 .. 8)."
 #endif
 
+#ifndef TOUCH_LINROT_USE_HIRES
+#error "Please Config TOUCH_LINROT_USE_HIRES."
+#endif
+
+#if ((TOUCH_LINROT_USE_HIRES < 0) || (TOUCH_LINROT_USE_HIRES > 1))
+#error "TOUCH_LINROT_USE_HIRES can be (0 .. 1)."
+#endif
+
+#if TOUCH_LINROT_USE_HIRES > 0
+
+#ifndef TOUCH_LINROT_HIRES_RESOLUTION
+#error "Please Config TOUCH_LINROT_HIRES_RESOLUTION."
+#endif
+
+#if ((TOUCH_LINROT_HIRES_RESOLUTION < 1) || (TOUCH_LINROT_HIRES_RESOLUTION > 16))
+#error "TOUCH_LINROT_HIRES_RESOLUTION can be (1 .. 16)."
+#endif
+
+#ifndef TOUCH_LINROT_HIRES_FILTER
+#error "Please Config TOUCH_LINROT_HIRES_FILTER."
+#endif
+
+#if ((TOUCH_LINROT_HIRES_FILTER < 0) || (TOUCH_LINROT_HIRES_FILTER > 8))
+#error "TOUCH_LINROT_HIRES_FILTER can be (0 .. 8)."
+#endif
+
+#endif /* TOUCH_LINROT_USE_HIRES > 0 */
+
 #ifndef TOUCH_DEBOUNCE_PROX
 #error "Please Config TOUCH_DEBOUNCE_PROX."
 #endif
@@ -477,6 +505,42 @@
 #error "TOUCH_ECS_DELAY can be (0 .. 5000)."
 #endif
 
+#ifndef TOUCH_USE_WATER
+#error "Please Config TOUCH_USE_WATER."
+#endif
+
+#if ((TOUCH_USE_WATER < 0) || (TOUCH_USE_WATER > 1))
+#error "TOUCH_USE_WATER can be (0 .. 1)."
+#endif
+
+#if TOUCH_USE_WATER > 0
+
+#ifndef TOUCH_WATER_SHIELD_TH
+#error "Please Config TOUCH_WATER_SHIELD_TH."
+#endif
+
+#if ((TOUCH_WATER_SHIELD_TH < 0) || (TOUCH_WATER_SHIELD_TH > 255))
+#error "TOUCH_WATER_SHIELD_TH can be (0 .. 255)."
+#endif
+
+#ifndef TOUCH_WATER_RATIO
+#error "Please Config TOUCH_WATER_RATIO."
+#endif
+
+#if ((TOUCH_WATER_RATIO < 1) || (TOUCH_WATER_RATIO > 255))
+#error "TOUCH_WATER_RATIO can be (1 .. 255)."
+#endif
+
+#ifndef TOUCH_WATER_DEB_DRY
+#error "Please Config TOUCH_WATER_DEB_DRY."
+#endif
+
+#if ((TOUCH_WATER_DEB_DRY < 0) || (TOUCH_WATER_DEB_DRY > 63))
+#error "TOUCH_WATER_DEB_DRY can be (0 .. 63)."
+#endif
+
+#endif /* TOUCH_USE_WATER > 0 */
+
 #ifndef TOUCH_USE_MEAS
 #error "Please Config TOUCH_USE_MEAS."
 #endif
@@ -534,6 +598,34 @@
 #error "TOUCH_USE_DXS can be (0 .. 1)."
 #endif
 
+#ifndef TOUCH_USE_DXS_ARB
+#error "Please Config TOUCH_USE_DXS_ARB."
+#endif
+
+#if ((TOUCH_USE_DXS_ARB < 0) || (TOUCH_USE_DXS_ARB > 1))
+#error "TOUCH_USE_DXS_ARB can be (0 .. 1)."
+#endif
+
+#if TOUCH_USE_DXS_ARB > 0
+
+#ifndef TOUCH_DXS_ARB_MODE
+#error "Please Config TOUCH_DXS_ARB_MODE."
+#endif
+
+#if ((TOUCH_DXS_ARB_MODE < 0) || (TOUCH_DXS_ARB_MODE > 3))
+#error "TOUCH_DXS_ARB_MODE can be (0 .. 3)."
+#endif
+
+#ifndef TOUCH_DXS_CHORD_MAX
+#error "Please Config TOUCH_DXS_CHORD_MAX."
+#endif
+
+#if ((TOUCH_DXS_CHORD_MAX < 1) || (TOUCH_DXS_CHORD_MAX > 24))
+#error "TOUCH_DXS_CHORD_MAX can be (1 .. 24)."
+#endif
+
+#endif /* TOUCH_USE_DXS_ARB > 0 */
+
 #ifndef TOUCH_USE_TIMER_CALLBACK
 #error "Please Config TOUCH_USE_TIMER_CALLBACK."
 #endif
@@ -58,18 +58,44 @@ extern "C" {
 #define FOR_LINROT_DXSLOCK TSC_Globals.For_LinRot->p_Data->DxsLock
 #define FOR_LINROT_CHANGE  TSC_Globals.For_LinRot->p_Data->Change
 
+#define TSC_DXS_ARB_NO_OWNER ((TSC_tIndex_T)0xFF)
+
 /**@} end of group TSC_DXS_Macros */
 
 /** @defgroup TSC_DXS_Enumerations Enumerations
   @{
 */
 
+/**
+ * @brief   Arbitration mode
+ */
+typedef enum
+{
+    TSC_DXS_ARB_EXCLUSIVE = 0, /*!< One object is reported only if it is alone in detect state */
+    TSC_DXS_ARB_FIRST     = 1, /*!< The first object detected is kept until it is released */
+    TSC_DXS_ARB_STRONGEST = 2, /*!< The object with the biggest delta is reported */
+    TSC_DXS_ARB_CHORD     = 3  /*!< All the objects in detect state are reported together */
+} TSC_DXS_ARB_MODE_T;
+
 /**@} end of group TSC_DXS_Enumerations */
 
 /** @defgroup TSC_DXS_Structures Structures
   @{
 */
 
+/**
+ * @brief   Contains the arbitration mode and result of an objects group.
+ *          Variables of this structure type must be placed in RAM only.
+ */
+typedef struct
+{
+    TSC_DXS_ARB_MODE_T     Mode;      /*!< Arbitration mode */
+    TSC_tNum_T             ChordMax;  /*!< Maximum number of objects reported in chord mode */
+    TSC_tIndex_T           Owner;     /*!< Object kept in first wins mode (TSC_DXS_ARB_NO_OWNER if none) */
+    uint32_t               Detected;  /*!< Objects in detect state, bit n = object n of the group */
+    uint32_t               Winners;   /*!< Objects reported, bit n = object n of the group */
+} TSC_DxsArb_T;
+
 /**@} end of group TSC_DXS_Structures */
 
 /** @defgroup TSC_DXS_Variables Variables
@@ -83,6 +109,10 @@ extern "C" {
 */
 
 void TSC_Dxs_FirstObj(CONST TSC_ObjectGroup_T *objgrp);
+#if TOUCH_USE_DXS_ARB > 0
+void TSC_Dxs_ConfigArbitration(TSC_DxsArb_T *arb);
+TSC_STATUS_T TSC_Dxs_Arbitrate(CONST TSC_ObjectGroup_T *objgrp, TSC_DxsArb_T *arb);
+#endif
 
 #ifdef __cplusplus
 }
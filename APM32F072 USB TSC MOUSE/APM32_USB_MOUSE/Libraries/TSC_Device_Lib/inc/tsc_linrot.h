@@ -117,6 +117,10 @@ typedef struct
     unsigned int           CounterDirection : 6; /*!< Counter for direction debounce management (TSC_tCounter_T) */
     unsigned int           DxsLock          : 1; /*!< The State is locked by the DxS (TSC_BOOL_T) */
     unsigned int           Direction        : 1; /*!< Movement direction (TSC_BOOL_T) */
+#if TOUCH_LINROT_USE_HIRES > 0
+    uint16_t               HiResPosition;        /*!< High resolution position (TOUCH_LINROT_HIRES_RESOLUTION bits) */
+    uint32_t               HiResFilter;          /*!< High resolution position jitter filter accumulator */
+#endif
 } TSC_LinRotData_T;
 
 /**
@@ -223,6 +227,9 @@ extern CONST TSC_tPosition_T TSC_POSOFF_6CH_ROT_M[6][6];
 void TSC_Linrot_Config(void);
 void TSC_Linrot_Process(void);
 TSC_STATUS_T TSC_Linrot_CalcPos(void);
+#if TOUCH_LINROT_USE_HIRES > 0
+TSC_STATUS_T TSC_Linrot_CalcPosHiRes(void);
+#endif
 
 /* Utility functions */
 void TSC_Linrot_ConfigCalibrationState(TSC_tCounter_T delay);
@@ -231,6 +238,9 @@ void TSC_Linrot_ConfigBurstOnlyState(void);
 TSC_STATEID_T TSC_Linrot_ReadStateId(void);
 TSC_STATEMASK_T TSC_Linrot_ReadStateMask(void);
 TSC_tNum_T TSC_Linrot_ReadChangeFlag(void);
+#if TOUCH_LINROT_USE_HIRES > 0
+uint16_t TSC_Linrot_ReadHiResPosition(void);
+#endif
 
 /* State machine functions */
 void TSC_Linrot_ProcessCalibrationState(void);
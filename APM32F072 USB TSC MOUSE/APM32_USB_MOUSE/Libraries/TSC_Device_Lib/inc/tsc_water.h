@@ -0,0 +1,101 @@
+/*!
+ * @file        tsc_water.h
+ *
+ * @brief       This file contains external declarations of the tsc_water.c file.
+ *
+ * @version     V1.0.0
+ *
+ * @date        2022-12-01
+ *
+ * @attention
+ *
+ *  Copyright (C) 2020-2022 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Define to prevent recursive inclusion */
+#ifndef __TOUCH_WATER_H
+#define __TOUCH_WATER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes */
+#include "tsc_object.h"
+
+/** @addtogroup TSC_Driver_Library TSC Driver Library
+  @{
+*/
+
+/** @addtogroup TSC_Water_Driver TSC Water Driver
+  @{
+*/
+
+/** @defgroup TSC_Water_Macros Macros
+  @{
+*/
+
+/**@} end of group TSC_Water_Macros */
+
+/** @defgroup TSC_Water_Enumerations Enumerations
+  @{
+*/
+
+/**@} end of group TSC_Water_Enumerations */
+
+/** @defgroup TSC_Water_Structures Structures
+  @{
+*/
+
+/**
+ * @brief   Contains all data related to the water rejection of an objects group.
+ *          Variables of this structure type must be placed in RAM only.
+ */
+typedef struct
+{
+    TSC_Channel_Data_T     *p_ShieldChD;   /*!< Shield channel data (Meas, Refer, Delta, ...) */
+    TSC_tThreshold_T       WaterTh;        /*!< Shield delta threshold for the water presence */
+    TSC_tNum_T             Ratio;          /*!< Minimum key/shield delta ratio of a finger, in 1/16 unit */
+    TSC_tCounter_T         CounterDebDry;  /*!< Debounce counter to leave the water state */
+    TSC_tCounter_T         CounterDeb;     /*!< Counter for the debounce management */
+    TSC_BOOL_T             Wet;            /*!< Water is present on the sensors */
+    uint32_t               Suppressed;     /*!< Objects rejected, bit n = object n of the group */
+} TSC_Water_T;
+
+/**@} end of group TSC_Water_Structures */
+
+/** @defgroup TSC_Water_Variables Variables
+  @{
+*/
+
+/**@} end of group TSC_Water_Variables */
+
+/** @defgroup TSC_Water_Functions Functions
+  @{
+*/
+
+#if TOUCH_USE_WATER > 0
+void TSC_Water_Config(TSC_Water_T *water, TSC_Channel_Data_T *shield);
+TSC_STATUS_T TSC_Water_Process(CONST TSC_ObjectGroup_T *objgrp, TSC_Water_T *water);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TSC_WATER_H */
+
+/**@} end of group TSC_Water_Functions */
+/**@} end of group TSC_Water_Driver */
+/**@} end of group TSC_Driver_Library */
@@ -197,6 +197,166 @@ void TSC_Dxs_FirstObj(CONST TSC_ObjectGroup_T *objgrp)
 #endif /*!< TOUCH_USE_DXS > 0 */
 }
 
+#if TOUCH_USE_DXS_ARB > 0
+/*!
+ * @brief       Config the arbitration with default values from configuration file
+ *
+ * @param       arb: Pointer to the arbitration data
+ *
+ * @retval      None
+ */
+void TSC_Dxs_ConfigArbitration(TSC_DxsArb_T *arb)
+{
+    arb->Mode     = (TSC_DXS_ARB_MODE_T)TOUCH_DXS_ARB_MODE;
+    arb->ChordMax = TOUCH_DXS_CHORD_MAX;
+    arb->Owner    = TSC_DXS_ARB_NO_OWNER;
+    arb->Detected = 0;
+    arb->Winners  = 0;
+}
+
+/*!
+ * @brief       Select the objects to report among the objects in detect state
+ *
+ * @param       objgrp: Pointer to the objects group to process
+ *
+ * @param       arb: Pointer to the arbitration data
+ *
+ * @retval      Status Return OK if the reported objects have changed
+ *
+ * @note        Must be called once per frame after TSC_Obj_ProcessGroup().
+ *              Each object is visited once. The objects in DETECT or TOUCH
+ *              state are taken into account, so it can be used with the DxS.
+ */
+TSC_STATUS_T TSC_Dxs_Arbitrate(CONST TSC_ObjectGroup_T *objgrp, TSC_DxsArb_T *arb)
+{
+    TSC_tIndex_T       idxObj;
+    TSC_tIndex_T       idxFirst = TSC_DXS_ARB_NO_OWNER;
+    TSC_tIndex_T       idxStrong = TSC_DXS_ARB_NO_OWNER;
+    TSC_tNum_T         nbDetect = 0;
+    TSC_tDelta_T       delta;
+    TSC_tDelta_T       deltaStrong = 0;
+    uint32_t           detected = 0;
+    uint32_t           winners = 0;
+    CONST TSC_Object_T *pObj;
+    TSC_STATEID_T      stateId;
+#if TOUCH_TOTAL_LNRTS > 0
+    TSC_tIndex_T       idxCh;
+#endif
+
+    /* Skip the objects scan if no object is in DETECT or TOUCH state */
+    if (objgrp->StateMask & (TSC_STATE_DETECT_BIT_MASK | TSC_STATE_TOUCH_BIT_MASK))
+    {
+        pObj = objgrp->p_Obj;
+
+        for (idxObj = 0; idxObj < objgrp->NbObjects; idxObj++)
+        {
+            TSC_Obj_ConfigGlobalObj(pObj);
+            stateId = TSC_STATEID_OFF;
+            delta = 0;
+
+            switch (FOR_OBJ_TYPE)
+            {
+                #if TOUCH_TOTAL_KEYS > 0
+                case TSC_OBJ_TOUCHKEY:
+                case TSC_OBJ_TOUCHKEYB:
+                    stateId = FOR_KEY_STATEID;
+                    delta = FOR_KEY->p_ChD->Delta;
+                    break;
+                #endif
+
+                #if TOUCH_TOTAL_LNRTS > 0
+                case TSC_OBJ_LINEAR:
+                case TSC_OBJ_LINEARB:
+                case TSC_OBJ_ROTARY:
+                case TSC_OBJ_ROTARYB:
+                    stateId = FOR_LINROT_STATEID;
+                    /* Biggest delta of the sensor channels */
+                    for (idxCh = 0; idxCh < FOR_LINROT->NumChannel; idxCh++)
+                    {
+                        if (FOR_LINROT->p_ChD[idxCh].Delta > delta)
+                        {
+                            delta = FOR_LINROT->p_ChD[idxCh].Delta;
+                        }
+                    }
+                    break;
+                #endif
+                default:
+                    break;
+            }
+
+            if ((stateId == TSC_STATEID_DETECT) || (stateId == TSC_STATEID_TOUCH))
+            {
+                detected |= (uint32_t)1 << idxObj;
+                nbDetect++;
+
+                if (idxFirst == TSC_DXS_ARB_NO_OWNER)
+                {
+                    idxFirst = idxObj;
+                }
+                if ((idxStrong == TSC_DXS_ARB_NO_OWNER) || (delta > deltaStrong))
+                {
+                    idxStrong = idxObj;
+                    deltaStrong = delta;
+                }
+            }
+            pObj++;
+        }
+    }
+
+    /* Keep the owner while it stays detected */
+    if ((arb->Owner == TSC_DXS_ARB_NO_OWNER) || ((detected & ((uint32_t)1 << arb->Owner)) == 0))
+    {
+        arb->Owner = idxFirst;
+    }
+
+    switch (arb->Mode)
+    {
+        case TSC_DXS_ARB_EXCLUSIVE:
+            if (nbDetect == 1)
+            {
+                winners = detected;
+            }
+            break;
+
+        case TSC_DXS_ARB_FIRST:
+            if (arb->Owner != TSC_DXS_ARB_NO_OWNER)
+            {
+                winners = (uint32_t)1 << arb->Owner;
+            }
+            break;
+
+        case TSC_DXS_ARB_STRONGEST:
+            if (idxStrong != TSC_DXS_ARB_NO_OWNER)
+            {
+                winners = (uint32_t)1 << idxStrong;
+            }
+            break;
+
+        case TSC_DXS_ARB_CHORD:
+            if (nbDetect <= arb->ChordMax)
+            {
+                winners = detected;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    arb->Detected = detected;
+
+    if (arb->Winners != winners)
+    {
+        arb->Winners = winners;
+        return TSC_STATUS_OK;
+    }
+    else
+    {
+        return TSC_STATUS_ERROR;
+    }
+}
+#endif /*!< TOUCH_USE_DXS_ARB > 0 */
+
 /**@} end of group TSC_DXS_Functions */
 /**@} end of group TSC_DXS_Driver */
 /**@} end of group TSC_Driver_Library */
@@ -316,7 +316,7 @@ TSC_STATUS_T TSC_Ecs_Process(TSC_ObjectGroup_T *objgrp)
     else
     {
         /* Calculate the K coefficient */
-        myKcoeff = TSC_Ecs_CalculateK(objgrp, TOUCH_ECS_K_DIFFER, TOUCH_ECS_K_SAME);
+        myKcoeff = TSC_Ecs_CalculateK(objgrp, TSC_Params.EcsKDiffer, TSC_Params.EcsKSame);
         /* Process the objects */
         TSC_Ecs_ProcessK(objgrp, myKcoeff);
         retval = TSC_STATUS_OK;
@@ -74,6 +74,11 @@
 #define FOR_SCT_COMP              TSC_Globals.For_LinRot->SctComp
 #define FOR_POS_CORR              TSC_Globals.For_LinRot->PosCorr
 
+#if TOUCH_LINROT_USE_HIRES > 0
+#define FOR_HIRES_POSITION        TSC_Globals.For_LinRot->p_Data->HiResPosition
+#define FOR_HIRES_FILTER          TSC_Globals.For_LinRot->p_Data->HiResFilter
+#endif
+
 #if TOUCH_DTO > 0
 #define DTO_READ_TIME  {TSC_Linrot_ReadTimeForDTO();}
 #else
@@ -84,6 +89,11 @@
 #define DIRECTION_CHANGE_TOTAL_STEPS      (256)
 #define RESOLUTION_CALCULATION            (8)
 
+#if TOUCH_LINROT_USE_HIRES > 0
+#define HIRES_FRACTION_BITS               (12)
+#define HIRES_FULL_SCALE                  ((uint32_t)((1UL << TOUCH_LINROT_HIRES_RESOLUTION) - 1))
+#endif
+
 /**@} end of group TSC_Linrot_Macros */
 
 /** @defgroup TSC_Linrot_Enumerations Enumerations
@@ -726,6 +736,216 @@ TSC_STATUS_T TSC_Linrot_CalcPos(void)
     }
 }
 
+#if TOUCH_LINROT_USE_HIRES > 0
+/*!
+ * @brief       Calculate the position with the high resolution weighted centroid
+ *
+ * @param       None
+ *
+ * @retval      Status Return OK if the position has changed
+ *
+ * @note        The electrodes are assumed to be equally spaced. On a linear sensor
+ *              the position 0 and the full scale are the centers of the first and
+ *              of the last electrode. A finger which also covers the neighbour of
+ *              an end electrode pulls the position toward the center there.
+ *
+ * @note        The smallest delta is removed from all the channels before the
+ *              centroid is computed, so idle electrodes do not pull the positions
+ *              measured at the ends of a linear sensor toward its center.
+ *
+ * @note        The position is filtered with a fixed-point exponential filter
+ *              (TOUCH_LINROT_HIRES_FILTER) which is restarted on each new touch.
+ *              RawPosition and Position are also updated on 8 bits and
+ *              TOUCH_LINROT_RESOLUTION bits for the legacy readers.
+ */
+TSC_STATUS_T TSC_Linrot_CalcPosHiRes(void)
+{
+    TSC_tIndex_T        index;
+    TSC_tIndex_T        peakIndex = 0;
+    TSC_tDelta_T        normDelta;
+    TSC_tDelta_T        peakDelta = 0;
+    TSC_tDelta_T        floorDelta = 0x7FFF;
+    int32_t             offset;
+    int32_t             sumWeight = 0;
+    int32_t             sumMoment = 0;
+    int32_t             centroid;
+    int32_t             span;
+    int32_t             diff;
+    uint32_t            curPosition;
+    TSC_tsignPosition_T rawPosition;
+    TSC_Channel_Data_T  *p_Ch = TSC_Globals.For_LinRot->p_ChD;
+
+    FOR_POSCHANGE = TSC_STATE_NOT_CHANGED;
+
+    if (FOR_NB_CHANNELS < 2)
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    /* Find the biggest and the smallest signals */
+    for (index = 0; index < FOR_NB_CHANNELS; index++)
+    {
+        #if TOUCH_LINROT_USE_NORMDELTA > 0
+        normDelta = TSC_Linrot_NormDelta(p_Ch, index);
+        #else
+        normDelta = p_Ch->Delta;
+        #endif
+
+        if (normDelta < 0)
+        {
+            normDelta = 0;
+        }
+        if (normDelta > peakDelta)
+        {
+            peakDelta = normDelta;
+            peakIndex = index;
+        }
+        if (normDelta < floorDelta)
+        {
+            floorDelta = normDelta;
+        }
+        p_Ch++;
+    }
+
+    if ((peakDelta - floorDelta) < (TSC_tDelta_T)(FOR_DETECTOUT_TH >> 1))
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    /**
+     *  Weighted centroid relative to the biggest signal
+     *    - Weight = Delta - Smallest signal
+     *    - Offset = Channel index - Biggest signal index
+     *      (wrapped in [-N/2 .. N/2] for a ROTARY sensor)
+     */
+    p_Ch = TSC_Globals.For_LinRot->p_ChD;
+    for (index = 0; index < FOR_NB_CHANNELS; index++)
+    {
+        #if TOUCH_LINROT_USE_NORMDELTA > 0
+        normDelta = TSC_Linrot_NormDelta(p_Ch, index);
+        #else
+        normDelta = p_Ch->Delta;
+        #endif
+
+        if (normDelta > floorDelta)
+        {
+            offset = (int32_t)index - (int32_t)peakIndex;
+
+            if ((FOR_OBJ_TYPE == TSC_OBJ_ROTARY) || (FOR_OBJ_TYPE == TSC_OBJ_ROTARYB))
+            {
+                if (offset > (int32_t)(FOR_NB_CHANNELS >> 1))
+                {
+                    offset -= FOR_NB_CHANNELS;
+                }
+                else if (offset < -(int32_t)((FOR_NB_CHANNELS - 1) >> 1))
+                {
+                    offset += FOR_NB_CHANNELS;
+                }
+            }
+
+            sumWeight += normDelta - floorDelta;
+            sumMoment += (normDelta - floorDelta) * offset;
+        }
+        p_Ch++;
+    }
+
+    if (sumWeight == 0)
+    {
+        return TSC_STATUS_ERROR;
+    }
+
+    /* Centroid in channel unit with HIRES_FRACTION_BITS fractional bits.
+       The division is split to keep the intermediate result on 32 bits. */
+    centroid = (sumMoment / sumWeight) << HIRES_FRACTION_BITS;
+    centroid += ((sumMoment % sumWeight) << HIRES_FRACTION_BITS) / sumWeight;
+    centroid += (int32_t)peakIndex << HIRES_FRACTION_BITS;
+
+    /* Scale the centroid on TOUCH_LINROT_HIRES_RESOLUTION bits */
+    if ((FOR_OBJ_TYPE == TSC_OBJ_LINEAR) || (FOR_OBJ_TYPE == TSC_OBJ_LINEARB))
+    {
+        span = (int32_t)(FOR_NB_CHANNELS - 1) << HIRES_FRACTION_BITS;
+
+        if (centroid < 0)
+        {
+            centroid = 0;
+        }
+        if (centroid > span)
+        {
+            centroid = span;
+        }
+        curPosition = ((uint32_t)centroid * HIRES_FULL_SCALE) / (uint32_t)span;
+    }
+    else /*!<ROTARY sensor: the position wraps around */
+    {
+        span = (int32_t)FOR_NB_CHANNELS << HIRES_FRACTION_BITS;
+
+        if (centroid < 0)
+        {
+            centroid += span;
+        }
+        if (centroid >= span)
+        {
+            centroid -= span;
+        }
+        curPosition = (((uint32_t)centroid << TOUCH_LINROT_HIRES_RESOLUTION) / (uint32_t)span) & HIRES_FULL_SCALE;
+    }
+
+    /******************** Jitter filter **********************/
+
+    if (FOR_CHANGE == TSC_STATE_CHANGED) /*!<New touch: restart the filter */
+    {
+        FOR_HIRES_FILTER = curPosition << TOUCH_LINROT_HIRES_FILTER;
+    }
+    else
+    {
+        diff = (int32_t)curPosition - (int32_t)(FOR_HIRES_FILTER >> TOUCH_LINROT_HIRES_FILTER);
+
+        if ((FOR_OBJ_TYPE == TSC_OBJ_ROTARY) || (FOR_OBJ_TYPE == TSC_OBJ_ROTARYB))
+        {
+            /* Take the shortest way around the sensor */
+            if (diff > (int32_t)(HIRES_FULL_SCALE >> 1))
+            {
+                diff -= (int32_t)(HIRES_FULL_SCALE + 1);
+            }
+            else if (diff < -(int32_t)(HIRES_FULL_SCALE >> 1))
+            {
+                diff += (int32_t)(HIRES_FULL_SCALE + 1);
+            }
+            FOR_HIRES_FILTER = (uint32_t)((int32_t)FOR_HIRES_FILTER + diff);
+            FOR_HIRES_FILTER &= ((HIRES_FULL_SCALE + 1) << TOUCH_LINROT_HIRES_FILTER) - 1;
+        }
+        else
+        {
+            FOR_HIRES_FILTER = (uint32_t)((int32_t)FOR_HIRES_FILTER + diff);
+        }
+    }
+
+    curPosition = FOR_HIRES_FILTER >> TOUCH_LINROT_HIRES_FILTER;
+
+    /******************** Final result **********************/
+
+#if TOUCH_LINROT_HIRES_RESOLUTION >= RESOLUTION_CALCULATION
+    rawPosition = (TSC_tsignPosition_T)(curPosition >> (TOUCH_LINROT_HIRES_RESOLUTION - RESOLUTION_CALCULATION));
+#else
+    rawPosition = (TSC_tsignPosition_T)(curPosition << (RESOLUTION_CALCULATION - TOUCH_LINROT_HIRES_RESOLUTION));
+#endif
+
+    FOR_RAW_POSITION = rawPosition;
+    FOR_POSITION = (TSC_tsignPosition_T)(rawPosition >> (RESOLUTION_CALCULATION - FOR_RESOLUTION));
+
+    if (FOR_HIRES_POSITION != (uint16_t)curPosition)
+    {
+        FOR_HIRES_POSITION = (uint16_t)curPosition;
+        FOR_POSCHANGE = TSC_STATE_CHANGED;
+        return TSC_STATUS_OK;
+    }
+    else
+    {
+        return TSC_STATUS_ERROR;
+    }
+}
+#endif
+
 /**@} "Object_methods" Functions */
 
 /** @defgroup Utility Functions
@@ -849,6 +1069,20 @@ TSC_tNum_T TSC_Linrot_ReadChangeFlag(void)
     return(FOR_CHANGE);
 }
 
+#if TOUCH_LINROT_USE_HIRES > 0
+/*!
+ * @brief       Return the high resolution position
+ *
+ * @param       None
+ *
+ * @retval      Position on TOUCH_LINROT_HIRES_RESOLUTION bits
+ */
+uint16_t TSC_Linrot_ReadHiResPosition(void)
+{
+    return(FOR_HIRES_POSITION);
+}
+#endif
+
 /**@} Utility Functions */
 
 /** @defgroup State_machine Functions
@@ -0,0 +1,202 @@
+/*!
+ * @file        tsc_water.c
+ *
+ * @brief       This file contains all functions to manage the water rejection
+ *
+ * @version     V1.0.0
+ *
+ * @date        2022-12-01
+ *
+ * @attention
+ *
+ *  Copyright (C) 2020-2022 Geehy Semiconductor
+ *
+ *  You may not use this file except in compliance with the
+ *  GEEHY COPYRIGHT NOTICE (GEEHY SOFTWARE PACKAGE LICENSE).
+ *
+ *  The program is only for reference, which is distributed in the hope
+ *  that it will be useful and instructional for customers to develop
+ *  their software. Unless required by applicable law or agreed to in
+ *  writing, the program is distributed on an "AS IS" BASIS, WITHOUT
+ *  ANY WARRANTY OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the GEEHY SOFTWARE PACKAGE LICENSE for the governing permissions
+ *  and limitations under the License.
+ */
+
+/* Includes */
+#include "tsc.h"
+#include "tsc_water.h"
+
+/** @addtogroup TSC_Driver_Library TSC Driver Library
+  @{
+*/
+
+/** @addtogroup TSC_Water_Driver TSC Water Driver
+  @{
+*/
+
+/** @defgroup TSC_Water_Macros Macros
+  @{
+*/
+
+/**@} end of group TSC_Water_Macros */
+
+/** @defgroup TSC_Water_Enumerations Enumerations
+  @{
+*/
+
+/**@} end of group TSC_Water_Enumerations */
+
+/** @defgroup TSC_Water_Structures Structures
+  @{
+*/
+
+/**@} end of group TSC_Water_Structures */
+
+/** @defgroup TSC_Water_Variables Variables
+  @{
+*/
+
+/**@} end of group TSC_Water_Variables */
+
+/** @defgroup TSC_Water_Functions Functions
+  @{
+*/
+
+#if TOUCH_USE_WATER > 0
+/*!
+ * @brief       Config the water rejection with default values from configuration file
+ *
+ * @param       water: Pointer to the water rejection data
+ *
+ * @param       shield: Pointer to the shield channel data
+ *
+ * @retval      None
+ */
+void TSC_Water_Config(TSC_Water_T *water, TSC_Channel_Data_T *shield)
+{
+    water->p_ShieldChD   = shield;
+    water->WaterTh       = TOUCH_WATER_SHIELD_TH;
+    water->Ratio         = TOUCH_WATER_RATIO;
+    water->CounterDebDry = TOUCH_WATER_DEB_DRY;
+    water->CounterDeb    = 0;
+    water->Wet           = TSC_FALSE;
+    water->Suppressed    = 0;
+}
+
+/*!
+ * @brief       Detect the water on the shield and reject the correlated detections
+ *
+ * @param       objgrp: Pointer to the objects group to process
+ *
+ * @param       water: Pointer to the water rejection data
+ *
+ * @retval      Status Return TSC_STATUS_BUSY while water is present, TSC_STATUS_OK otherwise
+ *
+ * @note        Must be called once per frame after TSC_Obj_ProcessGroup().
+ *              A water film couples the keys to the driven shield, so the shield
+ *              delta rises together with the key delta. A finger mainly loads the
+ *              key. While water is present, an object in detect state is rejected
+ *              if its delta is lower than the shield delta x Ratio / 16.
+ *
+ * @note        The ECS must not be run while this function returns TSC_STATUS_BUSY,
+ *              otherwise the references would drift toward the water level.
+ */
+TSC_STATUS_T TSC_Water_Process(CONST TSC_ObjectGroup_T *objgrp, TSC_Water_T *water)
+{
+    TSC_tIndex_T       idxObj;
+    TSC_tDelta_T       shieldDelta;
+    TSC_tDelta_T       delta;
+    TSC_STATEID_T      stateId;
+    uint32_t           suppressed = 0;
+    CONST TSC_Object_T *pObj;
+#if TOUCH_TOTAL_LNRTS > 0
+    TSC_tIndex_T       idxCh;
+#endif
+
+    shieldDelta = water->p_ShieldChD->Delta;
+
+    /* Water presence with debounce on the way back to dry */
+    if (shieldDelta >= (TSC_tDelta_T)water->WaterTh)
+    {
+        water->Wet = TSC_TRUE;
+        water->CounterDeb = water->CounterDebDry;
+    }
+    else if (water->Wet == TSC_TRUE)
+    {
+        if (water->CounterDeb > 0)
+        {
+            water->CounterDeb--;
+        }
+        if (water->CounterDeb == 0)
+        {
+            water->Wet = TSC_FALSE;
+        }
+    }
+
+    if ((water->Wet == TSC_TRUE) && (objgrp->StateMask & (TSC_STATE_DETECT_BIT_MASK | TSC_STATE_TOUCH_BIT_MASK)))
+    {
+        pObj = objgrp->p_Obj;
+
+        for (idxObj = 0; idxObj < objgrp->NbObjects; idxObj++)
+        {
+            TSC_Obj_ConfigGlobalObj(pObj);
+            stateId = TSC_STATEID_OFF;
+            delta = 0;
+
+            switch (TSC_Globals.For_Obj->Type)
+            {
+                #if TOUCH_TOTAL_KEYS > 0
+                case TSC_OBJ_TOUCHKEY:
+                case TSC_OBJ_TOUCHKEYB:
+                    stateId = TSC_Globals.For_Key->p_Data->StateId;
+                    delta = TSC_Globals.For_Key->p_ChD->Delta;
+                    break;
+                #endif
+
+                #if TOUCH_TOTAL_LNRTS > 0
+                case TSC_OBJ_LINEAR:
+                case TSC_OBJ_LINEARB:
+                case TSC_OBJ_ROTARY:
+                case TSC_OBJ_ROTARYB:
+                    stateId = TSC_Globals.For_LinRot->p_Data->StateId;
+                    for (idxCh = 0; idxCh < TSC_Globals.For_LinRot->NumChannel; idxCh++)
+                    {
+                        if (TSC_Globals.For_LinRot->p_ChD[idxCh].Delta > delta)
+                        {
+                            delta = TSC_Globals.For_LinRot->p_ChD[idxCh].Delta;
+                        }
+                    }
+                    break;
+                #endif
+                default:
+                    break;
+            }
+
+            if ((stateId == TSC_STATEID_DETECT) || (stateId == TSC_STATEID_TOUCH))
+            {
+                if (((int32_t)delta << 4) < ((int32_t)shieldDelta * (int32_t)water->Ratio))
+                {
+                    suppressed |= (uint32_t)1 << idxObj;
+                }
+            }
+            pObj++;
+        }
+    }
+
+    water->Suppressed = suppressed;
+
+    if (water->Wet == TSC_TRUE)
+    {
+        return TSC_STATUS_BUSY;
+    }
+    else
+    {
+        return TSC_STATUS_OK;
+    }
+}
+#endif /*!< TOUCH_USE_WATER > 0 */
+
+/**@} end of group TSC_Water_Functions */
+/**@} end of group TSC_Water_Driver */
+/**@} end of group TSC_Driver_Library */
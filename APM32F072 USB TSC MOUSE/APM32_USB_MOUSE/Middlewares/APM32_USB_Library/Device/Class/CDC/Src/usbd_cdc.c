@@ -50,6 +50,7 @@ static USBD_STA_T USBD_CDC_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T*
 static USBD_STA_T USBD_CDC_RxEP0Handler(USBD_INFO_T* usbInfo);
 static USBD_STA_T USBD_CDC_DataInHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
 static USBD_STA_T USBD_CDC_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
+static USBD_CDC_INFO_T* USBD_CDC_ReadInfo(USBD_INFO_T* usbInfo);
 
 /**@} end of group USBD_CDC_Functions */
 
@@ -112,9 +113,9 @@ static USBD_STA_T USBD_CDC_ClassInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgInd
         return USBD_FAIL;
     }
     
-    usbDevCDC->epCmdAddr = USBD_CDC_CMD_EP_ADDR;
-    usbDevCDC->epInAddr = USBD_CDC_DATA_IN_EP_ADDR;
-    usbDevCDC->epOutAddr = USBD_CDC_DATA_OUT_EP_ADDR;
+    usbDevCDC->epCmdAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_CDC_CMD_EP_ADDR);
+    usbDevCDC->epInAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_CDC_DATA_IN_EP_ADDR);
+    usbDevCDC->epOutAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_CDC_DATA_OUT_EP_ADDR);
     
     /* Open Command endpoint */
     USBD_EP_OpenCallback(usbInfo, usbDevCDC->epCmdAddr, EP_TYPE_INTERRUPT, USBD_CDC_CMD_MP_SIZE);
@@ -191,6 +192,12 @@ static USBD_STA_T USBD_CDC_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgI
     USBD_STA_T usbStatus = USBD_OK;
     USBD_CDC_INFO_T* usbDevCDC = (USBD_CDC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
 
+    /* Not configured */
+    if (usbDevCDC == NULL)
+    {
+        return usbStatus;
+    }
+
     /* Close CDC EP */
     USBD_EP_CloseCallback(usbInfo, usbDevCDC->epOutAddr);
     usbInfo->devEpOut[usbDevCDC->epOutAddr & 0x0F].useStatus = DISABLE;
@@ -481,6 +488,28 @@ static USBD_STA_T USBD_CDC_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum)
     return usbStatus;
 }
 
+/*!
+ * @brief       USB device CDC class data for the functions called by
+ *              the application, which run outside the class callbacks
+ *              that select the class
+ *
+ * @param       usbInfo: usb device information
+ *
+ * @retval      CDC class data, NULL if CDC is not registered or not
+ *              configured
+ */
+static USBD_CDC_INFO_T* USBD_CDC_ReadInfo(USBD_INFO_T* usbInfo)
+{
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_CDC_CLASS);
+
+    if (classIndex == USBD_CLASS_NONE)
+    {
+        return NULL;
+    }
+
+    return (USBD_CDC_INFO_T*)usbInfo->devClass[classIndex]->classData;
+}
+
 /*!
  * @brief       USB device CDC configure TX buffer handler
  *
@@ -495,7 +524,7 @@ static USBD_STA_T USBD_CDC_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum)
 USBD_STA_T USBD_CDC_ConfigTxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer, uint32_t length)
 {
     USBD_STA_T  usbStatus = USBD_OK;
-    USBD_CDC_INFO_T* usbDevCDC = (USBD_CDC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_CDC_INFO_T* usbDevCDC = USBD_CDC_ReadInfo(usbInfo);
     
     if (usbDevCDC == NULL)
     {
@@ -520,7 +549,7 @@ USBD_STA_T USBD_CDC_ConfigTxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer, uint32
 USBD_STA_T USBD_CDC_ConfigRxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer)
 {
     USBD_STA_T  usbStatus = USBD_OK;
-    USBD_CDC_INFO_T* usbDevCDC = (USBD_CDC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_CDC_INFO_T* usbDevCDC = USBD_CDC_ReadInfo(usbInfo);
     
     if (usbDevCDC == NULL)
     {
@@ -544,10 +573,11 @@ USBD_STA_T USBD_CDC_ConfigRxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer)
 USBD_STA_T USBD_CDC_RegisterItf(USBD_INFO_T* usbInfo, USBD_CDC_INTERFACE_T* itf)
 {
     USBD_STA_T usbStatus = USBD_FAIL;
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_CDC_CLASS);
 
-    if (itf != NULL)
+    if ((itf != NULL) && (classIndex != USBD_CLASS_NONE))
     {
-        usbInfo->devClassUserData[usbInfo->classID] = itf;
+        usbInfo->devClassUserData[classIndex] = itf;
         usbStatus = USBD_OK;
     }
 
@@ -564,7 +594,7 @@ USBD_STA_T USBD_CDC_RegisterItf(USBD_INFO_T* usbInfo, USBD_CDC_INTERFACE_T* itf)
 USBD_STA_T USBD_CDC_TxPacket(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_BUSY;
-    USBD_CDC_INFO_T* usbDevCDC = (USBD_CDC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_CDC_INFO_T* usbDevCDC = USBD_CDC_ReadInfo(usbInfo);
     
     if (usbDevCDC == NULL)
     {
@@ -595,7 +625,7 @@ USBD_STA_T USBD_CDC_TxPacket(USBD_INFO_T* usbInfo)
 USBD_STA_T USBD_CDC_RxPacket(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_BUSY;
-    USBD_CDC_INFO_T* usbDevCDC = (USBD_CDC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_CDC_INFO_T* usbDevCDC = USBD_CDC_ReadInfo(usbInfo);
     
     if (usbDevCDC == NULL)
     {
@@ -42,13 +42,37 @@
   @{
 */
 
-#define USBD_HID_MOUSE_REPORT_DESC_SIZE         74
 #define USBD_HID_DESC_SIZE                      9
 #define USBD_HID_FS_INTERVAL                    10
 #define USBD_HID_HS_INTERVAL                    7
 #define USBD_HID_IN_EP_ADDR                     0x81
-#define USBD_HID_IN_EP_SIZE                     0x04
+#define USBD_HID_IN_EP_SIZE                     0x10
 #define USBD_HID_FS_MP_SIZE                     0x40
+#define USBD_HID_MOUSE_REPORT_SIZE              0x04
+#define USBD_HID_MOUSE_HIRES_REPORT_SIZE        0x07
+#define USBD_HID_DIGITIZER_REPORT_SIZE          0x05
+#define USBD_HID_DIGITIZER_AXIS_MAX             32767
+#define USBD_HID_MOUSE_AXIS_MAX                 127
+#define USBD_HID_MOUSE_HIRES_AXIS_MAX           32767
+#define USBD_HID_WHEEL_RES_MULTIPLIER           8
+#define USBD_HID_MOUSE_QUEUE_SIZE               8
+#define USBD_HID_KEY_QUEUE_SIZE                 4
+#define USBD_HID_KEYBOARD_REPORT_SIZE           0x08
+#define USBD_HID_KEYBOARD_KEYS                  6
+#define USBD_HID_REPORT_MAX_SIZE                (USBD_HID_KEYBOARD_REPORT_SIZE + 1)
+
+/* Vendor defined telemetry interface */
+#define USBD_HID_TLM_ITF_NUM                    0x01
+#define USBD_HID_TLM_IN_EP_ADDR                 0x82
+#define USBD_HID_TLM_OUT_EP_ADDR                0x02
+#define USBD_HID_TLM_EP_SIZE                    0x40
+#define USBD_HID_TLM_FS_INTERVAL                1
+#define USBD_HID_TLM_REPORT_DESC_SIZE           29
+
+/* Report IDs of the composite format */
+#define USBD_HID_REPORT_ID_MOUSE                0x01
+#define USBD_HID_REPORT_ID_KEYBOARD             0x02
+#define USBD_HID_REPORT_ID_CONSUMER             0x03
 
 #define USBD_CLASS_SET_IDLE                     0x0A
 #define USBD_CLASS_GET_IDLE                     0x02
@@ -59,6 +83,29 @@
 #define USBD_CLASS_SET_PROTOCOL                 0x0B
 #define USBD_CLASS_GET_PROTOCOL                 0x03
 
+#define USBD_HID_PROTOCOL_BOOT                  0x00
+#define USBD_HID_PROTOCOL_REPORT                0x01
+
+/* SET_IDLE duration unit in ms */
+#define USBD_HID_IDLE_UNIT                      4
+
+#define USBD_HID_REPORT_TYPE_INPUT              0x01
+#define USBD_HID_REPORT_TYPE_OUTPUT             0x02
+#define USBD_HID_REPORT_TYPE_FEATURE            0x03
+
+/* Resolution multiplier feature report fields */
+#define USBD_HID_RES_MUL_WHEEL                  0x03
+#define USBD_HID_RES_MUL_PAN                    0x0C
+
+/* Device Mode feature of the digitizer usage page */
+#define USBD_HID_DEVICE_MODE_MOUSE              0x00
+#define USBD_HID_DEVICE_MODE_SINGLE             0x01
+#define USBD_HID_DEVICE_MODE_MULTI              0x02
+
+/* Digitizer report flags */
+#define USBD_HID_DIGITIZER_TIP                  0x01
+#define USBD_HID_DIGITIZER_IN_RANGE             0x02
+
 /**@} end of group USBD_HID_Macros*/
 
 /** @defgroup USBD_HID_Enumerates Enumerates
@@ -74,12 +121,56 @@ typedef enum
     USBD_HID_BUSY,
 } USBD_HID_STATE_T;
 
+/**
+ * @brief    HID mouse report format
+ */
+typedef enum
+{
+    USBD_HID_FORMAT_BOOT,
+    USBD_HID_FORMAT_HIRES,
+    USBD_HID_FORMAT_DIGITIZER,
+    USBD_HID_FORMAT_COMPOSITE,
+} USBD_HID_FORMAT_T;
+
+/**
+ * @brief    HID report kind sharing the IN endpoint
+ */
+typedef enum
+{
+    USBD_HID_KIND_MOUSE,
+    USBD_HID_KIND_KEYBOARD,
+    USBD_HID_KIND_CONSUMER,
+    USBD_HID_KIND_NUM,
+} USBD_HID_KIND_T;
+
 /**@} end of group USBD_HID_Enumerates*/
 
 /** @defgroup USBD_HID_Structures Structures
   @{
   */
 
+/**
+ * @brief    HID mouse queued event
+ */
+typedef struct
+{
+    uint8_t             buttons;
+    int16_t             x;
+    int16_t             y;
+} USBD_HID_MOUSE_EVENT_T;
+
+/**
+ * @brief    HID telemetry interface handler
+ */
+typedef struct
+{
+    const char*  itfName;
+    USBD_STA_T (*ItfReceive)(uint8_t* buffer, uint8_t length);
+    USBD_STA_T (*ItfGetFeature)(uint8_t* buffer, uint8_t length);
+    USBD_STA_T (*ItfSetFeature)(uint8_t* buffer, uint8_t length);
+    USBD_STA_T (*ItfVendor)(uint8_t request, uint16_t value, uint8_t* buffer, uint8_t length);
+} USBD_HID_TLM_INTERFACE_T;
+
 /**
  * @brief    HID information management
  */
@@ -88,8 +179,42 @@ typedef struct
     uint8_t             state;
     uint8_t             epInAddr;
     uint8_t             altSettingStatus;
-    uint8_t             idleStatus;
     uint8_t             protocol;
+    uint8_t             sofCnt;
+    uint8_t             buttons;
+    uint8_t             queueHead;
+    uint8_t             queueCount;
+    uint8_t             reportFormat;
+    uint8_t             resMultiplier;
+    int16_t             accWheel;
+    int16_t             accPan;
+    uint16_t            digX;
+    uint16_t            digY;
+    uint8_t             feature[2];
+    uint8_t             lastKind;
+    uint8_t             idleRate[USBD_HID_KIND_NUM];
+    uint16_t            idleCnt[USBD_HID_KIND_NUM];
+    uint16_t            txCnt;
+    uint16_t            inputCnt;
+    uint8_t             kbdHead;
+    uint8_t             kbdCount;
+    uint8_t             conHead;
+    uint8_t             conCount;
+    uint16_t            conState;
+    uint8_t             kbdState[USBD_HID_KEYBOARD_REPORT_SIZE];
+    uint8_t             kbdQueue[USBD_HID_KEY_QUEUE_SIZE][USBD_HID_KEYBOARD_REPORT_SIZE];
+    uint16_t            conQueue[USBD_HID_KEY_QUEUE_SIZE];
+    USBD_HID_MOUSE_EVENT_T queue[USBD_HID_MOUSE_QUEUE_SIZE];
+    uint8_t             report[USBD_HID_REPORT_MAX_SIZE];
+#if USBD_SUP_HID_TLM
+    uint8_t             tlmState;
+    uint8_t             tlmInAddr;
+    uint8_t             tlmOutAddr;
+    uint8_t             tlmIdleStatus;
+    uint8_t             tlmFeatureLen;
+    uint8_t             tlmRxBuffer[USBD_HID_TLM_EP_SIZE];
+    uint8_t             tlmFeature[USBD_HID_TLM_EP_SIZE];
+#endif
 } USBD_HID_INFO_T;
 
 extern USBD_CLASS_T USBD_HID_CLASS;
@@ -101,7 +226,24 @@ extern USBD_CLASS_T USBD_HID_CLASS;
   */
 
 uint8_t USBD_HID_ReadInterval(USBD_INFO_T* usbInfo);
+USBD_STA_T USBD_HID_ConfigInterval(uint8_t interval);
+USBD_STA_T USBD_HID_ConfigReportFormat(USBD_HID_FORMAT_T format);
+uint16_t USBD_HID_ReadReportDescSize(void);
+uint8_t USBD_HID_ReadReportFormat(USBD_INFO_T* usbInfo);
+uint8_t USBD_HID_ReadFormatChange(USBD_INFO_T* usbInfo);
+uint16_t USBD_HID_ReadTxCount(USBD_INFO_T* usbInfo);
+uint16_t USBD_HID_ReadInputCount(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_HID_TxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t length);
+USBD_STA_T USBD_HID_MouseMove(USBD_INFO_T* usbInfo, int16_t x, int16_t y, int8_t wheel);
+USBD_STA_T USBD_HID_MouseButton(USBD_INFO_T* usbInfo, uint8_t buttons);
+USBD_STA_T USBD_HID_MouseScroll(USBD_INFO_T* usbInfo, int16_t wheel, int16_t pan);
+USBD_STA_T USBD_HID_DigitizerWrite(USBD_INFO_T* usbInfo, uint8_t flags, uint16_t x, uint16_t y);
+USBD_STA_T USBD_HID_KeyboardWrite(USBD_INFO_T* usbInfo, uint8_t modifier, const uint8_t* keys);
+USBD_STA_T USBD_HID_ConsumerWrite(USBD_INFO_T* usbInfo, uint16_t usage);
+#if USBD_SUP_HID_TLM
+USBD_STA_T USBD_HID_RegisterTlmItf(USBD_INFO_T* usbInfo, USBD_HID_TLM_INTERFACE_T* itf);
+USBD_STA_T USBD_HID_TlmTxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t length);
+#endif
 
 /**@} end of group USBD_HID_Functions */
 /**@} end of group USBD_HID_Class */
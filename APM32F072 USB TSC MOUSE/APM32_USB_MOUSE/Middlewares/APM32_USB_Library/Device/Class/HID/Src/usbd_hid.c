@@ -48,9 +48,31 @@ static USBD_STA_T USBD_HID_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgI
 static USBD_STA_T USBD_HID_SOFHandler(USBD_INFO_T* usbInfo);
 static USBD_STA_T USBD_HID_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req);
 static USBD_STA_T USBD_HID_DataInHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
-
-static USBD_DESC_INFO_T USBD_HID_ReportDescHandler(uint8_t usbSpeed);
-static USBD_DESC_INFO_T USBD_HID_DescHandler(uint8_t usbSpeed);
+static USBD_STA_T USBD_HID_RxEP0Handler(USBD_INFO_T* usbInfo);
+static USBD_STA_T USBD_HID_CtrlReceiveData(USBD_INFO_T* usbInfo, uint8_t* buffer, uint32_t length);
+#if USBD_SUP_HID_TLM
+static USBD_STA_T USBD_HID_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
+static USBD_STA_T USBD_HID_TlmClassReqHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req);
+static USBD_STA_T USBD_HID_TlmVendorReqHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req);
+#endif
+
+static USBD_DESC_INFO_T USBD_HID_ReportDescHandler(uint8_t format);
+static USBD_DESC_INFO_T USBD_HID_DescHandler(uint8_t format);
+static uint16_t USBD_HID_FeatureLength(USBD_HID_INFO_T* usbDevHID);
+static uint8_t USBD_HID_ReadDeviceMode(uint8_t format);
+static int16_t USBD_HID_TakeAxis(int16_t* acc, int16_t max);
+static int8_t USBD_HID_TakeDetents(int16_t* acc);
+static uint16_t USBD_HID_MouseBuildReport(USBD_HID_INFO_T* usbDevHID, USBD_HID_MOUSE_EVENT_T* event);
+static int16_t USBD_HID_AddAxis(int16_t acc, int16_t delta);
+static uint8_t USBD_HID_MouseScrollPending(USBD_HID_INFO_T* usbDevHID);
+static uint16_t USBD_HID_MouseTakeReport(USBD_HID_INFO_T* usbDevHID);
+static uint16_t USBD_HID_KeyTakeReport(USBD_HID_INFO_T* usbDevHID, uint8_t kind);
+static USBD_STA_T USBD_HID_TxNext(USBD_INFO_T* usbInfo, USBD_HID_INFO_T* usbDevHID);
+static uint8_t USBD_HID_KindReportID(USBD_HID_INFO_T* usbDevHID, uint8_t kind);
+static uint16_t USBD_HID_IdleBuildReport(USBD_HID_INFO_T* usbDevHID, uint8_t kind);
+static USBD_STA_T USBD_HID_TxIdle(USBD_INFO_T* usbInfo, USBD_HID_INFO_T* usbDevHID);
+static uint8_t USBD_HID_Configured(USBD_INFO_T* usbInfo);
+static USBD_HID_INFO_T* USBD_HID_ReadInfo(USBD_INFO_T* usbInfo);
 
 /**@} end of group USBD_HID_Functions */
 
@@ -71,10 +93,14 @@ USBD_CLASS_T USBD_HID_CLASS =
     /* Control endpoint */
     USBD_HID_SetupHandler,
     NULL,
-    NULL,
+    USBD_HID_RxEP0Handler,
     /* Specific endpoint */
     USBD_HID_DataInHandler,
+#if USBD_SUP_HID_TLM
+    USBD_HID_DataOutHandler,
+#else
     NULL,
+#endif
     NULL,
     NULL,
 };
@@ -85,6 +111,17 @@ USBD_CLASS_T USBD_HID_CLASS =
   @{
   */
 
+/**
+ * @brief   Full speed polling interval in ms
+ */
+static uint8_t hidFsInterval = USBD_HID_FS_INTERVAL;
+
+/**
+ * @brief   Mouse report format of the next configuration, latched in the
+ *          class data at SET_CONFIGURATION
+ */
+static uint8_t hidReportFormat = USBD_HID_FORMAT_BOOT;
+
 /**
  * @brief   HID descriptor
  */
@@ -102,14 +139,14 @@ uint8_t USBD_HIDDesc[USBD_HID_DESC_SIZE] =
     0x01,
     /* bDescriptorType */
     USBD_DESC_HID_REPORT,
-    /* wItemLength */
-    USBD_HID_MOUSE_REPORT_DESC_SIZE & 0xFF, USBD_HID_MOUSE_REPORT_DESC_SIZE >> 8,
+    /* wItemLength: filled from the selected report descriptor */
+    0x00, 0x00,
 };
 
 /**
  * @brief   HID mouse report descriptor
  */
-uint8_t USBD_HIDReportDesc[USBD_HID_MOUSE_REPORT_DESC_SIZE] =
+uint8_t USBD_HIDReportDesc[] =
 {
     0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls)   */
     0x09, 0x02,        /* Usage (Mouse)                        */
@@ -153,6 +190,248 @@ uint8_t USBD_HIDReportDesc[USBD_HID_MOUSE_REPORT_DESC_SIZE] =
     0xC0               /* End Collection                       */
 };
 
+/**
+ * @brief   HID high resolution mouse report descriptor
+ */
+uint8_t USBD_HIDReportDescHiRes[] =
+{
+    0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls)   */
+    0x09, 0x02,        /* Usage (Mouse)                        */
+    0xA1, 0x01,        /* Collection (Application)             */
+
+    0x09, 0x01,        /* Usage (Pointer)                      */
+    0xA1, 0x00,        /* Collection (Physical)                */
+    0x05, 0x09,        /*   Usage Page (Button)                */
+    0x19, 0x01,        /*   Usage Minimum (0x01)               */
+    0x29, 0x03,        /*   Usage Maximum (0x03)               */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x25, 0x01,        /*   Logical Maximum (1)                */
+    0x95, 0x03,        /*   Report Count (3)                   */
+    0x75, 0x01,        /*   Report Size (1)                    */
+    0x81, 0x02,        /*   Input (Data,Var,Abs)               */
+    0x95, 0x01,        /*   Report Count (1)                   */
+    0x75, 0x05,        /*   Report Size (5)                    */
+    0x81, 0x01,        /*   Input (Const,Array,Abs)            */
+    0x05, 0x01,        /*   Usage Page (Generic Desktop Ctrls) */
+    0x09, 0x30,        /*   Usage (X)                          */
+    0x09, 0x31,        /*   Usage (Y)                          */
+    0x16, 0x01, 0x80,  /*   Logical Minimum (-32767)           */
+    0x26, 0xFF, 0x7F,  /*   Logical Maximum (32767)            */
+    0x75, 0x10,        /*   Report Size (16)                   */
+    0x95, 0x02,        /*   Report Count (2)                   */
+    0x81, 0x06,        /*   Input (Data,Var,Rel)               */
+
+    0xA1, 0x02,        /*   Collection (Logical)               */
+    0x09, 0x48,        /*     Usage (Resolution Multiplier)    */
+    0x15, 0x00,        /*     Logical Minimum (0)              */
+    0x25, 0x01,        /*     Logical Maximum (1)              */
+    0x35, 0x01,        /*     Physical Minimum (1)             */
+    0x45, USBD_HID_WHEEL_RES_MULTIPLIER, /* Physical Maximum   */
+    0x75, 0x02,        /*     Report Size (2)                  */
+    0x95, 0x01,        /*     Report Count (1)                 */
+    0xB1, 0x02,        /*     Feature (Data,Var,Abs)           */
+    0x35, 0x00,        /*     Physical Minimum (0)             */
+    0x45, 0x00,        /*     Physical Maximum (0)             */
+    0x09, 0x38,        /*     Usage (Wheel)                    */
+    0x15, 0x81,        /*     Logical Minimum (-127)           */
+    0x25, 0x7F,        /*     Logical Maximum (127)            */
+    0x75, 0x08,        /*     Report Size (8)                  */
+    0x81, 0x06,        /*     Input (Data,Var,Rel)             */
+    0xC0,              /*   End Collection                     */
+
+    0xA1, 0x02,        /*   Collection (Logical)               */
+    0x09, 0x48,        /*     Usage (Resolution Multiplier)    */
+    0x15, 0x00,        /*     Logical Minimum (0)              */
+    0x25, 0x01,        /*     Logical Maximum (1)              */
+    0x35, 0x01,        /*     Physical Minimum (1)             */
+    0x45, USBD_HID_WHEEL_RES_MULTIPLIER, /* Physical Maximum   */
+    0x75, 0x02,        /*     Report Size (2)                  */
+    0xB1, 0x02,        /*     Feature (Data,Var,Abs)           */
+    0x35, 0x00,        /*     Physical Minimum (0)             */
+    0x45, 0x00,        /*     Physical Maximum (0)             */
+    0x75, 0x04,        /*     Report Size (4)                  */
+    0xB1, 0x01,        /*     Feature (Const,Array,Abs)        */
+    0x05, 0x0C,        /*     Usage Page (Consumer)            */
+    0x0A, 0x38, 0x02,  /*     Usage (AC Pan)                   */
+    0x15, 0x81,        /*     Logical Minimum (-127)           */
+    0x25, 0x7F,        /*     Logical Maximum (127)            */
+    0x75, 0x08,        /*     Report Size (8)                  */
+    0x81, 0x06,        /*     Input (Data,Var,Rel)             */
+    0xC0,              /*   End Collection                     */
+    0xC0,              /* End Collection                       */
+
+    0x05, 0x0D,        /* Usage Page (Digitizer)               */
+    0x09, 0x52,        /* Usage (Device Mode)                  */
+    0x15, 0x00,        /* Logical Minimum (0)                  */
+    0x25, USBD_HID_DEVICE_MODE_SINGLE, /* Logical Maximum      */
+    0x75, 0x08,        /* Report Size (8)                      */
+    0x95, 0x01,        /* Report Count (1)                     */
+    0xB1, 0x02,        /* Feature (Data,Var,Abs)               */
+    0xC0               /* End Collection                       */
+};
+
+/**
+ * @brief   HID absolute digitizer report descriptor
+ */
+uint8_t USBD_HIDReportDescDigitizer[] =
+{
+    0x05, 0x0D,        /* Usage Page (Digitizer)               */
+    0x09, 0x02,        /* Usage (Pen)                          */
+    0xA1, 0x01,        /* Collection (Application)             */
+
+    0x09, 0x20,        /* Usage (Stylus)                       */
+    0xA1, 0x00,        /* Collection (Physical)                */
+    0x09, 0x42,        /*   Usage (Tip Switch)                 */
+    0x09, 0x32,        /*   Usage (In Range)                   */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x25, 0x01,        /*   Logical Maximum (1)                */
+    0x75, 0x01,        /*   Report Size (1)                    */
+    0x95, 0x02,        /*   Report Count (2)                   */
+    0x81, 0x02,        /*   Input (Data,Var,Abs)               */
+    0x95, 0x06,        /*   Report Count (6)                   */
+    0x81, 0x01,        /*   Input (Const,Array,Abs)            */
+    0x05, 0x01,        /*   Usage Page (Generic Desktop Ctrls) */
+    0x09, 0x30,        /*   Usage (X)                          */
+    0x09, 0x31,        /*   Usage (Y)                          */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x26, 0xFF, 0x7F,  /*   Logical Maximum (32767)            */
+    0x75, 0x10,        /*   Report Size (16)                   */
+    0x95, 0x02,        /*   Report Count (2)                   */
+    0x81, 0x02,        /*   Input (Data,Var,Abs)               */
+    0xC0,              /* End Collection                       */
+
+    0x05, 0x0D,        /* Usage Page (Digitizer)               */
+    0x09, 0x52,        /* Usage (Device Mode)                  */
+    0x15, 0x00,        /* Logical Minimum (0)                  */
+    0x25, USBD_HID_DEVICE_MODE_SINGLE, /* Logical Maximum      */
+    0x75, 0x08,        /* Report Size (8)                      */
+    0x95, 0x01,        /* Report Count (1)                     */
+    0xB1, 0x02,        /* Feature (Data,Var,Abs)               */
+    0xC0               /* End Collection                       */
+};
+
+/**
+ * @brief   HID composite mouse, keyboard and consumer control report descriptor
+ */
+uint8_t USBD_HIDReportDescComposite[] =
+{
+    0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls)   */
+    0x09, 0x02,        /* Usage (Mouse)                        */
+    0xA1, 0x01,        /* Collection (Application)             */
+    0x85, USBD_HID_REPORT_ID_MOUSE, /* Report ID               */
+    0x09, 0x01,        /*   Usage (Pointer)                    */
+    0xA1, 0x00,        /*   Collection (Physical)              */
+    0x05, 0x09,        /*     Usage Page (Button)              */
+    0x19, 0x01,        /*     Usage Minimum (0x01)             */
+    0x29, 0x03,        /*     Usage Maximum (0x03)             */
+    0x15, 0x00,        /*     Logical Minimum (0)              */
+    0x25, 0x01,        /*     Logical Maximum (1)              */
+    0x95, 0x03,        /*     Report Count (3)                 */
+    0x75, 0x01,        /*     Report Size (1)                  */
+    0x81, 0x02,        /*     Input (Data,Var,Abs)             */
+    0x95, 0x01,        /*     Report Count (1)                 */
+    0x75, 0x05,        /*     Report Size (5)                  */
+    0x81, 0x01,        /*     Input (Const,Array,Abs)          */
+    0x05, 0x01,        /*     Usage Page (Generic Desktop)     */
+    0x09, 0x30,        /*     Usage (X)                        */
+    0x09, 0x31,        /*     Usage (Y)                        */
+    0x16, 0x01, 0x80,  /*     Logical Minimum (-32767)         */
+    0x26, 0xFF, 0x7F,  /*     Logical Maximum (32767)          */
+    0x75, 0x10,        /*     Report Size (16)                 */
+    0x95, 0x02,        /*     Report Count (2)                 */
+    0x81, 0x06,        /*     Input (Data,Var,Rel)             */
+    0x09, 0x38,        /*     Usage (Wheel)                    */
+    0x15, 0x81,        /*     Logical Minimum (-127)           */
+    0x25, 0x7F,        /*     Logical Maximum (127)            */
+    0x75, 0x08,        /*     Report Size (8)                  */
+    0x95, 0x01,        /*     Report Count (1)                 */
+    0x81, 0x06,        /*     Input (Data,Var,Rel)             */
+    0xC0,              /*   End Collection                     */
+    0xC0,              /* End Collection                       */
+
+    0x05, 0x01,        /* Usage Page (Generic Desktop Ctrls)   */
+    0x09, 0x06,        /* Usage (Keyboard)                     */
+    0xA1, 0x01,        /* Collection (Application)             */
+    0x85, USBD_HID_REPORT_ID_KEYBOARD, /* Report ID            */
+    0x05, 0x07,        /*   Usage Page (Kbrd/Keypad)           */
+    0x19, 0xE0,        /*   Usage Minimum (0xE0)               */
+    0x29, 0xE7,        /*   Usage Maximum (0xE7)               */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x25, 0x01,        /*   Logical Maximum (1)                */
+    0x75, 0x01,        /*   Report Size (1)                    */
+    0x95, 0x08,        /*   Report Count (8)                   */
+    0x81, 0x02,        /*   Input (Data,Var,Abs)               */
+    0x95, 0x01,        /*   Report Count (1)                   */
+    0x75, 0x08,        /*   Report Size (8)                    */
+    0x81, 0x01,        /*   Input (Const,Array,Abs)            */
+    0x95, 0x06,        /*   Report Count (6)                   */
+    0x75, 0x08,        /*   Report Size (8)                    */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x25, 0x65,        /*   Logical Maximum (101)              */
+    0x19, 0x00,        /*   Usage Minimum (0x00)               */
+    0x29, 0x65,        /*   Usage Maximum (0x65)               */
+    0x81, 0x00,        /*   Input (Data,Array,Abs)             */
+    0xC0,              /* End Collection                       */
+
+    0x05, 0x0C,        /* Usage Page (Consumer)                */
+    0x09, 0x01,        /* Usage (Consumer Control)             */
+    0xA1, 0x01,        /* Collection (Application)             */
+    0x85, USBD_HID_REPORT_ID_CONSUMER, /* Report ID            */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x26, 0xFF, 0x03,  /*   Logical Maximum (1023)             */
+    0x19, 0x00,        /*   Usage Minimum (0x00)               */
+    0x2A, 0xFF, 0x03,  /*   Usage Maximum (0x3FF)              */
+    0x75, 0x10,        /*   Report Size (16)                   */
+    0x95, 0x01,        /*   Report Count (1)                   */
+    0x81, 0x00,        /*   Input (Data,Array,Abs)             */
+    0xC0               /* End Collection                       */
+};
+
+#if USBD_SUP_HID_TLM
+/**
+ * @brief   HID descriptor of the telemetry interface
+ */
+uint8_t USBD_HIDTlmDesc[USBD_HID_DESC_SIZE] =
+{
+    /* bLength */
+    0x09,
+    /* bDescriptorType: HID */
+    USBD_DESC_HID,
+    /* bcdHID */
+    0x11, 0x01,
+    /* bCountryCode */
+    0x00,
+    /* bNumDescriptors */
+    0x01,
+    /* bDescriptorType */
+    USBD_DESC_HID_REPORT,
+    /* wItemLength */
+    USBD_HID_TLM_REPORT_DESC_SIZE & 0xFF,
+    USBD_HID_TLM_REPORT_DESC_SIZE >> 8,
+};
+
+/**
+ * @brief   HID vendor defined telemetry report descriptor
+ */
+uint8_t USBD_HIDTlmReportDesc[USBD_HID_TLM_REPORT_DESC_SIZE] =
+{
+    0x06, 0x00, 0xFF,  /* Usage Page (Vendor Defined 0xFF00)   */
+    0x09, 0x01,        /* Usage (0x01)                         */
+    0xA1, 0x01,        /* Collection (Application)             */
+    0x09, 0x02,        /*   Usage (0x02)                       */
+    0x15, 0x00,        /*   Logical Minimum (0)                */
+    0x26, 0xFF, 0x00,  /*   Logical Maximum (255)              */
+    0x75, 0x08,        /*   Report Size (8)                    */
+    0x95, USBD_HID_TLM_EP_SIZE, /* Report Count                */
+    0x81, 0x02,        /*   Input (Data,Var,Abs)               */
+    0x09, 0x03,        /*   Usage (0x03)                       */
+    0x91, 0x02,        /*   Output (Data,Var,Abs)              */
+    0x09, 0x04,        /*   Usage (0x04)                       */
+    0xB1, 0x02,        /*   Feature (Data,Var,Abs)             */
+    0xC0               /* End Collection                       */
+};
+#endif
+
 /**@} end of group USBD_HID_Variables*/
 
 /** @defgroup USBD_HID_Functions Functions
@@ -187,11 +466,11 @@ static USBD_STA_T USBD_HID_ClassInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgInd
         return USBD_FAIL;
     }
 
-    usbDevHID->epInAddr = USBD_HID_IN_EP_ADDR;
+    usbDevHID->epInAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_HID_IN_EP_ADDR);
 
     if (usbInfo->devSpeed == USBD_SPEED_FS)
     {
-        usbInfo->devEpIn[usbDevHID->epInAddr & 0x0F].interval = USBD_HID_FS_INTERVAL;
+        usbInfo->devEpIn[usbDevHID->epInAddr & 0x0F].interval = hidFsInterval;
     }
     else
     {
@@ -202,7 +481,26 @@ static USBD_STA_T USBD_HID_ClassInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgInd
     USBD_EP_OpenCallback(usbInfo, usbDevHID->epInAddr, EP_TYPE_INTERRUPT, USBD_HID_IN_EP_SIZE);
     usbInfo->devEpIn[usbDevHID->epInAddr & 0x0F].useStatus = ENABLE;
 
+#if USBD_SUP_HID_TLM
+    /* Telemetry stream and command endpoints */
+    usbDevHID->tlmInAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_HID_TLM_IN_EP_ADDR);
+    usbDevHID->tlmOutAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_HID_TLM_OUT_EP_ADDR);
+
+    usbInfo->devEpIn[usbDevHID->tlmInAddr & 0x0F].interval = USBD_HID_TLM_FS_INTERVAL;
+    USBD_EP_OpenCallback(usbInfo, usbDevHID->tlmInAddr, EP_TYPE_INTERRUPT, USBD_HID_TLM_EP_SIZE);
+    usbInfo->devEpIn[usbDevHID->tlmInAddr & 0x0F].useStatus = ENABLE;
+
+    USBD_EP_OpenCallback(usbInfo, usbDevHID->tlmOutAddr, EP_TYPE_INTERRUPT, USBD_HID_TLM_EP_SIZE);
+    usbInfo->devEpOut[usbDevHID->tlmOutAddr & 0x0F].useStatus = ENABLE;
+
+    usbDevHID->tlmState = USBD_HID_IDLE;
+
+    USBD_EP_ReceiveCallback(usbInfo, usbDevHID->tlmOutAddr, usbDevHID->tlmRxBuffer, USBD_HID_TLM_EP_SIZE);
+#endif
+
     usbDevHID->state = USBD_HID_IDLE;
+    usbDevHID->reportFormat = hidReportFormat;
+    usbDevHID->protocol = USBD_HID_PROTOCOL_REPORT;
 
     return usbStatus;
 }
@@ -221,11 +519,26 @@ static USBD_STA_T USBD_HID_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgI
     USBD_STA_T usbStatus = USBD_OK;
     USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
 
+    /* Not configured */
+    if (usbDevHID == NULL)
+    {
+        return usbStatus;
+    }
+
     /* Close HID EP */
     USBD_EP_CloseCallback(usbInfo, usbDevHID->epInAddr);
     usbInfo->devEpIn[usbDevHID->epInAddr & 0x0F].interval = 0;
     usbInfo->devEpIn[usbDevHID->epInAddr & 0x0F].useStatus = DISABLE;
 
+#if USBD_SUP_HID_TLM
+    USBD_EP_CloseCallback(usbInfo, usbDevHID->tlmInAddr);
+    usbInfo->devEpIn[usbDevHID->tlmInAddr & 0x0F].interval = 0;
+    usbInfo->devEpIn[usbDevHID->tlmInAddr & 0x0F].useStatus = DISABLE;
+
+    USBD_EP_CloseCallback(usbInfo, usbDevHID->tlmOutAddr);
+    usbInfo->devEpOut[usbDevHID->tlmOutAddr & 0x0F].useStatus = DISABLE;
+#endif
+
     if (usbInfo->devClass[usbInfo->classID]->classData != NULL)
     {
         free(usbInfo->devClass[usbInfo->classID]->classData);
@@ -245,6 +558,42 @@ static USBD_STA_T USBD_HID_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgI
 static USBD_STA_T USBD_HID_SOFHandler(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T  usbStatus = USBD_BUSY;
+    USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    uint8_t kind;
+
+    if (usbDevHID == NULL)
+    {
+        return USBD_FAIL;
+    }
+
+    /* Time since the last report of each kind for the idle rate */
+    for (kind = 0; kind < USBD_HID_KIND_NUM; kind++)
+    {
+        if (usbDevHID->idleCnt[kind] < 0xFFFF)
+        {
+            usbDevHID->idleCnt[kind]++;
+        }
+    }
+
+    /* Count frames since the last report, saturated at one interval */
+    if (usbDevHID->sofCnt < USBD_HID_ReadInterval(usbInfo))
+    {
+        usbDevHID->sofCnt++;
+    }
+
+    if (usbDevHID->sofCnt < USBD_HID_ReadInterval(usbInfo))
+    {
+        return usbStatus;
+    }
+
+    /* Restart the queue after it ran empty */
+    usbStatus = USBD_HID_TxNext(usbInfo, usbDevHID);
+
+    /* Nothing changed, repeat the current state once the idle rate expires */
+    if (usbStatus == USBD_BUSY)
+    {
+        usbStatus = USBD_HID_TxIdle(usbInfo, usbDevHID);
+    }
 
     return usbStatus;
 }
@@ -269,6 +618,8 @@ static USBD_STA_T USBD_HID_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T*
     uint16_t wValue = req->DATA_FIELD.wValue[0] | req->DATA_FIELD.wValue[1] << 8;
     uint16_t wLength = req->DATA_FIELD.wLength[0] | req->DATA_FIELD.wLength[1] << 8;
     uint16_t status = 0x0000;
+    uint16_t featureLen;
+    uint8_t kind;
 
     if (usbDevHID == NULL)
     {
@@ -289,13 +640,34 @@ static USBD_STA_T USBD_HID_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T*
                     switch (req->DATA_FIELD.wValue[1])
                     {
                         case USBD_DESC_HID_REPORT:
-                            descInfo = USBD_HID_ReportDescHandler(usbInfo->devSpeed);
+#if USBD_SUP_HID_TLM
+                            if (req->DATA_FIELD.wIndex[0] == USBD_ReadClassItf(usbInfo, usbInfo->classID, USBD_HID_TLM_ITF_NUM))
+                            {
+                                descInfo.desc = USBD_HIDTlmReportDesc;
+                                descInfo.size = sizeof(USBD_HIDTlmReportDesc);
+                            }
+                            else
+#endif
+                            {
+                                /* The format latched by the configuration */
+                                descInfo = USBD_HID_ReportDescHandler(usbDevHID->reportFormat);
+                            }
 
                             descInfo.size = descInfo.size < wLength ? descInfo.size : wLength;
                             break;
 
                         case USBD_DESC_HID:
-                            descInfo = USBD_HID_DescHandler(usbInfo->devSpeed);
+#if USBD_SUP_HID_TLM
+                            if (req->DATA_FIELD.wIndex[0] == USBD_ReadClassItf(usbInfo, usbInfo->classID, USBD_HID_TLM_ITF_NUM))
+                            {
+                                descInfo.desc = USBD_HIDTlmDesc;
+                                descInfo.size = sizeof(USBD_HIDTlmDesc);
+                            }
+                            else
+#endif
+                            {
+                                descInfo = USBD_HID_DescHandler(usbDevHID->reportFormat);
+                            }
 
                             descInfo.size = descInfo.size < wLength ? descInfo.size : wLength;
                             break;
@@ -360,24 +732,91 @@ static USBD_STA_T USBD_HID_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T*
             break;
 
         case USBD_REQ_TYPE_CLASS:
+#if USBD_SUP_HID_TLM
+            if (req->DATA_FIELD.wIndex[0] == USBD_ReadClassItf(usbInfo, usbInfo->classID, USBD_HID_TLM_ITF_NUM))
+            {
+                usbStatus = USBD_HID_TlmClassReqHandler(usbInfo, req);
+                break;
+            }
+#endif
             switch (request)
             {
                 case USBD_CLASS_SET_IDLE:
-                    usbDevHID->idleStatus = req->DATA_FIELD.wValue[1];
+                    /* Report ID 0 sets the rate of all reports */
+                    for (kind = 0; kind < USBD_HID_KIND_NUM; kind++)
+                    {
+                        if ((req->DATA_FIELD.wValue[0] == 0) || \
+                            (req->DATA_FIELD.wValue[0] == USBD_HID_KindReportID(usbDevHID, kind)))
+                        {
+                            usbDevHID->idleRate[kind] = req->DATA_FIELD.wValue[1];
+                            usbDevHID->idleCnt[kind] = 0;
+                        }
+                    }
                     break;
 
                 case USBD_CLASS_GET_IDLE:
-                    USBD_CtrlSendData(usbInfo, (uint8_t*)&usbDevHID->idleStatus, 1);
+                    kind = USBD_HID_KIND_MOUSE;
+                    while ((kind < USBD_HID_KIND_NUM - 1) && (req->DATA_FIELD.wValue[0] != 0) && \
+                           (req->DATA_FIELD.wValue[0] != USBD_HID_KindReportID(usbDevHID, kind)))
+                    {
+                        kind++;
+                    }
+
+                    USBD_CtrlSendData(usbInfo, &usbDevHID->idleRate[kind], 1);
                     break;
 
                 case USBD_CLASS_SET_PROTOCOL:
-                    usbDevHID->protocol = req->DATA_FIELD.wValue[0];
+                    /* Boot protocol reports carry no report ID */
+                    usbDevHID->protocol = req->DATA_FIELD.wValue[0] ? \
+                                          USBD_HID_PROTOCOL_REPORT : USBD_HID_PROTOCOL_BOOT;
                     break;
 
                 case USBD_CLASS_GET_PROTOCOL:
                     USBD_CtrlSendData(usbInfo, (uint8_t*)&usbDevHID->protocol, 1);
                     break;
 
+                case USBD_CLASS_GET_REPORT:
+                    featureLen = USBD_HID_FeatureLength(usbDevHID);
+
+                    if ((req->DATA_FIELD.wValue[1] == USBD_HID_REPORT_TYPE_FEATURE) && (featureLen != 0))
+                    {
+                        /* Device mode of the next configuration */
+                        if (usbDevHID->reportFormat == USBD_HID_FORMAT_HIRES)
+                        {
+                            usbDevHID->feature[0] = usbDevHID->resMultiplier;
+                            usbDevHID->feature[1] = USBD_HID_ReadDeviceMode(hidReportFormat);
+                        }
+                        else
+                        {
+                            usbDevHID->feature[0] = USBD_HID_ReadDeviceMode(hidReportFormat);
+                        }
+
+                        featureLen = featureLen < wLength ? featureLen : wLength;
+                        USBD_CtrlSendData(usbInfo, usbDevHID->feature, featureLen);
+                    }
+                    else
+                    {
+                        USBD_REQ_CtrlError(usbInfo, req);
+                        usbStatus = USBD_FAIL;
+                    }
+                    break;
+
+                case USBD_CLASS_SET_REPORT:
+                    featureLen = USBD_HID_FeatureLength(usbDevHID);
+
+                    if ((req->DATA_FIELD.wValue[1] == USBD_HID_REPORT_TYPE_FEATURE) && \
+                        (featureLen != 0) && (wLength == featureLen))
+                    {
+                        /* Applied by the EP0 OUT handler */
+                        USBD_HID_CtrlReceiveData(usbInfo, usbDevHID->feature, featureLen);
+                    }
+                    else
+                    {
+                        USBD_REQ_CtrlError(usbInfo, req);
+                        usbStatus = USBD_FAIL;
+                    }
+                    break;
+
                 default:
                     USBD_REQ_CtrlError(usbInfo, req);
                     usbStatus = USBD_FAIL;
@@ -386,6 +825,13 @@ static USBD_STA_T USBD_HID_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T*
             break;
 
         case USBD_REQ_TYPE_VENDOR:
+#if USBD_SUP_HID_TLM
+            if (req->DATA_FIELD.wIndex[0] == USBD_ReadClassItf(usbInfo, usbInfo->classID, USBD_HID_TLM_ITF_NUM))
+            {
+                usbStatus = USBD_HID_TlmVendorReqHandler(usbInfo, req);
+                break;
+            }
+#endif
             USBD_REQ_CtrlError(usbInfo, req);
             usbStatus = USBD_FAIL;
             break;
@@ -417,78 +863,126 @@ static USBD_STA_T USBD_HID_DataInHandler(USBD_INFO_T* usbInfo, uint8_t epNum)
     {
         return USBD_FAIL;
     }
-    
+
+#if USBD_SUP_HID_TLM
+    if (epNum == (usbDevHID->tlmInAddr & 0x0F))
+    {
+        usbDevHID->tlmState = USBD_HID_IDLE;
+        return usbStatus;
+    }
+#endif
+
     usbDevHID->state = USBD_HID_IDLE;
+    usbDevHID->txCnt++;
+
+    /* Chain the next queued report, it is sent on the next host poll */
+    USBD_HID_TxNext(usbInfo, usbDevHID);
 
     return usbStatus;
 }
 
+#if USBD_SUP_HID_TLM
 /*!
- * @brief     USB device HID report descriptor
+ * @brief       USB device HID OUT data handler
+ *
+ * @param       usbInfo: usb device information
  *
- * @param     usbSpeed : usb speed
+ * @param       epNum: endpoint number
  *
- * @retval    usb descriptor information
+ * @retval      USB device operation status
  */
-static USBD_DESC_INFO_T USBD_HID_ReportDescHandler(uint8_t usbSpeed)
+static USBD_STA_T USBD_HID_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum)
 {
-    USBD_DESC_INFO_T descInfo;
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_HID_TLM_INTERFACE_T* itf = (USBD_HID_TLM_INTERFACE_T*)usbInfo->devClassUserData[usbInfo->classID];
+    uint8_t length;
+
+    if (usbDevHID == NULL)
+    {
+        return USBD_FAIL;
+    }
 
-    descInfo.desc = USBD_HIDReportDesc;
-    descInfo.size = sizeof(USBD_HIDReportDesc);
+    if (epNum != (usbDevHID->tlmOutAddr & 0x0F))
+    {
+        return usbStatus;
+    }
 
-    return descInfo;
-}
+    length = (uint8_t)USBD_EP_ReadRxDataLenCallback(usbInfo, epNum);
 
-/*!
- * @brief     USB device HID descriptor
- *
- * @param     usbSpeed : usb speed
- *
- * @retval    usb descriptor information
- */
-static USBD_DESC_INFO_T USBD_HID_DescHandler(uint8_t usbSpeed)
-{
-    USBD_DESC_INFO_T descInfo;
+    if ((itf != NULL) && (itf->ItfReceive != NULL))
+    {
+        itf->ItfReceive(usbDevHID->tlmRxBuffer, length);
+    }
 
-    descInfo.desc = USBD_HIDDesc;
-    descInfo.size = sizeof(USBD_HIDDesc);
+    /* Ready for the next command */
+    USBD_EP_ReceiveCallback(usbInfo, usbDevHID->tlmOutAddr, usbDevHID->tlmRxBuffer, USBD_HID_TLM_EP_SIZE);
 
-    return descInfo;
+    return usbStatus;
 }
 
 /*!
- * @brief     USB device HID send report descriptor
- *
- * @param     usbInfo: usb device information
+ * @brief       USB device HID telemetry interface class request handler
  *
- * @param     report: report buffer
+ * @param       usbInfo: usb device information
  *
- * @param     length: report data length
+ * @param       req: setup request
  *
- * @retval    usb descriptor information
+ * @retval      USB device operation status
  */
-USBD_STA_T USBD_HID_TxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t length)
+static USBD_STA_T USBD_HID_TlmClassReqHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
 {
     USBD_STA_T  usbStatus = USBD_OK;
     USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_HID_TLM_INTERFACE_T* itf = (USBD_HID_TLM_INTERFACE_T*)usbInfo->devClassUserData[usbInfo->classID];
+    uint16_t wLength = req->DATA_FIELD.wLength[0] | req->DATA_FIELD.wLength[1] << 8;
 
-    if (usbDevHID == NULL)
+    switch (req->DATA_FIELD.bRequest)
     {
-        return USBD_FAIL;
-    }
+        case USBD_CLASS_SET_IDLE:
+            usbDevHID->tlmIdleStatus = req->DATA_FIELD.wValue[1];
+            break;
 
-    switch (usbInfo->devState)
-    {
-        case USBD_DEV_CONFIGURE:
-            if (usbDevHID->state == USBD_HID_IDLE)
+        case USBD_CLASS_GET_IDLE:
+            USBD_CtrlSendData(usbInfo, (uint8_t*)&usbDevHID->tlmIdleStatus, 1);
+            break;
+
+        case USBD_CLASS_GET_REPORT:
+            if ((req->DATA_FIELD.wValue[1] == USBD_HID_REPORT_TYPE_FEATURE) && \
+                (itf != NULL) && (itf->ItfGetFeature != NULL))
             {
-                usbDevHID->state = USBD_HID_BUSY;
-                USBD_EP_TransferCallback(usbInfo, usbDevHID->epInAddr, report, length);
+                memset(usbDevHID->tlmFeature, 0, USBD_HID_TLM_EP_SIZE);
+                itf->ItfGetFeature(usbDevHID->tlmFeature, USBD_HID_TLM_EP_SIZE);
+
+                wLength = wLength < USBD_HID_TLM_EP_SIZE ? wLength : USBD_HID_TLM_EP_SIZE;
+                USBD_CtrlSendData(usbInfo, usbDevHID->tlmFeature, wLength);
+            }
+            else
+            {
+                USBD_REQ_CtrlError(usbInfo, req);
+                usbStatus = USBD_FAIL;
+            }
+            break;
+
+        case USBD_CLASS_SET_REPORT:
+            if ((req->DATA_FIELD.wValue[1] == USBD_HID_REPORT_TYPE_FEATURE) && \
+                (itf != NULL) && (itf->ItfSetFeature != NULL) && \
+                (wLength != 0) && (wLength <= USBD_HID_TLM_EP_SIZE))
+            {
+                /* Handed to the interface by the EP0 OUT handler */
+                usbDevHID->tlmFeatureLen = (uint8_t)wLength;
+                USBD_HID_CtrlReceiveData(usbInfo, usbDevHID->tlmFeature, wLength);
+            }
+            else
+            {
+                USBD_REQ_CtrlError(usbInfo, req);
+                usbStatus = USBD_FAIL;
             }
             break;
 
         default:
+            USBD_REQ_CtrlError(usbInfo, req);
+            usbStatus = USBD_FAIL;
             break;
     }
 
@@ -496,19 +990,1215 @@ USBD_STA_T USBD_HID_TxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t len
 }
 
 /*!
- * @brief     USB device HID read interval
+ * @brief       USB device HID telemetry interface vendor request handler.
+ *              IN requests are answered with up to USBD_HID_TLM_EP_SIZE
+ *              bytes, OUT requests carry no data.
  *
- * @param     usbInfo: usb device information
+ * @param       usbInfo: usb device information
  *
- * @retval    usb interval
+ * @param       req: setup request
+ *
+ * @retval      USB device operation status
  */
-uint8_t USBD_HID_ReadInterval(USBD_INFO_T* usbInfo)
+static USBD_STA_T USBD_HID_TlmVendorReqHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
+{
+    USBD_STA_T  usbStatus = USBD_FAIL;
+    USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_HID_TLM_INTERFACE_T* itf = (USBD_HID_TLM_INTERFACE_T*)usbInfo->devClassUserData[usbInfo->classID];
+    uint16_t wValue = req->DATA_FIELD.wValue[0] | req->DATA_FIELD.wValue[1] << 8;
+    uint16_t wLength = req->DATA_FIELD.wLength[0] | req->DATA_FIELD.wLength[1] << 8;
+
+    if ((itf != NULL) && (itf->ItfVendor != NULL))
+    {
+        if (wLength == 0)
+        {
+            /* Status stage is sent by the core */
+            usbStatus = itf->ItfVendor(req->DATA_FIELD.bRequest, wValue, NULL, 0);
+        }
+        else if (req->DATA_FIELD.bmRequest.REQ_TYPE_B.dir == EP_DIR_IN)
+        {
+            wLength = wLength < USBD_HID_TLM_EP_SIZE ? wLength : USBD_HID_TLM_EP_SIZE;
+
+            memset(usbDevHID->tlmFeature, 0, USBD_HID_TLM_EP_SIZE);
+            usbStatus = itf->ItfVendor(req->DATA_FIELD.bRequest, wValue, usbDevHID->tlmFeature, (uint8_t)wLength);
+            if (usbStatus == USBD_OK)
+            {
+                USBD_CtrlSendData(usbInfo, usbDevHID->tlmFeature, wLength);
+            }
+        }
+    }
+
+    if (usbStatus != USBD_OK)
+    {
+        USBD_REQ_CtrlError(usbInfo, req);
+    }
+
+    return usbStatus;
+}
+#endif
+
+/*!
+ * @brief     USB HID device receive CTRL data
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     buffer : data buffer
+ *
+ * @param     length : length of data
+ *
+ * @retval    usb device status
+ */
+static USBD_STA_T USBD_HID_CtrlReceiveData(USBD_INFO_T* usbInfo, uint8_t* buffer, uint32_t length)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+
+    usbInfo->devEp0State = USBD_DEV_EP0_DATA_OUT;
+    usbInfo->devEpOut[USBD_EP_0].length = length;
+    usbInfo->devEpOut[USBD_EP_0].remainLen = length;
+
+    USBD_EP_ReceiveCallback(usbInfo, USBD_EP_0, buffer, length);
+
+    return usbStatus;
+}
+
+/*!
+ * @brief       USB device HID EP0 OUT data handler
+ *
+ * @param       usbInfo: usb device information
+ *
+ * @retval      USB device operation status
+ */
+static USBD_STA_T USBD_HID_RxEP0Handler(USBD_INFO_T* usbInfo)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = (USBD_HID_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+#if USBD_SUP_HID_TLM
+    USBD_HID_TLM_INTERFACE_T* itf;
+#endif
+    uint16_t featureLen;
+    uint8_t mode;
+    uint8_t format;
+
+    if (usbDevHID == NULL)
+    {
+        return USBD_FAIL;
+    }
+
+#if USBD_SUP_HID_TLM
+    /* Feature report of the telemetry interface, a block the
+       application rejects stalls the status stage */
+    if (usbDevHID->tlmFeatureLen != 0)
+    {
+        itf = (USBD_HID_TLM_INTERFACE_T*)usbInfo->devClassUserData[usbInfo->classID];
+        usbStatus = itf->ItfSetFeature(usbDevHID->tlmFeature, usbDevHID->tlmFeatureLen);
+        usbDevHID->tlmFeatureLen = 0;
+
+        return usbStatus;
+    }
+#endif
+
+    /* SET_REPORT(Feature) of the mouse interface, the device mode is
+       its last byte */
+    featureLen = USBD_HID_FeatureLength(usbDevHID);
+
+    if (featureLen == 0)
+    {
+        return USBD_FAIL;
+    }
+
+    mode = usbDevHID->feature[featureLen - 1];
+
+    /* A new device mode is served at the next enumeration, the
+       application re-enumerates when USBD_HID_ReadFormatChange is set */
+    switch (mode)
+    {
+        case USBD_HID_DEVICE_MODE_MOUSE:
+            format = USBD_HID_FORMAT_HIRES;
+            break;
+
+        case USBD_HID_DEVICE_MODE_SINGLE:
+            format = USBD_HID_FORMAT_DIGITIZER;
+            break;
+
+        /* No multi-input collection, the status stage is stalled */
+        default:
+            return USBD_FAIL;
+    }
+
+    if (usbDevHID->reportFormat == USBD_HID_FORMAT_HIRES)
+    {
+        usbDevHID->resMultiplier = usbDevHID->feature[0];
+    }
+
+    hidReportFormat = format;
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID device mode of a report format
+ *
+ * @param     format: USBD_HID_FORMAT_T value
+ *
+ * @retval    device mode, the digitizer is a single-input device and
+ *            the other formats report as a mouse
+ */
+static uint8_t USBD_HID_ReadDeviceMode(uint8_t format)
+{
+    if (format == USBD_HID_FORMAT_DIGITIZER)
+    {
+        return USBD_HID_DEVICE_MODE_SINGLE;
+    }
+
+    return USBD_HID_DEVICE_MODE_MOUSE;
+}
+
+/*!
+ * @brief     USB device HID feature report length of the parsed format
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @retval    feature report length, 0 if the format has none
+ */
+static uint16_t USBD_HID_FeatureLength(USBD_HID_INFO_T* usbDevHID)
+{
+    uint16_t length;
+
+    switch (usbDevHID->reportFormat)
+    {
+        case USBD_HID_FORMAT_HIRES:
+            length = 2;
+            break;
+
+        case USBD_HID_FORMAT_DIGITIZER:
+            length = 1;
+            break;
+
+        default:
+            length = 0;
+            break;
+    }
+
+    return length;
+}
+
+/*!
+ * @brief     USB device HID report descriptor
+ *
+ * @param     format : USBD_HID_FORMAT_T value
+ *
+ * @retval    usb descriptor information
+ */
+static USBD_DESC_INFO_T USBD_HID_ReportDescHandler(uint8_t format)
+{
+    USBD_DESC_INFO_T descInfo;
+
+    switch (format)
+    {
+        case USBD_HID_FORMAT_HIRES:
+            descInfo.desc = USBD_HIDReportDescHiRes;
+            descInfo.size = sizeof(USBD_HIDReportDescHiRes);
+            break;
+
+        case USBD_HID_FORMAT_DIGITIZER:
+            descInfo.desc = USBD_HIDReportDescDigitizer;
+            descInfo.size = sizeof(USBD_HIDReportDescDigitizer);
+            break;
+
+        case USBD_HID_FORMAT_COMPOSITE:
+            descInfo.desc = USBD_HIDReportDescComposite;
+            descInfo.size = sizeof(USBD_HIDReportDescComposite);
+            break;
+
+        default:
+            descInfo.desc = USBD_HIDReportDesc;
+            descInfo.size = sizeof(USBD_HIDReportDesc);
+            break;
+    }
+
+    return descInfo;
+}
+
+/*!
+ * @brief     USB device HID descriptor
+ *
+ * @param     format : USBD_HID_FORMAT_T value of the report descriptor
+ *
+ * @retval    usb descriptor information
+ */
+static USBD_DESC_INFO_T USBD_HID_DescHandler(uint8_t format)
+{
+    USBD_DESC_INFO_T descInfo;
+    uint16_t reportDescSize = USBD_HID_ReportDescHandler(format).size;
+
+    USBD_HIDDesc[7] = reportDescSize & 0xFF;
+    USBD_HIDDesc[8] = reportDescSize >> 8;
+
+    descInfo.desc = USBD_HIDDesc;
+    descInfo.size = sizeof(USBD_HIDDesc);
+
+    return descInfo;
+}
+
+/*!
+ * @brief     USB device HID send report descriptor
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     report: report buffer
+ *
+ * @param     length: report data length
+ *
+ * @retval    usb descriptor information
+ */
+USBD_STA_T USBD_HID_TxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t length)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if (usbDevHID == NULL)
+    {
+        return USBD_FAIL;
+    }
+
+    switch (usbInfo->devState)
+    {
+        case USBD_DEV_CONFIGURE:
+            if (usbDevHID->state == USBD_HID_IDLE)
+            {
+                usbDevHID->state = USBD_HID_BUSY;
+                USBD_EP_TransferCallback(usbInfo, usbDevHID->epInAddr, report, length);
+            }
+            else
+            {
+                usbStatus = USBD_BUSY;
+            }
+            break;
+
+        default:
+            usbStatus = USBD_FAIL;
+            break;
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     Take one report's worth of motion from an axis accumulator
+ *
+ * @param     acc: axis accumulator, the taken part is subtracted from it
+ *
+ * @param     max: largest magnitude the report field can hold
+ *
+ * @retval    axis value clamped to the report range
+ */
+static int16_t USBD_HID_TakeAxis(int16_t* acc, int16_t max)
+{
+    int16_t value = *acc;
+
+    if (value > max)
+    {
+        value = max;
+    }
+    else if (value < -max)
+    {
+        value = -max;
+    }
+
+    *acc -= value;
+
+    return value;
+}
+
+/*!
+ * @brief     Take whole wheel detents from a high resolution accumulator
+ *
+ * @param     acc: accumulator in 1/USBD_HID_WHEEL_RES_MULTIPLIER detents
+ *
+ * @retval    wheel detents clamped to the report range
+ */
+static int8_t USBD_HID_TakeDetents(int16_t* acc)
+{
+    int16_t detents = *acc / USBD_HID_WHEEL_RES_MULTIPLIER;
+
+    detents = USBD_HID_TakeAxis(&detents, USBD_HID_MOUSE_AXIS_MAX);
+    *acc -= detents * USBD_HID_WHEEL_RES_MULTIPLIER;
+
+    return (int8_t)detents;
+}
+
+/*!
+ * @brief     Build the mouse report for the format the host has parsed
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @param     event: queued event to report
+ *
+ * @retval    report length
+ */
+static uint16_t USBD_HID_MouseBuildReport(USBD_HID_INFO_T* usbDevHID, USBD_HID_MOUSE_EVENT_T* event)
+{
+    int16_t value;
+    int8_t wheel;
+    int8_t pan;
+    uint8_t format = usbDevHID->reportFormat;
+
+    usbDevHID->report[0] = event->buttons;
+
+    /* Boot protocol uses the boot mouse layout of every format, an
+       absolute position has no boot equivalent and only the tip is kept */
+    if (usbDevHID->protocol == USBD_HID_PROTOCOL_BOOT)
+    {
+        if (format == USBD_HID_FORMAT_DIGITIZER)
+        {
+            usbDevHID->report[0] = event->buttons & USBD_HID_DIGITIZER_TIP;
+            event->x = 0;
+            event->y = 0;
+        }
+
+        format = USBD_HID_FORMAT_BOOT;
+    }
+
+    /* Absolute position, the event is consumed in one report */
+    if (format == USBD_HID_FORMAT_DIGITIZER)
+    {
+        usbDevHID->report[1] = (uint8_t)event->x;
+        usbDevHID->report[2] = (uint8_t)(event->x >> 8);
+        usbDevHID->report[3] = (uint8_t)event->y;
+        usbDevHID->report[4] = (uint8_t)(event->y >> 8);
+        event->x = 0;
+        event->y = 0;
+
+        return USBD_HID_DIGITIZER_REPORT_SIZE;
+    }
+
+    /* Wheel and pan are high resolution until the host enables the multiplier */
+    if ((usbDevHID->resMultiplier & USBD_HID_RES_MUL_WHEEL) && (format != USBD_HID_FORMAT_BOOT))
+    {
+        wheel = (int8_t)USBD_HID_TakeAxis(&usbDevHID->accWheel, USBD_HID_MOUSE_AXIS_MAX);
+    }
+    else
+    {
+        wheel = USBD_HID_TakeDetents(&usbDevHID->accWheel);
+    }
+
+    if (format == USBD_HID_FORMAT_COMPOSITE)
+    {
+        usbDevHID->report[0] = USBD_HID_REPORT_ID_MOUSE;
+        usbDevHID->report[1] = event->buttons;
+        value = USBD_HID_TakeAxis(&event->x, USBD_HID_MOUSE_HIRES_AXIS_MAX);
+        usbDevHID->report[2] = (uint8_t)value;
+        usbDevHID->report[3] = (uint8_t)(value >> 8);
+        value = USBD_HID_TakeAxis(&event->y, USBD_HID_MOUSE_HIRES_AXIS_MAX);
+        usbDevHID->report[4] = (uint8_t)value;
+        usbDevHID->report[5] = (uint8_t)(value >> 8);
+        usbDevHID->report[6] = (uint8_t)wheel;
+
+        /* Pan is not part of the composite mouse */
+        usbDevHID->accPan = 0;
+
+        return USBD_HID_MOUSE_HIRES_REPORT_SIZE;
+    }
+
+    if (format != USBD_HID_FORMAT_HIRES)
+    {
+        usbDevHID->report[1] = (uint8_t)USBD_HID_TakeAxis(&event->x, USBD_HID_MOUSE_AXIS_MAX);
+        usbDevHID->report[2] = (uint8_t)USBD_HID_TakeAxis(&event->y, USBD_HID_MOUSE_AXIS_MAX);
+        usbDevHID->report[3] = (uint8_t)wheel;
+
+        /* No pan in the boot format */
+        usbDevHID->accPan = 0;
+
+        return USBD_HID_MOUSE_REPORT_SIZE;
+    }
+
+    if (usbDevHID->resMultiplier & USBD_HID_RES_MUL_PAN)
+    {
+        pan = (int8_t)USBD_HID_TakeAxis(&usbDevHID->accPan, USBD_HID_MOUSE_AXIS_MAX);
+    }
+    else
+    {
+        pan = USBD_HID_TakeDetents(&usbDevHID->accPan);
+    }
+
+    value = USBD_HID_TakeAxis(&event->x, USBD_HID_MOUSE_HIRES_AXIS_MAX);
+    usbDevHID->report[1] = (uint8_t)value;
+    usbDevHID->report[2] = (uint8_t)(value >> 8);
+    value = USBD_HID_TakeAxis(&event->y, USBD_HID_MOUSE_HIRES_AXIS_MAX);
+    usbDevHID->report[3] = (uint8_t)value;
+    usbDevHID->report[4] = (uint8_t)(value >> 8);
+    usbDevHID->report[5] = (uint8_t)wheel;
+    usbDevHID->report[6] = (uint8_t)pan;
+
+    return USBD_HID_MOUSE_HIRES_REPORT_SIZE;
+}
+
+/*!
+ * @brief     Add motion to an axis accumulator with saturation
+ *
+ * @param     acc: axis accumulator
+ *
+ * @param     delta: motion to add
+ *
+ * @retval    new accumulator value
+ */
+static int16_t USBD_HID_AddAxis(int16_t acc, int16_t delta)
+{
+    int32_t value = (int32_t)acc + delta;
+
+    if (value > INT16_MAX)
+    {
+        value = INT16_MAX;
+    }
+    else if (value < -INT16_MAX)
+    {
+        value = -INT16_MAX;
+    }
+
+    return (int16_t)value;
+}
+
+/*!
+ * @brief     Check if the scroll accumulators hold a reportable step
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @retval    1 if a wheel or pan step is pending, 0 otherwise
+ */
+static uint8_t USBD_HID_MouseScrollPending(USBD_HID_INFO_T* usbDevHID)
+{
+    int16_t step;
+    uint8_t boot = (usbDevHID->protocol == USBD_HID_PROTOCOL_BOOT);
+
+    /* The boot report only carries whole detents */
+    step = ((usbDevHID->resMultiplier & USBD_HID_RES_MUL_WHEEL) && !boot) ? 1 : USBD_HID_WHEEL_RES_MULTIPLIER;
+    if ((usbDevHID->accWheel >= step) || (usbDevHID->accWheel <= -step))
+    {
+        return 1;
+    }
+
+    if ((usbDevHID->reportFormat != USBD_HID_FORMAT_HIRES) || boot)
+    {
+        return 0;
+    }
+
+    step = (usbDevHID->resMultiplier & USBD_HID_RES_MUL_PAN) ? 1 : USBD_HID_WHEEL_RES_MULTIPLIER;
+    if ((usbDevHID->accPan >= step) || (usbDevHID->accPan <= -step))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief     Take the report at the head of the mouse queue
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @retval    report length, 0 if the queue is empty
+ */
+static uint16_t USBD_HID_MouseTakeReport(USBD_HID_INFO_T* usbDevHID)
+{
+    USBD_HID_MOUSE_EVENT_T* event;
+    uint16_t length;
+
+    if (usbDevHID->queueCount == 0)
+    {
+        return 0;
+    }
+
+    event = &usbDevHID->queue[usbDevHID->queueHead];
+
+    length = USBD_HID_MouseBuildReport(usbDevHID, event);
+
+    /* Motion beyond one report's range keeps the event at the head,
+       the last event also stays while whole scroll steps remain */
+    if ((event->x == 0) && (event->y == 0) && \
+        ((usbDevHID->queueCount > 1) || (USBD_HID_MouseScrollPending(usbDevHID) == 0)))
+    {
+        usbDevHID->queueHead = (usbDevHID->queueHead + 1) % USBD_HID_MOUSE_QUEUE_SIZE;
+        usbDevHID->queueCount--;
+    }
+
+    return length;
+}
+
+/*!
+ * @brief     Take the report at the head of the keyboard or consumer queue
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @param     kind: USBD_HID_KIND_KEYBOARD or USBD_HID_KIND_CONSUMER
+ *
+ * @retval    report length, 0 if the queue is empty
+ */
+static uint16_t USBD_HID_KeyTakeReport(USBD_HID_INFO_T* usbDevHID, uint8_t kind)
+{
+    uint16_t length = 0;
+
+    /* The boot mouse interface has no keyboard or consumer report */
+    if (usbDevHID->protocol == USBD_HID_PROTOCOL_BOOT)
+    {
+        usbDevHID->kbdCount = 0;
+        usbDevHID->conCount = 0;
+    }
+
+    if ((kind == USBD_HID_KIND_KEYBOARD) && (usbDevHID->kbdCount != 0))
+    {
+        usbDevHID->report[0] = USBD_HID_REPORT_ID_KEYBOARD;
+        memcpy(&usbDevHID->report[1], usbDevHID->kbdQueue[usbDevHID->kbdHead], USBD_HID_KEYBOARD_REPORT_SIZE);
+
+        usbDevHID->kbdHead = (usbDevHID->kbdHead + 1) % USBD_HID_KEY_QUEUE_SIZE;
+        usbDevHID->kbdCount--;
+        length = USBD_HID_KEYBOARD_REPORT_SIZE + 1;
+    }
+    else if ((kind == USBD_HID_KIND_CONSUMER) && (usbDevHID->conCount != 0))
+    {
+        usbDevHID->report[0] = USBD_HID_REPORT_ID_CONSUMER;
+        usbDevHID->report[1] = (uint8_t)usbDevHID->conQueue[usbDevHID->conHead];
+        usbDevHID->report[2] = (uint8_t)(usbDevHID->conQueue[usbDevHID->conHead] >> 8);
+
+        usbDevHID->conHead = (usbDevHID->conHead + 1) % USBD_HID_KEY_QUEUE_SIZE;
+        usbDevHID->conCount--;
+        length = 3;
+    }
+
+    return length;
+}
+
+/*!
+ * @brief     Send the next queued report.
+ *            The report kinds take turns so none of them blocks the others.
+ *            Called from the SOF and IN endpoint interrupts.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @retval    usb device operation status
+ */
+static USBD_STA_T USBD_HID_TxNext(USBD_INFO_T* usbInfo, USBD_HID_INFO_T* usbDevHID)
+{
+    uint16_t length = 0;
+    uint8_t kind = usbDevHID->lastKind;
+    uint8_t i;
+
+    if (usbDevHID->state != USBD_HID_IDLE)
+    {
+        return USBD_BUSY;
+    }
+
+    for (i = 0; (i < USBD_HID_KIND_NUM) && (length == 0); i++)
+    {
+        kind = (kind + 1) % USBD_HID_KIND_NUM;
+
+        if (kind == USBD_HID_KIND_MOUSE)
+        {
+            length = USBD_HID_MouseTakeReport(usbDevHID);
+        }
+        else
+        {
+            length = USBD_HID_KeyTakeReport(usbDevHID, kind);
+        }
+    }
+
+    if (length == 0)
+    {
+        return USBD_BUSY;
+    }
+
+    usbDevHID->lastKind = kind;
+    usbDevHID->idleCnt[kind] = 0;
+    usbDevHID->sofCnt = 0;
+    usbDevHID->state = USBD_HID_BUSY;
+    USBD_EP_TransferCallback(usbInfo, usbDevHID->epInAddr, usbDevHID->report, length);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief     Check if the device is configured. Reports are still queued
+ *            while a configured device is suspended and are sent after
+ *            the resume.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    1 if configured, 0 otherwise
+ */
+static uint8_t USBD_HID_Configured(USBD_INFO_T* usbInfo)
+{
+    if (usbInfo->devState == USBD_DEV_CONFIGURE)
+    {
+        return 1;
+    }
+
+    if ((usbInfo->devState == USBD_DEV_SUSPEND) && (usbInfo->preDevState == USBD_DEV_CONFIGURE))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+/*!
+ * @brief     HID class data for the functions called by the
+ *            application, which run outside the class callbacks that
+ *            select the class
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    HID class data, NULL if HID is not registered or not
+ *            configured
+ */
+static USBD_HID_INFO_T* USBD_HID_ReadInfo(USBD_INFO_T* usbInfo)
+{
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_HID_CLASS);
+
+    if (classIndex == USBD_CLASS_NONE)
+    {
+        return NULL;
+    }
+
+    return (USBD_HID_INFO_T*)usbInfo->devClass[classIndex]->classData;
+}
+
+/*!
+ * @brief     Report ID of a report kind in the parsed format
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @param     kind: USBD_HID_KIND_T value
+ *
+ * @retval    report ID, 0 if the format has no report IDs
+ */
+static uint8_t USBD_HID_KindReportID(USBD_HID_INFO_T* usbDevHID, uint8_t kind)
+{
+    uint8_t reportID = 0;
+
+    if ((usbDevHID->reportFormat == USBD_HID_FORMAT_COMPOSITE) && \
+        (usbDevHID->protocol == USBD_HID_PROTOCOL_REPORT))
+    {
+        switch (kind)
+        {
+            case USBD_HID_KIND_MOUSE:
+                reportID = USBD_HID_REPORT_ID_MOUSE;
+                break;
+
+            case USBD_HID_KIND_KEYBOARD:
+                reportID = USBD_HID_REPORT_ID_KEYBOARD;
+                break;
+
+            default:
+                reportID = USBD_HID_REPORT_ID_CONSUMER;
+                break;
+        }
+    }
+
+    return reportID;
+}
+
+/*!
+ * @brief     Build a report of the current state of a kind.
+ *            Relative axes are reported as no motion.
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @param     kind: USBD_HID_KIND_T value
+ *
+ * @retval    report length, 0 if the kind is not served
+ */
+static uint16_t USBD_HID_IdleBuildReport(USBD_HID_INFO_T* usbDevHID, uint8_t kind)
+{
+    USBD_HID_MOUSE_EVENT_T event;
+    uint16_t length = 0;
+
+    switch (kind)
+    {
+        case USBD_HID_KIND_MOUSE:
+            event.buttons = usbDevHID->buttons;
+            event.x = 0;
+            event.y = 0;
+
+            if (usbDevHID->reportFormat == USBD_HID_FORMAT_DIGITIZER)
+            {
+                event.x = (int16_t)usbDevHID->digX;
+                event.y = (int16_t)usbDevHID->digY;
+            }
+
+            length = USBD_HID_MouseBuildReport(usbDevHID, &event);
+            break;
+
+        case USBD_HID_KIND_KEYBOARD:
+            if (USBD_HID_KindReportID(usbDevHID, kind) != 0)
+            {
+                usbDevHID->report[0] = USBD_HID_REPORT_ID_KEYBOARD;
+                memcpy(&usbDevHID->report[1], usbDevHID->kbdState, USBD_HID_KEYBOARD_REPORT_SIZE);
+                length = USBD_HID_KEYBOARD_REPORT_SIZE + 1;
+            }
+            break;
+
+        default:
+            if (USBD_HID_KindReportID(usbDevHID, kind) != 0)
+            {
+                usbDevHID->report[0] = USBD_HID_REPORT_ID_CONSUMER;
+                usbDevHID->report[1] = (uint8_t)usbDevHID->conState;
+                usbDevHID->report[2] = (uint8_t)(usbDevHID->conState >> 8);
+                length = 3;
+            }
+            break;
+    }
+
+    return length;
+}
+
+/*!
+ * @brief     Repeat the current state of the first kind whose idle
+ *            rate has expired. An idle rate of 0 never repeats.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     usbDevHID: HID class data
+ *
+ * @retval    usb device operation status
+ */
+static USBD_STA_T USBD_HID_TxIdle(USBD_INFO_T* usbInfo, USBD_HID_INFO_T* usbDevHID)
+{
+    uint16_t length = 0;
+    uint8_t kind;
+
+    if (usbDevHID->state != USBD_HID_IDLE)
+    {
+        return USBD_BUSY;
+    }
+
+    for (kind = 0; kind < USBD_HID_KIND_NUM; kind++)
+    {
+        if ((usbDevHID->idleRate[kind] != 0) && \
+            (usbDevHID->idleCnt[kind] >= usbDevHID->idleRate[kind] * USBD_HID_IDLE_UNIT))
+        {
+            length = USBD_HID_IdleBuildReport(usbDevHID, kind);
+            usbDevHID->idleCnt[kind] = 0;
+
+            if (length != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    if (length == 0)
+    {
+        return USBD_BUSY;
+    }
+
+    usbDevHID->sofCnt = 0;
+    usbDevHID->state = USBD_HID_BUSY;
+    USBD_EP_TransferCallback(usbInfo, usbDevHID->epInAddr, usbDevHID->report, length);
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief     USB device HID add relative motion to the mouse queue.
+ *            The motion is merged into the newest queued event.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     x: X axis motion
+ *
+ * @param     y: Y axis motion
+ *
+ * @param     wheel: wheel motion in detents
+ *
+ * @retval    usb device operation status
+ */
+USBD_STA_T USBD_HID_MouseMove(USBD_INFO_T* usbInfo, int16_t x, int16_t y, int8_t wheel)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+    USBD_HID_MOUSE_EVENT_T* event;
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat == USBD_HID_FORMAT_DIGITIZER))
+    {
+        return USBD_FAIL;
+    }
+
+    if ((x == 0) && (y == 0) && (wheel == 0))
+    {
+        return usbStatus;
+    }
+
+    /* The queue is drained by the SOF and IN endpoint interrupts */
+    __disable_irq();
+
+    if (usbDevHID->queueCount == 0)
+    {
+        event = &usbDevHID->queue[usbDevHID->queueHead];
+        event->buttons = usbDevHID->buttons;
+        event->x = 0;
+        event->y = 0;
+        usbDevHID->queueCount = 1;
+    }
+    else
+    {
+        event = &usbDevHID->queue[(usbDevHID->queueHead + usbDevHID->queueCount - 1) % USBD_HID_MOUSE_QUEUE_SIZE];
+    }
+
+    event->x = USBD_HID_AddAxis(event->x, x);
+    event->y = USBD_HID_AddAxis(event->y, y);
+    usbDevHID->accWheel = USBD_HID_AddAxis(usbDevHID->accWheel, wheel * USBD_HID_WHEEL_RES_MULTIPLIER);
+    usbDevHID->inputCnt++;
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID queue a mouse button change.
+ *            Every change gets its own report and is never merged.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     buttons: button bitmap
+ *
+ * @retval    usb device operation status, USBD_BUSY if the queue is full
+ */
+USBD_STA_T USBD_HID_MouseButton(USBD_INFO_T* usbInfo, uint8_t buttons)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+    USBD_HID_MOUSE_EVENT_T* event;
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat == USBD_HID_FORMAT_DIGITIZER))
+    {
+        return USBD_FAIL;
+    }
+
+    if (usbDevHID->buttons == buttons)
+    {
+        return usbStatus;
+    }
+
+    __disable_irq();
+
+    if (usbDevHID->queueCount >= USBD_HID_MOUSE_QUEUE_SIZE)
+    {
+        usbStatus = USBD_BUSY;
+    }
+    else
+    {
+        event = &usbDevHID->queue[(usbDevHID->queueHead + usbDevHID->queueCount) % USBD_HID_MOUSE_QUEUE_SIZE];
+        event->buttons = buttons;
+        event->x = 0;
+        event->y = 0;
+        usbDevHID->queueCount++;
+        usbDevHID->buttons = buttons;
+        usbDevHID->inputCnt++;
+    }
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID add high resolution wheel and pan motion.
+ *            Whole detents are reported until the host enables the
+ *            resolution multiplier.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     wheel: wheel motion in 1/USBD_HID_WHEEL_RES_MULTIPLIER detents
+ *
+ * @param     pan: AC pan motion in 1/USBD_HID_WHEEL_RES_MULTIPLIER detents
+ *
+ * @retval    usb device operation status
+ */
+USBD_STA_T USBD_HID_MouseScroll(USBD_INFO_T* usbInfo, int16_t wheel, int16_t pan)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+    USBD_HID_MOUSE_EVENT_T* event;
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat == USBD_HID_FORMAT_DIGITIZER))
+    {
+        return USBD_FAIL;
+    }
+
+    __disable_irq();
+
+    usbDevHID->accWheel = USBD_HID_AddAxis(usbDevHID->accWheel, wheel);
+    usbDevHID->accPan = USBD_HID_AddAxis(usbDevHID->accPan, pan);
+
+    /* Scroll rides on the next report, queue one if none is pending */
+    if ((usbDevHID->queueCount == 0) && USBD_HID_MouseScrollPending(usbDevHID))
+    {
+        event = &usbDevHID->queue[usbDevHID->queueHead];
+        event->buttons = usbDevHID->buttons;
+        event->x = 0;
+        event->y = 0;
+        usbDevHID->queueCount = 1;
+    }
+
+    usbDevHID->inputCnt++;
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID queue an absolute digitizer position.
+ *            Position updates merge into the newest queued event, a
+ *            change of the tip or in range flags gets its own report.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     flags: USBD_HID_DIGITIZER_TIP and USBD_HID_DIGITIZER_IN_RANGE
+ *
+ * @param     x: X position (0 .. USBD_HID_DIGITIZER_AXIS_MAX)
+ *
+ * @param     y: Y position (0 .. USBD_HID_DIGITIZER_AXIS_MAX)
+ *
+ * @retval    usb device operation status, USBD_BUSY if the queue is full
+ */
+USBD_STA_T USBD_HID_DigitizerWrite(USBD_INFO_T* usbInfo, uint8_t flags, uint16_t x, uint16_t y)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+    USBD_HID_MOUSE_EVENT_T* event;
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat != USBD_HID_FORMAT_DIGITIZER))
+    {
+        return USBD_FAIL;
+    }
+
+    x = x > USBD_HID_DIGITIZER_AXIS_MAX ? USBD_HID_DIGITIZER_AXIS_MAX : x;
+    y = y > USBD_HID_DIGITIZER_AXIS_MAX ? USBD_HID_DIGITIZER_AXIS_MAX : y;
+
+    if ((usbDevHID->buttons == flags) && (usbDevHID->digX == x) && (usbDevHID->digY == y))
+    {
+        return usbStatus;
+    }
+
+    __disable_irq();
+
+    if ((usbDevHID->buttons == flags) && (usbDevHID->queueCount != 0))
+    {
+        event = &usbDevHID->queue[(usbDevHID->queueHead + usbDevHID->queueCount - 1) % USBD_HID_MOUSE_QUEUE_SIZE];
+    }
+    else if (usbDevHID->queueCount < USBD_HID_MOUSE_QUEUE_SIZE)
+    {
+        event = &usbDevHID->queue[(usbDevHID->queueHead + usbDevHID->queueCount) % USBD_HID_MOUSE_QUEUE_SIZE];
+        event->buttons = flags;
+        usbDevHID->queueCount++;
+    }
+    else
+    {
+        event = NULL;
+        usbStatus = USBD_BUSY;
+    }
+
+    if (event != NULL)
+    {
+        event->x = (int16_t)x;
+        event->y = (int16_t)y;
+        usbDevHID->buttons = flags;
+        usbDevHID->digX = x;
+        usbDevHID->digY = y;
+        usbDevHID->inputCnt++;
+    }
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID queue a keyboard report.
+ *            Every change of the key state gets its own report.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     modifier: modifier key bitmap
+ *
+ * @param     keys: USBD_HID_KEYBOARD_KEYS usage codes, 0 for no key
+ *
+ * @retval    usb device operation status, USBD_BUSY if the queue is full
+ */
+USBD_STA_T USBD_HID_KeyboardWrite(USBD_INFO_T* usbInfo, uint8_t modifier, const uint8_t* keys)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+    uint8_t state[USBD_HID_KEYBOARD_REPORT_SIZE];
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat != USBD_HID_FORMAT_COMPOSITE))
+    {
+        return USBD_FAIL;
+    }
+
+    /* Boot keyboard layout */
+    state[0] = modifier;
+    state[1] = 0;
+    memcpy(&state[2], keys, USBD_HID_KEYBOARD_KEYS);
+
+    if (memcmp(state, usbDevHID->kbdState, USBD_HID_KEYBOARD_REPORT_SIZE) == 0)
+    {
+        return usbStatus;
+    }
+
+    __disable_irq();
+
+    if (usbDevHID->kbdCount >= USBD_HID_KEY_QUEUE_SIZE)
+    {
+        usbStatus = USBD_BUSY;
+    }
+    else
+    {
+        memcpy(usbDevHID->kbdQueue[(usbDevHID->kbdHead + usbDevHID->kbdCount) % USBD_HID_KEY_QUEUE_SIZE], \
+               state, USBD_HID_KEYBOARD_REPORT_SIZE);
+        usbDevHID->kbdCount++;
+        memcpy(usbDevHID->kbdState, state, USBD_HID_KEYBOARD_REPORT_SIZE);
+        usbDevHID->inputCnt++;
+    }
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID queue a consumer control report.
+ *            Every change of the usage gets its own report.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     usage: consumer usage, 0 to release
+ *
+ * @retval    usb device operation status, USBD_BUSY if the queue is full
+ */
+USBD_STA_T USBD_HID_ConsumerWrite(USBD_INFO_T* usbInfo, uint16_t usage)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if ((usbDevHID == NULL) || (!USBD_HID_Configured(usbInfo)) || \
+        (usbDevHID->reportFormat != USBD_HID_FORMAT_COMPOSITE))
+    {
+        return USBD_FAIL;
+    }
+
+    if (usbDevHID->conState == usage)
+    {
+        return usbStatus;
+    }
+
+    __disable_irq();
+
+    if (usbDevHID->conCount >= USBD_HID_KEY_QUEUE_SIZE)
+    {
+        usbStatus = USBD_BUSY;
+    }
+    else
+    {
+        usbDevHID->conQueue[(usbDevHID->conHead + usbDevHID->conCount) % USBD_HID_KEY_QUEUE_SIZE] = usage;
+        usbDevHID->conCount++;
+        usbDevHID->conState = usage;
+        usbDevHID->inputCnt++;
+    }
+
+    __enable_irq();
+
+    return usbStatus;
+}
+
+#if USBD_SUP_HID_TLM
+/*!
+ * @brief     USB device HID register telemetry interface handler
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     itf: interface handler
+ *
+ * @retval    usb device operation status
+ */
+USBD_STA_T USBD_HID_RegisterTlmItf(USBD_INFO_T* usbInfo, USBD_HID_TLM_INTERFACE_T* itf)
+{
+    USBD_STA_T usbStatus = USBD_FAIL;
+    uint8_t classIndex;
+
+    if (itf != NULL)
+    {
+        classIndex = USBD_ReadClassIndex(usbInfo, &USBD_HID_CLASS);
+
+        if (classIndex != USBD_CLASS_NONE)
+        {
+            usbInfo->devClassUserData[classIndex] = itf;
+            usbStatus = USBD_OK;
+        }
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID send a telemetry report.
+ *            The report is copied to the endpoint buffer before this
+ *            returns, so the caller can refill it at once.
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @param     report: report buffer
+ *
+ * @param     length: report length, up to USBD_HID_TLM_EP_SIZE
+ *
+ * @retval    usb device operation status, USBD_BUSY while the previous
+ *            report has not been polled by the host
+ */
+USBD_STA_T USBD_HID_TlmTxReport(USBD_INFO_T* usbInfo, uint8_t* report, uint16_t length)
+{
+    USBD_STA_T  usbStatus = USBD_OK;
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if ((usbDevHID == NULL) || (usbInfo->devState != USBD_DEV_CONFIGURE) || \
+        (length > USBD_HID_TLM_EP_SIZE))
+    {
+        return USBD_FAIL;
+    }
+
+    if (usbDevHID->tlmState != USBD_HID_IDLE)
+    {
+        return USBD_BUSY;
+    }
+
+    usbDevHID->tlmState = USBD_HID_BUSY;
+    USBD_EP_TransferCallback(usbInfo, usbDevHID->tlmInAddr, report, length);
+
+    return usbStatus;
+}
+#endif
+
+/*!
+ * @brief     USB device HID read interval
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    usb interval
+ */
+uint8_t USBD_HID_ReadInterval(USBD_INFO_T* usbInfo)
 {
     uint8_t interval;
 
     if (usbInfo->devSpeed == USBD_SPEED_FS)
     {
-        interval = USBD_HID_FS_INTERVAL;
+        interval = hidFsInterval;
     }
     else
     {
@@ -518,6 +2208,161 @@ uint8_t USBD_HID_ReadInterval(USBD_INFO_T* usbInfo)
     return interval;
 }
 
+/*!
+ * @brief     USB device HID config full speed polling interval.
+ *            The interval is reported in the endpoint descriptor, so it
+ *            takes effect at the next enumeration.
+ *
+ * @param     interval: polling interval in ms, can be 1, 2, 4, 8 or 10
+ *
+ * @retval    usb device operation status
+ */
+USBD_STA_T USBD_HID_ConfigInterval(uint8_t interval)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+
+    switch (interval)
+    {
+        case 1:
+        case 2:
+        case 4:
+        case 8:
+        case 10:
+            hidFsInterval = interval;
+            break;
+
+        default:
+            usbStatus = USBD_FAIL;
+            break;
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID config mouse report format.
+ *            The format is served in the report descriptor, so it
+ *            takes effect at the next enumeration.
+ *
+ * @param     format: USBD_HID_FORMAT_T value
+ *
+ * @retval    usb device operation status
+ */
+USBD_STA_T USBD_HID_ConfigReportFormat(USBD_HID_FORMAT_T format)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+
+    switch (format)
+    {
+        case USBD_HID_FORMAT_BOOT:
+        case USBD_HID_FORMAT_HIRES:
+        case USBD_HID_FORMAT_DIGITIZER:
+        case USBD_HID_FORMAT_COMPOSITE:
+            hidReportFormat = format;
+            break;
+
+        default:
+            usbStatus = USBD_FAIL;
+            break;
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device HID read report descriptor size
+ *
+ * @param     None
+ *
+ * @retval    size of the report descriptor of the next configuration
+ */
+uint16_t USBD_HID_ReadReportDescSize(void)
+{
+    return USBD_HID_ReportDescHandler(hidReportFormat).size;
+}
+
+/*!
+ * @brief     USB device HID read the report format latched by the
+ *            configuration
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    USBD_HID_FORMAT_T value
+ */
+uint8_t USBD_HID_ReadReportFormat(USBD_INFO_T* usbInfo)
+{
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if (usbDevHID == NULL)
+    {
+        return hidReportFormat;
+    }
+
+    return usbDevHID->reportFormat;
+}
+
+/*!
+ * @brief     USB device HID check for a report format set after the
+ *            configuration, by the host through the device mode or by
+ *            USBD_HID_ConfigReportFormat
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    1 when the device has to re-enumerate to serve it, else 0
+ */
+uint8_t USBD_HID_ReadFormatChange(USBD_INFO_T* usbInfo)
+{
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if ((usbDevHID == NULL) || (usbDevHID->reportFormat == hidReportFormat))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*!
+ * @brief     USB device HID read the number of input reports the host
+ *            has polled on the mouse endpoint, wrapping at 0xFFFF
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    report count
+ */
+uint16_t USBD_HID_ReadTxCount(USBD_INFO_T* usbInfo)
+{
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if (usbDevHID == NULL)
+    {
+        return 0;
+    }
+
+    return usbDevHID->txCnt;
+}
+
+/*!
+ * @brief     USB device HID read the number of inputs accepted by the
+ *            mouse, digitizer, keyboard and consumer writes, wrapping
+ *            at 0xFFFF
+ *
+ * @param     usbInfo: usb device information
+ *
+ * @retval    input count
+ */
+uint16_t USBD_HID_ReadInputCount(USBD_INFO_T* usbInfo)
+{
+    USBD_HID_INFO_T* usbDevHID = USBD_HID_ReadInfo(usbInfo);
+
+    if (usbDevHID == NULL)
+    {
+        return 0;
+    }
+
+    return usbDevHID->inputCnt;
+}
+
 /**@} end of group USBD_HID_Functions */
 /**@} end of group USBD_HID_Class */
 /**@} end of group APM32_USB_Library */
@@ -44,7 +44,8 @@
   @{
 */
 
-#define USBD_MSC_OUT_EP_ADDR            0x01
+/* The pipes take an endpoint number each, so both can be double buffered */
+#define USBD_MSC_OUT_EP_ADDR            0x02
 #define USBD_MSC_IN_EP_ADDR             0x81
 
 #define USBD_MSC_FS_MP_SIZE             0x40
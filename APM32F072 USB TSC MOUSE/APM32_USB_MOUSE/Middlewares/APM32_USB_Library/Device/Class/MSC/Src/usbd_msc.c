@@ -112,8 +112,8 @@ static USBD_STA_T USBD_MSC_ClassInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgInd
         return USBD_FAIL;
     }
 
-    usbDevMSC->epInAddr = USBD_MSC_IN_EP_ADDR;
-    usbDevMSC->epOutAddr = USBD_MSC_OUT_EP_ADDR;
+    usbDevMSC->epInAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_MSC_IN_EP_ADDR);
+    usbDevMSC->epOutAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_MSC_OUT_EP_ADDR);
 
     /* Open endpoint */
     switch (usbInfo->devSpeed)
@@ -154,6 +154,12 @@ static USBD_STA_T USBD_MSC_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t cfgI
     USBD_STA_T usbStatus = USBD_OK;
     USBD_MSC_INFO_T* usbDevMSC = (USBD_MSC_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
 
+    /* Not configured */
+    if (usbDevMSC == NULL)
+    {
+        return usbStatus;
+    }
+
     /* Close MSC EP */
     USBD_EP_CloseCallback(usbInfo, usbDevMSC->epOutAddr);
     usbInfo->devEpOut[usbDevMSC->epOutAddr & 0x0F].useStatus = DISABLE;
@@ -432,10 +438,11 @@ static USBD_STA_T USBD_MSC_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum)
 USBD_STA_T USBD_MSC_RegisterMemory(USBD_INFO_T* usbInfo, USBD_MSC_MEMORY_T* memory)
 {
     USBD_STA_T usbStatus = USBD_FAIL;
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_MSC_CLASS);
 
-    if (memory != NULL)
+    if ((memory != NULL) && (classIndex != USBD_CLASS_NONE))
     {
-        usbInfo->devClassUserData[usbInfo->classID] = memory;
+        usbInfo->devClassUserData[classIndex] = memory;
         usbStatus = USBD_OK;
     }
 
@@ -49,6 +49,7 @@ static USBD_STA_T USBD_WINUSB_SOFHandler(USBD_INFO_T* usbInfo);
 static USBD_STA_T USBD_WINUSB_SetupHandler(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req);
 static USBD_STA_T USBD_WINUSB_DataInHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
 static USBD_STA_T USBD_WINUSB_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum);
+static USBD_WINUSB_INFO_T* USBD_WINUSB_ReadInfo(USBD_INFO_T* usbInfo);
 
 /**@} end of group USBD_WINUSB_Functions */
 
@@ -239,8 +240,8 @@ static USBD_STA_T USBD_WINUSB_ClassInitHandler(USBD_INFO_T* usbInfo, uint8_t cfg
         return USBD_FAIL;
     }
 
-    usbDevWINUSB->epInAddr = USBD_WINUSB_DATA_IN_EP_ADDR;
-    usbDevWINUSB->epOutAddr = USBD_WINUSB_DATA_OUT_EP_ADDR;
+    usbDevWINUSB->epInAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_WINUSB_DATA_IN_EP_ADDR);
+    usbDevWINUSB->epOutAddr = USBD_ReadClassEpAddr(usbInfo, usbInfo->classID, USBD_WINUSB_DATA_OUT_EP_ADDR);
     
     /* Open Data endpoint */
     switch (usbInfo->devSpeed)
@@ -309,6 +310,12 @@ static USBD_STA_T USBD_WINUSB_ClassDeInitHandler(USBD_INFO_T* usbInfo, uint8_t c
     USBD_STA_T usbStatus = USBD_OK;
     USBD_WINUSB_INFO_T* usbDevWINUSB = (USBD_WINUSB_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
 
+    /* Not configured */
+    if (usbDevWINUSB == NULL)
+    {
+        return usbStatus;
+    }
+
     /* Close WINUSB EP */
     USBD_EP_CloseCallback(usbInfo, usbDevWINUSB->epOutAddr);
     usbInfo->devEpOut[usbDevWINUSB->epOutAddr & 0x0F].useStatus = DISABLE;
@@ -596,6 +603,28 @@ static USBD_STA_T USBD_WINUSB_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum
     return usbStatus;
 }
 
+/*!
+ * @brief       USB device WINUSB class data for the functions called by
+ *              the application, which run outside the class callbacks
+ *              that select the class
+ *
+ * @param       usbInfo: usb device information
+ *
+ * @retval      WINUSB class data, NULL if WINUSB is not registered or not
+ *              configured
+ */
+static USBD_WINUSB_INFO_T* USBD_WINUSB_ReadInfo(USBD_INFO_T* usbInfo)
+{
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_WINUSB_CLASS);
+
+    if (classIndex == USBD_CLASS_NONE)
+    {
+        return NULL;
+    }
+
+    return (USBD_WINUSB_INFO_T*)usbInfo->devClass[classIndex]->classData;
+}
+
 /*!
  * @brief       USB device WINUSB configure TX buffer handler
  *
@@ -610,7 +639,7 @@ static USBD_STA_T USBD_WINUSB_DataOutHandler(USBD_INFO_T* usbInfo, uint8_t epNum
 USBD_STA_T USBD_WINUSB_ConfigTxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer, uint32_t length)
 {
     USBD_STA_T  usbStatus = USBD_OK;
-    USBD_WINUSB_INFO_T* usbDevWINUSB = (USBD_WINUSB_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_WINUSB_INFO_T* usbDevWINUSB = USBD_WINUSB_ReadInfo(usbInfo);
     
     if (usbDevWINUSB == NULL)
     {
@@ -635,7 +664,7 @@ USBD_STA_T USBD_WINUSB_ConfigTxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer, uin
 USBD_STA_T USBD_WINUSB_ConfigRxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer)
 {
     USBD_STA_T  usbStatus = USBD_OK;
-    USBD_WINUSB_INFO_T* usbDevWINUSB = (USBD_WINUSB_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_WINUSB_INFO_T* usbDevWINUSB = USBD_WINUSB_ReadInfo(usbInfo);
     
     if (usbDevWINUSB == NULL)
     {
@@ -659,10 +688,11 @@ USBD_STA_T USBD_WINUSB_ConfigRxBuffer(USBD_INFO_T* usbInfo, uint8_t *buffer)
 USBD_STA_T USBD_WINUSB_RegisterItf(USBD_INFO_T* usbInfo, USBD_WINUSB_INTERFACE_T* itf)
 {
     USBD_STA_T usbStatus = USBD_FAIL;
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, &USBD_WINUSB_CLASS);
 
-    if (itf != NULL)
+    if ((itf != NULL) && (classIndex != USBD_CLASS_NONE))
     {
-        usbInfo->devClassUserData[usbInfo->classID] = itf;
+        usbInfo->devClassUserData[classIndex] = itf;
         usbStatus = USBD_OK;
     }
 
@@ -679,7 +709,7 @@ USBD_STA_T USBD_WINUSB_RegisterItf(USBD_INFO_T* usbInfo, USBD_WINUSB_INTERFACE_T
 USBD_STA_T USBD_WINUSB_TxPacket(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_BUSY;
-    USBD_WINUSB_INFO_T* usbDevWINUSB = (USBD_WINUSB_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_WINUSB_INFO_T* usbDevWINUSB = USBD_WINUSB_ReadInfo(usbInfo);
     
     if (usbDevWINUSB == NULL)
     {
@@ -710,7 +740,7 @@ USBD_STA_T USBD_WINUSB_TxPacket(USBD_INFO_T* usbInfo)
 USBD_STA_T USBD_WINUSB_RxPacket(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_BUSY;
-    USBD_WINUSB_INFO_T* usbDevWINUSB = (USBD_WINUSB_INFO_T*)usbInfo->devClass[usbInfo->classID]->classData;
+    USBD_WINUSB_INFO_T* usbDevWINUSB = USBD_WINUSB_ReadInfo(usbInfo);
     
     if (usbDevWINUSB == NULL)
     {
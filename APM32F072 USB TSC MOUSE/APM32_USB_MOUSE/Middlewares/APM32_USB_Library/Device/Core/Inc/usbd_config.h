@@ -55,6 +55,8 @@
 
 #define USBD_DEVICE_DEFAULT_ADDRESS         0
 #define USBD_EP0_PACKET_MAX_SIZE            64
+#define USBD_EP_MAX_NUM                     16
+#define USBD_CLASS_NONE                     0xFF
 
 /**@} end of group USBD_Core_Macros*/
 
@@ -204,6 +206,7 @@ typedef enum
     USBD_DESC_HID                = 0x21,
     USBD_DESC_HID_REPORT         = 0x22,
     USBD_DESC_HID_PHY            = 0x23,
+    USBD_DESC_CS_INTERFACE       = 0x24,
 } USBD_DESC_TYPE_T;
 
 /**
@@ -346,6 +349,22 @@ typedef struct
     USBD_STA_T(*ClassIsoInIncomplete)(struct _USBD_INFO_T* usbInfo, uint8_t epNum);
 } USBD_CLASS_T;
 
+/**
+ * @brief   USB device class resources in a composite device. The
+ *          descriptor of the class numbers its interfaces from 0, the
+ *          registration moves them after the classes registered before
+ *          and gives its endpoints the next free endpoint numbers.
+ */
+typedef struct
+{
+    const uint8_t*      desc;                   /*!< Interface, class specific and endpoint descriptors */
+    uint16_t            descLen;
+    uint8_t             iadStatus;              /*!< Group the interfaces with an IAD */
+    uint8_t             itfBase;                /*!< First interface number */
+    uint8_t             itfNum;
+    uint8_t             epMap[USBD_EP_MAX_NUM]; /*!< Descriptor endpoint number to device endpoint number */
+} USBD_CLASS_MAP_T;
+
 /**
  * @brief   USB device information
  */
@@ -366,6 +385,15 @@ typedef struct _USBD_INFO_T
     uint32_t                classID;
     uint32_t                classNum;
 
+    /* Composite device, the class of an interface or endpoint number */
+    USBD_CLASS_MAP_T        classMap[USBD_SUP_CLASS_MAX_NUM];
+    uint8_t                 itfClass[USBD_SUP_INTERFACE_MAX_NUM];
+    uint8_t                 epClass[USBD_EP_MAX_NUM];
+    uint8_t                 itfNum;
+    uint8_t                 epNum;
+    uint8_t                 devReqClassID;      /*!< Class of the requests to the device */
+    uint8_t                 reqClassID;         /*!< Class of the current control request */
+
     void*                   cfgDesc;
     USBD_REQ_SETUP_T        reqSetup;
 
@@ -68,6 +68,16 @@ USBD_STA_T USBD_Init(USBD_INFO_T* usbInfo, USBD_SPEED_T usbDevSpeed, \
                      USBD_CLASS_T* usbDevClass, \
                      void (*userCallbackFunc)(struct _USBD_INFO_T*, uint8_t));
 USBD_STA_T USBD_DeInit(USBD_INFO_T* usbInfo);
+USBD_STA_T USBD_RegisterClass(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass, \
+                              const uint8_t* desc, uint16_t length, uint8_t iadStatus);
+uint8_t USBD_ReadClassEpAddr(USBD_INFO_T* usbInfo, uint8_t classIndex, uint8_t epAddr);
+uint8_t USBD_ReadClassItf(USBD_INFO_T* usbInfo, uint8_t classIndex, uint8_t itfNum);
+uint8_t USBD_ReadClassIndex(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass);
+USBD_STA_T USBD_ConfigDevReqClass(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass);
+USBD_STA_T USBD_ComposeConfigDesc(USBD_INFO_T* usbInfo, const uint8_t* header, \
+                                  uint8_t* buffer, uint16_t* length);
+USBD_STA_T USBD_SetClassConfig(USBD_INFO_T* usbInfo, uint8_t cfgIndex);
+USBD_STA_T USBD_ClearClassConfig(USBD_INFO_T* usbInfo, uint8_t cfgIndex);
 void USBD_HardwareInit(USBD_INFO_T* usbInfo);
 void USBD_HardwareReset(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_SetSpeed(USBD_INFO_T* usbInfo, USBD_DEVICE_SPEED_T speed);
@@ -76,6 +86,7 @@ USBD_STA_T USBD_DataOutStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffe
 USBD_STA_T USBD_DataInStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffer);
 USBD_STA_T USBD_Resume(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_Suspend(USBD_INFO_T* usbInfo);
+USBD_STA_T USBD_RemoteWakeup(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_Reset(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_HandleSOF(USBD_INFO_T* usbInfo);
 USBD_STA_T USBD_IsoInInComplete(USBD_INFO_T* usbInfo, uint8_t epNum);
@@ -102,6 +113,7 @@ USBD_STA_T USBD_EP_TransferCallback(USBD_INFO_T* usbInfo, uint8_t epAddr, \
 USBD_STA_T USBD_EP_FlushCallback(USBD_INFO_T* usbInfo, uint8_t epAddr);
 
 USBD_STA_T USBD_SetDevAddressCallback(USBD_INFO_T* usbInfo, uint8_t address);
+USBD_STA_T USBD_RemoteWakeupCallback(USBD_INFO_T* usbInfo);
 
 /**@} end of group USBD_Core_Functions */
 /**@} end of group USBD_Core */
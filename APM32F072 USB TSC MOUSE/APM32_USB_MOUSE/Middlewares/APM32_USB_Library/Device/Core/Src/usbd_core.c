@@ -69,14 +69,15 @@ USBD_STA_T USBD_Init(USBD_INFO_T* usbInfo, USBD_SPEED_T usbDevSpeed, \
     }
 
     /* Register class function */
-    if (usbDevClass == NULL)
+    if (usbDevClass != NULL)
     {
-        usbStatus = USBD_FAIL;
-        return usbStatus;
+        usbInfo->devClass[usbInfo->classNum++] = usbDevClass;
     }
-    else
+    /* Classes of a composite device registered with USBD_RegisterClass */
+    else if (usbInfo->classNum == 0)
     {
-        usbInfo->devClass[usbInfo->classNum++] = usbDevClass;
+        usbStatus = USBD_FAIL;
+        return usbStatus;
     }
 
     /* Register user application */
@@ -105,10 +106,7 @@ USBD_STA_T USBD_DeInit(USBD_INFO_T* usbInfo)
     
     usbInfo->devState = USBD_DEV_DEFAULT;
     
-    if(usbInfo->devClass[0] != NULL)
-    {
-        usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, usbInfo->devCfg);
-    }
+    USBD_ClearClassConfig(usbInfo, usbInfo->devCfg);
     
     if(usbInfo->dataPoint != NULL)
     {
@@ -122,6 +120,413 @@ USBD_STA_T USBD_DeInit(USBD_INFO_T* usbInfo)
     return usbStatus;
 }
 
+/*!
+ * @brief     USB device register a class of a composite device. The
+ *            interfaces of its descriptor are numbered after the ones
+ *            of the classes registered before and its endpoints take
+ *            the next free endpoint numbers.
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     usbDevClass : class handler
+ *
+ * @param     desc : interface, class specific and endpoint descriptors
+ *            of the class, interfaces numbered from 0
+ *
+ * @param     length : descriptor length
+ *
+ * @param     iadStatus : ENABLE to group the interfaces of the class
+ *            with an interface association descriptor
+ *
+ * @retval    usb device status
+ *
+ * @note      Register the classes before USBD_Init, which is then
+ *            called with a NULL class. The class index is left in
+ *            usbInfo->classID for the class interface registered next.
+ *            An IN and an OUT endpoint of the same number in desc
+ *            share an endpoint number.
+ */
+USBD_STA_T USBD_RegisterClass(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass, \
+                              const uint8_t* desc, uint16_t length, uint8_t iadStatus)
+{
+    USBD_CLASS_MAP_T* map;
+    uint8_t classIndex;
+    uint8_t itfNum;
+    uint8_t epNum;
+    uint16_t index;
+
+    if ((usbDevClass == NULL) || (desc == NULL) || \
+        (usbInfo->classNum >= USBD_SUP_CLASS_MAX_NUM))
+    {
+        return USBD_FAIL;
+    }
+
+    /* Nothing is routed to a class before it is registered */
+    if (usbInfo->classNum == 0)
+    {
+        for (index = 0; index < USBD_SUP_INTERFACE_MAX_NUM; index++)
+        {
+            usbInfo->itfClass[index] = USBD_CLASS_NONE;
+        }
+
+        for (index = 0; index < USBD_EP_MAX_NUM; index++)
+        {
+            usbInfo->epClass[index] = USBD_CLASS_NONE;
+        }
+
+        usbInfo->itfNum = 0;
+        usbInfo->epNum = 0;
+    }
+
+    classIndex = usbInfo->classNum;
+    map = &usbInfo->classMap[classIndex];
+
+    map->desc = desc;
+    map->descLen = length;
+    map->iadStatus = iadStatus;
+    map->itfBase = usbInfo->itfNum;
+    map->itfNum = 0;
+
+    for (index = 0; index < USBD_EP_MAX_NUM; index++)
+    {
+        map->epMap[index] = 0;
+    }
+
+    for (index = 0; (index + 2) < length; index += desc[index])
+    {
+        if (desc[index] == 0)
+        {
+            return USBD_FAIL;
+        }
+
+        switch (desc[index + 1])
+        {
+            case USBD_DESC_INTERFACE:
+                /* Alternate settings share the interface */
+                if (desc[index + 3] == 0)
+                {
+                    itfNum = map->itfBase + desc[index + 2];
+
+                    if (itfNum >= USBD_SUP_INTERFACE_MAX_NUM)
+                    {
+                        return USBD_FAIL;
+                    }
+
+                    usbInfo->itfClass[itfNum] = classIndex;
+                    map->itfNum++;
+                }
+                break;
+
+            case USBD_DESC_ENDPOINT:
+                epNum = desc[index + 2] & 0x0F;
+
+                if (map->epMap[epNum] == 0)
+                {
+                    if ((usbInfo->epNum + 1) >= USBD_EP_MAX_NUM)
+                    {
+                        return USBD_FAIL;
+                    }
+
+                    map->epMap[epNum] = ++usbInfo->epNum;
+                    usbInfo->epClass[map->epMap[epNum]] = classIndex;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    usbInfo->itfNum += map->itfNum;
+    usbInfo->devClass[classIndex] = usbDevClass;
+    usbInfo->classID = classIndex;
+    usbInfo->classNum++;
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief     USB device read the device endpoint address of a class
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     classIndex : class index
+ *
+ * @param     epAddr : endpoint address in the class descriptor
+ *
+ * @retval    endpoint address, epAddr for a class not registered with
+ *            USBD_RegisterClass
+ */
+uint8_t USBD_ReadClassEpAddr(USBD_INFO_T* usbInfo, uint8_t classIndex, uint8_t epAddr)
+{
+    uint8_t epNum = usbInfo->classMap[classIndex].epMap[epAddr & 0x0F];
+
+    if (epNum == 0)
+    {
+        return epAddr;
+    }
+
+    return (epAddr & 0x80) | epNum;
+}
+
+/*!
+ * @brief     USB device read the device interface number of a class
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     classIndex : class index
+ *
+ * @param     itfNum : interface number in the class descriptor
+ *
+ * @retval    interface number
+ */
+uint8_t USBD_ReadClassItf(USBD_INFO_T* usbInfo, uint8_t classIndex, uint8_t itfNum)
+{
+    return usbInfo->classMap[classIndex].itfBase + itfNum;
+}
+
+/*!
+ * @brief     USB device read the index of a registered class, for the
+ *            class functions called by the application
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     usbDevClass : class handler
+ *
+ * @retval    class index, USBD_CLASS_NONE if the class is not registered
+ */
+uint8_t USBD_ReadClassIndex(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass)
+{
+    uint8_t classIndex;
+
+    for (classIndex = 0; classIndex < usbInfo->classNum; classIndex++)
+    {
+        if (usbInfo->devClass[classIndex] == usbDevClass)
+        {
+            return classIndex;
+        }
+    }
+
+    return USBD_CLASS_NONE;
+}
+
+/*!
+ * @brief     USB device config the class taking the class and vendor
+ *            requests to the device, which name no interface
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     usbDevClass : class handler
+ *
+ * @retval    usb device status
+ *
+ * @note      The first class registered takes them by default
+ */
+USBD_STA_T USBD_ConfigDevReqClass(USBD_INFO_T* usbInfo, USBD_CLASS_T* usbDevClass)
+{
+    uint8_t classIndex = USBD_ReadClassIndex(usbInfo, usbDevClass);
+
+    if (classIndex == USBD_CLASS_NONE)
+    {
+        return USBD_FAIL;
+    }
+
+    usbInfo->devReqClassID = classIndex;
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief     USB device compose the configuration descriptor of the
+ *            registered classes, with their interfaces and endpoints
+ *            renumbered and an IAD before the grouped ones
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     header : configuration descriptor header, its total
+ *            length and interface number are filled in
+ *
+ * @param     buffer : configuration descriptor buffer
+ *
+ * @param     length : buffer size in, descriptor length out
+ *
+ * @retval    usb device status
+ */
+USBD_STA_T USBD_ComposeConfigDesc(USBD_INFO_T* usbInfo, const uint8_t* header, \
+                                  uint8_t* buffer, uint16_t* length)
+{
+    USBD_CLASS_MAP_T* map;
+    const uint8_t* desc;
+    uint8_t* item;
+    uint8_t classIndex;
+    uint8_t i;
+    uint16_t itfIndex;
+    uint16_t size = *length;
+    uint16_t total;
+    uint16_t index;
+
+    if (size < header[0])
+    {
+        return USBD_FAIL;
+    }
+
+    for (total = 0; total < header[0]; total++)
+    {
+        buffer[total] = header[total];
+    }
+
+    for (classIndex = 0; classIndex < usbInfo->classNum; classIndex++)
+    {
+        map = &usbInfo->classMap[classIndex];
+        desc = map->desc;
+
+        if (desc == NULL)
+        {
+            continue;
+        }
+
+        if ((map->iadStatus == ENABLE) && (map->itfNum > 1))
+        {
+            /* Function class of the first interface */
+            for (itfIndex = 0; (itfIndex + 2) < map->descLen; itfIndex += desc[itfIndex])
+            {
+                if (desc[itfIndex + 1] == USBD_DESC_INTERFACE)
+                {
+                    break;
+                }
+            }
+
+            if (((itfIndex + 8) > map->descLen) || ((total + 8) > size))
+            {
+                return USBD_FAIL;
+            }
+
+            buffer[total++] = 0x08;
+            buffer[total++] = USBD_DESC_IAD;
+            buffer[total++] = map->itfBase;
+            buffer[total++] = map->itfNum;
+            buffer[total++] = desc[itfIndex + 5];
+            buffer[total++] = desc[itfIndex + 6];
+            buffer[total++] = desc[itfIndex + 7];
+            buffer[total++] = 0x00;
+        }
+
+        for (index = 0; (index + 2) < map->descLen; index += desc[index])
+        {
+            if ((desc[index] == 0) || ((total + desc[index]) > size))
+            {
+                return USBD_FAIL;
+            }
+
+            item = &buffer[total];
+
+            for (i = 0; i < desc[index]; i++)
+            {
+                buffer[total++] = desc[index + i];
+            }
+
+            switch (item[1])
+            {
+                case USBD_DESC_INTERFACE:
+                case USBD_DESC_IAD:
+                    item[2] += map->itfBase;
+                    break;
+
+                case USBD_DESC_ENDPOINT:
+                    item[2] = USBD_ReadClassEpAddr(usbInfo, classIndex, item[2]);
+                    break;
+
+                case USBD_DESC_CS_INTERFACE:
+                    /* CDC call management, data interface */
+                    if ((item[2] == 0x01) && (item[0] >= 5))
+                    {
+                        item[4] += map->itfBase;
+                    }
+                    /* CDC union, control then data interfaces */
+                    else if (item[2] == 0x06)
+                    {
+                        for (i = 3; i < item[0]; i++)
+                        {
+                            item[i] += map->itfBase;
+                        }
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    buffer[2] = total & 0xFF;
+    buffer[3] = total >> 8;
+    buffer[4] = usbInfo->itfNum;
+
+    *length = total;
+
+    return USBD_OK;
+}
+
+/*!
+ * @brief     USB device set the configuration of all classes
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     cfgIndex : configuration index
+ *
+ * @retval    usb device status
+ */
+USBD_STA_T USBD_SetClassConfig(USBD_INFO_T* usbInfo, uint8_t cfgIndex)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+    uint8_t classIndex;
+
+    for (classIndex = 0; classIndex < usbInfo->classNum; classIndex++)
+    {
+        if (usbInfo->devClass[classIndex]->ClassInitHandler != NULL)
+        {
+            usbInfo->classID = classIndex;
+
+            if (usbInfo->devClass[classIndex]->ClassInitHandler(usbInfo, cfgIndex) != USBD_OK)
+            {
+                usbStatus = USBD_FAIL;
+            }
+        }
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device clear the configuration of all classes
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     cfgIndex : configuration index
+ *
+ * @retval    usb device status
+ */
+USBD_STA_T USBD_ClearClassConfig(USBD_INFO_T* usbInfo, uint8_t cfgIndex)
+{
+    USBD_STA_T usbStatus = USBD_OK;
+    uint8_t classIndex;
+
+    for (classIndex = 0; classIndex < usbInfo->classNum; classIndex++)
+    {
+        if (usbInfo->devClass[classIndex]->ClassDeInitHandler != NULL)
+        {
+            usbInfo->classID = classIndex;
+
+            if (usbInfo->devClass[classIndex]->ClassDeInitHandler(usbInfo, cfgIndex) != USBD_OK)
+            {
+                usbStatus = USBD_FAIL;
+            }
+        }
+    }
+
+    return usbStatus;
+}
+
 /*!
  * @brief     USB device set speed
  *
@@ -161,6 +566,65 @@ USBD_STA_T USBD_TestModeHandler(USBD_INFO_T* usbInfo)
     return usbStatus;
 }
 
+/*!
+ * @brief     USB device pass a request to the class it is routed to
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     classIndex : class index, USBD_CLASS_NONE when the request
+ *            reaches no class
+ *
+ * @retval    usb device status
+ *
+ * @note      EP0 is stalled when no class takes the request or the
+ *            class rejects it. The class is kept for the data and
+ *            status stages of the request.
+ */
+static USBD_STA_T USBD_ClassSetupIndex(USBD_INFO_T* usbInfo, uint8_t classIndex)
+{
+    USBD_STA_T usbStatus = USBD_FAIL;
+    uint16_t reqWLength = usbInfo->reqSetup.DATA_FIELD.wLength[0] | \
+                          usbInfo->reqSetup.DATA_FIELD.wLength[1] << 8;
+
+    usbInfo->reqClassID = classIndex;
+
+    if ((classIndex < usbInfo->classNum) && (usbInfo->devClass[classIndex]->ClassSetup != NULL))
+    {
+        usbInfo->classID = classIndex;
+        usbStatus = usbInfo->devClass[classIndex]->ClassSetup(usbInfo, &usbInfo->reqSetup);
+    }
+
+    if (usbStatus != USBD_OK)
+    {
+        USBD_REQ_CtrlError(usbInfo, &usbInfo->reqSetup);
+    }
+    else if (reqWLength == 0)
+    {
+        USBD_CtrlSendStatus(usbInfo);
+    }
+
+    return usbStatus;
+}
+
+/*!
+ * @brief     USB device read the class of an interface
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @param     itfNum : interface number
+ *
+ * @retval    class index, USBD_CLASS_NONE for an unknown interface
+ */
+static uint8_t USBD_ReadItfClass(USBD_INFO_T* usbInfo, uint8_t itfNum)
+{
+    if (itfNum >= USBD_SUP_INTERFACE_MAX_NUM)
+    {
+        return USBD_CLASS_NONE;
+    }
+
+    return usbInfo->itfClass[itfNum];
+}
+
 /*!
  * @brief     USB device SETUP stage
  *
@@ -221,7 +685,9 @@ USBD_STA_T USBD_SetupStage(USBD_INFO_T* usbInfo, uint8_t* setup)
 
                 case USBD_REQ_TYPE_CLASS:
                 case USBD_REQ_TYPE_VENDOR:
-                    usbInfo->devClass[usbInfo->classID]->ClassSetup(usbInfo, &usbInfo->reqSetup);
+                    /* No interface is named, the requests to the device
+                       go to one class */
+                    usbStatus = USBD_ClassSetupIndex(usbInfo, usbInfo->devReqClassID);
                     break;
 
                 default:
@@ -241,44 +707,18 @@ USBD_STA_T USBD_SetupStage(USBD_INFO_T* usbInfo, uint8_t* setup)
                         case USBD_DEV_DEFAULT:
                         case USBD_DEV_ADDRESS:
                         case USBD_DEV_CONFIGURE:
-                            if(request == USBD_VEN_REQ_MS_CODE)
+                            if ((reqType == USBD_REQ_TYPE_VENDOR) && (request == USBD_VEN_REQ_MS_CODE))
                             {
-                                usbInfo->devClass[usbInfo->classID]->ClassSetup(usbInfo, &usbInfo->reqSetup);
+                                /* MS OS extended properties, wIndex holds the
+                                   descriptor index and wValue the interface */
+                                classIndex = USBD_ReadItfClass(usbInfo, usbInfo->reqSetup.DATA_FIELD.wValue[0]);
                             }
                             else
                             {
-                                if (usbInfo->reqSetup.DATA_FIELD.wIndex[0] <= USBD_SUP_INTERFACE_MAX_NUM)
-                                {
-                                    /* Add multi class support */
-                                    classIndex = 0;
-                                    if ((classIndex != 0xFF) && (classIndex < USBD_SUP_CLASS_MAX_NUM))
-                                    {
-                                        usbInfo->classID = classIndex;
-                                        
-                                        if (usbInfo->devClass[classIndex]->ClassSetup != NULL)
-                                        {
-                                            usbStatus = usbInfo->devClass[classIndex]->ClassSetup(usbInfo, &usbInfo->reqSetup);
-                                        }
-                                        else
-                                        {
-                                            usbStatus = USBD_FAIL;
-                                        }
-                                    }
-                                    else
-                                    {
-                                        usbStatus = USBD_FAIL;
-                                    }
-
-                                    if ((usbStatus == USBD_OK) && (reqWLength == 0))
-                                    {
-                                        USBD_CtrlSendStatus(usbInfo);
-                                    }
-                                }
-                                else
-                                {
-                                    USBD_REQ_CtrlError(usbInfo, &usbInfo->reqSetup);
-                                }
+                                classIndex = USBD_ReadItfClass(usbInfo, usbInfo->reqSetup.DATA_FIELD.wIndex[0]);
                             }
+
+                            usbStatus = USBD_ClassSetupIndex(usbInfo, classIndex);
                             break;
 
                         default:
@@ -405,9 +845,8 @@ USBD_STA_T USBD_SetupStage(USBD_INFO_T* usbInfo, uint8_t* setup)
 
                                         USBD_CtrlSendStatus(usbInfo);
 
-                                        /* Add multi class support */
-                                        classIndex = 0;
-                                        if ((classIndex != 0xFF) && (classIndex < USBD_SUP_CLASS_MAX_NUM))
+                                        classIndex = usbInfo->epClass[epAddr & 0x0F];
+                                        if ((classIndex != USBD_CLASS_NONE) && (classIndex < usbInfo->classNum))
                                         {
                                             usbInfo->classID = classIndex;
 
@@ -467,17 +906,7 @@ USBD_STA_T USBD_SetupStage(USBD_INFO_T* usbInfo, uint8_t* setup)
 
                 case USBD_REQ_TYPE_CLASS:
                 case USBD_REQ_TYPE_VENDOR:
-                    /* Add multi class support */
-                    classIndex = 0;
-                    if ((classIndex != 0xFF) && (classIndex < USBD_SUP_CLASS_MAX_NUM))
-                    {
-                        usbInfo->classID = classIndex;
-
-                        if (usbInfo->devClass[classIndex]->ClassSetup != NULL)
-                        {
-                            usbStatus = usbInfo->devClass[classIndex]->ClassSetup(usbInfo, &usbInfo->reqSetup);
-                        }
-                    }
+                    usbStatus = USBD_ClassSetupIndex(usbInfo, usbInfo->epClass[epAddr & 0x0F]);
                     break;
 
                 default:
@@ -513,16 +942,15 @@ USBD_STA_T USBD_DataOutStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffe
 
     if (epNum != 0)
     {
-        /* Add multi class support */
-        classIndex = 0;
+        classIndex = usbInfo->epClass[epNum & 0x0F];
 
-        if ((classIndex != 0xFF) && (classIndex < USBD_SUP_CLASS_MAX_NUM))
+        if ((classIndex != USBD_CLASS_NONE) && (classIndex < usbInfo->classNum))
         {
             if (usbInfo->devState == USBD_DEV_CONFIGURE)
             {
                 if (usbInfo->devClass[classIndex]->ClassDataOut != NULL)
                 {
-                    usbInfo->classNum = classIndex;
+                    usbInfo->classID = classIndex;
                     usbStatus = usbInfo->devClass[classIndex]->ClassDataOut(usbInfo, epNum);
 
                     if (usbStatus != USBD_OK)
@@ -550,43 +978,37 @@ USBD_STA_T USBD_DataOutStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffe
                 }
                 else
                 {
-                    switch (usbInfo->reqSetup.DATA_FIELD.bmRequest.REQ_TYPE_B.recipient)
-                    {
-                        case USBD_RECIPIENT_DEVICE:
-                            classIndex = 0;
-                            break;
-
-                        case USBD_RECIPIENT_INTERFACE:
-                            /* Add multi class support */
-                            classIndex = 0;
-                            break;
-
-                        case USBD_RECIPIENT_ENDPOINT:
-                            /* Add multi class support */
-                            classIndex = 0;
-                            break;
+                    /* The class of the SETUP stage */
+                    classIndex = usbInfo->reqClassID;
 
-                        default:
-                            classIndex = 0;
-                            break;
-                    }
-
-                    if (classIndex < USBD_SUP_CLASS_MAX_NUM)
+                    if (classIndex < usbInfo->classNum)
                     {
                         if (usbInfo->devState == USBD_DEV_CONFIGURE)
                         {
                             if (usbInfo->devClass[classIndex]->ClassRxEP0 != NULL)
                             {
-                                usbInfo->classNum = classIndex;
-                                usbInfo->devClass[classIndex]->ClassRxEP0(usbInfo);
+                                usbInfo->classID = classIndex;
+                                usbStatus = usbInfo->devClass[classIndex]->ClassRxEP0(usbInfo);
                             }
                         }
                     }
 
-                    USBD_CtrlSendStatus(usbInfo);
+                    /* Data the class rejects stalls the status stage */
+                    if (usbStatus != USBD_OK)
+                    {
+                        USBD_REQ_CtrlError(usbInfo, &usbInfo->reqSetup);
+                    }
+                    else
+                    {
+                        USBD_CtrlSendStatus(usbInfo);
+                    }
                 }
                 break;
 
+            case USBD_DEV_EP0_STATUS_OUT:
+                usbInfo->devEp0State = USBD_DEV_EP0_IDLE;
+                break;
+
             default:
                 
                 break;
@@ -615,9 +1037,8 @@ USBD_STA_T USBD_DataInStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffer
 
     if (epNum)
     {
-        /* Add multi class support */
-        classIndex = 0;
-        if ((classIndex != 0xFF) && (classIndex < USBD_SUP_CLASS_MAX_NUM))
+        classIndex = usbInfo->epClass[epNum & 0x0F];
+        if ((classIndex != USBD_CLASS_NONE) && (classIndex < usbInfo->classNum))
         {
             if (usbInfo->devState == USBD_DEV_CONFIGURE)
             {
@@ -664,14 +1085,15 @@ USBD_STA_T USBD_DataInStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffer
                 }
                 else
                 {
-                    classIndex = 0;
+                    /* The class of the SETUP stage */
+                    classIndex = usbInfo->reqClassID;
 
-                    if (usbInfo->devState == USBD_DEV_CONFIGURE)
+                    if ((usbInfo->devState == USBD_DEV_CONFIGURE) && (classIndex < usbInfo->classNum))
                     {
-                        if (usbInfo->devClass[USBD_EP_0]->ClassTxEP0 != NULL)
+                        if (usbInfo->devClass[classIndex]->ClassTxEP0 != NULL)
                         {
                             usbInfo->classID = classIndex;
-                            usbInfo->devClass[USBD_EP_0]->ClassTxEP0(usbInfo);
+                            usbInfo->devClass[classIndex]->ClassTxEP0(usbInfo);
                         }
                     }
                     USBD_EP_StallCallback(usbInfo, 0x80);
@@ -679,9 +1101,10 @@ USBD_STA_T USBD_DataInStage(USBD_INFO_T* usbInfo, uint8_t epNum, uint8_t* buffer
                 }
             }
         }
-        else
+        else if (usbInfo->devEp0State == USBD_DEV_EP0_STATUS_IN)
         {
-
+            /* The control transfer ends with its status stage */
+            usbInfo->devEp0State = USBD_DEV_EP0_IDLE;
         }
 
         if (usbInfo->devTestModeStatus == ENABLE)
@@ -734,6 +1157,26 @@ USBD_STA_T USBD_Suspend(USBD_INFO_T* usbInfo)
     return usbStatus;
 }
 
+/*!
+ * @brief     USB device remote wakeup. The device state is restored
+ *            by USBD_Resume at the end of the resume signalling.
+ *
+ * @param     usbInfo : usb handler information
+ *
+ * @retval    usb device status, USBD_FAIL if the device is not
+ *            suspended or the host has not enabled remote wakeup
+ */
+USBD_STA_T USBD_RemoteWakeup(USBD_INFO_T* usbInfo)
+{
+    if ((usbInfo->devState != USBD_DEV_SUSPEND) || \
+        (usbInfo->devRemoteWakeUpStatus != ENABLE))
+    {
+        return USBD_FAIL;
+    }
+
+    return USBD_RemoteWakeupCallback(usbInfo);
+}
+
 /*!
  * @brief     USB device reset
  *
@@ -751,16 +1194,7 @@ USBD_STA_T USBD_Reset(USBD_INFO_T* usbInfo)
     usbInfo->devState               = USBD_DEV_DEFAULT;
     usbInfo->devEp0State            = USBD_DEV_EP0_IDLE;
 
-    if ((usbInfo->devClass[0] != NULL) && \
-            (usbInfo->devClass[0]->ClassDeInitHandler != NULL))
-    {
-        usbStatus = usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, \
-                    usbInfo->devCfg);
-        if (usbStatus != USBD_OK)
-        {
-            usbStatus = USBD_FAIL;
-        }
-    }
+    usbStatus = USBD_ClearClassConfig(usbInfo, usbInfo->devCfg);
 
     /* Open EP0 OUT */
     USBD_EP_OpenCallback(usbInfo, 0x00, EP_TYPE_CONTROL, USBD_EP0_PACKET_MAX_SIZE);
@@ -787,13 +1221,17 @@ USBD_STA_T USBD_Reset(USBD_INFO_T* usbInfo)
 USBD_STA_T USBD_HandleSOF(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_OK;
+    uint8_t classIndex;
 
     if (usbInfo->devState == USBD_DEV_CONFIGURE)
     {
-        if ((usbInfo->devClass[0] != NULL) && \
-                usbInfo->devClass[0]->ClassSofHandler != NULL)
+        for (classIndex = 0; classIndex < usbInfo->classNum; classIndex++)
         {
-            usbInfo->devClass[0]->ClassSofHandler(usbInfo);
+            if (usbInfo->devClass[classIndex]->ClassSofHandler != NULL)
+            {
+                usbInfo->classID = classIndex;
+                usbInfo->devClass[classIndex]->ClassSofHandler(usbInfo);
+            }
         }
     }
 
@@ -884,24 +1322,10 @@ USBD_STA_T USBD_Connect(USBD_INFO_T* usbInfo)
 USBD_STA_T USBD_Disconnect(USBD_INFO_T* usbInfo)
 {
     USBD_STA_T usbStatus = USBD_OK;
-    uint8_t reqStatus = USBD_BUSY;
 
     usbInfo->devState = USBD_DEV_DEFAULT;
 
-    if (usbInfo->devClass[0] != NULL)
-    {
-        reqStatus = usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, usbInfo->devCfg);
-
-        switch (reqStatus)
-        {
-            case USBD_OK:
-                break;
-
-            default:
-                usbStatus = USBD_FAIL;
-                break;
-        }
-    }
+    usbStatus = USBD_ClearClassConfig(usbInfo, usbInfo->devCfg);
 
     usbInfo->userCallback(usbInfo, USBD_USER_DISCONNECT);
 
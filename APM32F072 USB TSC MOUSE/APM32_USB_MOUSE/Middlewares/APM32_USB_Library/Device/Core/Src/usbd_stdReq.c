@@ -536,10 +536,7 @@ static USBD_STA_T USBD_REQ_SetCfg(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
                 usbInfo->devCfg = cfgIndex;
 
                 /* Set class configuration */
-                if (usbInfo->devClass[0] != NULL)
-                {
-                    usbStatus = usbInfo->devClass[0]->ClassInitHandler(usbInfo, cfgIndex);
-                }
+                usbStatus = USBD_SetClassConfig(usbInfo, cfgIndex);
 
                 if (usbStatus == USBD_OK)
                 {
@@ -561,22 +558,19 @@ static USBD_STA_T USBD_REQ_SetCfg(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
                 usbInfo->devCfg = cfgIndex;
 
                 /* Clear class configuration */
-                usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, cfgIndex);
+                USBD_ClearClassConfig(usbInfo, cfgIndex);
 
                 USBD_CtrlSendStatus(usbInfo);
             }
             else if (cfgIndex != usbInfo->devCfg)
             {
                 /* Clear old class configuration */
-                usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, usbInfo->devCfg);
+                USBD_ClearClassConfig(usbInfo, usbInfo->devCfg);
 
                 usbInfo->devCfg = cfgIndex;
 
                 /* Set class configuration */
-                if (usbInfo->devClass[0] != NULL)
-                {
-                    usbStatus = usbInfo->devClass[0]->ClassInitHandler(usbInfo, cfgIndex);
-                }
+                usbStatus = USBD_SetClassConfig(usbInfo, cfgIndex);
 
                 if (usbStatus == USBD_OK)
                 {
@@ -586,7 +580,7 @@ static USBD_STA_T USBD_REQ_SetCfg(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
                 {
                     USBD_REQ_CtrlError(usbInfo, req);
                     /* Clear old class configuration */
-                    usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, usbInfo->devCfg);
+                    USBD_ClearClassConfig(usbInfo, usbInfo->devCfg);
                     usbInfo->devState = USBD_DEV_ADDRESS;
                 }
             }
@@ -600,7 +594,7 @@ static USBD_STA_T USBD_REQ_SetCfg(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
             USBD_REQ_CtrlError(usbInfo, req);
 
             /* Clear class configuration */
-            if (usbInfo->devClass[0]->ClassDeInitHandler(usbInfo, cfgIndex) != USBD_OK)
+            if (USBD_ClearClassConfig(usbInfo, cfgIndex) != USBD_OK)
             {
                 usbStatus = USBD_FAIL;
             }
@@ -675,6 +669,8 @@ USBD_STA_T USBD_REQ_CtrlError(USBD_INFO_T* usbInfo, USBD_REQ_SETUP_T* req)
     USBD_EP_StallCallback(usbInfo, 0x80);
     USBD_EP_StallCallback(usbInfo, 0x00);
 
+    usbInfo->devEp0State = USBD_DEV_EP0_STALL;
+
     return usbStatus;
 }
 